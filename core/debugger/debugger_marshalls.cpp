@@ -144,6 +144,72 @@ bool DebuggerMarshalls::OutputError::deserialize(const Array &p_arr) {
 	return true;
 }
 
+void DebuggerMarshalls::MemoryTagUsage::capture() {
+	entries.clear();
+	uint32_t count = Memory::get_tag_count();
+	entries.resize(count);
+	Entry *w = entries.ptrw();
+	for (uint32_t i = 0; i < count; i++) {
+		Memory::TagUsage usage = Memory::get_tag_usage(i);
+		w[i].name = String::utf8(Memory::get_tag_name(i));
+		w[i].live_bytes = usage.live_bytes;
+		w[i].live_blocks = usage.live_blocks;
+		w[i].allocations = usage.allocations;
+	}
+}
+
+DebuggerMarshalls::MemoryTagUsage DebuggerMarshalls::MemoryTagUsage::diff(const MemoryTagUsage &p_baseline) const {
+	HashMap<String, int> baseline_indices;
+	for (int i = 0; i < p_baseline.entries.size(); i++) {
+		baseline_indices.insert(p_baseline.entries[i].name, i);
+	}
+
+	MemoryTagUsage result;
+	for (const Entry &entry : entries) {
+		Entry change = entry;
+		const int *index = baseline_indices.getptr(entry.name);
+		if (index) {
+			const Entry &base = p_baseline.entries[*index];
+			change.live_bytes -= base.live_bytes;
+			change.live_blocks -= base.live_blocks;
+			change.allocations -= base.allocations;
+		}
+		if (change.live_bytes != 0 || change.live_blocks != 0 || change.allocations != 0) {
+			result.entries.push_back(change);
+		}
+	}
+	return result;
+}
+
+Array DebuggerMarshalls::MemoryTagUsage::serialize() {
+	Array arr = { entries.size() * 4 };
+	for (const Entry &entry : entries) {
+		arr.push_back(entry.name);
+		arr.push_back(entry.live_bytes);
+		arr.push_back(entry.live_blocks);
+		arr.push_back(entry.allocations);
+	}
+	return arr;
+}
+
+bool DebuggerMarshalls::MemoryTagUsage::deserialize(const Array &p_arr) {
+	CHECK_SIZE(p_arr, 1, "MemoryTagUsage");
+	uint32_t size = p_arr[0];
+	CHECK_SIZE(p_arr, size + 1, "MemoryTagUsage");
+	entries.resize(size / 4);
+	Entry *w = entries.ptrw();
+	int idx = 1;
+	for (uint32_t i = 0; i < size / 4; i++) {
+		w[i].name = p_arr[idx];
+		w[i].live_bytes = p_arr[idx + 1];
+		w[i].live_blocks = p_arr[idx + 2];
+		w[i].allocations = p_arr[idx + 3];
+		idx += 4;
+	}
+	CHECK_END(p_arr, idx, "MemoryTagUsage");
+	return true;
+}
+
 Array DebuggerMarshalls::serialize_key_shortcut(const Ref<Shortcut> &p_shortcut) {
 	ERR_FAIL_COND_V(p_shortcut.is_null(), Array());
 	Array keys;
@@ -68,6 +68,25 @@ struct DebuggerMarshalls {
 		bool deserialize(const Array &p_arr);
 	};
 
+	// Live heap usage per allocation tag, see Memory::get_tag().
+	struct MemoryTagUsage {
+		struct Entry {
+			String name;
+			int64_t live_bytes = 0;
+			int64_t live_blocks = 0;
+			int64_t allocations = 0;
+		};
+		Vector<Entry> entries;
+
+		// Empty unless the engine was built with `memory_tags=yes`.
+		void capture();
+		// Change since p_baseline, matching tags by name. Unchanged tags are left out.
+		MemoryTagUsage diff(const MemoryTagUsage &p_baseline) const;
+
+		Array serialize();
+		bool deserialize(const Array &p_arr);
+	};
+
 	static Array serialize_key_shortcut(const Ref<Shortcut> &p_shortcut);
 	static Ref<Shortcut> deserialize_key_shortcut(const Array &p_keys);
 };
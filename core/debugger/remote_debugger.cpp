@@ -728,6 +728,13 @@ Error RemoteDebugger::_core_capture(const String &p_cmd, const Array &p_data, bo
 		script_debugger->set_ignore_error_breaks(p_data[0]);
 	} else if (p_cmd == "break") {
 		script_debugger->debug(script_debugger->get_break_language());
+	} else if (p_cmd == "memory_tags_baseline") {
+		memory_tags_baseline.capture();
+	} else if (p_cmd == "memory_tags") {
+		// Replies with the current usage per tag and its change since the last baseline.
+		DebuggerMarshalls::MemoryTagUsage usage;
+		usage.capture();
+		send_message("memory_tags", { usage.serialize(), usage.diff(memory_tags_baseline).serialize() });
 	} else {
 		r_captured = false;
 	}
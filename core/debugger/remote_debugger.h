@@ -74,6 +74,7 @@ private:
 	int last_reset = 0;
 	bool reload_all_scripts = false;
 	Array script_paths_to_reload;
+	DebuggerMarshalls::MemoryTagUsage memory_tags_baseline;
 
 	// Make handlers and send_message thread safe.
 	Mutex mutex;
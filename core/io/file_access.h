@@ -191,6 +191,8 @@ public:
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const = 0; ///< get an array of bytes, needs to be overwritten by children.
 	Vector<uint8_t> get_buffer(int64_t p_length) const;
+	virtual Span<uint8_t> map_read_only() { return Span<uint8_t>(); } ///< map the whole file into memory, valid until the file is closed; empty if the file can't be mapped.
+	virtual Span<uint8_t> get_mapped_buffer() const { return Span<uint8_t>(); } ///< whole contents of the file if they are already mapped in memory (e.g. uncompressed files in a mapped pack), empty otherwise; valid while the file is open.
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(const String &p_delim = ",") const;
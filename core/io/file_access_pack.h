@@ -154,6 +154,15 @@ public:
 };
 
 class PackedSourcePCK : public PackSource {
+	struct MappedPack {
+		Ref<FileAccess> file;
+		Span<uint8_t> data;
+	};
+
+	// Packs mapped into memory, by path. Files that are neither encrypted nor
+	// in a sparse bundle are read straight from the mapping.
+	HashMap<String, MappedPack> mapped_packs;
+
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) override;
 	virtual Ref<FileAccess> get_file(const String &p_path, PackedData::PackedFile *p_file) override;
@@ -177,6 +186,9 @@ class FileAccessPack : public FileAccess {
 	uint64_t off;
 
 	Ref<FileAccess> f;
+	// Start of the file inside a mapped pack, f is not used when set.
+	const uint8_t *mapped = nullptr;
+
 	virtual Error open_internal(const String &p_path, int p_mode_flags) override;
 	virtual uint64_t _get_modified_time(const String &p_file) override { return 0; }
 	virtual uint64_t _get_access_time(const String &p_file) override { return 0; }
@@ -203,6 +215,7 @@ public:
 	virtual bool eof_reached() const override;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const override;
+	virtual Span<uint8_t> get_mapped_buffer() const override;
 
 	virtual void set_big_endian(bool p_big_endian) override;
 
@@ -216,7 +229,7 @@ public:
 
 	virtual void close() override;
 
-	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file);
+	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_mapped_data = nullptr);
 };
 
 int64_t PackedData::get_size(const String &p_path) {
@@ -35,6 +35,14 @@
 #include "core/object/script_language.h"
 #include "core/variant/container_type_validate.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSON_SCAN_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define JSON_SCAN_NEON
+#include <arm_neon.h>
+#endif
+
 const char *JSON::tk_name[TK_MAX] = {
 	"'{'",
 	"'}'",
@@ -193,329 +201,493 @@ void JSON::_stringify(String &r_result, const Variant &p_var, const String &p_in
 	}
 }
 
-Error JSON::_get_token(const char32_t *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str) {
-	while (p_len > 0) {
-		switch (p_str[index]) {
-			case '\n': {
-				line++;
-				index++;
+// Returns the first byte in [p_from, p_end) that ends a run of plain string content:
+// a quote, a backslash, a newline (lines are counted for errors) or NUL.
+static _FORCE_INLINE_ const uint8_t *_find_string_special(const uint8_t *p_from, const uint8_t *p_end) {
+#if defined(JSON_SCAN_SSE2)
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i newline = _mm_set1_epi8('\n');
+	const __m128i zero = _mm_setzero_si128();
+	while (p_end - p_from >= 16) {
+		const __m128i chunk = _mm_loadu_si128((const __m128i *)p_from);
+		const __m128i found = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, newline), _mm_cmpeq_epi8(chunk, zero)));
+		if (_mm_movemask_epi8(found) != 0) {
+			break; // The loop below finds which byte it is.
+		}
+		p_from += 16;
+	}
+#elif defined(JSON_SCAN_NEON)
+	const uint8x16_t quote = vdupq_n_u8('"');
+	const uint8x16_t backslash = vdupq_n_u8('\\');
+	const uint8x16_t newline = vdupq_n_u8('\n');
+	while (p_end - p_from >= 16) {
+		const uint8x16_t chunk = vld1q_u8(p_from);
+		const uint8x16_t found = vorrq_u8(
+				vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)),
+				vorrq_u8(vceqq_u8(chunk, newline), vceqzq_u8(chunk)));
+		if (vmaxvq_u8(found) != 0) {
+			break;
+		}
+		p_from += 16;
+	}
+#endif
+	while (p_from < p_end) {
+		const uint8_t c = *p_from;
+		if (c == '"' || c == '\\' || c == '\n' || c == 0) {
+			break;
+		}
+		p_from++;
+	}
+	return p_from;
+}
+
+// Parses UTF-8 from memory, or from a file a chunk at a time, and reports what it finds to the handler.
+// Strings are decoded straight from the input bytes.
+template <typename THandler>
+class JSONReader {
+	static constexpr int64_t FILE_CHUNK_SIZE = 64 * 1024;
+	// Object keys repeat a lot in large documents, so short ones are decoded once and shared.
+	static constexpr uint32_t MAX_INTERNED_KEYS = 4096;
+	static constexpr uint32_t MAX_INTERNED_KEY_LENGTH = 64;
+
+	struct InternedKey {
+		uint32_t hash = 0;
+		uint32_t offset = 0;
+		uint32_t length = 0;
+		String key;
+	};
+
+	const uint8_t *data = nullptr;
+	int64_t pos = 0;
+	int64_t size = 0;
+	Ref<FileAccess> file;
+	LocalVector<uint8_t> file_buffer;
+
+	THandler *handler = nullptr;
+	int line = 0;
+	String err_str;
+
+	JSON::TokenType token = JSON::TK_EOF;
+	LocalVector<char> text; // Bytes of the last string or identifier.
+	LocalVector<char> number_text;
+	double number = 0.0;
+
+	LocalVector<InternedKey> interned_keys;
+	LocalVector<uint32_t> interned_slots; // Index in interned_keys + 1, or 0 when empty.
+	LocalVector<char> interned_bytes;
+
+	bool _fill(int64_t p_needed) {
+		if (file.is_null()) {
+			return false;
+		}
+
+		// Keep what wasn't read yet, it may be the start of a token.
+		const int64_t remaining = size - pos;
+		const int64_t capacity = MAX(FILE_CHUNK_SIZE, p_needed);
+		if ((int64_t)file_buffer.size() < capacity) {
+			file_buffer.resize(capacity);
+		}
+		if (remaining > 0 && pos > 0) {
+			memmove(file_buffer.ptr(), file_buffer.ptr() + pos, remaining);
+		}
+		pos = 0;
+		size = remaining;
+
+		while (size < p_needed) {
+			const uint64_t read = file->get_buffer(file_buffer.ptr() + size, file_buffer.size() - size);
+			if (read == 0) {
 				break;
 			}
-			case 0: {
-				r_token.type = TK_EOF;
-				return OK;
-			} break;
-			case '{': {
-				r_token.type = TK_CURLY_BRACKET_OPEN;
-				index++;
-				return OK;
-			}
-			case '}': {
-				r_token.type = TK_CURLY_BRACKET_CLOSE;
-				index++;
-				return OK;
+			size += read;
+		}
+		data = file_buffer.ptr();
+		return size >= p_needed;
+	}
+
+	// Returns 0 past the end, the same as the terminator of a string.
+	_FORCE_INLINE_ uint8_t _peek(int64_t p_offset = 0) {
+		if (likely(pos + p_offset < size) || _fill(p_offset + 1)) {
+			return data[pos + p_offset];
+		}
+		return 0;
+	}
+
+	Error _stopped() {
+		err_str = "Parsing stopped by the handler";
+		return ERR_SKIP;
+	}
+
+	_FORCE_INLINE_ bool _text_is(const char *p_word) const {
+		const uint32_t length = strlen(p_word);
+		return text.size() == length && memcmp(text.ptr(), p_word, length) == 0;
+	}
+
+	String _make_string() const {
+		if (text.is_empty()) {
+			return String();
+		}
+		return String::utf8(text.ptr(), text.size());
+	}
+
+	void _insert_interned(uint32_t p_index) {
+		const uint32_t mask = interned_slots.size() - 1;
+		uint32_t slot = interned_keys[p_index].hash & mask;
+		while (interned_slots[slot] != 0) {
+			slot = (slot + 1) & mask;
+		}
+		interned_slots[slot] = p_index + 1;
+	}
+
+	String _make_key() {
+		const uint32_t length = text.size();
+		if (length > MAX_INTERNED_KEY_LENGTH) {
+			return _make_string();
+		}
+
+		const uint32_t hash = hash_murmur3_buffer(text.ptr(), length);
+		if (!interned_slots.is_empty()) {
+			const uint32_t mask = interned_slots.size() - 1;
+			for (uint32_t slot = hash & mask; interned_slots[slot] != 0; slot = (slot + 1) & mask) {
+				const InternedKey &interned = interned_keys[interned_slots[slot] - 1];
+				if (interned.hash == hash && interned.length == length && memcmp(interned_bytes.ptr() + interned.offset, text.ptr(), length) == 0) {
+					return interned.key;
+				}
 			}
-			case '[': {
-				r_token.type = TK_BRACKET_OPEN;
-				index++;
-				return OK;
+		}
+
+		String key = _make_string();
+		if (interned_keys.size() < MAX_INTERNED_KEYS) {
+			InternedKey interned;
+			interned.hash = hash;
+			interned.offset = interned_bytes.size();
+			interned.length = length;
+			interned.key = key;
+			interned_bytes.resize(interned.offset + length);
+			memcpy(interned_bytes.ptr() + interned.offset, text.ptr(), length);
+			interned_keys.push_back(interned);
+
+			// Keep the table at most half full.
+			if (interned_keys.size() * 2 > interned_slots.size()) {
+				const uint32_t slot_count = interned_slots.is_empty() ? 64 : interned_slots.size() * 2;
+				interned_slots.clear();
+				interned_slots.resize_initialized(slot_count);
+				for (uint32_t i = 0; i < interned_keys.size(); i++) {
+					_insert_interned(i);
+				}
+			} else {
+				_insert_interned(interned_keys.size() - 1);
 			}
-			case ']': {
-				r_token.type = TK_BRACKET_CLOSE;
-				index++;
-				return OK;
+		}
+		return key;
+	}
+
+	void _append_utf8(char32_t p_char) {
+		if (p_char == 0) {
+			p_char = 0xfffd; // NUL is not supported in strings.
+		}
+		if (p_char < 0x80) {
+			text.push_back(p_char);
+		} else if (p_char < 0x800) {
+			text.push_back(0xc0 | (p_char >> 6));
+			text.push_back(0x80 | (p_char & 0x3f));
+		} else if (p_char < 0x10000) {
+			text.push_back(0xe0 | (p_char >> 12));
+			text.push_back(0x80 | ((p_char >> 6) & 0x3f));
+			text.push_back(0x80 | (p_char & 0x3f));
+		} else {
+			text.push_back(0xf0 | (p_char >> 18));
+			text.push_back(0x80 | ((p_char >> 12) & 0x3f));
+			text.push_back(0x80 | ((p_char >> 6) & 0x3f));
+			text.push_back(0x80 | (p_char & 0x3f));
+		}
+	}
+
+	Error _read_hex(int64_t p_offset, char32_t &r_value) {
+		r_value = 0;
+		for (int j = 0; j < 4; j++) {
+			const uint8_t c = _peek(p_offset + j);
+			if (c == 0) {
+				err_str = "Unterminated string";
+				return ERR_PARSE_ERROR;
 			}
-			case ':': {
-				r_token.type = TK_COLON;
-				index++;
-				return OK;
+			if (!is_hex_digit(c)) {
+				err_str = "Malformed hex constant in string";
+				return ERR_PARSE_ERROR;
 			}
-			case ',': {
-				r_token.type = TK_COMMA;
-				index++;
-				return OK;
+			char32_t v;
+			if (is_digit(c)) {
+				v = c - '0';
+			} else if (c >= 'a' && c <= 'f') {
+				v = c - 'a' + 10;
+			} else {
+				v = c - 'A' + 10;
 			}
-			case '"': {
-				index++;
-				String str;
-				while (true) {
-					if (p_str[index] == 0) {
-						r_err_str = "Unterminated string";
-						return ERR_PARSE_ERROR;
-					} else if (p_str[index] == '"') {
-						index++;
-						break;
-					} else if (p_str[index] == '\\') {
-						//escaped characters...
-						index++;
-						char32_t next = p_str[index];
-						if (next == 0) {
-							r_err_str = "Unterminated string";
-							return ERR_PARSE_ERROR;
-						}
-						char32_t res = 0;
-
-						switch (next) {
-							case 'b':
-								res = 8;
-								break;
-							case 't':
-								res = 9;
-								break;
-							case 'n':
-								res = 10;
-								break;
-							case 'f':
-								res = 12;
-								break;
-							case 'r':
-								res = 13;
-								break;
-							case 'u': {
-								// hex number
-								for (int j = 0; j < 4; j++) {
-									char32_t c = p_str[index + j + 1];
-									if (c == 0) {
-										r_err_str = "Unterminated string";
-										return ERR_PARSE_ERROR;
-									}
-									if (!is_hex_digit(c)) {
-										r_err_str = "Malformed hex constant in string";
-										return ERR_PARSE_ERROR;
-									}
-									char32_t v;
-									if (is_digit(c)) {
-										v = c - '0';
-									} else if (c >= 'a' && c <= 'f') {
-										v = c - 'a';
-										v += 10;
-									} else if (c >= 'A' && c <= 'F') {
-										v = c - 'A';
-										v += 10;
-									} else {
-										ERR_PRINT("Bug parsing hex constant.");
-										v = 0;
-									}
-
-									res <<= 4;
-									res |= v;
-								}
-								index += 4; //will add at the end anyway
-
-								if ((res & 0xfffffc00) == 0xd800) {
-									if (p_str[index + 1] != '\\' || p_str[index + 2] != 'u') {
-										r_err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
-										return ERR_PARSE_ERROR;
-									}
-									index += 2;
-									char32_t trail = 0;
-									for (int j = 0; j < 4; j++) {
-										char32_t c = p_str[index + j + 1];
-										if (c == 0) {
-											r_err_str = "Unterminated string";
-											return ERR_PARSE_ERROR;
-										}
-										if (!is_hex_digit(c)) {
-											r_err_str = "Malformed hex constant in string";
-											return ERR_PARSE_ERROR;
-										}
-										char32_t v;
-										if (is_digit(c)) {
-											v = c - '0';
-										} else if (c >= 'a' && c <= 'f') {
-											v = c - 'a';
-											v += 10;
-										} else if (c >= 'A' && c <= 'F') {
-											v = c - 'A';
-											v += 10;
-										} else {
-											ERR_PRINT("Bug parsing hex constant.");
-											v = 0;
-										}
-
-										trail <<= 4;
-										trail |= v;
-									}
-									if ((trail & 0xfffffc00) == 0xdc00) {
-										res = (res << 10UL) + trail - ((0xd800 << 10UL) + 0xdc00 - 0x10000);
-										index += 4; //will add at the end anyway
-									} else {
-										r_err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
-										return ERR_PARSE_ERROR;
-									}
-								} else if ((res & 0xfffffc00) == 0xdc00) {
-									r_err_str = "Invalid UTF-16 sequence in string, unpaired trail surrogate";
-									return ERR_PARSE_ERROR;
-								}
-
-							} break;
-							case '"':
-							case '\\':
-							case '/': {
-								res = next;
-							} break;
-							default: {
-								r_err_str = "Invalid escape sequence";
-								return ERR_PARSE_ERROR;
-							}
-						}
+			r_value = (r_value << 4) | v;
+		}
+		return OK;
+	}
 
-						str += res;
+	Error _read_string() {
+		text.clear();
+		while (true) {
+			if (pos == size && !_fill(1)) {
+				err_str = "Unterminated string";
+				return ERR_PARSE_ERROR;
+			}
 
-					} else {
-						if (p_str[index] == '\n') {
-							line++;
-						}
-						str += p_str[index];
-					}
-					index++;
-				}
+			const uint8_t *from = data + pos;
+			const uint8_t *special = _find_string_special(from, data + size);
+			if (special != from) {
+				const uint32_t run = special - from;
+				const uint32_t offset = text.size();
+				text.resize(offset + run);
+				memcpy(text.ptr() + offset, from, run);
+				pos += run;
+			}
+			if (pos == size) {
+				continue;
+			}
 
-				r_token.type = TK_STRING;
-				r_token.value = str;
+			const uint8_t c = data[pos];
+			if (c == '"') {
+				pos++;
 				return OK;
+			}
+			if (c == 0) {
+				err_str = "Unterminated string";
+				return ERR_PARSE_ERROR;
+			}
+			if (c == '\n') {
+				line++;
+				text.push_back('\n');
+				pos++;
+				continue;
+			}
 
-			} break;
-			default: {
-				if (p_str[index] <= 32) {
-					index++;
-					break;
-				}
-
-				if (p_str[index] == '-' || is_digit(p_str[index])) {
-					//a number
-					const char32_t *rptr;
-					double number = String::to_float(&p_str[index], &rptr);
-					index += (rptr - &p_str[index]);
-					r_token.type = TK_NUMBER;
-					r_token.value = number;
-					return OK;
-
-				} else if (is_ascii_alphabet_char(p_str[index])) {
-					String id;
+			// Escaped characters.
+			pos++;
+			const uint8_t next = _peek();
+			if (next == 0) {
+				err_str = "Unterminated string";
+				return ERR_PARSE_ERROR;
+			}
+			char32_t res = 0;
 
-					while (is_ascii_alphabet_char(p_str[index])) {
-						id += p_str[index];
-						index++;
+			switch (next) {
+				case 'b':
+					res = 8;
+					break;
+				case 't':
+					res = 9;
+					break;
+				case 'n':
+					res = 10;
+					break;
+				case 'f':
+					res = 12;
+					break;
+				case 'r':
+					res = 13;
+					break;
+				case 'u': {
+					Error err = _read_hex(1, res);
+					if (err != OK) {
+						return err;
 					}
+					pos += 4;
 
-					r_token.type = TK_IDENTIFIER;
-					r_token.value = id;
-					return OK;
-				} else {
-					r_err_str = "Unexpected character";
+					if ((res & 0xfffffc00) == 0xd800) {
+						if (_peek(1) != '\\' || _peek(2) != 'u') {
+							err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
+							return ERR_PARSE_ERROR;
+						}
+						pos += 2;
+						char32_t trail = 0;
+						err = _read_hex(1, trail);
+						if (err != OK) {
+							return err;
+						}
+						if ((trail & 0xfffffc00) == 0xdc00) {
+							res = (res << 10UL) + trail - ((0xd800 << 10UL) + 0xdc00 - 0x10000);
+							pos += 4;
+						} else {
+							err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
+							return ERR_PARSE_ERROR;
+						}
+					} else if ((res & 0xfffffc00) == 0xdc00) {
+						err_str = "Invalid UTF-16 sequence in string, unpaired trail surrogate";
+						return ERR_PARSE_ERROR;
+					}
+				} break;
+				case '"':
+				case '\\':
+				case '/': {
+					res = next;
+				} break;
+				default: {
+					err_str = "Invalid escape sequence";
 					return ERR_PARSE_ERROR;
 				}
 			}
-		}
-	}
-
-	r_err_str = "Unknown error getting token";
-	return ERR_PARSE_ERROR;
-}
 
-Error JSON::_parse_value(Variant &value, Token &token, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str) {
-	if (p_depth > Variant::MAX_RECURSION_DEPTH) {
-		r_err_str = "JSON structure is too deep";
-		return ERR_OUT_OF_MEMORY;
+			_append_utf8(res);
+			pos++;
+		}
 	}
 
-	if (token.type == TK_CURLY_BRACKET_OPEN) {
-		Dictionary d;
-		Error err = _parse_object(d, p_str, index, p_len, line, p_depth + 1, r_err_str);
-		if (err) {
-			return err;
-		}
-		value = d;
-	} else if (token.type == TK_BRACKET_OPEN) {
-		Array a;
-		Error err = _parse_array(a, p_str, index, p_len, line, p_depth + 1, r_err_str);
-		if (err) {
-			return err;
-		}
-		value = a;
-	} else if (token.type == TK_IDENTIFIER) {
-		String id = token.value;
-		if (id == "true") {
-			value = true;
-		} else if (id == "false") {
-			value = false;
-		} else if (id == "null") {
-			value = Variant();
-		} else {
-			r_err_str = vformat("Expected 'true', 'false', or 'null', got '%s'", id);
-			return ERR_PARSE_ERROR;
+	void _read_number() {
+		// Only consume what the number parser used, the rest is read as the next token.
+		number_text.clear();
+		for (int64_t i = 0;; i++) {
+			const uint8_t c = _peek(i);
+			if (!is_digit(c) && c != '-' && c != '+' && c != '.' && c != 'e' && c != 'E') {
+				break;
+			}
+			number_text.push_back(c);
 		}
-	} else if (token.type == TK_NUMBER) {
-		value = token.value;
-	} else if (token.type == TK_STRING) {
-		value = token.value;
-	} else {
-		r_err_str = vformat("Expected value, got '%s'", String(tk_name[token.type]));
-		return ERR_PARSE_ERROR;
-	}
+		number_text.push_back(0);
 
-	return OK;
-}
+		const char *end = nullptr;
+		number = String::to_float(number_text.ptr(), &end);
+		pos += end - number_text.ptr();
+	}
 
-Error JSON::_parse_array(Array &array, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str) {
-	Token token;
-	bool need_comma = false;
+	Error _next_token() {
+		while (true) {
+			const uint8_t c = _peek();
+			switch (c) {
+				case '\n': {
+					line++;
+					pos++;
+				} break;
+				case 0: {
+					token = JSON::TK_EOF;
+					return OK;
+				}
+				case '{': {
+					token = JSON::TK_CURLY_BRACKET_OPEN;
+					pos++;
+					return OK;
+				}
+				case '}': {
+					token = JSON::TK_CURLY_BRACKET_CLOSE;
+					pos++;
+					return OK;
+				}
+				case '[': {
+					token = JSON::TK_BRACKET_OPEN;
+					pos++;
+					return OK;
+				}
+				case ']': {
+					token = JSON::TK_BRACKET_CLOSE;
+					pos++;
+					return OK;
+				}
+				case ':': {
+					token = JSON::TK_COLON;
+					pos++;
+					return OK;
+				}
+				case ',': {
+					token = JSON::TK_COMMA;
+					pos++;
+					return OK;
+				}
+				case '"': {
+					pos++;
+					token = JSON::TK_STRING;
+					return _read_string();
+				}
+				default: {
+					if (c <= 32) {
+						pos++;
+						break;
+					}
 
-	while (index < p_len) {
-		Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
-		if (err != OK) {
-			return err;
+					if (c == '-' || is_digit(c)) {
+						_read_number();
+						token = JSON::TK_NUMBER;
+						return OK;
+					} else if (is_ascii_alphabet_char(c)) {
+						text.clear();
+						while (is_ascii_alphabet_char(_peek())) {
+							text.push_back(_peek());
+							pos++;
+						}
+						token = JSON::TK_IDENTIFIER;
+						return OK;
+					} else {
+						err_str = "Unexpected character";
+						return ERR_PARSE_ERROR;
+					}
+				}
+			}
 		}
+	}
 
-		if (token.type == TK_BRACKET_CLOSE) {
-			return OK;
+	Error _parse_value(int p_depth) {
+		if (p_depth > Variant::MAX_RECURSION_DEPTH) {
+			err_str = "JSON structure is too deep";
+			return ERR_OUT_OF_MEMORY;
 		}
 
-		if (need_comma) {
-			if (token.type != TK_COMMA) {
-				r_err_str = "Expected ','";
+		bool keep_going = true;
+		switch (token) {
+			case JSON::TK_CURLY_BRACKET_OPEN: {
+				return _parse_object(p_depth + 1);
+			}
+			case JSON::TK_BRACKET_OPEN: {
+				return _parse_array(p_depth + 1);
+			}
+			case JSON::TK_IDENTIFIER: {
+				if (_text_is("true")) {
+					keep_going = handler->value(true);
+				} else if (_text_is("false")) {
+					keep_going = handler->value(false);
+				} else if (_text_is("null")) {
+					keep_going = handler->value(Variant());
+				} else {
+					err_str = vformat("Expected 'true', 'false', or 'null', got '%s'", _make_string());
+					return ERR_PARSE_ERROR;
+				}
+			} break;
+			case JSON::TK_NUMBER: {
+				keep_going = handler->value(number);
+			} break;
+			case JSON::TK_STRING: {
+				keep_going = handler->value(_make_string());
+			} break;
+			default: {
+				err_str = vformat("Expected value, got '%s'", String(JSON::tk_name[token]));
 				return ERR_PARSE_ERROR;
-			} else {
-				need_comma = false;
-				continue;
 			}
 		}
-
-		Variant v;
-		err = _parse_value(v, token, p_str, index, p_len, line, p_depth, r_err_str);
-		if (err) {
-			return err;
-		}
-
-		array.push_back(v);
-		need_comma = true;
+		return keep_going ? OK : _stopped();
 	}
 
-	r_err_str = "Expected ']'";
-	return ERR_PARSE_ERROR;
-}
-
-Error JSON::_parse_object(Dictionary &object, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str) {
-	bool at_key = true;
-	String key;
-	Token token;
-	bool need_comma = false;
+	Error _parse_array(int p_depth) {
+		if (!handler->begin_array()) {
+			return _stopped();
+		}
+		bool need_comma = false;
 
-	while (index < p_len) {
-		if (at_key) {
-			Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
+		while (_peek() != 0) {
+			Error err = _next_token();
 			if (err != OK) {
 				return err;
 			}
 
-			if (token.type == TK_CURLY_BRACKET_CLOSE) {
-				return OK;
+			if (token == JSON::TK_BRACKET_CLOSE) {
+				return handler->end_array() ? OK : _stopped();
 			}
 
 			if (need_comma) {
-				if (token.type != TK_COMMA) {
-					r_err_str = "Expected '}' or ','";
+				if (token != JSON::TK_COMMA) {
+					err_str = "Expected ','";
 					return ERR_PARSE_ERROR;
 				} else {
 					need_comma = false;
@@ -523,80 +695,203 @@ Error JSON::_parse_object(Dictionary &object, const char32_t *p_str, int &index,
 				}
 			}
 
-			if (token.type != TK_STRING) {
-				r_err_str = "Expected key";
-				return ERR_PARSE_ERROR;
-			}
-
-			key = token.value;
-			err = _get_token(p_str, index, p_len, token, line, r_err_str);
+			err = _parse_value(p_depth);
 			if (err != OK) {
 				return err;
 			}
-			if (token.type != TK_COLON) {
-				r_err_str = "Expected ':'";
-				return ERR_PARSE_ERROR;
-			}
-			at_key = false;
-		} else {
-			Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
+			need_comma = true;
+		}
+
+		err_str = "Expected ']'";
+		return ERR_PARSE_ERROR;
+	}
+
+	Error _parse_object(int p_depth) {
+		if (!handler->begin_object()) {
+			return _stopped();
+		}
+		bool at_key = true;
+		bool need_comma = false;
+
+		while (_peek() != 0) {
+			Error err = _next_token();
 			if (err != OK) {
 				return err;
 			}
 
-			Variant v;
-			err = _parse_value(v, token, p_str, index, p_len, line, p_depth, r_err_str);
-			if (err) {
-				return err;
+			if (at_key) {
+				if (token == JSON::TK_CURLY_BRACKET_CLOSE) {
+					return handler->end_object() ? OK : _stopped();
+				}
+
+				if (need_comma) {
+					if (token != JSON::TK_COMMA) {
+						err_str = "Expected '}' or ','";
+						return ERR_PARSE_ERROR;
+					} else {
+						need_comma = false;
+						continue;
+					}
+				}
+
+				if (token != JSON::TK_STRING) {
+					err_str = "Expected key";
+					return ERR_PARSE_ERROR;
+				}
+				if (!handler->object_key(_make_key())) {
+					return _stopped();
+				}
+
+				err = _next_token();
+				if (err != OK) {
+					return err;
+				}
+				if (token != JSON::TK_COLON) {
+					err_str = "Expected ':'";
+					return ERR_PARSE_ERROR;
+				}
+				at_key = false;
+			} else {
+				err = _parse_value(p_depth);
+				if (err != OK) {
+					return err;
+				}
+				need_comma = true;
+				at_key = true;
 			}
-			object[key] = v;
-			need_comma = true;
-			at_key = true;
 		}
+
+		err_str = "Expected '}'";
+		return ERR_PARSE_ERROR;
 	}
 
-	r_err_str = "Expected '}'";
-	return ERR_PARSE_ERROR;
-}
+public:
+	Error parse(String &r_err_str, int &r_err_line) {
+		line = 0;
+		Error err = OK;
 
-void JSON::set_data(const Variant &p_data) {
-	data = p_data;
-	text.clear();
-}
+		if (_peek() == 0xef && _peek(1) == 0xbb && _peek(2) == 0xbf) {
+			pos += 3; // Byte order mark.
+		}
 
-Error JSON::_parse_string(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line) {
-	const char32_t *str = p_json.ptr();
-	int idx = 0;
-	int len = p_json.length();
-	Token token;
-	r_err_line = 0;
-	String aux_key;
+		if (pos == size && !_fill(1)) {
+			err_str = "Unknown error getting token";
+			err = ERR_PARSE_ERROR;
+		} else {
+			err = _next_token();
+			if (err == OK) {
+				err = _parse_value(0);
+			}
+		}
+
+		// Check if EOF is reached or it's a type of the next token.
+		if (err == OK && _peek() != 0) {
+			err = _next_token();
+			if (err != OK || token != JSON::TK_EOF) {
+				err_str = "Expected 'EOF'";
+				err = ERR_PARSE_ERROR;
+			}
+		}
 
-	Error err = _get_token(str, idx, len, token, r_err_line, r_err_str);
-	if (err) {
+		r_err_str = err_str;
+		r_err_line = line;
 		return err;
 	}
 
-	err = _parse_value(r_ret, token, str, idx, len, r_err_line, 0, r_err_str);
+	JSONReader(const Span<uint8_t> &p_json, THandler *p_handler) {
+		data = p_json.ptr();
+		size = p_json.size();
+		handler = p_handler;
+	}
 
-	// Check if EOF is reached
-	// or it's a type of the next token.
-	if (err == OK && idx < len) {
-		err = _get_token(str, idx, len, token, r_err_line, r_err_str);
+	JSONReader(const Ref<FileAccess> &p_file, THandler *p_handler) {
+		file = p_file;
+		handler = p_handler;
+	}
+};
 
-		if (err || token.type != TK_EOF) {
-			r_err_str = "Expected 'EOF'";
-			// Reset return value to empty `Variant`
-			r_ret = Variant();
-			return ERR_PARSE_ERROR;
+// Builds the document for JSON::parse() from the same callbacks a StreamHandler gets.
+class JSONDocumentBuilder final : public JSON::StreamHandler {
+	enum ContainerType : uint8_t {
+		CONTAINER_OBJECT,
+		CONTAINER_ARRAY,
+	};
+
+	LocalVector<ContainerType> containers;
+	LocalVector<Dictionary> objects;
+	LocalVector<String> keys;
+	LocalVector<Array> arrays;
+
+	void _add(const Variant &p_value) {
+		if (containers.is_empty()) {
+			result = p_value;
+		} else if (containers[containers.size() - 1] == CONTAINER_OBJECT) {
+			objects[objects.size() - 1][keys[keys.size() - 1]] = p_value;
+		} else {
+			arrays[arrays.size() - 1].push_back(p_value);
 		}
 	}
 
+public:
+	Variant result;
+
+	bool begin_object() override {
+		containers.push_back(CONTAINER_OBJECT);
+		objects.push_back(Dictionary());
+		keys.push_back(String());
+		return true;
+	}
+
+	bool object_key(const String &p_key) override {
+		keys[keys.size() - 1] = p_key;
+		return true;
+	}
+
+	bool end_object() override {
+		const Dictionary object = objects[objects.size() - 1];
+		containers.resize(containers.size() - 1);
+		objects.resize(objects.size() - 1);
+		keys.resize(keys.size() - 1);
+		_add(object);
+		return true;
+	}
+
+	bool begin_array() override {
+		containers.push_back(CONTAINER_ARRAY);
+		arrays.push_back(Array());
+		return true;
+	}
+
+	bool end_array() override {
+		const Array array = arrays[arrays.size() - 1];
+		containers.resize(containers.size() - 1);
+		arrays.resize(arrays.size() - 1);
+		_add(array);
+		return true;
+	}
+
+	bool value(const Variant &p_value) override {
+		_add(p_value);
+		return true;
+	}
+};
+
+void JSON::set_data(const Variant &p_data) {
+	data = p_data;
+	text.clear();
+}
+
+Error JSON::_parse_utf8(const Span<uint8_t> &p_json, Variant &r_ret, String &r_err_str, int &r_err_line) {
+	JSONDocumentBuilder builder;
+	JSONReader<JSONDocumentBuilder> reader(p_json, &builder);
+	Error err = reader.parse(r_err_str, r_err_line);
+	r_ret = err == OK ? builder.result : Variant();
 	return err;
 }
 
 Error JSON::parse(const String &p_json_string, bool p_keep_text) {
-	Error err = _parse_string(p_json_string, data, err_str, err_line);
+	const CharString utf8 = p_json_string.utf8();
+	Error err = _parse_utf8(Span((const uint8_t *)utf8.ptr(), utf8.length()), data, err_str, err_line);
 	if (err == Error::OK) {
 		err_line = 0;
 	}
@@ -606,6 +901,37 @@ Error JSON::parse(const String &p_json_string, bool p_keep_text) {
 	return err;
 }
 
+Error JSON::parse_utf8(const Span<uint8_t> &p_json) {
+	Error err = _parse_utf8(p_json, data, err_str, err_line);
+	if (err == Error::OK) {
+		err_line = 0;
+	}
+	text.clear();
+	return err;
+}
+
+Error JSON::parse_file(const Ref<FileAccess> &p_file) {
+	ERR_FAIL_COND_V(p_file.is_null(), ERR_INVALID_PARAMETER);
+
+	JSONDocumentBuilder builder;
+	JSONReader<JSONDocumentBuilder> reader(p_file, &builder);
+	Error err = reader.parse(err_str, err_line);
+	data = err == OK ? builder.result : Variant();
+	if (err == Error::OK) {
+		err_line = 0;
+	}
+	text.clear();
+	return err;
+}
+
+Error JSON::parse_stream(const Ref<FileAccess> &p_file, StreamHandler *p_handler, String &r_err_str, int &r_err_line) {
+	ERR_FAIL_COND_V(p_file.is_null(), ERR_INVALID_PARAMETER);
+	ERR_FAIL_NULL_V(p_handler, ERR_INVALID_PARAMETER);
+
+	JSONReader<StreamHandler> reader(p_file, p_handler);
+	return reader.parse(r_err_str, r_err_line);
+}
+
 String JSON::get_parsed_text() const {
 	return text;
 }
@@ -1563,7 +1889,15 @@ Ref<Resource> ResourceFormatLoaderJSON::load(const String &p_path, const String
 	Ref<JSON> json;
 	json.instantiate();
 
-	Error err = json->parse(FileAccess::get_file_as_string(p_path), Engine::get_singleton()->is_editor_hint());
+	Error err;
+	if (Engine::get_singleton()->is_editor_hint()) {
+		// The editor keeps the text, so it can be edited even if it doesn't parse.
+		err = json->parse(FileAccess::get_file_as_string(p_path), true);
+	} else {
+		Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ);
+		ERR_FAIL_COND_V_MSG(file.is_null(), Ref<Resource>(), "Cannot open JSON file '" + p_path + "'.");
+		err = json->parse_file(file);
+	}
 	if (err != OK) {
 		String err_text = "Error parsing JSON file at '" + p_path + "', on line " + itos(json->get_error_line()) + ": " + json->get_error_message();
 
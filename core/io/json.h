@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include "core/io/file_access.h"
 #include "core/io/resource.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
@@ -52,18 +53,6 @@ class JSON : public Resource {
 		TK_MAX
 	};
 
-	enum Expecting {
-		EXPECT_OBJECT,
-		EXPECT_OBJECT_KEY,
-		EXPECT_COLON,
-		EXPECT_OBJECT_VALUE,
-	};
-
-	struct Token {
-		TokenType type;
-		Variant value;
-	};
-
 	String text;
 	Variant data;
 	String err_str;
@@ -71,13 +60,12 @@ class JSON : public Resource {
 
 	static const char *tk_name[];
 
+	template <typename>
+	friend class JSONReader;
+
 	static void _add_indent(String &r_result, const String &p_indent, int p_size);
 	static void _stringify(String &r_result, const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys, HashSet<const void *> &p_markers, bool p_full_precision);
-	static Error _get_token(const char32_t *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str);
-	static Error _parse_value(Variant &value, Token &token, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str);
-	static Error _parse_array(Array &array, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str);
-	static Error _parse_object(Dictionary &object, const char32_t *p_str, int &index, int p_len, int &line, int p_depth, String &r_err_str);
-	static Error _parse_string(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line);
+	static Error _parse_utf8(const Span<uint8_t> &p_json, Variant &r_ret, String &r_err_str, int &r_err_line);
 
 	static Variant _from_native(const Variant &p_variant, bool p_full_objects, int p_depth);
 	static Variant _to_native(const Variant &p_json, bool p_allow_objects, int p_depth);
@@ -86,7 +74,27 @@ protected:
 	static void _bind_methods();
 
 public:
+	// Receives the contents of a document from parse_stream() as they are read, so large documents
+	// don't have to be kept in memory. Returning false from any callback stops parsing with ERR_SKIP.
+	class StreamHandler {
+	public:
+		virtual bool begin_object() { return true; }
+		virtual bool object_key(const String &p_key) { return true; }
+		virtual bool end_object() { return true; }
+		virtual bool begin_array() { return true; }
+		virtual bool end_array() { return true; }
+		// Strings, numbers, booleans and null.
+		virtual bool value(const Variant &p_value) { return true; }
+
+		virtual ~StreamHandler() {}
+	};
+
 	Error parse(const String &p_json_string, bool p_keep_text = false);
+	// Same as parse(), but reads UTF-8 directly instead of a String.
+	Error parse_utf8(const Span<uint8_t> &p_json);
+	// Reads the file a chunk at a time, so only the parsed data is kept in memory.
+	Error parse_file(const Ref<FileAccess> &p_file);
+	static Error parse_stream(const Ref<FileAccess> &p_file, StreamHandler *p_handler, String &r_err_str, int &r_err_line);
 	String get_parsed_text() const;
 
 	static String stringify(const Variant &p_var, const String &p_indent = "", bool p_sort_keys = true, bool p_full_precision = false);
@@ -923,12 +923,21 @@ static String get_ustring(Ref<FileAccess> f) {
 
 String ResourceLoaderBinary::get_unicode_string() {
 	int len = f->get_32();
-	if (len > str_buf.size()) {
-		str_buf.resize(len);
-	}
 	if (len == 0) {
 		return String();
 	}
+	const Span<uint8_t> mapped = f->get_mapped_buffer();
+	if (!mapped.is_empty()) {
+		// The file is in memory (e.g. in a mapped pack), decode in place.
+		const uint64_t pos = f->get_position();
+		if (len > 0 && pos + len <= mapped.size()) {
+			f->seek(pos + len);
+			return String::utf8((const char *)mapped.ptr() + pos, len);
+		}
+	}
+	if (len > str_buf.size()) {
+		str_buf.resize(len);
+	}
 	f->get_buffer((uint8_t *)&str_buf[0], len);
 	return String::utf8(&str_buf[0], len);
 }
@@ -1422,7 +1422,7 @@ bool Expression::_execute(const Array &p_inputs, Object *p_instance, Expression:
 
 		} break;
 		case Expression::ENode::TYPE_CALL: {
-			const Expression::CallNode *call = static_cast<const Expression::CallNode *>(p_node);
+			Expression::CallNode *call = static_cast<Expression::CallNode *>(p_node);
 
 			Variant base;
 			bool ret = _execute(p_inputs, p_instance, call->base, base, p_const_calls_only, r_error_str);
@@ -1449,9 +1449,9 @@ bool Expression::_execute(const Array &p_inputs, Object *p_instance, Expression:
 
 			Callable::CallError ce;
 			if (p_const_calls_only) {
-				base.call_const(call->method, (const Variant **)argp.ptr(), argp.size(), r_ret, ce);
+				base.call_const(call->method, (const Variant **)argp.ptr(), argp.size(), r_ret, ce, call->method_cache);
 			} else {
-				base.callp(call->method, (const Variant **)argp.ptr(), argp.size(), r_ret, ce);
+				base.callp(call->method, (const Variant **)argp.ptr(), argp.size(), r_ret, ce, call->method_cache);
 			}
 
 			if (ce.error != Callable::CallError::CALL_OK) {
@@ -202,6 +202,7 @@ private:
 		ENode *base = nullptr;
 		StringName method;
 		Vector<ENode *> arguments;
+		Variant::BuiltInMethodCache method_cache;
 
 		CallNode() {
 			type = TYPE_CALL;
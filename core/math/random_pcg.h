@@ -68,6 +68,8 @@ public:
 
 	_FORCE_INLINE_ void set_state(uint64_t p_state) { pcg.state = p_state; }
 	_FORCE_INLINE_ uint64_t get_state() const { return pcg.state; }
+	// Jumps ahead by `p_delta` calls to rand() in O(log n), so slices of one stream can be evaluated out of order.
+	_FORCE_INLINE_ void advance(uint64_t p_delta) { pcg32_advance_r(&pcg, p_delta); }
 
 	void randomize();
 	_FORCE_INLINE_ uint32_t rand() {
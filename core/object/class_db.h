@@ -168,6 +168,8 @@ public:
 		Object *(*creation_func)(bool) = nullptr;
 	};
 
+	typedef Object *(*CreationFunc)(bool);
+
 	template <typename T>
 	static Object *creator(bool p_notify_postinitialize) {
 		Object *ret = new ("") T;
@@ -350,6 +352,9 @@ public:
 	static Object *instantiate(const StringName &p_class);
 	static Object *instantiate_no_placeholders(const StringName &p_class);
 	static Object *instantiate_without_postinitialization(const StringName &p_class);
+	// Constructor instantiate() ends up calling for a built-in class, for callers that create the same class
+	// many times. Null when the class needs the full lookup (extension, runtime, editor-only or disabled classes).
+	static CreationFunc get_creation_func(const StringName &p_class);
 	static void set_object_extension_instance(Object *p_object, const StringName &p_class, GDExtensionClassInstancePtr p_instance);
 
 	static APIType get_api_type(const StringName &p_class);
@@ -482,6 +487,7 @@ public:
 	static int get_property_index(const StringName &p_class, const StringName &p_property, bool *r_is_valid = nullptr);
 	static Variant::Type get_property_type(const StringName &p_class, const StringName &p_property, bool *r_is_valid = nullptr);
 	static StringName get_property_setter(const StringName &p_class, const StringName &p_property);
+	static MethodBind *get_property_setter_method(const StringName &p_class, const StringName &p_property, int *r_index = nullptr);
 	static StringName get_property_getter(const StringName &p_class, const StringName &p_property);
 
 	static bool has_method(const StringName &p_class, const StringName &p_method, bool p_no_inheritance = false);
@@ -33,6 +33,7 @@
 #include "core/config/project_settings.h"
 #include "core/object/class_db.h"
 #include "core/object/script_language.h"
+#include "core/os/thread.h"
 
 #include <cstdio>
 
@@ -67,6 +68,96 @@ void CallQueue::_add_page() {
 	pages_used++;
 }
 
+CallQueue::ProducerChunk *CallQueue::_alloc_producer_chunk() {
+	ProducerChunk *chunk = memnew(ProducerChunk);
+	chunk->page = allocator->alloc();
+	producer_pages.fetch_add(1, std::memory_order_relaxed);
+	return chunk;
+}
+
+void CallQueue::_free_producer_chunk(ProducerChunk *p_chunk) {
+	allocator->free(p_chunk->page);
+	memdelete(p_chunk);
+	producer_pages.fetch_sub(1, std::memory_order_relaxed);
+}
+
+CallQueue::Producer *CallQueue::_acquire_producer() {
+	const uint64_t id = Thread::get_caller_id();
+	for (ProducerCacheEntry &entry : producer_cache) {
+		if (entry.queue_serial == serial) {
+			uint64_t expected = id;
+			if (likely(entry.producer->state.compare_exchange_strong(expected, id | PRODUCER_BUSY, std::memory_order_acquire))) {
+				return entry.producer;
+			}
+			// It was retired, and maybe handed to another thread since.
+			entry.queue_serial = 0;
+			break;
+		}
+	}
+
+	MutexLock lock(mutex);
+	Producer *producer = nullptr;
+	for (Producer *p = producers.load(std::memory_order_relaxed); p; p = p->next) {
+		if (p->state.load(std::memory_order_relaxed) == 0) {
+			producer = p;
+			break;
+		}
+	}
+	if (!producer) {
+		producer = memnew(Producer);
+		producer->write_chunk = _alloc_producer_chunk();
+		producer->read_chunk = producer->write_chunk;
+		producer->next = producers.load(std::memory_order_relaxed);
+		producers.store(producer, std::memory_order_release);
+	}
+	producer->state.store(id | PRODUCER_BUSY, std::memory_order_relaxed);
+
+	producer_cache[producer_cache_next] = { serial, producer };
+	producer_cache_next = (producer_cache_next + 1) % PRODUCER_CACHE_SIZE;
+	return producer;
+}
+
+uint8_t *CallQueue::_begin_push(uint32_t p_room_needed, Producer *&r_producer) {
+	if (this == MessageQueue::thread_singleton) {
+		DEV_ASSERT(is_current_thread_override);
+		r_producer = nullptr;
+		_ensure_first_page();
+		if ((page_bytes[pages_used - 1] + p_room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
+			if (pages_used == max_pages) {
+				return nullptr;
+			}
+			_add_page();
+		}
+		return &pages[pages_used - 1]->data[page_bytes[pages_used - 1]];
+	}
+
+	DEV_ASSERT(!is_current_thread_override);
+	Producer *producer = _acquire_producer();
+	if ((producer->write_bytes + p_room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
+		if (producer_pages.load(std::memory_order_relaxed) >= max_pages) {
+			producer->state.store(producer->state.load(std::memory_order_relaxed) & ~PRODUCER_BUSY, std::memory_order_release);
+			return nullptr;
+		}
+		ProducerChunk *chunk = _alloc_producer_chunk();
+		producer->write_chunk->next.store(chunk, std::memory_order_release);
+		producer->write_chunk = chunk;
+		producer->write_bytes = 0;
+	}
+	r_producer = producer;
+	return &producer->write_chunk->page->data[producer->write_bytes];
+}
+
+void CallQueue::_end_push(uint32_t p_room_needed, Producer *p_producer) {
+	if (!p_producer) {
+		page_bytes[pages_used - 1] += p_room_needed;
+		return;
+	}
+	p_producer->write_bytes += p_room_needed;
+	p_producer->write_chunk->published.store(p_producer->write_bytes, std::memory_order_release);
+	p_producer->pushed.store(p_producer->pushed.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	p_producer->state.store(p_producer->state.load(std::memory_order_relaxed) & ~PRODUCER_BUSY, std::memory_order_release);
+}
+
 Error CallQueue::push_callp(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
 	return push_callablep(Callable(p_id, p_method), p_args, p_argcount, p_show_error);
 }
@@ -88,24 +179,14 @@ Error CallQueue::push_callablep(const Callable &p_callable, const Variant **p_ar
 
 	ERR_FAIL_COND_V_MSG(room_needed > uint32_t(PAGE_SIZE_BYTES), ERR_INVALID_PARAMETER, "Message is too large to fit on a page (" + itos(PAGE_SIZE_BYTES) + " bytes), consider passing less arguments.");
 
-	LOCK_MUTEX;
-
-	_ensure_first_page();
-
-	if ((page_bytes[pages_used - 1] + room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
-		if (pages_used == max_pages) {
-			fprintf(stderr, "Failed method: %s. Message queue out of memory. %s\n", String(p_callable).utf8().get_data(), error_text.utf8().get_data());
-			statistics();
-			UNLOCK_MUTEX;
-			return ERR_OUT_OF_MEMORY;
-		}
-		_add_page();
+	Producer *producer;
+	uint8_t *buffer_end = _begin_push(room_needed, producer);
+	if (!buffer_end) {
+		fprintf(stderr, "Failed method: %s. Message queue out of memory. %s\n", String(p_callable).utf8().get_data(), error_text.utf8().get_data());
+		statistics();
+		return ERR_OUT_OF_MEMORY;
 	}
 
-	Page *page = pages[pages_used - 1];
-
-	uint8_t *buffer_end = &page->data[page_bytes[pages_used - 1]];
-
 	Message *msg = memnew_placement(buffer_end, Message);
 	msg->args = p_argcount;
 	msg->callable = p_callable;
@@ -126,37 +207,26 @@ Error CallQueue::push_callablep(const Callable &p_callable, const Variant **p_ar
 		*v = *p_args[i];
 	}
 
-	page_bytes[pages_used - 1] += room_needed;
-
-	UNLOCK_MUTEX;
+	_end_push(room_needed, producer);
 
 	return OK;
 }
 
 Error CallQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	LOCK_MUTEX;
 	uint32_t room_needed = sizeof(Message) + sizeof(Variant);
 
-	_ensure_first_page();
-
-	if ((page_bytes[pages_used - 1] + room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
-		if (pages_used == max_pages) {
-			String type;
-			if (ObjectDB::get_instance(p_id)) {
-				type = ObjectDB::get_instance(p_id)->get_class();
-			}
-			fprintf(stderr, "Failed set: %s: %s target ID: %s. Message queue out of memory. %s\n", type.utf8().get_data(), String(p_prop).utf8().get_data(), itos(p_id).utf8().get_data(), error_text.utf8().get_data());
-			statistics();
-
-			UNLOCK_MUTEX;
-			return ERR_OUT_OF_MEMORY;
+	Producer *producer;
+	uint8_t *buffer_end = _begin_push(room_needed, producer);
+	if (!buffer_end) {
+		String type;
+		if (ObjectDB::get_instance(p_id)) {
+			type = ObjectDB::get_instance(p_id)->get_class();
 		}
-		_add_page();
+		fprintf(stderr, "Failed set: %s: %s target ID: %s. Message queue out of memory. %s\n", type.utf8().get_data(), String(p_prop).utf8().get_data(), itos(p_id).utf8().get_data(), error_text.utf8().get_data());
+		statistics();
+		return ERR_OUT_OF_MEMORY;
 	}
 
-	Page *page = pages[pages_used - 1];
-	uint8_t *buffer_end = &page->data[page_bytes[pages_used - 1]];
-
 	Message *msg = memnew_placement(buffer_end, Message);
 	msg->args = 1;
 	msg->callable = Callable(p_id, p_prop);
@@ -167,32 +237,23 @@ Error CallQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant
 	Variant *v = memnew_placement(buffer_end, Variant);
 	*v = p_value;
 
-	page_bytes[pages_used - 1] += room_needed;
-	UNLOCK_MUTEX;
+	_end_push(room_needed, producer);
 
 	return OK;
 }
 
 Error CallQueue::push_notification(ObjectID p_id, int p_notification) {
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
-	LOCK_MUTEX;
 	uint32_t room_needed = sizeof(Message);
 
-	_ensure_first_page();
-
-	if ((page_bytes[pages_used - 1] + room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
-		if (pages_used == max_pages) {
-			fprintf(stderr, "Failed notification: %d target ID: %s. Message queue out of memory. %s\n", p_notification, itos(p_id).utf8().get_data(), error_text.utf8().get_data());
-			statistics();
-			UNLOCK_MUTEX;
-			return ERR_OUT_OF_MEMORY;
-		}
-		_add_page();
+	Producer *producer;
+	uint8_t *buffer_end = _begin_push(room_needed, producer);
+	if (!buffer_end) {
+		fprintf(stderr, "Failed notification: %d target ID: %s. Message queue out of memory. %s\n", p_notification, itos(p_id).utf8().get_data(), error_text.utf8().get_data());
+		statistics();
+		return ERR_OUT_OF_MEMORY;
 	}
 
-	Page *page = pages[pages_used - 1];
-	uint8_t *buffer_end = &page->data[page_bytes[pages_used - 1]];
-
 	Message *msg = memnew_placement(buffer_end, Message);
 
 	msg->type = TYPE_NOTIFICATION;
@@ -200,8 +261,7 @@ Error CallQueue::push_notification(ObjectID p_id, int p_notification) {
 	//msg->target;
 	msg->notification = p_notification;
 
-	page_bytes[pages_used - 1] += room_needed;
-	UNLOCK_MUTEX;
+	_end_push(room_needed, producer);
 
 	return OK;
 }
@@ -223,10 +283,104 @@ void CallQueue::_call_function(const Callable &p_callable, const Variant *p_args
 	}
 }
 
+void CallQueue::_process_message(Message *p_message, bool p_execute) {
+	if (p_execute) {
+		Object *target = p_message->callable.get_object();
+
+		switch (p_message->type & FLAG_MASK) {
+			case TYPE_CALL: {
+				if (target || (p_message->type & FLAG_NULL_IS_OK)) {
+					Variant *args = (Variant *)(p_message + 1);
+					_call_function(p_message->callable, args, p_message->args, p_message->type & FLAG_SHOW_ERROR);
+				}
+			} break;
+			case TYPE_NOTIFICATION: {
+				if (target) {
+					target->notification(p_message->notification);
+				}
+			} break;
+			case TYPE_SET: {
+				if (target) {
+					Variant *arg = (Variant *)(p_message + 1);
+					target->set(p_message->callable.get_method(), *arg);
+				}
+			} break;
+		}
+	}
+
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		Variant *args = (Variant *)(p_message + 1);
+		for (int k = 0; k < p_message->args; k++) {
+			args[k].~Variant();
+		}
+	}
+
+	p_message->~Message();
+}
+
+bool CallQueue::_flush_producer(Producer *p_producer, bool p_execute) {
+	bool processed = false;
+	ProducerChunk *chunk = p_producer->read_chunk;
+	while (true) {
+		if (p_producer->read_bytes < chunk->published.load(std::memory_order_acquire)) {
+			Message *message = (Message *)&chunk->page->data[p_producer->read_bytes];
+			// Pre-advance, the message may push more messages from this thread.
+			p_producer->read_bytes += _get_message_size(message);
+			_process_message(message, p_execute);
+			p_producer->consumed.store(p_producer->consumed.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+			processed = true;
+			continue;
+		}
+
+		ProducerChunk *next = chunk->next.load(std::memory_order_acquire);
+		if (!next) {
+			break;
+		}
+		// The producer is done with this chunk, but may have published more before moving on.
+		if (p_producer->read_bytes < chunk->published.load(std::memory_order_acquire)) {
+			continue;
+		}
+		_free_producer_chunk(chunk);
+		chunk = next;
+		p_producer->read_chunk = chunk;
+		p_producer->read_bytes = 0;
+	}
+	return processed;
+}
+
+void CallQueue::_retire_idle_producers() {
+	MutexLock lock(mutex);
+	for (Producer *p = producers.load(std::memory_order_relaxed); p; p = p->next) {
+		const uint64_t state = p->state.load(std::memory_order_relaxed);
+		if (state == 0) {
+			continue;
+		}
+		const uint64_t consumed = p->consumed.load(std::memory_order_relaxed);
+		if (consumed != p->last_consumed) {
+			p->last_consumed = consumed;
+			p->idle_flushes = 0;
+			continue;
+		}
+		if (++p->idle_flushes < PRODUCER_RETIRE_FLUSHES || p->pushed.load(std::memory_order_acquire) != consumed) {
+			continue;
+		}
+
+		uint64_t expected = state & ~PRODUCER_BUSY;
+		if (p->state.compare_exchange_strong(expected, 0, std::memory_order_acquire)) {
+			// Drained, so both sides are on the same chunk. Nobody can push until it's handed out again under the mutex.
+			DEV_ASSERT(p->read_chunk == p->write_chunk);
+			p->write_bytes = 0;
+			p->read_bytes = 0;
+			p->write_chunk->published.store(0, std::memory_order_relaxed);
+			p->idle_flushes = 0;
+		}
+	}
+}
+
 Error CallQueue::flush() {
 	LOCK_MUTEX;
 
-	if (pages.is_empty()) {
+	if (pages.is_empty() && producers.load(std::memory_order_acquire) == nullptr) {
 		// Never allocated
 		UNLOCK_MUTEX;
 		return OK; // Do nothing.
@@ -239,66 +393,49 @@ Error CallQueue::flush() {
 
 	flushing = true;
 
-	uint32_t i = 0;
-	uint32_t offset = 0;
+	// Messages may push more messages, from any thread. Keep going until all are processed.
+	bool processed = true;
+	while (processed) {
+		processed = false;
 
-	while (i < pages_used && offset < page_bytes[i]) {
-		Page *page = pages[i];
+		uint32_t i = 0;
+		uint32_t offset = 0;
 
-		//lock on each iteration, so a call can re-add itself to the message queue
+		while (i < pages_used && offset < page_bytes[i]) {
+			Page *page = pages[i];
 
-		Message *message = (Message *)&page->data[offset];
+			//lock on each iteration, so a call can re-add itself to the message queue
 
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			advance += sizeof(Variant) * message->args;
-		}
+			Message *message = (Message *)&page->data[offset];
 
-		//pre-advance so this function is reentrant
-		offset += advance;
+			//pre-advance so this function is reentrant
+			offset += _get_message_size(message);
 
-		Object *target = message->callable.get_object();
+			UNLOCK_MUTEX;
 
-		UNLOCK_MUTEX;
+			_process_message(message, true);
+			processed = true;
 
-		switch (message->type & FLAG_MASK) {
-			case TYPE_CALL: {
-				if (target || (message->type & FLAG_NULL_IS_OK)) {
-					Variant *args = (Variant *)(message + 1);
-					_call_function(message->callable, args, message->args, message->type & FLAG_SHOW_ERROR);
-				}
-			} break;
-			case TYPE_NOTIFICATION: {
-				if (target) {
-					target->notification(message->notification);
-				}
-			} break;
-			case TYPE_SET: {
-				if (target) {
-					Variant *arg = (Variant *)(message + 1);
-					target->set(message->callable.get_method(), *arg);
-				}
-			} break;
-		}
-
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			Variant *args = (Variant *)(message + 1);
-			for (int k = 0; k < message->args; k++) {
-				args[k].~Variant();
+			LOCK_MUTEX;
+			if (offset == page_bytes[i]) {
+				i++;
+				offset = 0;
 			}
 		}
 
-		message->~Message();
+		if (!pages.is_empty()) {
+			page_bytes[0] = 0;
+			pages_used = 1;
+		}
 
-		LOCK_MUTEX;
-		if (offset == page_bytes[i]) {
-			i++;
-			offset = 0;
+		UNLOCK_MUTEX;
+		for (Producer *p = producers.load(std::memory_order_acquire); p; p = p->next) {
+			processed = _flush_producer(p, true) || processed;
 		}
+		LOCK_MUTEX;
 	}
 
-	page_bytes[0] = 0;
-	pages_used = 1;
+	_retire_idle_producers();
 
 	flushing = false;
 	UNLOCK_MUTEX;
@@ -308,6 +445,10 @@ Error CallQueue::flush() {
 void CallQueue::clear() {
 	LOCK_MUTEX;
 
+	for (Producer *p = producers.load(std::memory_order_acquire); p; p = p->next) {
+		_flush_producer(p, false);
+	}
+
 	if (pages.is_empty()) {
 		UNLOCK_MUTEX;
 		return; // Nothing to clear.
@@ -322,21 +463,9 @@ void CallQueue::clear() {
 
 			Message *message = (Message *)&page->data[offset];
 
-			uint32_t advance = sizeof(Message);
-			if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-				advance += sizeof(Variant) * message->args;
-			}
-
-			offset += advance;
-
-			if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-				Variant *args = (Variant *)(message + 1);
-				for (int k = 0; k < message->args; k++) {
-					args[k].~Variant();
-				}
-			}
+			offset += _get_message_size(message);
 
-			message->~Message();
+			_process_message(message, false);
 		}
 	}
 
@@ -424,6 +553,9 @@ void CallQueue::statistics() {
 	}
 
 	fprintf(stdout, "TOTAL PAGES: %d (%d bytes).\n", pages_used, pages_used * PAGE_SIZE_BYTES);
+	// Other threads' messages may be in use by the flushing thread, so only their memory is reported.
+	uint32_t other_thread_pages = producer_pages.load(std::memory_order_relaxed);
+	fprintf(stdout, "OTHER THREAD PAGES: %d (%d bytes).\n", other_thread_pages, other_thread_pages * PAGE_SIZE_BYTES);
 	fprintf(stdout, "NULL count: %d.\n", null_count);
 
 	for (const KeyValue<StringName, int> &E : set_count) {
@@ -446,6 +578,12 @@ bool CallQueue::is_flushing() const {
 }
 
 bool CallQueue::has_messages() const {
+	for (const Producer *p = producers.load(std::memory_order_acquire); p; p = p->next) {
+		if (p->pushed.load(std::memory_order_acquire) != p->consumed.load(std::memory_order_acquire)) {
+			return true;
+		}
+	}
+
 	if (pages_used == 0) {
 		return false;
 	}
@@ -457,7 +595,7 @@ bool CallQueue::has_messages() const {
 }
 
 int CallQueue::get_max_buffer_usage() const {
-	return pages.size() * PAGE_SIZE_BYTES;
+	return (pages.size() + producer_pages.load(std::memory_order_relaxed)) * PAGE_SIZE_BYTES;
 }
 
 CallQueue::CallQueue(Allocator *p_custom_allocator, uint32_t p_max_pages, const String &p_error_text) {
@@ -470,6 +608,7 @@ CallQueue::CallQueue(Allocator *p_custom_allocator, uint32_t p_max_pages, const
 	}
 	max_pages = p_max_pages;
 	error_text = p_error_text;
+	serial = last_serial.fetch_add(1, std::memory_order_relaxed) + 1;
 }
 
 CallQueue::~CallQueue() {
@@ -478,6 +617,13 @@ CallQueue::~CallQueue() {
 	for (uint32_t i = 0; i < pages.size(); i++) {
 		allocator->free(pages[i]);
 	}
+	Producer *producer = producers.load(std::memory_order_acquire);
+	while (producer) {
+		Producer *next = producer->next;
+		_free_producer_chunk(producer->read_chunk);
+		memdelete(producer);
+		producer = next;
+	}
 	if (!allocator_is_custom) {
 		memdelete(allocator);
 	}
@@ -486,6 +632,10 @@ CallQueue::~CallQueue() {
 
 //////////////////////
 
+thread_local CallQueue::ProducerCacheEntry CallQueue::producer_cache[PRODUCER_CACHE_SIZE];
+thread_local uint32_t CallQueue::producer_cache_next = 0;
+std::atomic<uint64_t> CallQueue::last_serial = { 0 };
+
 CallQueue *MessageQueue::main_singleton = nullptr;
 thread_local CallQueue *MessageQueue::thread_singleton = nullptr;
 
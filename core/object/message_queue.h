@@ -36,6 +36,8 @@
 #include "core/templates/paged_allocator.h"
 #include "core/variant/variant.h"
 
+#include <atomic>
+
 class Object;
 
 class CallQueue {
@@ -70,12 +72,58 @@ private:
 	Allocator *allocator = nullptr;
 	bool allocator_is_custom = false;
 
+	// Used by the thread this queue is the MessageQueue override of.
 	LocalVector<Page *> pages;
 	LocalVector<uint32_t> page_bytes;
 	uint32_t max_pages = 0;
 	uint32_t pages_used = 0;
 	bool flushing = false;
 
+	// Any other thread pushes through its own producer, so pushing doesn't
+	// contend on `mutex`. A producer's chunks are only written by its thread and
+	// only read by the flushing thread, so each thread's messages are delivered
+	// in the order they were pushed. There is no ordering between threads.
+	struct ProducerChunk {
+		Page *page = nullptr;
+		std::atomic<uint32_t> published = { 0 }; // Bytes that can be read.
+		std::atomic<ProducerChunk *> next = { nullptr }; // Set once the producer moved on.
+	};
+
+	struct Producer {
+		// ID of the owning thread, or 0 when free. PRODUCER_BUSY is added while pushing.
+		std::atomic<uint64_t> state = { 0 };
+		std::atomic<uint64_t> pushed = { 0 };
+		std::atomic<uint64_t> consumed = { 0 };
+		// Owning thread only.
+		ProducerChunk *write_chunk = nullptr;
+		uint32_t write_bytes = 0;
+		// Flushing thread only.
+		ProducerChunk *read_chunk = nullptr;
+		uint32_t read_bytes = 0;
+		uint64_t last_consumed = 0;
+		uint32_t idle_flushes = 0;
+		Producer *next = nullptr; // Never changes once the producer is listed.
+	};
+
+	static constexpr uint64_t PRODUCER_BUSY = uint64_t(1) << 63;
+	// A producer that had no messages for this many flushes is released, so queues
+	// don't keep one per thread that ever pushed. Its thread gets a new one if needed.
+	static constexpr uint32_t PRODUCER_RETIRE_FLUSHES = 16;
+	static constexpr uint32_t PRODUCER_CACHE_SIZE = 4;
+
+	struct ProducerCacheEntry {
+		uint64_t queue_serial = 0;
+		Producer *producer = nullptr;
+	};
+	static thread_local ProducerCacheEntry producer_cache[PRODUCER_CACHE_SIZE];
+	static thread_local uint32_t producer_cache_next;
+	static std::atomic<uint64_t> last_serial;
+
+	// Identifies this queue in the producer caches, since addresses get reused.
+	uint64_t serial = 0;
+	std::atomic<Producer *> producers = { nullptr };
+	std::atomic<uint32_t> producer_pages = { 0 };
+
 #ifdef DEV_ENABLED
 	bool is_current_thread_override = false;
 #endif
@@ -99,6 +147,24 @@ private:
 
 	void _add_page();
 
+	ProducerChunk *_alloc_producer_chunk();
+	void _free_producer_chunk(ProducerChunk *p_chunk);
+	Producer *_acquire_producer();
+	// Returns where to construct a message of p_room_needed bytes, or nullptr when out of memory.
+	uint8_t *_begin_push(uint32_t p_room_needed, Producer *&r_producer);
+	void _end_push(uint32_t p_room_needed, Producer *p_producer);
+	bool _flush_producer(Producer *p_producer, bool p_execute);
+	void _retire_idle_producers();
+
+	_FORCE_INLINE_ static uint32_t _get_message_size(const Message *p_message) {
+		if ((p_message->type & FLAG_MASK) == TYPE_NOTIFICATION) {
+			return sizeof(Message);
+		}
+		return sizeof(Message) + sizeof(Variant) * p_message->args;
+	}
+	// Runs the message if p_execute is true, then destroys it.
+	void _process_message(Message *p_message, bool p_execute);
+
 	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
 
 	String error_text;
@@ -80,6 +80,12 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 		if (p_task->pending_notify_yield_over) {
 			curr_thread.yield_is_over = true;
 		}
+		if (!prev_task) {
+			// Called from _thread_function(), where the task may have been taken from the
+			// thread queues without the mutex. Like the locked path, taking a task consumes
+			// any pending notification. Nested calls keep it (see _wait_collaboratively()).
+			curr_thread.signaled = false;
+		}
 		task_mutex.unlock();
 	}
 #endif
@@ -186,8 +192,14 @@ void WorkerThreadPool::_thread_function(void *p_user) {
 	Thread::set_name(vformat("WorkerThread %d", thread_data->index));
 
 	while (true) {
+		// Own tasks first, newest first, then steal the oldest task of another thread.
+		// Neither needs the task mutex.
 		Task *task_to_process = nullptr;
-		{
+		if (!thread_data->queue.pop(task_to_process)) {
+			task_to_process = thread_data->pool->_steal_task(thread_data);
+		}
+
+		if (!task_to_process) {
 			// Create the lock outside the inner loop so it isn't needlessly unlocked and relocked
 			//  when no task was found to process, and the loop is re-entered.
 			MutexLock lock(thread_data->pool->task_mutex);
@@ -200,17 +212,23 @@ void WorkerThreadPool::_thread_function(void *p_user) {
 
 				thread_data->signaled = false;
 
-				if (!thread_data->pool->task_queue.first()) {
-					// There wasn't a task available yet.
-					// Let's wait for the next notification, then recheck.
-					thread_data->cond_var.wait(lock);
-					continue;
+				if (thread_data->pool->task_queue.first()) {
+					// Got a task to process! Remove it from the queue, then break into the task handling section.
+					task_to_process = thread_data->pool->task_queue.first()->self();
+					thread_data->pool->task_queue.remove(thread_data->pool->task_queue.first());
+					break;
 				}
 
-				// Got a task to process! Remove it from the queue, then break into the task handling section.
-				task_to_process = thread_data->pool->task_queue.first()->self();
-				thread_data->pool->task_queue.remove(thread_data->pool->task_queue.first());
-				break;
+				// Tasks are only pushed to the thread queues with the mutex held,
+				// so nothing can be posted between this check and the wait.
+				task_to_process = thread_data->pool->_steal_task(thread_data);
+				if (task_to_process) {
+					break;
+				}
+
+				// There wasn't a task available yet.
+				// Let's wait for the next notification, then recheck.
+				thread_data->cond_var.wait(lock);
 			}
 		}
 
@@ -244,10 +262,19 @@ void WorkerThreadPool::_post_tasks(Task **p_tasks, uint32_t p_count, bool p_high
 
 	ThreadData *caller_pool_thread = thread_ids.has(Thread::get_caller_id()) ? &threads[thread_ids[Thread::get_caller_id()]] : nullptr;
 
+	// Tasks posted from a pool thread stay in its own queue, where it will find them
+	// without locking once it finishes or waits, and where idle threads steal them from.
+	// Pump tasks always go to the shared queue, so a thread can refuse them.
+	WorkStealingQueue<Task *> *local_queue = caller_pool_thread && !p_pump_task ? &caller_pool_thread->queue : nullptr;
+
 	for (uint32_t i = 0; i < p_count; i++) {
 		p_tasks[i]->low_priority = !p_high_priority;
 		if (p_high_priority || low_priority_threads_used < max_low_priority_threads) {
-			task_queue.add_last(&p_tasks[i]->task_elem);
+			if (local_queue) {
+				local_queue->push(p_tasks[i]);
+			} else {
+				task_queue.add_last(&p_tasks[i]->task_elem);
+			}
 			if (!p_high_priority) {
 				low_priority_threads_used++;
 			}
@@ -286,9 +313,10 @@ void WorkerThreadPool::_notify_threads(const ThreadData *p_current_thread_data,
 		if (th.signaled) {
 			continue;
 		}
-		if (th.current_task) {
+		Task *current_task = th.current_task;
+		if (current_task) {
 			// Good thread for promoting low-prio?
-			if (to_promote && th.awaited_task && th.current_task->low_priority) {
+			if (to_promote && th.awaited_task && current_task->low_priority) {
 				if (likely(&th != p_current_thread_data)) {
 					th.cond_var.notify_one();
 				}
@@ -338,6 +366,39 @@ bool WorkerThreadPool::_try_promote_low_priority_task() {
 	}
 }
 
+WorkerThreadPool::Task *WorkerThreadPool::_steal_task(ThreadData *p_thief) {
+	uint32_t thread_count = threads.size();
+	while (true) {
+		bool retry = false;
+		for (uint32_t i = 1; i < thread_count; i++) {
+			Task *task = nullptr;
+			switch (threads[(p_thief->index + i) % thread_count].queue.steal(task)) {
+				case WorkStealingQueue<Task *>::STEAL_SUCCESS:
+					return task;
+				case WorkStealingQueue<Task *>::STEAL_RETRY:
+					retry = true;
+					break;
+				case WorkStealingQueue<Task *>::STEAL_EMPTY:
+					break;
+			}
+		}
+		// Only give up once every queue was seen empty, otherwise a thread could go to sleep
+		// after losing a race while the task it was notified for is still queued.
+		if (!retry) {
+			return nullptr;
+		}
+	}
+}
+
+bool WorkerThreadPool::_has_thread_queued_tasks() const {
+	for (const ThreadData &th : threads) {
+		if (!th.queue.is_empty()) {
+			return true;
+		}
+	}
+	return false;
+}
+
 WorkerThreadPool::TaskID WorkerThreadPool::add_native_task(void (*p_func)(void *), void *p_userdata, bool p_high_priority, const String &p_description) {
 	return _add_task(Callable(), p_func, p_userdata, nullptr, p_high_priority, p_description);
 }
@@ -417,7 +478,7 @@ Error WorkerThreadPool::wait_for_task_completion(TaskID p_task_id) {
 	}
 
 	ThreadData *caller_pool_thread = thread_ids.has(Thread::get_caller_id()) ? &threads[thread_ids[Thread::get_caller_id()]] : nullptr;
-	if (caller_pool_thread && p_task_id <= caller_pool_thread->current_task->self) {
+	if (caller_pool_thread && p_task_id <= caller_pool_thread->current_task.load()->self) {
 		// Deadlock prevention:
 		// When a pool thread wants to wait for an older task, the following situations can happen:
 		// 1. Awaited task is deep in the stack of the awaiter.
@@ -516,8 +577,8 @@ void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, T
 				if (was_signaled) {
 					// This thread was awaken for some additional reason, but it's about to exit.
 					// Let's find out what may be pending and forward the requests.
-					uint32_t to_process = task_queue.first() ? 1 : 0;
-					uint32_t to_promote = p_caller_pool_thread->current_task->low_priority && low_priority_task_queue.first() ? 1 : 0;
+					uint32_t to_process = task_queue.first() || _has_thread_queued_tasks() ? 1 : 0;
+					uint32_t to_promote = p_caller_pool_thread->current_task.load()->low_priority && low_priority_task_queue.first() ? 1 : 0;
 					if (to_process || to_promote) {
 						// This thread must be left alone since it won't loop again.
 						p_caller_pool_thread->signaled = true;
@@ -528,13 +589,14 @@ void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, T
 				break;
 			}
 
-			if (p_caller_pool_thread->current_task->low_priority && low_priority_task_queue.first()) {
+			if (p_caller_pool_thread->current_task.load()->low_priority && low_priority_task_queue.first()) {
 				if (_try_promote_low_priority_task()) {
 					_notify_threads(p_caller_pool_thread, 1, 0);
 				}
 			}
 
-			if (p_caller_pool_thread->pool->task_queue.first()) {
+			// Own tasks first, since they are likely what is being waited for.
+			if (!p_caller_pool_thread->queue.pop(task_to_process) && p_caller_pool_thread->pool->task_queue.first()) {
 				task_to_process = task_queue.first()->self();
 				if ((p_task == ThreadData::YIELDING || p_caller_pool_thread->has_pump_task == true) && task_to_process->is_pump_task) {
 					task_to_process = nullptr;
@@ -544,6 +606,10 @@ void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, T
 				}
 			}
 
+			if (!task_to_process) {
+				task_to_process = _steal_task(p_caller_pool_thread);
+			}
+
 			if (!task_to_process) {
 				p_caller_pool_thread->awaited_task = p_task;
 
@@ -587,7 +653,7 @@ bool WorkerThreadPool::_handle_runlevel(ThreadData *p_thread_data, MutexLock<Bin
 		} break;
 		case RUNLEVEL_PRE_EXIT_LANGUAGES: {
 			if (!p_thread_data->pre_exited_languages) {
-				if (!task_queue.first() && !low_priority_task_queue.first()) {
+				if (!task_queue.first() && !low_priority_task_queue.first() && !_has_thread_queued_tasks()) {
 					p_thread_data->pre_exited_languages = true;
 					runlevel_data.pre_exit_languages.num_idle_threads++;
 					control_cond_var.notify_all();
@@ -764,8 +830,9 @@ int WorkerThreadPool::get_thread_index() const {
 
 WorkerThreadPool::TaskID WorkerThreadPool::get_caller_task_id() const {
 	int th_index = get_thread_index();
-	if (th_index != -1 && threads[th_index].current_task) {
-		return threads[th_index].current_task->self;
+	Task *current_task = th_index != -1 ? threads[th_index].current_task.load() : nullptr;
+	if (current_task) {
+		return current_task->self;
 	} else {
 		return INVALID_TASK_ID;
 	}
@@ -773,8 +840,9 @@ WorkerThreadPool::TaskID WorkerThreadPool::get_caller_task_id() const {
 
 WorkerThreadPool::GroupID WorkerThreadPool::get_caller_group_id() const {
 	int th_index = get_thread_index();
-	if (th_index != -1 && threads[th_index].current_task && threads[th_index].current_task->group) {
-		return threads[th_index].current_task->group->self;
+	Task *current_task = th_index != -1 ? threads[th_index].current_task.load() : nullptr;
+	if (current_task && current_task->group) {
+		return current_task->group->self;
 	} else {
 		return INVALID_TASK_ID;
 	}
@@ -40,6 +40,7 @@
 #include "core/templates/rid.h"
 #include "core/templates/safe_refcount.h"
 #include "core/templates/self_list.h"
+#include "core/templates/work_stealing_queue.h"
 
 class WorkerThreadPool : public Object {
 	GDCLASS(WorkerThreadPool, Object)
@@ -105,6 +106,8 @@ private:
 	PagedAllocator<Group, false, GROUPS_PAGE_SIZE> group_allocator;
 
 	SelfList<Task>::List low_priority_task_queue;
+	// Tasks posted from outside the pool, pump tasks and promoted low priority tasks.
+	// Tasks posted from a pool thread go to that thread's own queue instead.
 	SelfList<Task>::List task_queue;
 
 	BinaryMutex task_mutex;
@@ -119,10 +122,13 @@ private:
 		bool pre_exited_languages : 1;
 		bool exited_languages : 1;
 		bool has_pump_task : 1; // Threads can only have one pump task.
-		Task *current_task = nullptr;
+		// Atomic because group tasks set it without holding the task mutex. Other threads only read it with the mutex held.
+		std::atomic<Task *> current_task = nullptr;
 		Task *awaited_task = nullptr; // Null if not awaiting the condition variable, or special value (YIELDING).
 		ConditionVariable cond_var;
 		WorkerThreadPool *pool = nullptr;
+		// Tasks posted from this thread. Popped by this thread, stolen by the others.
+		WorkStealingQueue<Task *> queue;
 
 		ThreadData() :
 				signaled(false),
@@ -183,6 +189,9 @@ private:
 
 	bool _try_promote_low_priority_task();
 
+	Task *_steal_task(ThreadData *p_thief);
+	bool _has_thread_queued_tasks() const;
+
 	static WorkerThreadPool *singleton;
 
 #ifdef THREADS_ENABLED
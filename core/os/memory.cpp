@@ -33,9 +33,31 @@
 #include "core/profiling/profiling.h"
 #include "core/templates/safe_refcount.h"
 
+#ifdef SMALL_ALLOCATOR_ENABLED
+#include "core/os/small_allocator.h"
+#endif
+
+#ifdef MEMORY_TAGS_ENABLED
+#include "core/os/spin_lock.h"
+
+#include <atomic>
+#include <cstring>
+#endif
+
 #include <cstdlib>
 
+#ifdef MEMORY_TAGS_ENABLED
+static thread_local Memory::Tag _thread_tag = Memory::TAG_UNTAGGED;
+#endif
+
 void *operator new(size_t p_size, const char *p_description) {
+#ifdef MEMORY_TAGS_ENABLED
+	// memnew() passes its call site. Explicit scopes take precedence.
+	if (_thread_tag == Memory::TAG_UNTAGGED && p_description[0] != 0) {
+		MemoryTagScope scope(Memory::get_tag(p_description));
+		return Memory::alloc_static(p_size, false);
+	}
+#endif
 	return Memory::alloc_static(p_size, false);
 }
 
@@ -62,6 +84,165 @@ static SafeNumeric<uint64_t> _current_mem_usage;
 static SafeNumeric<uint64_t> _max_mem_usage;
 #endif
 
+// Debug builds always keep the size header, and so do tagged builds since the
+// tag is stored in its upper bits.
+#if defined(DEBUG_ENABLED) || defined(MEMORY_TAGS_ENABLED)
+#define MEMORY_ALWAYS_PREPAD
+#endif
+
+#ifdef MEMORY_TAGS_ENABLED
+static constexpr int TAG_SHIFT = 48;
+static constexpr uint64_t SIZE_MASK = (uint64_t(1) << TAG_SHIFT) - 1;
+
+struct TagData {
+	const char *name = nullptr;
+	std::atomic<uint64_t> live_bytes = { 0 };
+	std::atomic<uint64_t> live_blocks = { 0 };
+	std::atomic<uint64_t> allocations = { 0 };
+};
+
+static TagData _tags[Memory::MAX_TAGS];
+static std::atomic<uint32_t> _tag_count = { 1 }; // TAG_UNTAGGED is always there.
+static SpinLock _tag_lock;
+
+// Both tables use open addressing and are only written under `_tag_lock`.
+// `_tag_slots` finds tags by name contents. `_site_keys` maps name pointers to
+// tags, so memnew() from a known call site doesn't have to hash the string.
+// Different pointers may share a tag, as the same file name can be emitted by
+// several translation units.
+static constexpr uint32_t TAG_SLOTS = Memory::MAX_TAGS * 2;
+// Keep the pointer table at most 3/4 full so lookups of unknown pointers stay short.
+static constexpr uint32_t MAX_SITES = TAG_SLOTS / 4 * 3;
+static std::atomic<Memory::Tag> _tag_slots[TAG_SLOTS];
+static std::atomic<const char *> _site_keys[TAG_SLOTS];
+static Memory::Tag _site_tags[TAG_SLOTS];
+static std::atomic<uint32_t> _site_count = { 0 };
+
+_FORCE_INLINE_ static uint32_t _hash_site(const char *p_name) {
+	uint64_t v = (uint64_t)(uintptr_t)p_name;
+	v ^= v >> 33;
+	v *= 0xff51afd7ed558ccdULL;
+	v ^= v >> 33;
+	return (uint32_t)v & (TAG_SLOTS - 1);
+}
+
+static uint32_t _hash_name(const char *p_name) {
+	// FNV-1a.
+	uint32_t hash = 2166136261u;
+	for (const char *c = p_name; *c; c++) {
+		hash = (hash ^ (uint8_t)*c) * 16777619u;
+	}
+	return hash & (TAG_SLOTS - 1);
+}
+
+_FORCE_INLINE_ static bool _find_site(const char *p_name, Memory::Tag &r_tag) {
+	uint32_t slot = _hash_site(p_name);
+	for (uint32_t i = 0; i < TAG_SLOTS; i++) {
+		const char *key = _site_keys[slot].load(std::memory_order_acquire);
+		if (key == p_name) {
+			r_tag = _site_tags[slot];
+			return true;
+		}
+		if (key == nullptr) {
+			return false;
+		}
+		slot = (slot + 1) & (TAG_SLOTS - 1);
+	}
+	return false;
+}
+
+// Names are published after their tag data, so this is safe without locking.
+// r_slot is set to the free slot the name would go in when it isn't found.
+static bool _find_name(const char *p_name, uint32_t &r_slot, Memory::Tag &r_tag) {
+	uint32_t slot = _hash_name(p_name);
+	Memory::Tag tag;
+	while ((tag = _tag_slots[slot].load(std::memory_order_acquire)) != Memory::TAG_UNTAGGED) {
+		if (strcmp(_tags[tag].name, p_name) == 0) {
+			r_tag = tag;
+			return true;
+		}
+		slot = (slot + 1) & (TAG_SLOTS - 1);
+	}
+	r_slot = slot;
+	return false;
+}
+
+static Memory::Tag _register_tag(const char *p_name) {
+	uint32_t slot = 0;
+	Memory::Tag tag = Memory::TAG_UNTAGGED;
+
+	// Once the pointer table is full, call sites missing from it would take the lock on every
+	// allocation. Only look up names that are already known then, new ones stay untagged.
+	if (_site_count.load(std::memory_order_acquire) >= MAX_SITES) {
+		_find_name(p_name, slot, tag);
+		return tag;
+	}
+
+	_tag_lock.lock();
+
+	if (_find_site(p_name, tag)) {
+		// Another thread got here first.
+		_tag_lock.unlock();
+		return tag;
+	}
+
+	if (!_find_name(p_name, slot, tag)) {
+		tag = Memory::TAG_UNTAGGED;
+		uint32_t count = _tag_count.load(std::memory_order_relaxed);
+		if (count < Memory::MAX_TAGS) {
+			// Once full, new names stay untagged (and get cached as such below).
+			tag = (Memory::Tag)count;
+			_tags[tag].name = p_name;
+			_tag_slots[slot].store(tag, std::memory_order_release);
+			_tag_count.store(count + 1, std::memory_order_release);
+		}
+	}
+
+	const uint32_t site_count = _site_count.load(std::memory_order_relaxed);
+	if (site_count < MAX_SITES) {
+		slot = _hash_site(p_name);
+		while (_site_keys[slot].load(std::memory_order_relaxed) != nullptr) {
+			slot = (slot + 1) & (TAG_SLOTS - 1);
+		}
+		_site_tags[slot] = tag;
+		_site_keys[slot].store(p_name, std::memory_order_release);
+		_site_count.store(site_count + 1, std::memory_order_release);
+	}
+
+	_tag_lock.unlock();
+	return tag;
+}
+
+_FORCE_INLINE_ static void _tag_alloc(Memory::Tag p_tag, uint64_t p_bytes) {
+	TagData &data = _tags[p_tag];
+	data.live_bytes.fetch_add(p_bytes, std::memory_order_relaxed);
+	data.live_blocks.fetch_add(1, std::memory_order_relaxed);
+	data.allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+_FORCE_INLINE_ static void _tag_free(Memory::Tag p_tag, uint64_t p_bytes) {
+	TagData &data = _tags[p_tag];
+	data.live_bytes.fetch_sub(p_bytes, std::memory_order_relaxed);
+	data.live_blocks.fetch_sub(1, std::memory_order_relaxed);
+}
+#endif
+
+_FORCE_INLINE_ static uint64_t _get_header_size(uint64_t p_header) {
+#ifdef MEMORY_TAGS_ENABLED
+	return p_header & SIZE_MASK;
+#else
+	return p_header;
+#endif
+}
+
+_FORCE_INLINE_ static uint64_t _set_header_size(uint64_t p_header, uint64_t p_bytes) {
+#ifdef MEMORY_TAGS_ENABLED
+	return (p_header & ~SIZE_MASK) | p_bytes;
+#else
+	return p_bytes;
+#endif
+}
+
 void *Memory::alloc_aligned_static(size_t p_bytes, size_t p_alignment) {
 	DEV_ASSERT(is_power_of_2(p_alignment));
 
@@ -96,20 +277,70 @@ void Memory::free_aligned_static(void *p_memory) {
 	free(p);
 }
 
+// Blocks as seen by alloc_static() and friends, including the size header.
+// Small blocks come from SmallAllocator when it is enabled, the rest from malloc.
+
+template <bool p_ensure_zero>
+_FORCE_INLINE_ static void *_alloc_block(size_t p_bytes) {
+#ifdef SMALL_ALLOCATOR_ENABLED
+	if (p_bytes <= SmallAllocator::MAX_SIZE) {
+		void *block = SmallAllocator::alloc(p_bytes);
+		if (likely(block)) {
+			if constexpr (p_ensure_zero) {
+				memset(block, 0, p_bytes);
+			}
+			return block;
+		}
+	}
+#endif
+	if constexpr (p_ensure_zero) {
+		return calloc(1, p_bytes);
+	} else {
+		return malloc(p_bytes);
+	}
+}
+
+_FORCE_INLINE_ static void _free_block(void *p_block) {
+#ifdef SMALL_ALLOCATOR_ENABLED
+	if (SmallAllocator::owns(p_block)) {
+		SmallAllocator::free(p_block);
+		return;
+	}
+#endif
+	free(p_block);
+}
+
+_FORCE_INLINE_ static void *_realloc_block(void *p_block, size_t p_bytes) {
+#ifdef SMALL_ALLOCATOR_ENABLED
+	if (SmallAllocator::owns(p_block)) {
+		if (p_bytes == 0) {
+			SmallAllocator::free(p_block);
+			return nullptr;
+		}
+		size_t block_size = SmallAllocator::get_block_size(p_block);
+		if (p_bytes <= block_size && p_bytes > block_size / 2) {
+			return p_block;
+		}
+		void *new_block = _alloc_block<false>(p_bytes);
+		if (new_block) {
+			memcpy(new_block, p_block, MIN(block_size, p_bytes));
+			SmallAllocator::free(p_block);
+		}
+		return new_block;
+	}
+#endif
+	return realloc(p_block, p_bytes);
+}
+
 template <bool p_ensure_zero>
 void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_ALWAYS_PREPAD
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
 #endif
 
-	void *mem;
-	if constexpr (p_ensure_zero) {
-		mem = calloc(1, p_bytes + (prepad ? DATA_OFFSET : 0));
-	} else {
-		mem = malloc(p_bytes + (prepad ? DATA_OFFSET : 0));
-	}
+	void *mem = _alloc_block<p_ensure_zero>(p_bytes + (prepad ? DATA_OFFSET : 0));
 
 	ERR_FAIL_NULL_V(mem, nullptr);
 	GodotProfileAlloc(mem, p_bytes + (prepad ? DATA_OFFSET : 0));
@@ -123,6 +354,10 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 #ifdef DEBUG_ENABLED
 		uint64_t new_mem_usage = _current_mem_usage.add(p_bytes);
 		_max_mem_usage.exchange_if_greater(new_mem_usage);
+#endif
+#ifdef MEMORY_TAGS_ENABLED
+		*s |= (uint64_t)_thread_tag << TAG_SHIFT;
+		_tag_alloc(_thread_tag, p_bytes);
 #endif
 		return s8 + DATA_OFFSET;
 	} else {
@@ -140,7 +375,7 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_memory;
 
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_ALWAYS_PREPAD
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -149,37 +384,48 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 	if (prepad) {
 		mem -= DATA_OFFSET;
 		uint64_t *s = (uint64_t *)(mem + SIZE_OFFSET);
+		uint64_t header = *s;
+#if defined(DEBUG_ENABLED) || defined(MEMORY_TAGS_ENABLED)
+		uint64_t old_bytes = _get_header_size(header);
+#endif
 
 #ifdef DEBUG_ENABLED
-		if (p_bytes > *s) {
-			uint64_t new_mem_usage = _current_mem_usage.add(p_bytes - *s);
+		if (p_bytes > old_bytes) {
+			uint64_t new_mem_usage = _current_mem_usage.add(p_bytes - old_bytes);
 			_max_mem_usage.exchange_if_greater(new_mem_usage);
 		} else {
-			_current_mem_usage.sub(*s - p_bytes);
+			_current_mem_usage.sub(old_bytes - p_bytes);
 		}
 #endif
 
 		if (p_bytes == 0) {
+#ifdef MEMORY_TAGS_ENABLED
+			_tag_free(header >> TAG_SHIFT, old_bytes);
+#endif
 			GodotProfileFree(mem);
-			free(mem);
+			_free_block(mem);
 			return nullptr;
 		} else {
-			*s = p_bytes;
+#ifdef MEMORY_TAGS_ENABLED
+			// Resized blocks stay with the tag they were allocated with.
+			_tags[header >> TAG_SHIFT].live_bytes.fetch_add(p_bytes - old_bytes, std::memory_order_relaxed);
+#endif
+			*s = _set_header_size(header, p_bytes);
 
 			GodotProfileFree(mem);
-			mem = (uint8_t *)realloc(mem, p_bytes + DATA_OFFSET);
+			mem = (uint8_t *)_realloc_block(mem, p_bytes + DATA_OFFSET);
 			ERR_FAIL_NULL_V(mem, nullptr);
 			GodotProfileAlloc(mem, p_bytes + DATA_OFFSET);
 
 			s = (uint64_t *)(mem + SIZE_OFFSET);
 
-			*s = p_bytes;
+			*s = _set_header_size(header, p_bytes);
 
 			return mem + DATA_OFFSET;
 		}
 	} else {
 		GodotProfileFree(mem);
-		mem = (uint8_t *)realloc(mem, p_bytes);
+		mem = (uint8_t *)_realloc_block(mem, p_bytes);
 
 		ERR_FAIL_COND_V(mem == nullptr && p_bytes > 0, nullptr);
 		GodotProfileAlloc(mem, p_bytes);
@@ -193,7 +439,7 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 
 	uint8_t *mem = (uint8_t *)p_ptr;
 
-#ifdef DEBUG_ENABLED
+#ifdef MEMORY_ALWAYS_PREPAD
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -202,16 +448,21 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 	if (prepad) {
 		mem -= DATA_OFFSET;
 
+#if defined(DEBUG_ENABLED) || defined(MEMORY_TAGS_ENABLED)
+		uint64_t header = *(uint64_t *)(mem + SIZE_OFFSET);
+#endif
 #ifdef DEBUG_ENABLED
-		uint64_t *s = (uint64_t *)(mem + SIZE_OFFSET);
-		_current_mem_usage.sub(*s);
+		_current_mem_usage.sub(_get_header_size(header));
+#endif
+#ifdef MEMORY_TAGS_ENABLED
+		_tag_free(header >> TAG_SHIFT, _get_header_size(header));
 #endif
 
 		GodotProfileFree(mem);
-		free(mem);
+		_free_block(mem);
 	} else {
 		GodotProfileFree(mem);
-		free(mem);
+		_free_block(mem);
 	}
 }
 
@@ -235,6 +486,74 @@ uint64_t Memory::get_mem_max_usage() {
 #endif
 }
 
+bool Memory::is_tagging_enabled() {
+#ifdef MEMORY_TAGS_ENABLED
+	return true;
+#else
+	return false;
+#endif
+}
+
+Memory::Tag Memory::get_tag(const char *p_name) {
+#ifdef MEMORY_TAGS_ENABLED
+	ERR_FAIL_NULL_V(p_name, TAG_UNTAGGED);
+	Tag tag;
+	if (likely(_find_site(p_name, tag))) {
+		return tag;
+	}
+	return _register_tag(p_name);
+#else
+	return TAG_UNTAGGED;
+#endif
+}
+
+Memory::Tag Memory::get_thread_tag() {
+#ifdef MEMORY_TAGS_ENABLED
+	return _thread_tag;
+#else
+	return TAG_UNTAGGED;
+#endif
+}
+
+void Memory::set_thread_tag(Tag p_tag) {
+#ifdef MEMORY_TAGS_ENABLED
+	DEV_ASSERT(p_tag < _tag_count.load(std::memory_order_relaxed));
+	_thread_tag = p_tag;
+#endif
+}
+
+uint32_t Memory::get_tag_count() {
+#ifdef MEMORY_TAGS_ENABLED
+	return _tag_count.load(std::memory_order_acquire);
+#else
+	return 0;
+#endif
+}
+
+const char *Memory::get_tag_name(Tag p_tag) {
+#ifdef MEMORY_TAGS_ENABLED
+	if (p_tag == TAG_UNTAGGED) {
+		return "untagged";
+	}
+	ERR_FAIL_COND_V(p_tag >= _tag_count.load(std::memory_order_acquire), nullptr);
+	return _tags[p_tag].name;
+#else
+	return nullptr;
+#endif
+}
+
+Memory::TagUsage Memory::get_tag_usage(Tag p_tag) {
+	TagUsage usage;
+#ifdef MEMORY_TAGS_ENABLED
+	ERR_FAIL_COND_V(p_tag >= _tag_count.load(std::memory_order_acquire), usage);
+	const TagData &data = _tags[p_tag];
+	usage.live_bytes = data.live_bytes.load(std::memory_order_relaxed);
+	usage.live_blocks = data.live_blocks.load(std::memory_order_relaxed);
+	usage.allocations = data.allocations.load(std::memory_order_relaxed);
+#endif
+	return usage;
+}
+
 _GlobalNil::_GlobalNil() {
 	left = this;
 	right = this;
@@ -96,8 +96,53 @@ void free_aligned_static(void *p_memory);
 uint64_t get_mem_available();
 uint64_t get_mem_usage();
 uint64_t get_mem_max_usage();
+
+// Allocation tags, tracked only when built with `memory_tags=yes` (otherwise
+// every query below returns zero). Each block remembers the tag that was
+// current when it was allocated: the innermost MemoryTagScope of the
+// allocating thread or, for memnew() outside of any scope, the file and line
+// of the call. Tag names are not copied and must stay valid for the lifetime
+// of the process, which in practice means string literals.
+typedef uint16_t Tag;
+inline constexpr Tag TAG_UNTAGGED = 0;
+inline constexpr uint32_t MAX_TAGS = 4096;
+
+struct TagUsage {
+	uint64_t live_bytes = 0;
+	uint64_t live_blocks = 0;
+	uint64_t allocations = 0; // Since startup, including freed blocks.
+};
+
+bool is_tagging_enabled();
+// Registers the tag on first use. Returns TAG_UNTAGGED once MAX_TAGS is reached.
+Tag get_tag(const char *p_name);
+Tag get_thread_tag();
+void set_thread_tag(Tag p_tag);
+uint32_t get_tag_count();
+const char *get_tag_name(Tag p_tag);
+TagUsage get_tag_usage(Tag p_tag);
 }; //namespace Memory
 
+// Attributes allocations made by the current thread to p_tag until the end of the scope.
+class MemoryTagScope {
+	Memory::Tag previous;
+
+public:
+	_FORCE_INLINE_ explicit MemoryTagScope(Memory::Tag p_tag) {
+		previous = Memory::get_thread_tag();
+		Memory::set_thread_tag(p_tag);
+	}
+	_FORCE_INLINE_ ~MemoryTagScope() { Memory::set_thread_tag(previous); }
+};
+
+#ifdef MEMORY_TAGS_ENABLED
+#define MEMORY_TAG_SCOPE(m_name)                                          \
+	static const Memory::Tag _memory_scope_tag = Memory::get_tag(m_name); \
+	MemoryTagScope _memory_scope(_memory_scope_tag)
+#else
+#define MEMORY_TAG_SCOPE(m_name)
+#endif
+
 class DefaultAllocator {
 public:
 	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return Memory::alloc_static(p_memory, false); }
@@ -134,7 +179,12 @@ _ALWAYS_INLINE_ T *_post_initialize(T *p_obj) {
 	return p_obj;
 }
 
+#ifdef MEMORY_TAGS_ENABLED
+// The description becomes the allocation tag.
+#define memnew(m_class) _post_initialize(::new (__FILE__ ":" _MKSTR(__LINE__)) m_class)
+#else
 #define memnew(m_class) _post_initialize(::new ("") m_class)
+#endif
 
 #define memnew_allocator(m_class, m_allocator) _post_initialize(::new (m_allocator::alloc) m_class)
 #define memnew_placement(m_placement, m_class) _post_initialize(::new (m_placement) m_class)
@@ -0,0 +1,371 @@
+/**************************************************************************/
+/*  small_allocator.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "small_allocator.h"
+
+#include "core/os/spin_lock.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace SmallAllocator {
+
+// Block sizes are multiples of 16, so blocks stay aligned for any type.
+static constexpr uint32_t BLOCK_SIZES[SIZE_CLASS_COUNT] = {
+	16, 32, 48, 64, 80, 96, 112, 128,
+	160, 192, 224, 256,
+	320, 384, 448, 512,
+	640, 768, 896, 1024
+};
+static constexpr size_t GRANULE = 16;
+static constexpr size_t SLAB_HEADER_SIZE = 64;
+static constexpr size_t ARENA_SIZE = SLAB_SIZE * SLABS_PER_ARENA;
+
+static_assert(BLOCK_SIZES[SIZE_CLASS_COUNT - 1] == MAX_SIZE);
+static_assert(SLAB_HEADER_SIZE % GRANULE == 0);
+
+struct Heap;
+
+struct Slab {
+	Heap *heap = nullptr;
+	uint32_t size_class = 0;
+	uint32_t block_size = 0;
+};
+static_assert(sizeof(Slab) <= SLAB_HEADER_SIZE);
+
+// Counters are only written by the thread owning the heap, so they don't need
+// read-modify-write operations; they are atomic so other threads can read them.
+struct Counter {
+	std::atomic<uint64_t> value = 0;
+
+	_FORCE_INLINE_ void increment() { value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+	_FORCE_INLINE_ uint64_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+struct Heap {
+	struct SizeClass {
+		void *free_list = nullptr;
+		uint8_t *bump = nullptr; // Not yet used part of the newest slab.
+		uint8_t *bump_end = nullptr;
+		std::atomic<void *> remote_free = nullptr; // Blocks of this heap freed by other threads.
+		Counter allocations;
+		Counter frees;
+		Counter remote_frees;
+		Counter slabs;
+	};
+
+	SizeClass size_classes[SIZE_CLASS_COUNT];
+	Heap *next_heap = nullptr; // All heaps, for statistics.
+	Heap *next_abandoned = nullptr;
+};
+
+// Size class for each number of granules.
+static constexpr uint32_t GRANULE_CLASS_COUNT = MAX_SIZE / GRANULE + 1;
+struct SizeClassTable {
+	uint8_t classes[GRANULE_CLASS_COUNT] = {};
+
+	constexpr SizeClassTable() {
+		uint32_t size_class = 0;
+		for (uint32_t i = 0; i < GRANULE_CLASS_COUNT; i++) {
+			while (BLOCK_SIZES[size_class] < i * GRANULE) {
+				size_class++;
+			}
+			classes[i] = size_class;
+		}
+	}
+};
+static constexpr SizeClassTable size_class_table;
+
+// Which 64 KiB pages of the address space hold slabs, as a two level bitmap.
+// Keeps owns() safe for pointers that didn't come from this allocator.
+static constexpr uint32_t PAGE_SHIFT = 16;
+static constexpr uint32_t LEAF_BITS = 18;
+static constexpr uint32_t ROOT_BITS = 14; // Covers 48-bit addresses.
+static constexpr uint64_t LEAF_WORDS = (1 << LEAF_BITS) / 64;
+static_assert(SLAB_SIZE == (1 << PAGE_SHIFT));
+
+static std::atomic<std::atomic<uint64_t> *> page_map[1 << ROOT_BITS] = {};
+
+static SpinLock arena_lock;
+static uint8_t *arena_next_slab = nullptr;
+static uint32_t arena_slabs_left = 0;
+static std::atomic<uint64_t> reserved_bytes = 0;
+
+static SpinLock heaps_lock;
+static Heap *all_heaps = nullptr;
+static Heap *abandoned_heaps = nullptr;
+
+static thread_local Heap *thread_heap = nullptr;
+static thread_local bool thread_heap_released = false;
+
+static bool _mark_pages(uint8_t *p_start, size_t p_size) {
+	uint64_t first = (uint64_t)(uintptr_t)p_start >> PAGE_SHIFT;
+	uint64_t last = ((uint64_t)(uintptr_t)p_start + p_size - 1) >> PAGE_SHIFT;
+	if ((last >> LEAF_BITS) >= (1 << ROOT_BITS)) {
+		return false;
+	}
+
+	for (uint64_t page = first; page <= last; page++) {
+		std::atomic<uint64_t> *leaf = page_map[page >> LEAF_BITS].load(std::memory_order_acquire);
+		if (!leaf) {
+			std::atomic<uint64_t> *new_leaf = (std::atomic<uint64_t> *)calloc(LEAF_WORDS, sizeof(std::atomic<uint64_t>));
+			if (!new_leaf) {
+				return false;
+			}
+			if (page_map[page >> LEAF_BITS].compare_exchange_strong(leaf, new_leaf, std::memory_order_acq_rel)) {
+				leaf = new_leaf;
+			} else {
+				::free(new_leaf);
+			}
+		}
+		uint64_t bit = page & ((1 << LEAF_BITS) - 1);
+		leaf[bit / 64].fetch_or(uint64_t(1) << (bit % 64), std::memory_order_release);
+	}
+	return true;
+}
+
+static Slab *_acquire_slab(Heap *p_heap, uint32_t p_size_class) {
+	uint8_t *slab_memory = nullptr;
+	{
+		arena_lock.lock();
+		if (arena_slabs_left == 0) {
+			// Over-allocate so the arena can start on a slab boundary.
+			uint8_t *arena = (uint8_t *)malloc(ARENA_SIZE + SLAB_SIZE);
+			uint8_t *aligned = arena ? (uint8_t *)(((uintptr_t)arena + SLAB_SIZE - 1) & ~(uintptr_t)(SLAB_SIZE - 1)) : nullptr;
+			if (!aligned || !_mark_pages(aligned, ARENA_SIZE)) {
+				::free(arena);
+				arena_lock.unlock();
+				return nullptr;
+			}
+			reserved_bytes.fetch_add(ARENA_SIZE + SLAB_SIZE, std::memory_order_relaxed);
+			arena_next_slab = aligned;
+			arena_slabs_left = SLABS_PER_ARENA;
+		}
+		slab_memory = arena_next_slab;
+		arena_next_slab += SLAB_SIZE;
+		arena_slabs_left--;
+		arena_lock.unlock();
+	}
+
+	Slab *slab = new (slab_memory) Slab;
+	slab->heap = p_heap;
+	slab->size_class = p_size_class;
+	slab->block_size = BLOCK_SIZES[p_size_class];
+	return slab;
+}
+
+static void _release_thread_heap();
+
+struct ThreadHeapReleaser {
+	~ThreadHeapReleaser() { _release_thread_heap(); }
+};
+static thread_local ThreadHeapReleaser thread_heap_releaser;
+
+static Heap *_get_heap_slow() {
+	if (thread_heap_released) {
+		// Destructors of other thread-locals can still allocate and free after the
+		// heap was handed back. Taking a heap now would never release it again, so
+		// alloc() leaves these to malloc and free() treats the blocks as remote.
+		return nullptr;
+	}
+
+	Heap *heap = nullptr;
+	heaps_lock.lock();
+	if (abandoned_heaps) {
+		heap = abandoned_heaps;
+		abandoned_heaps = heap->next_abandoned;
+		heap->next_abandoned = nullptr;
+	}
+	heaps_lock.unlock();
+
+	if (!heap) {
+		void *memory = malloc(sizeof(Heap));
+		if (!memory) {
+			return nullptr;
+		}
+		heap = new (memory) Heap;
+		heaps_lock.lock();
+		heap->next_heap = all_heaps;
+		all_heaps = heap;
+		heaps_lock.unlock();
+	}
+
+	thread_heap = heap;
+	// Touch the releaser so its destructor runs when this thread exits.
+	(void)&thread_heap_releaser;
+	return heap;
+}
+
+static void _release_thread_heap() {
+	Heap *heap = thread_heap;
+	thread_heap = nullptr;
+	thread_heap_released = true;
+	if (!heap) {
+		return;
+	}
+	heaps_lock.lock();
+	heap->next_abandoned = abandoned_heaps;
+	abandoned_heaps = heap;
+	heaps_lock.unlock();
+}
+
+_FORCE_INLINE_ static Heap *_get_heap() {
+	Heap *heap = thread_heap;
+	return likely(heap) ? heap : _get_heap_slow();
+}
+
+_FORCE_INLINE_ static Slab *_get_slab(const void *p_ptr) {
+	return (Slab *)((uintptr_t)p_ptr & ~(uintptr_t)(SLAB_SIZE - 1));
+}
+
+static void *_refill(Heap *p_heap, uint32_t p_size_class) {
+	Heap::SizeClass &size_class = p_heap->size_classes[p_size_class];
+
+	// Take back everything other threads freed.
+	void *remote = size_class.remote_free.exchange(nullptr, std::memory_order_acquire);
+	if (remote) {
+		size_class.free_list = *(void **)remote;
+		return remote;
+	}
+
+	uint32_t block_size = BLOCK_SIZES[p_size_class];
+	if (size_t(size_class.bump_end - size_class.bump) < block_size) {
+		Slab *slab = _acquire_slab(p_heap, p_size_class);
+		if (!slab) {
+			return nullptr;
+		}
+		size_class.slabs.increment();
+		size_class.bump = (uint8_t *)slab + SLAB_HEADER_SIZE;
+		size_class.bump_end = (uint8_t *)slab + SLAB_SIZE;
+	}
+
+	void *block = size_class.bump;
+	size_class.bump += block_size;
+	return block;
+}
+
+void *alloc(size_t p_bytes) {
+	if (unlikely(p_bytes > MAX_SIZE)) {
+		return nullptr;
+	}
+	Heap *heap = _get_heap();
+	if (unlikely(!heap)) {
+		return nullptr;
+	}
+
+	uint32_t size_class_index = size_class_table.classes[(p_bytes + GRANULE - 1) / GRANULE];
+	Heap::SizeClass &size_class = heap->size_classes[size_class_index];
+	void *block = size_class.free_list;
+	if (likely(block)) {
+		size_class.free_list = *(void **)block;
+	} else {
+		block = _refill(heap, size_class_index);
+		if (unlikely(!block)) {
+			return nullptr;
+		}
+	}
+	size_class.allocations.increment();
+	return block;
+}
+
+void free(void *p_ptr) {
+	Slab *slab = _get_slab(p_ptr);
+	Heap *heap = _get_heap();
+
+	if (likely(slab->heap == heap)) {
+		Heap::SizeClass &size_class = heap->size_classes[slab->size_class];
+		*(void **)p_ptr = size_class.free_list;
+		size_class.free_list = p_ptr;
+		size_class.frees.increment();
+		return;
+	}
+
+	std::atomic<void *> &remote_free = slab->heap->size_classes[slab->size_class].remote_free;
+	void *head = remote_free.load(std::memory_order_relaxed);
+	do {
+		*(void **)p_ptr = head;
+	} while (!remote_free.compare_exchange_weak(head, p_ptr, std::memory_order_release, std::memory_order_relaxed));
+
+	if (heap) {
+		// Counted on the freeing thread, since the owner's counters are not ours to write.
+		heap->size_classes[slab->size_class].frees.increment();
+		heap->size_classes[slab->size_class].remote_frees.increment();
+	}
+}
+
+bool owns(const void *p_ptr) {
+	uint64_t page = (uint64_t)(uintptr_t)p_ptr >> PAGE_SHIFT;
+	if ((page >> LEAF_BITS) >= (1 << ROOT_BITS)) {
+		return false;
+	}
+	const std::atomic<uint64_t> *leaf = page_map[page >> LEAF_BITS].load(std::memory_order_acquire);
+	if (!leaf) {
+		return false;
+	}
+	uint64_t bit = page & ((1 << LEAF_BITS) - 1);
+	return leaf[bit / 64].load(std::memory_order_acquire) & (uint64_t(1) << (bit % 64));
+}
+
+size_t get_block_size(const void *p_ptr) {
+	return _get_slab(p_ptr)->block_size;
+}
+
+uint32_t get_size_class_block_size(uint32_t p_size_class) {
+	return p_size_class < SIZE_CLASS_COUNT ? BLOCK_SIZES[p_size_class] : 0;
+}
+
+SizeClassStats get_size_class_stats(uint32_t p_size_class) {
+	SizeClassStats stats;
+	if (p_size_class >= SIZE_CLASS_COUNT) {
+		return stats;
+	}
+	stats.block_size = BLOCK_SIZES[p_size_class];
+
+	heaps_lock.lock();
+	for (const Heap *heap = all_heaps; heap; heap = heap->next_heap) {
+		const Heap::SizeClass &size_class = heap->size_classes[p_size_class];
+		stats.allocations += size_class.allocations.get();
+		stats.frees += size_class.frees.get();
+		stats.remote_frees += size_class.remote_frees.get();
+		stats.slabs += size_class.slabs.get();
+	}
+	heaps_lock.unlock();
+
+	// Counters of different threads are read at slightly different times.
+	stats.blocks_in_use = stats.allocations > stats.frees ? stats.allocations - stats.frees : 0;
+	return stats;
+}
+
+uint64_t get_reserved_bytes() {
+	return reserved_bytes.load(std::memory_order_relaxed);
+}
+
+} // namespace SmallAllocator
@@ -0,0 +1,79 @@
+/**************************************************************************/
+/*  small_allocator.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/typedefs.h"
+
+// Allocator for small blocks, used by Memory::alloc_static() instead of malloc
+// when building with `small_allocator=yes` (SMALL_ALLOCATOR_ENABLED).
+//
+// Blocks are grouped in size classes. Each size class takes blocks from slabs of
+// SLAB_SIZE bytes, carved out of larger arenas. Every thread has its own heap with
+// a free list per size class, so allocating and freeing on the same thread takes
+// no lock and touches no shared state. A block freed on another thread is pushed
+// to a lock-free list of the heap that owns its slab, and that heap takes it back
+// once its own free list runs out. The heap of a finished thread is kept and
+// handed over to the next new thread.
+//
+// Memory is never returned to the system; slabs stay with the size class that
+// first used them.
+namespace SmallAllocator {
+
+inline constexpr size_t MAX_SIZE = 1024;
+inline constexpr uint32_t SIZE_CLASS_COUNT = 20;
+inline constexpr size_t SLAB_SIZE = 64 * 1024;
+inline constexpr uint32_t SLABS_PER_ARENA = 64;
+
+struct SizeClassStats {
+	uint32_t block_size = 0;
+	uint64_t allocations = 0; // Since startup.
+	uint64_t frees = 0; // Since startup.
+	uint64_t remote_frees = 0; // Frees on a thread other than the one owning the block.
+	uint64_t blocks_in_use = 0;
+	uint64_t slabs = 0;
+};
+
+// Returns nullptr if p_bytes is larger than MAX_SIZE, the system is out of memory,
+// or the calling thread is exiting and has already released its heap.
+void *alloc(size_t p_bytes);
+// p_ptr must be owned by this allocator.
+void free(void *p_ptr);
+// Whether p_ptr was returned by alloc(). Safe to call with any pointer.
+bool owns(const void *p_ptr);
+// Usable size of a block returned by alloc().
+size_t get_block_size(const void *p_ptr);
+
+uint32_t get_size_class_block_size(uint32_t p_size_class);
+// Totals over all threads. Exact once the threads using the allocator are idle.
+SizeClassStats get_size_class_stats(uint32_t p_size_class);
+uint64_t get_reserved_bytes();
+
+} // namespace SmallAllocator
@@ -236,6 +236,16 @@ void godot_init_profiler() {
 void godot_cleanup_profiler() {
 }
 
+#elif defined(GODOT_USE_BUILTIN_PROFILER)
+
+void godot_init_profiler() {
+	// Recording starts with TraceRecorder::start().
+}
+
+void godot_cleanup_profiler() {
+	TraceRecorder::_free_buffers();
+}
+
 #else
 void godot_init_profiler() {
 	// Stub
@@ -115,7 +115,7 @@ struct PerfettoGroupedEventEnder {
 	}
 };
 
-#define GodotProfileFrameMark // TODO
+#define GodotProfileFrameMark TRACE_EVENT_INSTANT("godot", "Frame")
 #define GodotProfileZone(m_zone_name) TRACE_EVENT("godot", m_zone_name);
 #define GodotProfileZoneGroupedFirst(m_group_name, m_zone_name) \
 	TRACE_EVENT_BEGIN("godot", m_zone_name);                    \
@@ -194,6 +194,28 @@ private:
 void godot_init_profiler();
 void godot_cleanup_profiler();
 
+#elif defined(GODOT_USE_BUILTIN_PROFILER)
+// Use the built-in trace recorder. Nothing is recorded until TraceRecorder::start()
+// is called (or --trace-file is passed on the command line).
+
+#include "core/profiling/trace_recorder.h"
+
+#define GodotProfileFrameMark TraceRecorder::frame_mark()
+#define GodotProfileZone(m_zone_name) TraceRecorder::Zone GD_UNIQUE_NAME(__godot_trace_zone_)(m_zone_name)
+#define GodotProfileZoneGroupedFirst(m_group_name, m_zone_name) TraceRecorder::Zone __godot_trace_zone_##m_group_name(m_zone_name)
+#define GodotProfileZoneGroupedEndEarly(m_group_name, m_zone_name) __godot_trace_zone_##m_group_name.end()
+#define GodotProfileZoneGrouped(m_group_name, m_zone_name) __godot_trace_zone_##m_group_name.restart(m_zone_name)
+
+// Script zones have dynamic names, which the ring buffers don't store.
+#define GodotProfileZoneScript(m_ptr, m_file, m_function, m_name, m_line)
+#define GodotProfileZoneScriptSystemCall(m_ptr, m_file, m_function, m_name, m_line)
+
+#define GodotProfileAlloc(m_ptr, m_size)
+#define GodotProfileFree(m_ptr)
+
+void godot_init_profiler();
+void godot_cleanup_profiler();
+
 #else
 // No profiling; all macros are stubs.
 
@@ -13,6 +13,8 @@ def profiler_gen_builder(target, source, env):
                 file.write("#define GODOT_PROFILER_TRACK_MEMORY\n")
         if env["profiler"] == "perfetto":
             file.write("#define GODOT_USE_PERFETTO\n")
+        if env["profiler"] == "builtin":
+            file.write("#define GODOT_USE_BUILTIN_PROFILER\n")
         if env["profiler"] == "instruments":
             file.write("#define GODOT_USE_INSTRUMENTS\n")
             if env["profiler_sample_callstack"]:
@@ -0,0 +1,241 @@
+/**************************************************************************/
+/*  trace_recorder.cpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "trace_recorder.h"
+
+#include "core/io/file_access.h"
+#include "core/os/mutex.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/string/string_builder.h"
+#include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
+
+#include <chrono>
+
+struct TraceEvent {
+	const char *name = nullptr;
+	uint64_t begin = 0;
+	uint64_t end = 0; // INSTANT_EVENT for frame marks.
+	Thread::ID thread = 0;
+};
+
+static constexpr uint64_t INSTANT_EVENT = UINT64_MAX;
+
+// Written only by the owning thread. Readers copy a range and then drop the
+// events that may have been overwritten while copying.
+struct ThreadBuffer {
+	TraceEvent events[TraceRecorder::EVENTS_PER_THREAD];
+	std::atomic<uint64_t> write_index = { 0 };
+	// Cleared when the owning thread exits, so a new thread can take over the buffer.
+	std::atomic<bool> in_use = { true };
+	// Set when the buffers are freed while the owning thread still runs, the owner frees it on exit instead.
+	// Guarded by buffers_mutex.
+	bool orphaned = false;
+	ThreadBuffer *next = nullptr;
+};
+
+static BinaryMutex buffers_mutex;
+static ThreadBuffer *buffers = nullptr;
+
+struct ThreadBufferOwner {
+	ThreadBuffer *buffer = nullptr;
+
+	~ThreadBufferOwner() {
+		if (!buffer) {
+			return;
+		}
+		MutexLock lock(buffers_mutex);
+		if (buffer->orphaned) {
+			memdelete(buffer);
+		} else {
+			buffer->in_use.store(false, std::memory_order_release);
+		}
+		buffer = nullptr;
+	}
+};
+
+static thread_local ThreadBufferOwner thread_buffer;
+
+static std::atomic<uint64_t> start_time = { 0 };
+static std::atomic<uint64_t> stop_time = { UINT64_MAX };
+
+static ThreadBuffer *_get_thread_buffer() {
+	if (likely(thread_buffer.buffer)) {
+		return thread_buffer.buffer;
+	}
+
+	MutexLock lock(buffers_mutex);
+	ThreadBuffer *buffer = nullptr;
+	for (ThreadBuffer *b = buffers; b; b = b->next) {
+		if (!b->in_use.load(std::memory_order_acquire)) {
+			buffer = b;
+			break;
+		}
+	}
+	if (!buffer) {
+		buffer = memnew(ThreadBuffer);
+		buffer->next = buffers;
+		buffers = buffer;
+	}
+	buffer->in_use.store(true, std::memory_order_relaxed);
+	thread_buffer.buffer = buffer;
+	return buffer;
+}
+
+static void _collect_events(LocalVector<TraceEvent> &r_events) {
+	const uint64_t from = start_time.load(std::memory_order_acquire);
+	const uint64_t to = stop_time.load(std::memory_order_acquire);
+	const uint64_t capacity = TraceRecorder::EVENTS_PER_THREAD;
+
+	LocalVector<TraceEvent> copied;
+	MutexLock lock(buffers_mutex);
+	for (const ThreadBuffer *buffer = buffers; buffer; buffer = buffer->next) {
+		const uint64_t end_index = buffer->write_index.load(std::memory_order_acquire);
+		const uint64_t begin_index = end_index > capacity ? end_index - capacity : 0;
+		copied.clear();
+		for (uint64_t i = begin_index; i < end_index; i++) {
+			copied.push_back(buffer->events[i & (capacity - 1)]);
+		}
+
+		// The owner may have wrapped around since, and may be writing the next slot right now.
+		// The fence keeps the copies above from being reordered after the index is read again.
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const uint64_t next_index = buffer->write_index.load(std::memory_order_relaxed) + 1;
+		const uint64_t valid_from = next_index > capacity ? next_index - capacity : 0;
+		for (uint64_t i = MAX(begin_index, valid_from); i < end_index; i++) {
+			const TraceEvent &event = copied[i - begin_index];
+			if (event.begin >= from && (event.end == INSTANT_EVENT ? event.begin : event.end) <= to) {
+				r_events.push_back(event);
+			}
+		}
+	}
+}
+
+static String _format_us(uint64_t p_ns) {
+	return String::num_uint64(p_ns / 1000) + "." + String::num_uint64(p_ns % 1000).pad_zeros(3);
+}
+
+template <typename F>
+static void _write_json(const F &p_write) {
+	LocalVector<TraceEvent> events;
+	_collect_events(events);
+
+	const uint64_t from = start_time.load(std::memory_order_acquire);
+	const String pid = itos(OS::get_singleton() ? OS::get_singleton()->get_process_id() : 0);
+
+	p_write("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	HashSet<Thread::ID> threads;
+	for (const TraceEvent &event : events) {
+		if (!threads.has(event.thread)) {
+			threads.insert(event.thread);
+			const String thread_name = event.thread == Thread::get_main_id() ? String("Main Thread") : vformat("Thread %d", event.thread);
+			p_write(vformat("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%s,\"tid\":%d,\"args\":{\"name\":\"%s\"}},\n", pid, event.thread, thread_name));
+		}
+		const String name = String::utf8(event.name).json_escape();
+		if (event.end == INSTANT_EVENT) {
+			p_write(vformat("{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"g\",\"pid\":%s,\"tid\":%d,\"ts\":%s},\n", name, pid, event.thread, _format_us(event.begin - from)));
+		} else {
+			p_write(vformat("{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%s,\"tid\":%d,\"ts\":%s,\"dur\":%s},\n", name, pid, event.thread, _format_us(event.begin - from), _format_us(event.end - event.begin)));
+		}
+	}
+	// Trailing commas are not allowed, so close with an empty metadata event.
+	p_write(vformat("{\"name\":\"trace_recorder\",\"ph\":\"M\",\"pid\":%s,\"args\":{}}\n]}\n", pid));
+}
+
+std::atomic<bool> TraceRecorder::recording = { false };
+
+uint64_t TraceRecorder::get_time_ns() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void TraceRecorder::_record(const char *p_name, uint64_t p_begin, uint64_t p_end) {
+	ThreadBuffer *buffer = _get_thread_buffer();
+	const uint64_t index = buffer->write_index.load(std::memory_order_relaxed);
+	TraceEvent &event = buffer->events[index & (EVENTS_PER_THREAD - 1)];
+	event.name = p_name;
+	event.begin = p_begin;
+	event.end = p_end;
+	event.thread = Thread::get_caller_id();
+	buffer->write_index.store(index + 1, std::memory_order_release);
+}
+
+void TraceRecorder::_free_buffers() {
+	recording.store(false, std::memory_order_relaxed);
+	MutexLock lock(buffers_mutex);
+	ThreadBuffer *own_buffer = thread_buffer.buffer;
+	thread_buffer.buffer = nullptr;
+	while (buffers) {
+		ThreadBuffer *next = buffers->next;
+		// Threads that are still running keep a pointer to their buffer, and may still end a zone.
+		if (buffers != own_buffer && buffers->in_use.load(std::memory_order_acquire)) {
+			buffers->orphaned = true;
+			buffers->next = nullptr;
+		} else {
+			memdelete(buffers);
+		}
+		buffers = next;
+	}
+}
+
+void TraceRecorder::start() {
+	start_time.store(get_time_ns(), std::memory_order_release);
+	stop_time.store(UINT64_MAX, std::memory_order_release);
+	recording.store(true, std::memory_order_relaxed);
+}
+
+void TraceRecorder::stop() {
+	recording.store(false, std::memory_order_relaxed);
+	stop_time.store(get_time_ns(), std::memory_order_release);
+}
+
+void TraceRecorder::frame_mark() {
+	if (is_recording()) {
+		_record("Frame", get_time_ns(), INSTANT_EVENT);
+	}
+}
+
+Error TraceRecorder::save(const String &p_path) {
+	Error err;
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(file.is_null(), err, vformat("Cannot open trace file \"%s\".", p_path));
+	_write_json([&file](const String &p_text) {
+		file->store_string(p_text);
+	});
+	return file->get_error();
+}
+
+String TraceRecorder::to_json() {
+	StringBuilder builder;
+	_write_json([&builder](const String &p_text) {
+		builder.append(p_text);
+	});
+	return builder.as_string();
+}
@@ -0,0 +1,102 @@
+/**************************************************************************/
+/*  trace_recorder.h                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/error/error_list.h"
+#include "core/typedefs.h"
+
+#include <atomic>
+
+class String;
+
+void godot_cleanup_profiler();
+
+// Self-contained trace recorder, used as the profiling backend when building
+// with `profiler=builtin` (see profiling.h). Zones and frame marks go into a
+// fixed-size ring buffer per thread, so recording never locks or allocates
+// after a thread's first event, and only the most recent EVENTS_PER_THREAD
+// events of each thread are kept. Traces are written in the Chrome trace event
+// format, which chrome://tracing and ui.perfetto.dev can open.
+class TraceRecorder {
+public:
+	static constexpr uint32_t EVENTS_PER_THREAD = 1 << 15;
+
+private:
+	static std::atomic<bool> recording;
+
+	static void _record(const char *p_name, uint64_t p_begin, uint64_t p_end);
+	// Called by godot_cleanup_profiler(). Buffers of threads that are still
+	// running are freed by those threads when they exit.
+	static void _free_buffers();
+	friend void godot_cleanup_profiler();
+
+public:
+	// Monotonic time in nanoseconds.
+	static uint64_t get_time_ns();
+
+	// Starting again discards the events of the previous recording.
+	static void start();
+	static void stop();
+	_FORCE_INLINE_ static bool is_recording() { return recording.load(std::memory_order_relaxed); }
+
+	// Writes the events recorded since start() (and before stop(), if stopped).
+	// Safe to call while recording.
+	static Error save(const String &p_path);
+	static String to_json();
+
+	static void frame_mark();
+
+	// Records the time between construction (or restart()) and destruction
+	// (or end()) as one complete event.
+	class Zone {
+		const char *name = nullptr;
+		uint64_t begin = 0;
+
+	public:
+		_FORCE_INLINE_ void end() {
+			if (name) {
+				_record(name, begin, get_time_ns());
+				name = nullptr;
+			}
+		}
+
+		_FORCE_INLINE_ void restart(const char *p_name) {
+			end();
+			if (is_recording()) {
+				name = p_name;
+				begin = get_time_ns();
+			}
+		}
+
+		_FORCE_INLINE_ explicit Zone(const char *p_name) { restart(p_name); }
+		_FORCE_INLINE_ ~Zone() { end(); }
+	};
+};
@@ -33,36 +33,206 @@
 #include "core/os/mutex.h"
 #include "core/os/os.h"
 #include "core/string/print_string.h"
-
+#include "core/templates/local_vector.h"
+#include "core/templates/paged_allocator.h"
+
+// Names are spread over independent shards by hash, each with its own lock and
+// its own growable bucket array, so threads interning unrelated names rarely
+// meet on a lock.
+//
+// Existing names are found without locking: readers announce themselves in one
+// of the shard's two `active_readers` counters, picked by the low bit of the
+// shard's `epoch`, and walk the chains through atomic links. Writers (insert,
+// removal, growth) hold the shard lock. Unlinked entries and replaced bucket
+// arrays are not freed right away. They are retired, and a writer later moves
+// them to the draining list and flips the epoch. Readers that start after the
+// flip use the other counter, so the old one only waits on readers that were
+// already running, and the draining list is freed once it reaches zero. A
+// reader that started before an entry was unlinked has then finished, and one
+// that started after can no longer reach it.
 struct StringName::Table {
-	constexpr static uint32_t TABLE_BITS = 16;
-	constexpr static uint32_t TABLE_LEN = 1 << TABLE_BITS;
-	constexpr static uint32_t TABLE_MASK = TABLE_LEN - 1;
+	constexpr static uint32_t SHARD_BITS = 6;
+	constexpr static uint32_t SHARD_COUNT = 1 << SHARD_BITS;
+	constexpr static uint32_t SHARD_MASK = SHARD_COUNT - 1;
+	// Same total as the old fixed table; shards double their buckets when their load exceeds 1.
+	constexpr static uint32_t INITIAL_SHARD_BUCKETS = (1 << 16) / SHARD_COUNT;
+
+	struct Buckets {
+		std::atomic<_Data *> *heads = nullptr;
+		uint32_t mask = 0;
+	};
+
+	// Readers load `buckets` and `epoch` and write `active_readers`; writers own the
+	// rest. Each group gets its own cache line so they don't invalidate each other.
+	struct alignas(64) Shard {
+		std::atomic<Buckets *> buckets = nullptr;
+		std::atomic<uint32_t> epoch = 0;
+
+		alignas(64) std::atomic<uint32_t> active_readers[2] = {};
+#ifdef DEV_ENABLED
+		std::atomic<uint64_t> lock_free_hits = 0;
+#endif
+
+		alignas(64) BinaryMutex mutex;
+		uint32_t count = 0;
+		LocalVector<_Data *> retired_data;
+		LocalVector<Buckets *> retired_buckets;
+		// Retired before the last epoch flip, waiting for the previous epoch's readers.
+		LocalVector<_Data *> draining_data;
+		LocalVector<Buckets *> draining_buckets;
+		PagedAllocator<_Data, false, 256> allocator;
+
+		uint64_t locked_lookups = 0;
+		uint64_t lock_contentions = 0;
+		uint64_t releases = 0;
+	};
+
+	static Shard shards[SHARD_COUNT];
+
+	_FORCE_INLINE_ static Shard &get_shard(uint32_t p_hash) { return shards[p_hash & SHARD_MASK]; }
+	_FORCE_INLINE_ static std::atomic<_Data *> &get_head(const Buckets *p_buckets, uint32_t p_hash) {
+		return p_buckets->heads[(p_hash >> SHARD_BITS) & p_buckets->mask];
+	}
+
+	static Buckets *alloc_buckets(uint32_t p_count) {
+		Buckets *buckets = memnew(Buckets);
+		buckets->heads = (std::atomic<_Data *> *)memalloc(sizeof(std::atomic<_Data *>) * p_count);
+		for (uint32_t i = 0; i < p_count; i++) {
+			memnew_placement(&buckets->heads[i], std::atomic<_Data *>(nullptr));
+		}
+		buckets->mask = p_count - 1;
+		return buckets;
+	}
+
+	static void free_buckets(Buckets *p_buckets) {
+		memfree(p_buckets->heads);
+		memdelete(p_buckets);
+	}
+
+	struct ShardLock {
+		Shard &shard;
+		explicit ShardLock(Shard &p_shard) :
+				shard(p_shard) {
+			if (!shard.mutex.try_lock()) {
+				shard.mutex.lock();
+				shard.lock_contentions++;
+			}
+		}
+		~ShardLock() { shard.mutex.unlock(); }
+	};
+
+	// Must be called with the shard locked.
+	static bool try_free_draining(Shard &p_shard) {
+		// Orders the unlinking stores before the reader check (pairs with the readers' increment).
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const uint32_t previous = (p_shard.epoch.load(std::memory_order_relaxed) - 1) & 1;
+		if (p_shard.active_readers[previous].load(std::memory_order_seq_cst) != 0) {
+			return false;
+		}
+		for (_Data *d : p_shard.draining_data) {
+			p_shard.allocator.free(d);
+		}
+		p_shard.draining_data.clear();
+		for (Buckets *b : p_shard.draining_buckets) {
+			free_buckets(b);
+		}
+		p_shard.draining_buckets.clear();
+		return true;
+	}
+
+	// Must be called with the shard locked.
+	static void reclaim(Shard &p_shard) {
+		if (!p_shard.draining_data.is_empty() || !p_shard.draining_buckets.is_empty()) {
+			if (!try_free_draining(p_shard)) {
+				return;
+			}
+		}
+		if (p_shard.retired_data.is_empty() && p_shard.retired_buckets.is_empty()) {
+			return;
+		}
+		// Swapping keeps both lists' capacity around for the next rounds.
+		SWAP(p_shard.retired_data, p_shard.draining_data);
+		SWAP(p_shard.retired_buckets, p_shard.draining_buckets);
+		p_shard.epoch.fetch_add(1, std::memory_order_seq_cst);
+		// Without concurrent readers this frees the entries right away.
+		try_free_draining(p_shard);
+	}
+
+	// Must be called with the shard locked.
+	static void grow(Shard &p_shard) {
+		Buckets *old_buckets = p_shard.buckets.load(std::memory_order_relaxed);
+		uint32_t old_count = old_buckets->mask + 1;
+		Buckets *new_buckets = alloc_buckets(old_count * 2);
+
+		// Entries are moved chain by chain, front to back. A concurrent reader may
+		// follow a moved entry into its new chain and miss the name it looks for,
+		// which only sends it to the locked path; the links never form a cycle.
+		for (uint32_t i = 0; i < old_count; i++) {
+			_Data *d = old_buckets->heads[i].load(std::memory_order_relaxed);
+			while (d) {
+				_Data *next = d->next.load(std::memory_order_relaxed);
+				std::atomic<_Data *> &head = get_head(new_buckets, d->hash);
+				d->next.store(head.load(std::memory_order_relaxed), std::memory_order_release);
+				head.store(d, std::memory_order_release);
+				d = next;
+			}
+		}
+
+		p_shard.buckets.store(new_buckets, std::memory_order_release);
+		p_shard.retired_buckets.push_back(old_buckets);
+	}
 
-	static inline _Data *table[TABLE_LEN];
-	static inline BinaryMutex mutex;
-	static inline PagedAllocator<_Data> allocator;
+	template <typename T>
+	static _Data *find_lock_free(Shard &p_shard, const T &p_name, uint32_t p_hash) {
+		// Register under an epoch that is still current after registering. Otherwise a
+		// writer may have flipped past it and only checks the other counter.
+		std::atomic<uint32_t> *readers;
+		while (true) {
+			const uint32_t epoch = p_shard.epoch.load(std::memory_order_seq_cst);
+			readers = &p_shard.active_readers[epoch & 1];
+			readers->fetch_add(1, std::memory_order_seq_cst);
+			if (likely(p_shard.epoch.load(std::memory_order_seq_cst) == epoch)) {
+				break;
+			}
+			readers->fetch_sub(1, std::memory_order_release);
+		}
+		_Data *d = get_head(p_shard.buckets.load(std::memory_order_acquire), p_hash).load(std::memory_order_acquire);
+		while (d) {
+			// An entry whose count already dropped to zero is being released and cannot be revived.
+			if (d->hash == p_hash && d->name == p_name && d->refcount.ref()) {
+				break;
+			}
+			d = d->next.load(std::memory_order_acquire);
+		}
+		readers->fetch_sub(1, std::memory_order_release);
+		return d;
+	}
 };
 
+StringName::Table::Shard StringName::Table::shards[StringName::Table::SHARD_COUNT];
+
 void StringName::setup() {
 	ERR_FAIL_COND(configured);
-	for (uint32_t i = 0; i < Table::TABLE_LEN; i++) {
-		Table::table[i] = nullptr;
+	for (uint32_t i = 0; i < Table::SHARD_COUNT; i++) {
+		Table::shards[i].buckets.store(Table::alloc_buckets(Table::INITIAL_SHARD_BUCKETS), std::memory_order_relaxed);
 	}
 	configured = true;
 }
 
 void StringName::cleanup() {
-	MutexLock lock(Table::mutex);
-
 #ifdef DEBUG_ENABLED
 	if (unlikely(debug_stringname)) {
 		Vector<_Data *> data;
-		for (uint32_t i = 0; i < Table::TABLE_LEN; i++) {
-			_Data *d = Table::table[i];
-			while (d) {
-				data.push_back(d);
-				d = d->next;
+		for (uint32_t s = 0; s < Table::SHARD_COUNT; s++) {
+			Table::Shard &shard = Table::shards[s];
+			MutexLock lock(shard.mutex);
+			const Table::Buckets *buckets = shard.buckets.load(std::memory_order_relaxed);
+			for (uint32_t i = 0; i <= buckets->mask; i++) {
+				_Data *d = buckets->heads[i].load(std::memory_order_relaxed);
+				while (d) {
+					data.push_back(d);
+					d = d->next.load(std::memory_order_relaxed);
+				}
 			}
 		}
 
@@ -85,20 +255,47 @@ void StringName::cleanup() {
 	}
 #endif
 	int lost_strings = 0;
-	for (uint32_t i = 0; i < Table::TABLE_LEN; i++) {
-		while (Table::table[i]) {
-			_Data *d = Table::table[i];
-			if (d->static_count.get() != d->refcount.get()) {
-				lost_strings++;
-
-				if (OS::get_singleton()->is_stdout_verbose()) {
-					print_line(vformat("Orphan StringName: %s (static: %d, total: %d)", d->name, d->static_count.get(), d->refcount.get()));
+	for (uint32_t s = 0; s < Table::SHARD_COUNT; s++) {
+		Table::Shard &shard = Table::shards[s];
+		MutexLock lock(shard.mutex);
+
+		Table::Buckets *buckets = shard.buckets.load(std::memory_order_relaxed);
+		for (uint32_t i = 0; i <= buckets->mask; i++) {
+			_Data *d = buckets->heads[i].load(std::memory_order_relaxed);
+			while (d) {
+				if (d->static_count.get() != d->refcount.get()) {
+					lost_strings++;
+
+					if (OS::get_singleton()->is_stdout_verbose()) {
+						print_line(vformat("Orphan StringName: %s (static: %d, total: %d)", d->name, d->static_count.get(), d->refcount.get()));
+					}
 				}
+
+				_Data *next = d->next.load(std::memory_order_relaxed);
+				shard.allocator.free(d);
+				d = next;
 			}
+		}
+		Table::free_buckets(buckets);
+		shard.buckets.store(nullptr, std::memory_order_relaxed);
+		shard.count = 0;
 
-			Table::table[i] = Table::table[i]->next;
-			Table::allocator.free(d);
+		for (_Data *d : shard.retired_data) {
+			shard.allocator.free(d);
+		}
+		shard.retired_data.reset();
+		for (_Data *d : shard.draining_data) {
+			shard.allocator.free(d);
+		}
+		shard.draining_data.reset();
+		for (Table::Buckets *b : shard.retired_buckets) {
+			Table::free_buckets(b);
+		}
+		shard.retired_buckets.reset();
+		for (Table::Buckets *b : shard.draining_buckets) {
+			Table::free_buckets(b);
 		}
+		shard.draining_buckets.reset();
 	}
 	if (lost_strings) {
 		print_verbose(vformat("StringName: %d unclaimed string names at exit.", lost_strings));
@@ -110,27 +307,110 @@ void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
-		MutexLock lock(Table::mutex);
+		Table::Shard &shard = Table::get_shard(_data->hash);
+		Table::ShardLock lock(shard);
 
 		if (CoreGlobals::leak_reporting_enabled && _data->static_count.get() > 0) {
 			ERR_PRINT("BUG: Unreferenced static string to 0: " + _data->name);
 		}
-		if (_data->prev) {
-			_data->prev->next = _data->next;
-		} else {
-			const uint32_t idx = _data->hash & Table::TABLE_MASK;
-			Table::table[idx] = _data->next;
-		}
 
-		if (_data->next) {
-			_data->next->prev = _data->prev;
+		std::atomic<_Data *> *link = &Table::get_head(shard.buckets.load(std::memory_order_relaxed), _data->hash);
+		while (link->load(std::memory_order_relaxed) != _data) {
+			link = &link->load(std::memory_order_relaxed)->next;
 		}
-		Table::allocator.free(_data);
+		// Readers currently on this entry still need its link to continue.
+		link->store(_data->next.load(std::memory_order_relaxed), std::memory_order_release);
+		shard.retired_data.push_back(_data);
+		shard.count--;
+		shard.releases++;
+		Table::reclaim(shard);
 	}
 
 	_data = nullptr;
 }
 
+template <typename T>
+StringName::_Data *StringName::_intern(const T &p_name, uint32_t p_hash, bool p_static) {
+	Table::Shard &shard = Table::get_shard(p_hash);
+
+	_Data *data = Table::find_lock_free(shard, p_name, p_hash);
+	if (data) {
+#ifdef DEV_ENABLED
+		shard.lock_free_hits.fetch_add(1, std::memory_order_relaxed);
+#endif
+	} else {
+		Table::ShardLock lock(shard);
+		shard.locked_lookups++;
+
+		// Look again: another thread may have added the name, or it may have been
+		// missed while the shard was growing.
+		std::atomic<_Data *> &head = Table::get_head(shard.buckets.load(std::memory_order_relaxed), p_hash);
+		data = head.load(std::memory_order_relaxed);
+		while (data) {
+			if (data->hash == p_hash && data->name == p_name && data->refcount.ref()) {
+				break;
+			}
+			data = data->next.load(std::memory_order_relaxed);
+		}
+
+		if (!data) {
+			data = shard.allocator.alloc();
+			data->name = p_name;
+			data->refcount.init();
+			data->static_count.set(p_static ? 1 : 0);
+			data->hash = p_hash;
+			data->next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+#ifdef DEBUG_ENABLED
+			if (unlikely(debug_stringname)) {
+				// Keep in memory, force static.
+				data->refcount.ref();
+				data->static_count.increment();
+			}
+#endif
+			// Publishes the fully initialized entry to lock-free readers.
+			head.store(data, std::memory_order_release);
+
+			shard.count++;
+			if (shard.count > shard.buckets.load(std::memory_order_relaxed)->mask + 1) {
+				Table::grow(shard);
+			}
+			Table::reclaim(shard);
+			return data;
+		}
+	}
+
+	// Exists.
+	if (p_static) {
+		data->static_count.increment();
+	}
+#ifdef DEBUG_ENABLED
+	if (unlikely(debug_stringname)) {
+		data->debug_references++;
+	}
+#endif
+	return data;
+}
+
+StringName::TableStats StringName::get_table_stats() {
+	TableStats stats;
+	stats.shards = Table::SHARD_COUNT;
+	for (uint32_t s = 0; s < Table::SHARD_COUNT; s++) {
+		Table::Shard &shard = Table::shards[s];
+		MutexLock lock(shard.mutex);
+#ifdef DEV_ENABLED
+		stats.lock_free_hits += shard.lock_free_hits.load(std::memory_order_relaxed);
+#endif
+		stats.locked_lookups += shard.locked_lookups;
+		stats.lock_contentions += shard.lock_contentions;
+		stats.releases += shard.releases;
+		stats.names += shard.count;
+		stats.retired += shard.retired_data.size() + shard.draining_data.size();
+		const Table::Buckets *buckets = shard.buckets.load(std::memory_order_relaxed);
+		stats.buckets += buckets ? buckets->mask + 1 : 0;
+	}
+	return stats;
+}
+
 uint32_t StringName::get_empty_hash() {
 	static uint32_t empty_hash = String::hash("");
 	return empty_hash;
@@ -210,52 +490,7 @@ StringName::StringName(const char *p_name, bool p_static) {
 		return; //empty, ignore
 	}
 
-	const uint32_t hash = String::hash(p_name);
-	const uint32_t idx = hash & Table::TABLE_MASK;
-
-	MutexLock lock(Table::mutex);
-	_data = Table::table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->name == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-		return;
-	}
-
-	_data = Table::allocator.alloc();
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->next = Table::table[idx];
-	_data->prev = nullptr;
-
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-	if (Table::table[idx]) {
-		Table::table[idx]->prev = _data;
-	}
-	Table::table[idx] = _data;
+	_data = _intern(p_name, String::hash(p_name), p_static);
 }
 
 StringName::StringName(const String &p_name, bool p_static) {
@@ -267,51 +502,7 @@ StringName::StringName(const String &p_name, bool p_static) {
 		return;
 	}
 
-	const uint32_t hash = p_name.hash();
-	const uint32_t idx = hash & Table::TABLE_MASK;
-
-	MutexLock lock(Table::mutex);
-	_data = Table::table[idx];
-
-	while (_data) {
-		if (_data->hash == hash && _data->name == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-		return;
-	}
-
-	_data = Table::allocator.alloc();
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->next = Table::table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-
-	if (Table::table[idx]) {
-		Table::table[idx]->prev = _data;
-	}
-	Table::table[idx] = _data;
+	_data = _intern(p_name, p_name.hash(), p_static);
 }
 
 bool operator==(const String &p_name, const StringName &p_string_name) {
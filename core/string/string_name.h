@@ -49,8 +49,9 @@ class [[nodiscard]] StringName {
 #endif
 
 		uint32_t hash = 0;
-		_Data *prev = nullptr;
-		_Data *next = nullptr;
+		// Lookups walk the bucket chains without taking the shard lock,
+		// so the links are atomic and only modified while holding it.
+		std::atomic<_Data *> next = nullptr;
 	};
 
 	_Data *_data = nullptr;
@@ -62,6 +63,8 @@ class [[nodiscard]] StringName {
 	static void setup();
 	static void cleanup();
 	static uint32_t get_empty_hash();
+	template <typename T>
+	static _Data *_intern(const T &p_name, uint32_t p_hash, bool p_static);
 	static inline bool configured = false;
 #ifdef DEBUG_ENABLED
 	struct DebugSortReferences {
@@ -186,6 +189,18 @@ public:
 #ifdef DEBUG_ENABLED
 	static void set_debug_stringnames(bool p_enable) { debug_stringname = p_enable; }
 #endif
+
+	struct TableStats {
+		uint64_t lock_free_hits = 0; // Names found without taking a shard lock. Only counted in dev builds.
+		uint64_t locked_lookups = 0; // Constructions that had to take a shard lock (new names, races with release).
+		uint64_t lock_contentions = 0; // Shard lock acquisitions that had to wait for another thread.
+		uint64_t releases = 0; // Names removed from the table.
+		uint32_t names = 0;
+		uint32_t retired = 0; // Removed names whose memory is not reclaimed yet.
+		uint32_t buckets = 0;
+		uint32_t shards = 0;
+	};
+	static TableStats get_table_stats();
 };
 
 // Zero-constructing StringName initializes _data to nullptr (and thus empty).
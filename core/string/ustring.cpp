@@ -2571,8 +2571,8 @@ done:
 #define READING_EXP 3
 #define READING_DONE 4
 
-double String::to_float(const char *p_str) {
-	return built_in_strtod<char>(p_str);
+double String::to_float(const char *p_str, const char **r_end) {
+	return built_in_strtod<char>(p_str, (char **)r_end);
 }
 
 double String::to_float(const char32_t *p_str, const char32_t **r_end) {
@@ -2745,13 +2745,13 @@ uint32_t String::hash(const char32_t *p_cstr) {
 uint32_t String::hash() const {
 	/* simple djb2 hashing */
 
-	const char32_t *chr = get_data();
+	// The length is known, so don't look for the terminator. Strings can't contain NUL, so the result is the same.
+	const char32_t *chr = ptr();
+	const int len = length();
 	uint32_t hashv = 5381;
-	uint32_t c = *chr++;
 
-	while (c) {
-		hashv = ((hashv << 5) + hashv) + c; /* hash * 33 + c */
-		c = *chr++;
+	for (int i = 0; i < len; i++) {
+		hashv = ((hashv << 5) + hashv) + chr[i]; /* hash * 33 + c */
 	}
 
 	return hashv;
@@ -2760,13 +2760,12 @@ uint32_t String::hash() const {
 uint64_t String::hash64() const {
 	/* simple djb2 hashing */
 
-	const char32_t *chr = get_data();
+	const char32_t *chr = ptr();
+	const int len = length();
 	uint64_t hashv = 5381;
-	uint64_t c = *chr++;
 
-	while (c) {
-		hashv = ((hashv << 5) + hashv) + c; /* hash * 33 + c */
-		c = *chr++;
+	for (int i = 0; i < len; i++) {
+		hashv = ((hashv << 5) + hashv) + chr[i]; /* hash * 33 + c */
 	}
 
 	return hashv;
@@ -121,6 +121,10 @@ public:
 		}
 	}
 
+	// Iterates from the most to the least recently used entry, without touching the order.
+	_FORCE_INLINE_ typename List<Pair>::ConstIterator begin() const { return _list.begin(); }
+	_FORCE_INLINE_ typename List<Pair>::ConstIterator end() const { return _list.end(); }
+
 	_FORCE_INLINE_ size_t get_capacity() const { return capacity; }
 	_FORCE_INLINE_ size_t get_size() const { return _map.size(); }
 
@@ -0,0 +1,175 @@
+/**************************************************************************/
+/*  work_stealing_queue.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/os/memory.h"
+#include "core/templates/local_vector.h"
+#include "core/typedefs.h"
+
+#include <atomic>
+
+// Chase-Lev work-stealing deque.
+// The owner thread pushes and pops at the bottom (LIFO); any other thread may
+// steal from the top (FIFO). Only push() may grow the storage. Buffers replaced
+// by growth are kept until the queue is destroyed, since a thief may still be
+// reading from them.
+// See "Correct and Efficient Work-Stealing for Weak Memory Models" (Lê et al., 2013).
+
+template <typename T>
+class WorkStealingQueue {
+	static_assert(std::atomic<T>::is_always_lock_free);
+
+	struct Buffer {
+		int64_t mask = 0;
+		std::atomic<T> *items = nullptr;
+
+		_FORCE_INLINE_ T get(int64_t p_index) const { return items[p_index & mask].load(std::memory_order_relaxed); }
+		_FORCE_INLINE_ void put(int64_t p_index, T p_value) { items[p_index & mask].store(p_value, std::memory_order_relaxed); }
+	};
+
+	// Padded instead of aligned, since the queue may live in memory from Memory::alloc_static().
+	std::atomic<int64_t> top = 0;
+	uint8_t padding[64 - sizeof(std::atomic<int64_t>)] = {};
+	std::atomic<int64_t> bottom = 0;
+	std::atomic<Buffer *> buffer = nullptr;
+	LocalVector<Buffer *> retired; // Owner only.
+
+	static Buffer *_create_buffer(int64_t p_capacity) {
+		Buffer *new_buffer = memnew(Buffer);
+		new_buffer->mask = p_capacity - 1;
+		new_buffer->items = memnew_arr(std::atomic<T>, p_capacity);
+		return new_buffer;
+	}
+
+	static void _free_buffer(Buffer *p_buffer) {
+		memdelete_arr(p_buffer->items);
+		memdelete(p_buffer);
+	}
+
+	Buffer *_grow(Buffer *p_old, int64_t p_bottom, int64_t p_top) {
+		Buffer *new_buffer = _create_buffer((p_old->mask + 1) * 2);
+		for (int64_t i = p_top; i < p_bottom; i++) {
+			new_buffer->put(i, p_old->get(i));
+		}
+		retired.push_back(p_old);
+		buffer.store(new_buffer, std::memory_order_release);
+		return new_buffer;
+	}
+
+public:
+	enum StealResult {
+		STEAL_SUCCESS,
+		STEAL_EMPTY,
+		STEAL_RETRY, // Lost a race against another thief or the owner; the queue may still have items.
+	};
+
+	// Owner only.
+	void push(T p_value) {
+		int64_t b = bottom.load(std::memory_order_relaxed);
+		int64_t t = top.load(std::memory_order_acquire);
+		Buffer *a = buffer.load(std::memory_order_relaxed);
+		if (b - t > a->mask) {
+			a = _grow(a, b, t);
+		}
+		a->put(b, p_value);
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+
+	// Owner only.
+	bool pop(T &r_value) {
+		int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+		Buffer *a = buffer.load(std::memory_order_relaxed);
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t t = top.load(std::memory_order_relaxed);
+
+		if (t > b) {
+			// Empty.
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		T value = a->get(b);
+		if (t == b) {
+			// Last item, race against thieves for it.
+			bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			bottom.store(b + 1, std::memory_order_relaxed);
+			if (!won) {
+				return false;
+			}
+		}
+		r_value = value;
+		return true;
+	}
+
+	// Any thread.
+	StealResult steal(T &r_value) {
+		int64_t t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t b = bottom.load(std::memory_order_acquire);
+		if (t >= b) {
+			return STEAL_EMPTY;
+		}
+
+		Buffer *a = buffer.load(std::memory_order_acquire);
+		T value = a->get(t);
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			return STEAL_RETRY;
+		}
+		r_value = value;
+		return STEAL_SUCCESS;
+	}
+
+	// Approximate when called concurrently with push(), pop() or steal().
+	_FORCE_INLINE_ bool is_empty() const {
+		return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+	}
+
+	_FORCE_INLINE_ uint32_t size() const {
+		int64_t count = bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_relaxed);
+		return count > 0 ? (uint32_t)count : 0;
+	}
+
+	WorkStealingQueue(uint32_t p_initial_capacity = 64) {
+		buffer.store(_create_buffer((int64_t)next_power_of_2(MAX(p_initial_capacity, 2u))), std::memory_order_relaxed);
+	}
+
+	~WorkStealingQueue() {
+		for (Buffer *old : retired) {
+			_free_buffer(old);
+		}
+		_free_buffer(buffer.load(std::memory_order_relaxed));
+	}
+
+	WorkStealingQueue(const WorkStealingQueue &) = delete;
+	WorkStealingQueue &operator=(const WorkStealingQueue &) = delete;
+};
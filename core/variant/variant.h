@@ -77,6 +77,7 @@ class TypedDictionary;
 
 struct PropertyInfo;
 struct MethodInfo;
+struct VariantBuiltInMethodInfo;
 
 typedef Vector<uint8_t> PackedByteArray;
 typedef Vector<int32_t> PackedInt32Array;
@@ -662,7 +663,18 @@ public:
 	static uint32_t get_builtin_method_hash(Variant::Type p_type, const StringName &p_method);
 	static Vector<uint32_t> get_builtin_method_compatibility_hashes(Variant::Type p_type, const StringName &p_method);
 
+	// Builtin method resolved by a call site, so calling it again skips the lookup by name.
+	// It remembers the base type it was resolved for, and is resolved again when that changes.
+	// Only use it with the method name it was first used with.
+	struct BuiltInMethodCache {
+		Type type = VARIANT_MAX;
+		const VariantBuiltInMethodInfo *method = nullptr;
+	};
+
+	static void resolve_builtin_method(Variant::Type p_type, const StringName &p_method, BuiltInMethodCache &r_cache);
+
 	void callp(const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error);
+	void callp(const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error, BuiltInMethodCache &r_cache);
 
 	template <typename... VarArgs>
 	Variant call(const StringName &p_method, VarArgs... p_args) {
@@ -681,6 +693,7 @@ public:
 	}
 
 	void call_const(const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error);
+	void call_const(const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error, BuiltInMethodCache &r_cache);
 	static void call_static(Variant::Type p_type, const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error);
 
 	static String get_call_error_text(const StringName &p_method, const Variant **p_argptrs, int p_argcount, const Callable::CallError &ce);
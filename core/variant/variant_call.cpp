@@ -1481,6 +1481,63 @@ void Variant::call_const(const StringName &p_method, const Variant **p_args, int
 	}
 }
 
+static _FORCE_INLINE_ const VariantBuiltInMethodInfo *_get_cached_builtin_method(Variant::Type p_type, const StringName &p_method, Variant::BuiltInMethodCache &r_cache) {
+	if (unlikely(r_cache.type != p_type)) {
+		// Methods are only registered at startup, so the pointer stays valid. Missing methods are cached too.
+		r_cache.method = builtin_method_info[p_type].getptr(p_method);
+		r_cache.type = p_type;
+	}
+	return r_cache.method;
+}
+
+void Variant::resolve_builtin_method(Variant::Type p_type, const StringName &p_method, BuiltInMethodCache &r_cache) {
+	ERR_FAIL_INDEX(p_type, Variant::VARIANT_MAX);
+	r_cache.type = Variant::VARIANT_MAX;
+	_get_cached_builtin_method(p_type, p_method, r_cache);
+}
+
+void Variant::callp(const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error, BuiltInMethodCache &r_cache) {
+	if (type == Variant::OBJECT) {
+		// Object methods can change at any time, so they aren't cached.
+		callp(p_method, p_args, p_argcount, r_ret, r_error);
+		return;
+	}
+
+	r_error.error = Callable::CallError::CALL_OK;
+
+	const VariantBuiltInMethodInfo *imf = _get_cached_builtin_method(type, p_method, r_cache);
+
+	if (!imf) {
+		r_error.error = Callable::CallError::CALL_ERROR_INVALID_METHOD;
+		return;
+	}
+
+	imf->call(this, p_args, p_argcount, r_ret, imf->default_arguments, r_error);
+}
+
+void Variant::call_const(const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error, BuiltInMethodCache &r_cache) {
+	if (type == Variant::OBJECT) {
+		call_const(p_method, p_args, p_argcount, r_ret, r_error);
+		return;
+	}
+
+	r_error.error = Callable::CallError::CALL_OK;
+
+	const VariantBuiltInMethodInfo *imf = _get_cached_builtin_method(type, p_method, r_cache);
+
+	if (!imf) {
+		r_error.error = Callable::CallError::CALL_ERROR_INVALID_METHOD;
+		return;
+	}
+
+	if (!imf->is_const) {
+		r_error.error = Callable::CallError::CALL_ERROR_METHOD_NOT_CONST;
+		return;
+	}
+
+	imf->call(this, p_args, p_argcount, r_ret, imf->default_arguments, r_error);
+}
+
 void Variant::call_static(Variant::Type p_type, const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error) {
 	r_error.error = Callable::CallError::CALL_OK;
 
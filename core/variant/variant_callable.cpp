@@ -79,12 +79,15 @@ int VariantCallable::get_argument_count(bool &r_is_valid) const {
 
 void VariantCallable::call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, Callable::CallError &r_call_error) const {
 	Variant v = variant;
-	v.callp(method, p_arguments, p_argcount, r_return_value, r_call_error);
+	// Use a copy, this can be called from several threads at once.
+	Variant::BuiltInMethodCache cache = method_cache;
+	v.callp(method, p_arguments, p_argcount, r_return_value, r_call_error, cache);
 }
 
 VariantCallable::VariantCallable(const Variant &p_variant, const StringName &p_method) {
 	variant = p_variant;
 	method = p_method;
+	Variant::resolve_builtin_method(variant.get_type(), method, method_cache);
 	h = variant.hash();
 	h = hash_murmur3_one_64(Variant::get_builtin_method_hash(variant.get_type(), method), h);
 }
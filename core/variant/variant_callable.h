@@ -36,6 +36,8 @@
 class VariantCallable : public CallableCustom {
 	Variant variant;
 	StringName method;
+	// The type of `variant` never changes, so this is resolved once.
+	Variant::BuiltInMethodCache method_cache;
 	uint32_t h = 0;
 
 	static bool compare_equal(const CallableCustom *p_a, const CallableCustom *p_b);
@@ -2478,6 +2478,22 @@ Transform3D MeshStorage::skeleton_bone_get_transform(RID p_skeleton, int p_bone)
 	return t;
 }
 
+void MeshStorage::skeleton_set_transforms(RID p_skeleton, const Vector<float> &p_buffer) {
+	Skeleton *skeleton = skeleton_owner.get_or_null(p_skeleton);
+
+	ERR_FAIL_NULL(skeleton);
+	ERR_FAIL_COND(skeleton->use_2d);
+	ERR_FAIL_COND(p_buffer.size() != skeleton->size * 12);
+
+	if (skeleton->size == 0) {
+		return;
+	}
+
+	memcpy(skeleton->data.ptr(), p_buffer.ptr(), p_buffer.size() * sizeof(float));
+
+	_skeleton_make_dirty(skeleton);
+}
+
 void MeshStorage::skeleton_bone_set_transform_2d(RID p_skeleton, int p_bone, const Transform2D &p_transform) {
 	Skeleton *skeleton = skeleton_owner.get_or_null(p_skeleton);
 
@@ -36,6 +36,7 @@
 #include "core/string/print_string.h"
 
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #if !defined(__FreeBSD__) && !defined(__OpenBSD__) && !defined(__NetBSD__) && !defined(WEB_ENABLED)
@@ -204,6 +205,12 @@ void FileAccessUnix::_close() {
 		return;
 	}
 
+	if (mapped_data) {
+		munmap((void *)mapped_data, mapped_size);
+		mapped_data = nullptr;
+		mapped_size = 0;
+	}
+
 	fclose(f);
 	f = nullptr;
 
@@ -309,6 +316,35 @@ uint64_t FileAccessUnix::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	return read;
 }
 
+Span<uint8_t> FileAccessUnix::map_read_only() {
+	ERR_FAIL_NULL_V_MSG(f, Span<uint8_t>(), "File must be opened before use.");
+
+	if (mapped_data) {
+		return Span<uint8_t>(mapped_data, mapped_size);
+	}
+#ifdef WEB_ENABLED
+	// The Emscripten implementation copies the file into the heap, which is what mapping is meant to avoid.
+	return Span<uint8_t>();
+#else
+	if (flags != READ) {
+		return Span<uint8_t>();
+	}
+
+	struct stat st = {};
+	if (fstat(fileno(f), &st) != 0 || st.st_size <= 0 || (uint64_t)st.st_size > SIZE_MAX) {
+		return Span<uint8_t>();
+	}
+	void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+	if (data == MAP_FAILED) {
+		return Span<uint8_t>();
+	}
+
+	mapped_data = (const uint8_t *)data;
+	mapped_size = st.st_size;
+	return Span<uint8_t>(mapped_data, mapped_size);
+#endif
+}
+
 Error FileAccessUnix::get_error() const {
 	return last_error;
 }
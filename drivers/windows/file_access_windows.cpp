@@ -238,6 +238,12 @@ void FileAccessWindows::_close() {
 		return;
 	}
 
+	if (mapped_data) {
+		UnmapViewOfFile(mapped_data);
+		mapped_data = nullptr;
+		mapped_size = 0;
+	}
+
 	fclose(f);
 	f = nullptr;
 
@@ -349,6 +355,37 @@ uint64_t FileAccessWindows::get_buffer(uint8_t *p_dst, uint64_t p_length) const
 	return read;
 }
 
+Span<uint8_t> FileAccessWindows::map_read_only() {
+	ERR_FAIL_NULL_V_MSG(f, Span<uint8_t>(), "File must be opened before use.");
+
+	if (mapped_data) {
+		return Span<uint8_t>(mapped_data, mapped_size);
+	}
+	if (flags != READ) {
+		return Span<uint8_t>();
+	}
+
+	HANDLE file_handle = (HANDLE)_get_osfhandle(_fileno(f));
+	LARGE_INTEGER size;
+	if (file_handle == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_handle, &size) || size.QuadPart <= 0 || (uint64_t)size.QuadPart > SIZE_MAX) {
+		return Span<uint8_t>();
+	}
+	HANDLE mapping = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping) {
+		return Span<uint8_t>();
+	}
+	// The view keeps the mapping object alive.
+	void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!data) {
+		return Span<uint8_t>();
+	}
+
+	mapped_data = (const uint8_t *)data;
+	mapped_size = size.QuadPart;
+	return Span<uint8_t>(mapped_data, mapped_size);
+}
+
 Error FileAccessWindows::get_error() const {
 	return last_error;
 }
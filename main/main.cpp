@@ -277,6 +277,9 @@ static int fixed_fps = -1;
 static MovieWriter *movie_writer = nullptr;
 static bool disable_vsync = false;
 static bool print_fps = false;
+#ifdef GODOT_USE_BUILTIN_PROFILER
+static String trace_file;
+#endif
 #ifdef TOOLS_ENABLED
 static bool editor_pseudolocalization = false;
 static bool dump_gdextension_interface = false;
@@ -672,6 +675,9 @@ void Main::print_help(const char *p_binary) {
 	print_help_option("--fixed-fps <fps>", "Force a fixed number of frames per second. This setting disables real-time synchronization.\n");
 	print_help_option("--delta-smoothing <enable>", "Enable or disable frame delta smoothing [\"enable\", \"disable\"].\n");
 	print_help_option("--print-fps", "Print the frames per second to the stdout.\n");
+#ifdef GODOT_USE_BUILTIN_PROFILER
+	print_help_option("--trace-file <file>", "Record profiling zones from startup and write them to <file> as Chrome trace event JSON when the engine quits.\n");
+#endif
 #ifdef TOOLS_ENABLED
 	print_help_option("--editor-pseudolocalization", "Enable pseudolocalization for the editor and the project manager.\n", CLI_OPTION_AVAILABILITY_EDITOR);
 #endif
@@ -1895,6 +1901,17 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 			disable_vsync = true;
 		} else if (arg == "--print-fps") {
 			print_fps = true;
+#ifdef GODOT_USE_BUILTIN_PROFILER
+		} else if (arg == "--trace-file") {
+			if (N) {
+				trace_file = N->get();
+				N = N->next();
+				TraceRecorder::start();
+			} else {
+				OS::get_singleton()->print("Missing trace-file argument, aborting.\n");
+				goto error;
+			}
+#endif
 #ifdef TOOLS_ENABLED
 		} else if (arg == "--editor-pseudolocalization") {
 			editor_pseudolocalization = true;
@@ -5055,6 +5072,13 @@ void Main::cleanup(bool p_force) {
 		ERR_FAIL_COND(!_start_success);
 	}
 
+#ifdef GODOT_USE_BUILTIN_PROFILER
+	if (!trace_file.is_empty()) {
+		TraceRecorder::stop();
+		TraceRecorder::save(trace_file);
+	}
+#endif
+
 #ifdef DEBUG_ENABLED
 	if (input) {
 		input->flush_frame_parsed_events();
@@ -38,6 +38,10 @@
 #include "servers/audio/audio_server.h"
 #include "servers/rendering/rendering_server.h"
 
+#ifdef SMALL_ALLOCATOR_ENABLED
+#include "core/os/small_allocator.h"
+#endif // SMALL_ALLOCATOR_ENABLED
+
 #ifndef NAVIGATION_2D_DISABLED
 #include "servers/navigation_2d/navigation_server_2d.h"
 #endif // NAVIGATION_2D_DISABLED
@@ -601,12 +605,43 @@ uint64_t Performance::get_monitor_modification_time() {
 	return _monitor_modification_time;
 }
 
+#ifdef SMALL_ALLOCATOR_ENABLED
+void Performance::_add_small_allocator_monitors() {
+	for (uint32_t i = 0; i < SmallAllocator::SIZE_CLASS_COUNT; i++) {
+		add_custom_monitor(vformat("SmallAllocator/%d B blocks", SmallAllocator::get_size_class_block_size(i)), callable_mp(this, &Performance::_get_small_allocator_bytes_in_use), varray(i), MONITOR_TYPE_MEMORY);
+	}
+	add_custom_monitor("SmallAllocator/Remote Frees", callable_mp(this, &Performance::_get_small_allocator_remote_frees), Vector<Variant>());
+	add_custom_monitor("SmallAllocator/Reserved", callable_mp(this, &Performance::_get_small_allocator_reserved_bytes), Vector<Variant>(), MONITOR_TYPE_MEMORY);
+}
+
+uint64_t Performance::_get_small_allocator_bytes_in_use(uint32_t p_size_class) const {
+	SmallAllocator::SizeClassStats stats = SmallAllocator::get_size_class_stats(p_size_class);
+	return stats.blocks_in_use * stats.block_size;
+}
+
+uint64_t Performance::_get_small_allocator_remote_frees() const {
+	uint64_t remote_frees = 0;
+	for (uint32_t i = 0; i < SmallAllocator::SIZE_CLASS_COUNT; i++) {
+		remote_frees += SmallAllocator::get_size_class_stats(i).remote_frees;
+	}
+	return remote_frees;
+}
+
+uint64_t Performance::_get_small_allocator_reserved_bytes() const {
+	return SmallAllocator::get_reserved_bytes();
+}
+#endif // SMALL_ALLOCATOR_ENABLED
+
 Performance::Performance() {
 	_process_time = 0;
 	_physics_process_time = 0;
 	_navigation_process_time = 0;
 	_monitor_modification_time = 0;
 	singleton = this;
+
+#ifdef SMALL_ALLOCATOR_ENABLED
+	_add_small_allocator_monitors();
+#endif
 }
 
 Performance::MonitorCall::MonitorCall(Performance::MonitorType p_type, const Callable &p_callable, const Vector<Variant> &p_arguments) {
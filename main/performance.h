@@ -53,6 +53,13 @@ class Performance : public Object {
 	int _get_node_count() const;
 	int _get_orphan_node_count() const;
 
+#ifdef SMALL_ALLOCATOR_ENABLED
+	void _add_small_allocator_monitors();
+	uint64_t _get_small_allocator_bytes_in_use(uint32_t p_size_class) const;
+	uint64_t _get_small_allocator_remote_frees() const;
+	uint64_t _get_small_allocator_reserved_bytes() const;
+#endif
+
 	double _process_time;
 	double _physics_process_time;
 	double _navigation_process_time;
@@ -4,6 +4,9 @@
 
 #include "character.h"
 
+#include "snapshot.h"
+#include "state_hash.h"
+
 #include "core/math/math_funcs.h"
 
 void Character::_bind_methods() {
@@ -15,59 +18,64 @@ Character::Character() {
 	set_object_type(TYPE_INTERACTABLE);
 }
 
-Character::~Character() = default;
+Character::~Character() {
+	// 派生类（例如 Monster）的成员此时已经销毁，不能再拷回
+	if (entity_store) {
+		entity_store->detach(this);
+	}
+}
 
 // ============ 生命系统 ============
 
 void Character::set_health(float p_health) {
-	health = CLAMP(p_health, 0.0f, max_health);
-	if (health <= 0 && has_state(CHARACTER_STATE_ALIVE)) {
+	_health() = CLAMP(p_health, 0.0f, _max_health());
+	if (_health() <= 0 && has_state(CHARACTER_STATE_ALIVE)) {
 		die(nullptr);
 	}
 }
 
 void Character::set_max_health(float p_max) {
-	max_health = MAX(1.0f, p_max);
-	if (health > max_health) {
-		health = max_health;
+	_max_health() = MAX(1.0f, p_max);
+	if (_health() > _max_health()) {
+		_health() = _max_health();
 	}
 }
 
 float Character::get_health_percent() const {
-	if (max_health <= 0) {
+	if (_max_health() <= 0) {
 		return 0.0f;
 	}
-	return health / max_health;
+	return _health() / _max_health();
 }
 
 // ============ 法力系统 ============
 
 void Character::set_mana(float p_mana) {
-	mana = CLAMP(p_mana, 0.0f, max_mana);
+	_mana() = CLAMP(p_mana, 0.0f, _max_mana());
 }
 
 void Character::set_max_mana(float p_max) {
-	max_mana = MAX(0.0f, p_max);
-	if (mana > max_mana) {
-		mana = max_mana;
+	_max_mana() = MAX(0.0f, p_max);
+	if (_mana() > _max_mana()) {
+		_mana() = _max_mana();
 	}
 }
 
 float Character::get_mana_percent() const {
-	if (max_mana <= 0) {
+	if (_max_mana() <= 0) {
 		return 0.0f;
 	}
-	return mana / max_mana;
+	return _mana() / _max_mana();
 }
 
 bool Character::consume_mana(float p_amount) {
 	if (p_amount <= 0) {
 		return true;
 	}
-	if (mana < p_amount) {
+	if (_mana() < p_amount) {
 		return false;
 	}
-	mana -= p_amount;
+	_mana() -= p_amount;
 	return true;
 }
 
@@ -163,10 +171,10 @@ float Character::take_damage(float p_amount, DamageType p_type, Object *p_source
 	GDVIRTUAL_CALL(_on_take_damage, actual_damage, static_cast<int>(p_type), p_source);
 
 	// 扣血
-	health = MAX(0.0f, health - actual_damage);
+	_health() = MAX(0.0f, _health() - actual_damage);
 
 	// 检查死亡
-	if (health <= 0) {
+	if (_health() <= 0) {
 		die(p_source);
 	}
 
@@ -178,9 +186,9 @@ float Character::heal(float p_amount, Object *p_source) {
 		return 0.0f;
 	}
 
-	float old_health = health;
-	health = MIN(health + p_amount, max_health);
-	float actual_heal = health - old_health;
+	float old_health = _health();
+	_health() = MIN(_health() + p_amount, _max_health());
+	float actual_heal = _health() - old_health;
 
 	if (actual_heal > 0) {
 		GDVIRTUAL_CALL(_on_heal, actual_heal, p_source);
@@ -195,7 +203,7 @@ void Character::die(Object *p_killer) {
 	}
 
 	remove_state(CHARACTER_STATE_ALIVE);
-	health = 0.0f;
+	_health() = 0.0f;
 
 	// 清除所有临时状态
 	remove_state(CHARACTER_STATE_MOVING);
@@ -211,8 +219,8 @@ void Character::respawn(float p_health_percent) {
 	}
 
 	add_state(CHARACTER_STATE_ALIVE);
-	health = max_health * CLAMP(p_health_percent, 0.1f, 1.0f);
-	mana = max_mana;
+	_health() = _max_health() * CLAMP(p_health_percent, 0.1f, 1.0f);
+	_mana() = _max_mana();
 
 	GDVIRTUAL_CALL(_on_respawn);
 }
@@ -225,13 +233,15 @@ void Character::tick(float p_delta) {
 	}
 
 	// 生命回复
-	if (health_regen > 0 && health < max_health) {
-		health = MIN(health + health_regen * p_delta, max_health);
+	float &hp = _health();
+	if (_health_regen() > 0 && hp < _max_health()) {
+		hp = MIN(hp + _health_regen() * p_delta, _max_health());
 	}
 
 	// 法力回复
-	if (mana_regen > 0 && mana < max_mana) {
-		mana = MIN(mana + mana_regen * p_delta, max_mana);
+	float &mp = _mana();
+	if (_mana_regen() > 0 && mp < _max_mana()) {
+		mp = MIN(mp + _mana_regen() * p_delta, _max_mana());
 	}
 }
 
@@ -245,14 +255,14 @@ Dictionary Character::serialize() const {
 	data["faction"] = static_cast<int>(faction);
 
 	// 生命系统
-	data["health"] = health;
-	data["max_health"] = max_health;
-	data["health_regen"] = health_regen;
+	data["health"] = _health();
+	data["max_health"] = _max_health();
+	data["health_regen"] = _health_regen();
 
 	// 法力系统
-	data["mana"] = mana;
-	data["max_mana"] = max_mana;
-	data["mana_regen"] = mana_regen;
+	data["mana"] = _mana();
+	data["max_mana"] = _max_mana();
+	data["mana_regen"] = _mana_regen();
 
 	// 基础属性
 	data["move_speed"] = move_speed;
@@ -262,7 +272,7 @@ Dictionary Character::serialize() const {
 	data["magic_resist"] = magic_resist;
 
 	// 状态和等级
-	data["state_flags"] = state_flags;
+	data["state_flags"] = _state_flags();
 	data["level"] = level;
 
 	return data;
@@ -276,14 +286,14 @@ void Character::deserialize(const Dictionary &p_data) {
 	faction = static_cast<Faction>((int)p_data.get("faction", FACTION_NEUTRAL));
 
 	// 生命系统
-	max_health = p_data.get("max_health", 100.0f);
-	health = p_data.get("health", max_health);
-	health_regen = p_data.get("health_regen", 0.0f);
+	_max_health() = p_data.get("max_health", 100.0f);
+	_health() = p_data.get("health", _max_health());
+	_health_regen() = p_data.get("health_regen", 0.0f);
 
 	// 法力系统
-	max_mana = p_data.get("max_mana", 100.0f);
-	mana = p_data.get("mana", max_mana);
-	mana_regen = p_data.get("mana_regen", 0.0f);
+	_max_mana() = p_data.get("max_mana", 100.0f);
+	_mana() = p_data.get("mana", _max_mana());
+	_mana_regen() = p_data.get("mana_regen", 0.0f);
 
 	// 基础属性
 	move_speed = p_data.get("move_speed", 5.0f);
@@ -293,6 +303,65 @@ void Character::deserialize(const Dictionary &p_data) {
 	magic_resist = p_data.get("magic_resist", 0.0f);
 
 	// 状态和等级
-	state_flags = p_data.get("state_flags", CHARACTER_STATE_ALIVE);
+	_state_flags() = p_data.get("state_flags", CHARACTER_STATE_ALIVE);
 	level = p_data.get("level", 1);
 }
+
+void Character::write_snapshot(SnapshotWriter &p_writer) const {
+	WorldObject::write_snapshot(p_writer);
+
+	p_writer.write_name(character_name);
+	p_writer.write_u8((uint8_t)faction);
+
+	p_writer.write_float(_health());
+	p_writer.write_float(_max_health());
+	p_writer.write_float(_health_regen());
+
+	p_writer.write_float(_mana());
+	p_writer.write_float(_max_mana());
+	p_writer.write_float(_mana_regen());
+
+	p_writer.write_float(move_speed);
+	p_writer.write_float(attack_damage);
+	p_writer.write_float(attack_speed);
+	p_writer.write_float(armor);
+	p_writer.write_float(magic_resist);
+
+	p_writer.write_u32(_state_flags());
+	p_writer.write_s32(level);
+}
+
+void Character::read_snapshot(SnapshotReader &p_reader) {
+	WorldObject::read_snapshot(p_reader);
+
+	character_name = p_reader.read_name();
+	faction = static_cast<Faction>(p_reader.read_enum(FACTION_MAX, FACTION_NEUTRAL));
+
+	_health() = p_reader.read_float();
+	_max_health() = p_reader.read_float();
+	_health_regen() = p_reader.read_float();
+
+	_mana() = p_reader.read_float();
+	_max_mana() = p_reader.read_float();
+	_mana_regen() = p_reader.read_float();
+
+	move_speed = p_reader.read_float();
+	attack_damage = p_reader.read_float();
+	attack_speed = p_reader.read_float();
+	armor = p_reader.read_float();
+	magic_resist = p_reader.read_float();
+
+	_state_flags() = p_reader.read_u32();
+	level = p_reader.read_s32();
+}
+
+void Character::hash_state(StateHasher &p_hasher) const {
+	WorldObject::hash_state(p_hasher);
+
+	p_hasher.add_float(_health());
+	p_hasher.add_float(_max_health());
+	p_hasher.add_float(_mana());
+	p_hasher.add_float(_max_mana());
+	p_hasher.add_u32(_state_flags());
+	p_hasher.add_s32(level);
+}
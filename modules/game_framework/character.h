@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "entity_store.h"
 #include "world_object.h"
 
 #include "core/object/gdvirtual.gen.inc"
@@ -74,6 +75,27 @@ private:
 	int32_t level = 1;
 
 protected:
+	// === 批量存储 ===
+	// 加入 EntityStore 后，生命/法力/状态以存储中的列为准，上面对应的成员变量不再使用
+	EntityStore *entity_store = nullptr;
+	uint32_t entity_index = 0;
+	friend class EntityStore;
+
+	_FORCE_INLINE_ float &_health() { return entity_store ? entity_store->health[entity_index] : health; }
+	_FORCE_INLINE_ float _health() const { return entity_store ? entity_store->health[entity_index] : health; }
+	_FORCE_INLINE_ float &_max_health() { return entity_store ? entity_store->max_health[entity_index] : max_health; }
+	_FORCE_INLINE_ float _max_health() const { return entity_store ? entity_store->max_health[entity_index] : max_health; }
+	_FORCE_INLINE_ float &_health_regen() { return entity_store ? entity_store->health_regen[entity_index] : health_regen; }
+	_FORCE_INLINE_ float _health_regen() const { return entity_store ? entity_store->health_regen[entity_index] : health_regen; }
+	_FORCE_INLINE_ float &_mana() { return entity_store ? entity_store->mana[entity_index] : mana; }
+	_FORCE_INLINE_ float _mana() const { return entity_store ? entity_store->mana[entity_index] : mana; }
+	_FORCE_INLINE_ float &_max_mana() { return entity_store ? entity_store->max_mana[entity_index] : max_mana; }
+	_FORCE_INLINE_ float _max_mana() const { return entity_store ? entity_store->max_mana[entity_index] : max_mana; }
+	_FORCE_INLINE_ float &_mana_regen() { return entity_store ? entity_store->mana_regen[entity_index] : mana_regen; }
+	_FORCE_INLINE_ float _mana_regen() const { return entity_store ? entity_store->mana_regen[entity_index] : mana_regen; }
+	_FORCE_INLINE_ uint32_t &_state_flags() { return entity_store ? entity_store->state_flags[entity_index] : state_flags; }
+	_FORCE_INLINE_ uint32_t _state_flags() const { return entity_store ? entity_store->state_flags[entity_index] : state_flags; }
+
 	static void _bind_methods();
 
 	// === 虚函数（子类重写）===
@@ -96,30 +118,30 @@ public:
 
 	// === 生命系统 ===
 	void set_health(float p_health);
-	float get_health() const { return health; }
+	float get_health() const { return _health(); }
 
 	void set_max_health(float p_max);
-	float get_max_health() const { return max_health; }
+	float get_max_health() const { return _max_health(); }
 
-	void set_health_regen(float p_regen) { health_regen = p_regen; }
-	float get_health_regen() const { return health_regen; }
+	void set_health_regen(float p_regen) { _health_regen() = p_regen; }
+	float get_health_regen() const { return _health_regen(); }
 
 	float get_health_percent() const;
-	bool is_alive() const { return has_state(CHARACTER_STATE_ALIVE) && health > 0; }
-	bool is_full_health() const { return health >= max_health; }
+	bool is_alive() const { return has_state(CHARACTER_STATE_ALIVE) && _health() > 0; }
+	bool is_full_health() const { return _health() >= _max_health(); }
 
 	// === 法力系统 ===
 	void set_mana(float p_mana);
-	float get_mana() const { return mana; }
+	float get_mana() const { return _mana(); }
 
 	void set_max_mana(float p_max);
-	float get_max_mana() const { return max_mana; }
+	float get_max_mana() const { return _max_mana(); }
 
-	void set_mana_regen(float p_regen) { mana_regen = p_regen; }
-	float get_mana_regen() const { return mana_regen; }
+	void set_mana_regen(float p_regen) { _mana_regen() = p_regen; }
+	float get_mana_regen() const { return _mana_regen(); }
 
 	float get_mana_percent() const;
-	bool has_mana(float p_amount) const { return mana >= p_amount; }
+	bool has_mana(float p_amount) const { return _mana() >= p_amount; }
 	bool consume_mana(float p_amount);
 
 	// === 基础属性 ===
@@ -139,13 +161,13 @@ public:
 	float get_magic_resist() const { return magic_resist; }
 
 	// === 状态系统 ===
-	void set_state_flags(uint32_t p_flags) { state_flags = p_flags; }
-	uint32_t get_state_flags() const { return state_flags; }
+	void set_state_flags(uint32_t p_flags) { _state_flags() = p_flags; }
+	uint32_t get_state_flags() const { return _state_flags(); }
 
-	void add_state(CharacterState p_state) { state_flags |= p_state; }
-	void remove_state(CharacterState p_state) { state_flags &= ~p_state; }
-	bool has_state(CharacterState p_state) const { return (state_flags & p_state) != 0; }
-	void clear_states() { state_flags = CHARACTER_STATE_NONE; }
+	void add_state(CharacterState p_state) { _state_flags() |= p_state; }
+	void remove_state(CharacterState p_state) { _state_flags() &= ~p_state; }
+	bool has_state(CharacterState p_state) const { return (_state_flags() & p_state) != 0; }
+	void clear_states() { _state_flags() = CHARACTER_STATE_NONE; }
 
 	// 便捷状态检查
 	bool can_move() const;
@@ -176,6 +198,9 @@ public:
 	// === 序列化 ===
 	Dictionary serialize() const override;
 	void deserialize(const Dictionary &p_data) override;
+	void write_snapshot(SnapshotWriter &p_writer) const override;
+	void read_snapshot(SnapshotReader &p_reader) override;
+	void hash_state(StateHasher &p_hasher) const override;
 };
 
 VARIANT_ENUM_CAST(CharacterState);
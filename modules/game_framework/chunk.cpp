@@ -3,9 +3,13 @@
 /**************************************************************************/
 
 #include "chunk.h"
+#include "item_definition.h"
+#include "snapshot.h"
 
 #include "core/string/print_string.h"
 #include "core/variant/variant.h"
+#include "tile_kernel.h"
+
 #include <cmath>
 
 // 预定义物品ID列表（用于随机生成）
@@ -46,9 +50,11 @@ static const char *NPC_IDS[] = {
 };
 static const int NPC_ID_COUNT = sizeof(NPC_IDS) / sizeof(NPC_IDS[0]);
 
-Chunk::Chunk(const ChunkCoord &p_coord) :
+Chunk::Chunk(const ChunkCoord &p_coord, bool p_generate) :
 		coord(p_coord), center_x(0), center_y(0) {
-	generate();
+	if (p_generate) {
+		generate();
+	}
 }
 
 void Chunk::generate() {
@@ -58,16 +64,52 @@ void Chunk::generate() {
 	center_x = rng.rand(CHUNK_SIZE);
 	center_y = rng.rand(CHUNK_SIZE);
 
-	// 计算最大可能距离（用于归一化）
-	float max_dist = std::sqrt((float)(CHUNK_SIZE * CHUNK_SIZE + CHUNK_SIZE * CHUNK_SIZE));
-
 	// 清空列表
 	cities.clear();
 	monsters.clear();
 	npcs.clear();
 
-	// 遍历每个格子生成地形
+	// 生成地形
+	generate_tiles(rng);
+
+	// 生成世界物体（使用同一个 rng 保证可重复性）
+	generate_world_objects(rng);
+	// 生成怪物
+	generate_monsters(rng);
+	// 生成 NPC
+	generate_npcs(rng);
+}
+
+// 最大可能距离（用于归一化）
+static float _get_max_tile_dist() {
+	return std::sqrt((float)(CHUNK_SIZE * CHUNK_SIZE + CHUNK_SIZE * CHUNK_SIZE));
+}
+
+void Chunk::generate_tiles(RandomPCG &rng) {
+	const RandomPCG start = rng;
+	const float max_dist = _get_max_tile_dist();
+
+	float noise[CHUNK_SIZE];
+	uint8_t row[CHUNK_SIZE];
+
 	for (int y = 0; y < CHUNK_SIZE; y++) {
+		if (unlikely(!TileKernel::fill_row_noise(rng, CHUNK_SIZE, noise))) {
+			// 本行出现了只消耗一个 rand() 的 randf()，从本行行首改用逐格实现
+			rng = TileKernel::seek_row(start, y, CHUNK_SIZE);
+			generate_tiles_scalar(rng, y);
+			return;
+		}
+
+		TileKernel::classify_row(y, CHUNK_SIZE, center_x, center_y, max_dist, noise, row);
+		tiles.set_row(y, row);
+	}
+}
+
+void Chunk::generate_tiles_scalar(RandomPCG &rng, int p_from_row) {
+	const float max_dist = _get_max_tile_dist();
+
+	// 遍历每个格子生成地形
+	for (int y = p_from_row; y < CHUNK_SIZE; y++) {
 		for (int x = 0; x < CHUNK_SIZE; x++) {
 			int dx = x - center_x;
 			int dy = y - center_y;
@@ -94,16 +136,9 @@ void Chunk::generate() {
 				type = TILE_MOUNTAIN;
 			}
 
-			tiles[y][x] = type;
+			tiles.set_tile(x, y, type);
 		}
 	}
-
-	// 生成世界物体（使用同一个 rng 保证可重复性）
-	generate_world_objects(rng);
-	// 生成怪物
-	generate_monsters(rng);
-	// 生成 NPC
-	generate_npcs(rng);
 }
 
 void Chunk::generate_world_objects(RandomPCG &rng) {
@@ -114,7 +149,7 @@ void Chunk::generate_world_objects(RandomPCG &rng) {
 	const int sample_step = 8;
 	for (int y = 0; y < CHUNK_SIZE; y += sample_step) {
 		for (int x = 0; x < CHUNK_SIZE; x += sample_step) {
-			if (tiles[y][x] == TILE_CITY) {
+			if (tiles.get_tile(x, y) == TILE_CITY) {
 				city_positions.push_back(Vector2i(x, y));
 			}
 		}
@@ -144,27 +179,27 @@ void Chunk::generate_world_objects(RandomPCG &rng) {
 		// 随机添加1-3个物品
 		int item_count = 1 + rng.rand(3);
 		for (int j = 0; j < item_count; j++) {
-			Ref<Item> item;
-			item.instantiate();
+			ItemDefinition definition;
 
 			// 随机选择物品类型
 			int item_idx = rng.rand(ITEM_COUNT);
-			item->set_item_id(StringName(ITEM_IDS[item_idx]));
-			item->set_display_name(StringName(ITEM_IDS[item_idx]));
+			definition.item_id = StringName(ITEM_IDS[item_idx]);
+			definition.display_name = definition.item_id;
 
 			// 随机数量（1-10）
 			int quantity = 1 + rng.rand(10);
-			item->set_max_stack_size(99);
-			item->set_quantity(quantity);
+			definition.max_stack_size = 99;
 
 			// 随机稀有度
-			item->set_rarity(static_cast<ItemRarity>(rng.rand(5)));
+			definition.rarity = static_cast<ItemRarity>(rng.rand(5));
 
 			// 随机类别
-			item->set_category(static_cast<ItemCategory>(rng.rand(6)));
+			definition.category = static_cast<ItemCategory>(rng.rand(6));
 
-			// 添加到容器
-			city_obj->container_add_item(item);
+			// 添加到容器（只记录定义索引和数量，不创建 Item 对象）
+			uint32_t definition_index = ItemRegistry::intern(definition);
+			city_obj->container_add_stack(definition_index, quantity);
+			ItemRegistry::release(definition_index);
 		}
 
 		// 保存城市数据
@@ -199,7 +234,7 @@ String Chunk::to_string(int preview_size) const {
 		for (int x = 0; x < preview_size; x++) {
 			int sample_x = x * step;
 			int sample_y = y * step;
-			TileType type = tiles[sample_y][sample_x];
+			TileType type = tiles.get_tile(sample_x, sample_y);
 			result += tile_chars[type];
 		}
 		result += "|\n";
@@ -253,6 +288,170 @@ String Chunk::to_string(int preview_size) const {
 	return result;
 }
 
+// ============ 持久化 ============
+
+// 位置 + 是否有实体 + 实体快照
+static void _save_spawn(SnapshotWriter &p_writer, const Vector2i &p_position, const WorldObject *p_object) {
+	p_writer.write_s32(p_position.x);
+	p_writer.write_s32(p_position.y);
+	p_writer.write_bool(p_object != nullptr);
+	if (p_object) {
+		p_object->write_snapshot(p_writer);
+	}
+}
+
+// 读取位置和实体快照，没有实体时返回 false
+static bool _load_spawn(SnapshotReader &p_reader, Vector2i &r_position) {
+	r_position.x = p_reader.read_s32();
+	r_position.y = p_reader.read_s32();
+	return p_reader.read_bool();
+}
+
+Error Chunk::save(const Ref<FileAccess> &p_file) const {
+	ERR_FAIL_COND_V(p_file.is_null(), ERR_INVALID_PARAMETER);
+
+	p_file->store_32(SAVE_MAGIC);
+	p_file->store_32(SAVE_VERSION);
+	p_file->store_32((uint32_t)coord.x);
+	p_file->store_32((uint32_t)coord.y);
+	p_file->store_32((uint32_t)center_x);
+	p_file->store_32((uint32_t)center_y);
+
+	LocalVector<uint8_t> rle = tiles.get_rle_data();
+	p_file->store_32(rle.size());
+	p_file->store_buffer(rle.ptr(), rle.size());
+
+	p_file->store_32(SnapshotWriter::VERSION);
+	SnapshotWriter writer(p_file);
+
+	p_file->store_32(cities.size());
+	for (const CityData &city : cities) {
+		_save_spawn(writer, city.position, city.world_object.ptr());
+	}
+
+	p_file->store_32(monsters.size());
+	for (const MonsterSpawnData &data : monsters) {
+		_save_spawn(writer, data.position, data.monster.ptr());
+	}
+
+	p_file->store_32(npcs.size());
+	for (const NPCSpawnData &data : npcs) {
+		_save_spawn(writer, data.position, data.npc.ptr());
+	}
+
+	return p_file->get_error();
+}
+
+// 版本 1：读取位置和实体字典，数据为空字典时返回 false
+static bool _load_spawn_dictionary(const Ref<FileAccess> &p_file, Vector2i &r_position, Dictionary &r_data) {
+	r_position.x = (int32_t)p_file->get_32();
+	r_position.y = (int32_t)p_file->get_32();
+	r_data = p_file->get_var();
+	return !r_data.is_empty();
+}
+
+static void _load_entities_dictionary(const Ref<FileAccess> &p_file, Chunk *p_chunk) {
+	Dictionary data;
+	uint32_t city_count = p_file->get_32();
+	for (uint32_t i = 0; i < city_count && !p_file->eof_reached(); i++) {
+		CityData city;
+		if (_load_spawn_dictionary(p_file, city.position, data)) {
+			city.world_object.instantiate();
+			city.world_object->deserialize(data);
+		}
+		p_chunk->cities.push_back(city);
+	}
+
+	uint32_t monster_count = p_file->get_32();
+	for (uint32_t i = 0; i < monster_count && !p_file->eof_reached(); i++) {
+		MonsterSpawnData spawn;
+		if (_load_spawn_dictionary(p_file, spawn.position, data)) {
+			spawn.monster.instantiate();
+			spawn.monster->deserialize(data);
+		}
+		p_chunk->monsters.push_back(spawn);
+	}
+
+	uint32_t npc_count = p_file->get_32();
+	for (uint32_t i = 0; i < npc_count && !p_file->eof_reached(); i++) {
+		NPCSpawnData spawn;
+		if (_load_spawn_dictionary(p_file, spawn.position, data)) {
+			spawn.npc.instantiate();
+			spawn.npc->deserialize(data);
+		}
+		p_chunk->npcs.push_back(spawn);
+	}
+}
+
+Error Chunk::load(const Ref<FileAccess> &p_file) {
+	ERR_FAIL_COND_V(p_file.is_null(), ERR_INVALID_PARAMETER);
+
+	ERR_FAIL_COND_V_MSG(p_file->get_32() != SAVE_MAGIC, ERR_FILE_UNRECOGNIZED, "Not a chunk save file.");
+	uint32_t version = p_file->get_32();
+	ERR_FAIL_COND_V_MSG(version > SAVE_VERSION, ERR_FILE_UNRECOGNIZED, vformat("Unsupported chunk save version %d.", version));
+
+	ChunkCoord saved_coord((int32_t)p_file->get_32(), (int32_t)p_file->get_32());
+	ERR_FAIL_COND_V_MSG(!(saved_coord == coord), ERR_FILE_CORRUPT, "Chunk save file belongs to a different coordinate.");
+	center_x = (int32_t)p_file->get_32();
+	center_y = (int32_t)p_file->get_32();
+
+	uint32_t rle_size = p_file->get_32();
+	ERR_FAIL_COND_V(rle_size > (uint32_t)(CHUNK_SIZE * CHUNK_SIZE), ERR_FILE_CORRUPT);
+	LocalVector<uint8_t> rle;
+	rle.resize(rle_size);
+	ERR_FAIL_COND_V(p_file->get_buffer(rle.ptr(), rle_size) != rle_size, ERR_FILE_CORRUPT);
+	ERR_FAIL_COND_V(!tiles.set_rle_data(rle.ptr(), rle_size), ERR_FILE_CORRUPT);
+	// 刚加载的区块大多会被访问，直接转为热数据
+	tiles.decompress();
+
+	cities.clear();
+	monsters.clear();
+	npcs.clear();
+
+	if (version < 2) {
+		_load_entities_dictionary(p_file, this);
+	} else {
+		uint32_t snapshot_version = p_file->get_32();
+		ERR_FAIL_COND_V_MSG(snapshot_version > SnapshotWriter::VERSION, ERR_FILE_UNRECOGNIZED, vformat("Unsupported snapshot version %d.", snapshot_version));
+		SnapshotReader reader(p_file, snapshot_version);
+
+		uint32_t city_count = p_file->get_32();
+		for (uint32_t i = 0; i < city_count && !reader.is_corrupt(); i++) {
+			CityData city;
+			if (_load_spawn(reader, city.position)) {
+				city.world_object.instantiate();
+				city.world_object->read_snapshot(reader);
+			}
+			cities.push_back(city);
+		}
+
+		uint32_t monster_count = p_file->get_32();
+		for (uint32_t i = 0; i < monster_count && !reader.is_corrupt(); i++) {
+			MonsterSpawnData spawn;
+			if (_load_spawn(reader, spawn.position)) {
+				spawn.monster.instantiate();
+				spawn.monster->read_snapshot(reader);
+			}
+			monsters.push_back(spawn);
+		}
+
+		uint32_t npc_count = p_file->get_32();
+		for (uint32_t i = 0; i < npc_count && !reader.is_corrupt(); i++) {
+			NPCSpawnData spawn;
+			if (_load_spawn(reader, spawn.position)) {
+				spawn.npc.instantiate();
+				spawn.npc->read_snapshot(reader);
+			}
+			npcs.push_back(spawn);
+		}
+
+		ERR_FAIL_COND_V_MSG(reader.is_corrupt(), ERR_FILE_CORRUPT, "Corrupt entity data in chunk save file.");
+	}
+
+	ERR_FAIL_COND_V_MSG(p_file->eof_reached(), ERR_FILE_CORRUPT, "Truncated chunk save file.");
+	return OK;
+}
+
 Ref<WorldObject> Chunk::get_city_object(int index) const {
 	ERR_FAIL_INDEX_V(index, cities.size(), Ref<WorldObject>());
 	return cities[index].world_object;
@@ -299,7 +498,7 @@ void Chunk::generate_monsters(RandomPCG &rng) {
 	const int sample_step = 16;
 	for (int y = 0; y < CHUNK_SIZE; y += sample_step) {
 		for (int x = 0; x < CHUNK_SIZE; x += sample_step) {
-			TileType type = tiles[y][x];
+			TileType type = tiles.get_tile(x, y);
 			if (type == TILE_FOREST || type == TILE_MOUNTAIN) {
 				spawn_positions.push_back(Vector2i(x, y));
 			}
@@ -329,7 +528,7 @@ void Chunk::generate_monsters(RandomPCG &rng) {
 		monster->set_spawn_position(pos);
 
 		// 随机等级（基于地形）
-		TileType terrain = tiles[pos.y][pos.x];
+		TileType terrain = tiles.get_tile(pos.x, pos.y);
 		MonsterRank rank;
 		int rank_roll = rng.rand(100);
 		if (terrain == TILE_MOUNTAIN) {
@@ -372,18 +571,20 @@ void Chunk::generate_monsters(RandomPCG &rng) {
 		// 随机添加 0-2 个物品（掉落物）
 		int item_count = rng.rand(3);
 		for (int j = 0; j < item_count; j++) {
-			Ref<Item> item;
-			item.instantiate();
+			ItemDefinition definition;
 
 			int item_idx = rng.rand(ITEM_COUNT);
-			item->set_item_id(StringName(ITEM_IDS[item_idx]));
-			item->set_display_name(StringName(ITEM_IDS[item_idx]));
-			item->set_quantity(1 + rng.rand(5));
-			item->set_max_stack_size(99);
-			item->set_rarity(static_cast<ItemRarity>(rng.rand(5)));
-			item->set_category(static_cast<ItemCategory>(rng.rand(6)));
-
-			monster->container_add_item(item);
+			definition.item_id = StringName(ITEM_IDS[item_idx]);
+			definition.display_name = definition.item_id;
+			// 数量一直是在设置堆叠上限之前赋值的，会被截断为 1；保持不变以免改变已生成的内容
+			rng.rand(5);
+			definition.max_stack_size = 99;
+			definition.rarity = static_cast<ItemRarity>(rng.rand(5));
+			definition.category = static_cast<ItemCategory>(rng.rand(6));
+
+			uint32_t definition_index = ItemRegistry::intern(definition);
+			monster->container_add_stack(definition_index, 1);
+			ItemRegistry::release(definition_index);
 		}
 
 		// 保存怪物数据
@@ -401,7 +602,7 @@ void Chunk::generate_npcs(RandomPCG &rng) {
 	const int sample_step = 12;
 	for (int y = 0; y < CHUNK_SIZE; y += sample_step) {
 		for (int x = 0; x < CHUNK_SIZE; x += sample_step) {
-			TileType type = tiles[y][x];
+			TileType type = tiles.get_tile(x, y);
 			if (type == TILE_CITY || type == TILE_TOWN || type == TILE_VILLAGE) {
 				spawn_positions.push_back(Vector2i(x, y));
 			}
@@ -430,7 +631,7 @@ void Chunk::generate_npcs(RandomPCG &rng) {
 		npc->set_spawn_position(pos);
 
 		// 根据地形设置 NPC 类型
-		TileType terrain = tiles[pos.y][pos.x];
+		TileType terrain = tiles.get_tile(pos.x, pos.y);
 		NPCType npc_type;
 		if (terrain == TILE_CITY) {
 			// 城市有更多商人和训练师
@@ -473,23 +674,25 @@ void Chunk::generate_npcs(RandomPCG &rng) {
 		// 商人随机添加 3-6 个物品，其他 NPC 0-2 个
 		int item_count = (npc_type == NPC_TYPE_MERCHANT) ? (3 + rng.rand(4)) : rng.rand(3);
 		for (int j = 0; j < item_count; j++) {
-			Ref<Item> item;
-			item.instantiate();
+			ItemDefinition definition;
 
 			int item_idx = rng.rand(ITEM_COUNT);
-			item->set_item_id(StringName(ITEM_IDS[item_idx]));
-			item->set_display_name(StringName(ITEM_IDS[item_idx]));
-			item->set_quantity(1 + rng.rand(20));
-			item->set_max_stack_size(99);
-			item->set_rarity(static_cast<ItemRarity>(rng.rand(5)));
-			item->set_category(static_cast<ItemCategory>(rng.rand(6)));
+			definition.item_id = StringName(ITEM_IDS[item_idx]);
+			definition.display_name = definition.item_id;
+			// 同怪物：数量被截断为 1
+			rng.rand(20);
+			definition.max_stack_size = 99;
+			definition.rarity = static_cast<ItemRarity>(rng.rand(5));
+			definition.category = static_cast<ItemCategory>(rng.rand(6));
 
 			// 商人物品设置价值
 			if (npc_type == NPC_TYPE_MERCHANT) {
-				item->set_base_value(10 + rng.rand(100));
+				definition.base_value = 10 + rng.rand(100);
 			}
 
-			npc->container_add_item(item);
+			uint32_t definition_index = ItemRegistry::intern(definition);
+			npc->container_add_stack(definition_index, 1);
+			ItemRegistry::release(definition_index);
 		}
 
 		// 保存 NPC 数据
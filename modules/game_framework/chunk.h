@@ -7,24 +7,13 @@
 #include "world_object.h"
 #include "monster.h"
 #include "npc.h"
+#include "tile_grid.h"
 
+#include "core/io/file_access.h"
 #include "core/math/random_pcg.h"
 #include "core/string/ustring.h"
 #include "core/templates/vector.h"
 
-// 地块类型
-enum TileType {
-	TILE_CITY,      // 城市中心
-	TILE_TOWN,      // 城镇
-	TILE_VILLAGE,   // 村庄
-	TILE_GRASSLAND, // 草原
-	TILE_FOREST,    // 树林
-	TILE_MOUNTAIN,  // 山地
-};
-
-// 区块常量
-constexpr int CHUNK_SIZE = 256;
-
 // 区块坐标
 struct ChunkCoord {
 	int32_t x;
@@ -64,7 +53,7 @@ struct NPCSpawnData {
 class Chunk {
 public:
 	ChunkCoord coord;
-	TileType tiles[CHUNK_SIZE][CHUNK_SIZE];
+	TileGrid tiles;
 	int center_x;
 	int center_y;
 
@@ -75,13 +64,29 @@ public:
 	// NPC 列表
 	Vector<NPCSpawnData> npcs;
 
-	Chunk(const ChunkCoord &p_coord);
+	// 区块存档格式
+	static constexpr uint32_t SAVE_MAGIC = 0x4B434647; // "GFCK"
+	// 版本 1：实体以字典（store_var）保存；版本 2：实体以二进制快照保存
+	static constexpr uint32_t SAVE_VERSION = 2;
+
+	// p_generate 为 false 时只创建空区块（用于从存档加载）
+	Chunk(const ChunkCoord &p_coord, bool p_generate = true);
 	void generate();
+	// 生成地形格子：按行使用 TileKernel，极小概率下回退到逐格实现
+	void generate_tiles(RandomPCG &rng);
+	// 逐格参考实现，从 p_from_row 行开始（rng 必须位于该行行首）
+	void generate_tiles_scalar(RandomPCG &rng, int p_from_row = 0);
 	void generate_world_objects(RandomPCG &rng);
 	void generate_monsters(RandomPCG &rng);
 	void generate_npcs(RandomPCG &rng);
 	String to_string(int preview_size = 32) const;
 
+	// === 持久化 ===
+	// 地形以游程编码写入，城市/怪物/NPC 以二进制快照写入（write_snapshot()/read_snapshot()），
+	// 仍可读取以字典保存的旧存档
+	Error save(const Ref<FileAccess> &p_file) const;
+	Error load(const Ref<FileAccess> &p_file);
+
 	// 获取城市数量
 	int get_city_count() const { return cities.size(); }
 	// 获取指定城市的 WorldObject
@@ -0,0 +1,178 @@
+/**************************************************************************/
+/*  chunk_mesher.cpp                                                      */
+/**************************************************************************/
+
+#include "chunk_mesher.h"
+
+#include "scene/resources/mesh.h"
+
+void ChunkMesher::build_quads(const TileGrid &p_tiles, LocalVector<Quad> &r_quads) {
+	// 两个 64 KiB 的缓冲区，放在堆上以免占用工作线程的栈
+	LocalVector<uint8_t> types;
+	types.resize(CHUNK_SIZE * CHUNK_SIZE);
+	for (int y = 0; y < CHUNK_SIZE; y++) {
+		p_tiles.get_row(y, types.ptr() + y * CHUNK_SIZE);
+	}
+
+	// 已被某个四边形覆盖的格子
+	LocalVector<uint8_t> covered;
+	covered.resize(CHUNK_SIZE * CHUNK_SIZE);
+	memset(covered.ptr(), 0, covered.size());
+
+	for (int y = 0; y < CHUNK_SIZE; y++) {
+		const uint8_t *type_row = types.ptr() + y * CHUNK_SIZE;
+		const uint8_t *covered_row = covered.ptr() + y * CHUNK_SIZE;
+		int x = 0;
+		while (x < CHUNK_SIZE) {
+			if (covered_row[x]) {
+				x++;
+				continue;
+			}
+
+			uint8_t type = type_row[x];
+			int width = 1;
+			while (x + width < CHUNK_SIZE && !covered_row[x + width] && type_row[x + width] == type) {
+				width++;
+			}
+
+			int height = 1;
+			while (y + height < CHUNK_SIZE) {
+				const uint8_t *row = types.ptr() + (y + height) * CHUNK_SIZE;
+				const uint8_t *row_covered = covered.ptr() + (y + height) * CHUNK_SIZE;
+				bool match = true;
+				for (int i = x; i < x + width; i++) {
+					if (row_covered[i] || row[i] != type) {
+						match = false;
+						break;
+					}
+				}
+				if (!match) {
+					break;
+				}
+				height++;
+			}
+
+			for (int j = y; j < y + height; j++) {
+				memset(covered.ptr() + j * CHUNK_SIZE + x, 1, width);
+			}
+
+			Quad quad;
+			quad.x = x;
+			quad.y = y;
+			quad.width = width;
+			quad.height = height;
+			quad.type = static_cast<TileType>(type);
+			r_quads.push_back(quad);
+
+			x += width;
+		}
+	}
+}
+
+Array ChunkMesher::build_surface_arrays(const LocalVector<Quad> &p_quads, float p_tile_size, const Color *p_palette) {
+	PackedVector3Array vertices;
+	PackedVector3Array normals;
+	PackedColorArray colors;
+	PackedInt32Array indices;
+	vertices.resize(p_quads.size() * 4);
+	normals.resize(p_quads.size() * 4);
+	colors.resize(p_quads.size() * 4);
+	indices.resize(p_quads.size() * 6);
+
+	Vector3 *vertex_ptr = vertices.ptrw();
+	Vector3 *normal_ptr = normals.ptrw();
+	Color *color_ptr = colors.ptrw();
+	int32_t *index_ptr = indices.ptrw();
+
+	for (uint32_t i = 0; i < p_quads.size(); i++) {
+		const Quad &quad = p_quads[i];
+		float x0 = quad.x * p_tile_size;
+		float z0 = quad.y * p_tile_size;
+		float x1 = (quad.x + quad.width) * p_tile_size;
+		float z1 = (quad.y + quad.height) * p_tile_size;
+
+		uint32_t base = i * 4;
+		vertex_ptr[base + 0] = Vector3(x0, 0, z0);
+		vertex_ptr[base + 1] = Vector3(x1, 0, z0);
+		vertex_ptr[base + 2] = Vector3(x1, 0, z1);
+		vertex_ptr[base + 3] = Vector3(x0, 0, z1);
+		for (int v = 0; v < 4; v++) {
+			normal_ptr[base + v] = Vector3(0, 1, 0);
+			color_ptr[base + v] = p_palette[quad.type];
+		}
+
+		// 从上方看为顺时针（正面）
+		int32_t *index = index_ptr + i * 6;
+		index[0] = base + 0;
+		index[1] = base + 1;
+		index[2] = base + 2;
+		index[3] = base + 0;
+		index[4] = base + 2;
+		index[5] = base + 3;
+	}
+
+	Array arrays;
+	arrays.resize(Mesh::ARRAY_MAX);
+	arrays[Mesh::ARRAY_VERTEX] = vertices;
+	arrays[Mesh::ARRAY_NORMAL] = normals;
+	arrays[Mesh::ARRAY_COLOR] = colors;
+	arrays[Mesh::ARRAY_INDEX] = indices;
+	return arrays;
+}
+
+void ChunkMesher::_build_task(Job *p_job) {
+	LocalVector<Quad> quads;
+	build_quads(p_job->tiles, quads);
+	p_job->result.arrays = build_surface_arrays(quads, p_job->tile_size, p_job->palette);
+	p_job->result.quad_count = quads.size();
+}
+
+bool ChunkMesher::request(const ChunkCoord &p_coord, const TileGrid &p_tiles, float p_tile_size, const Color *p_palette) {
+	uint64_t key = p_coord.to_seed();
+	if (jobs.has(key)) {
+		return false;
+	}
+
+	Job *job = new Job;
+	job->coord = p_coord;
+	job->tiles = p_tiles;
+	job->tile_size = p_tile_size;
+	for (int i = 0; i < TILE_TYPE_MAX; i++) {
+		job->palette[i] = p_palette[i];
+	}
+	job->result.coord = p_coord;
+	jobs[key] = job;
+	job->task_id = WorkerThreadPool::get_singleton()->add_template_task(this, &ChunkMesher::_build_task, job, false, vformat("MeshChunk:%d,%d", p_coord.x, p_coord.y));
+	return true;
+}
+
+int ChunkMesher::poll(LocalVector<Result> &r_results) {
+	LocalVector<uint64_t> finished;
+	for (const KeyValue<uint64_t, Job *> &kv : jobs) {
+		if (WorkerThreadPool::get_singleton()->is_task_completed(kv.value->task_id)) {
+			finished.push_back(kv.key);
+		}
+	}
+
+	for (uint64_t key : finished) {
+		Job *job = jobs[key];
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(job->task_id);
+		r_results.push_back(job->result);
+		jobs.erase(key);
+		delete job;
+	}
+
+	return finished.size();
+}
+
+void ChunkMesher::cancel_all() {
+	for (const KeyValue<uint64_t, Job *> &kv : jobs) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(kv.value->task_id);
+		delete kv.value;
+	}
+	jobs.clear();
+}
+
+ChunkMesher::~ChunkMesher() {
+	cancel_all();
+}
@@ -0,0 +1,213 @@
+/**************************************************************************/
+/*  entity_store.cpp                                                      */
+/**************************************************************************/
+
+#include "entity_store.h"
+
+#include "monster.h"
+#include "player.h"
+
+#include "core/object/worker_thread_pool.h"
+
+EntityStore::~EntityStore() {
+	clear();
+}
+
+uint32_t EntityStore::add(Character *p_character) {
+	ERR_FAIL_NULL_V(p_character, UINT32_MAX);
+	ERR_FAIL_COND_V_MSG(ticking, UINT32_MAX, "Cannot add entities while the store is ticking.");
+	ERR_FAIL_COND_V_MSG(p_character->entity_store != nullptr, UINT32_MAX, "Character already belongs to an entity store.");
+	// 玩家的 tick 还有额外逻辑，不能用批量更新代替
+	ERR_FAIL_COND_V_MSG(Object::cast_to<Player>(p_character) != nullptr, UINT32_MAX, "Players cannot be added to an entity store.");
+
+	uint32_t index = owners.size();
+	owners.push_back(p_character);
+
+	health.push_back(p_character->health);
+	max_health.push_back(p_character->max_health);
+	health_regen.push_back(p_character->health_regen);
+	mana.push_back(p_character->mana);
+	max_mana.push_back(p_character->max_mana);
+	mana_regen.push_back(p_character->mana_regen);
+	state_flags.push_back(p_character->state_flags);
+
+	Monster *monster = Object::cast_to<Monster>(p_character);
+	if (monster) {
+		kind.push_back(KIND_MONSTER);
+		ai_state.push_back(monster->ai_state);
+		respawn_time.push_back(monster->respawn_time);
+		death_timer.push_back(monster->death_timer);
+	} else {
+		kind.push_back(KIND_CHARACTER);
+		ai_state.push_back(0);
+		respawn_time.push_back(0.0f);
+		death_timer.push_back(0.0f);
+	}
+
+	p_character->entity_store = this;
+	p_character->entity_index = index;
+	return index;
+}
+
+void EntityStore::remove(Character *p_character) {
+	ERR_FAIL_NULL(p_character);
+	ERR_FAIL_COND_MSG(ticking, "Cannot remove entities while the store is ticking.");
+	ERR_FAIL_COND(p_character->entity_store != this);
+
+	uint32_t index = p_character->entity_index;
+
+	// 拷回对象自身的成员
+	p_character->health = health[index];
+	p_character->max_health = max_health[index];
+	p_character->health_regen = health_regen[index];
+	p_character->mana = mana[index];
+	p_character->max_mana = max_mana[index];
+	p_character->mana_regen = mana_regen[index];
+	p_character->state_flags = state_flags[index];
+	if (kind[index] == KIND_MONSTER) {
+		Monster *monster = static_cast<Monster *>(p_character);
+		monster->ai_state = static_cast<MonsterAIState>(ai_state[index]);
+		monster->respawn_time = respawn_time[index];
+		monster->death_timer = death_timer[index];
+	}
+	p_character->entity_store = nullptr;
+	p_character->entity_index = 0;
+
+	_remove_row(index);
+}
+
+void EntityStore::detach(Character *p_character) {
+	ERR_FAIL_NULL(p_character);
+	ERR_FAIL_COND_MSG(ticking, "Cannot remove entities while the store is ticking.");
+	ERR_FAIL_COND(p_character->entity_store != this);
+
+	uint32_t index = p_character->entity_index;
+	p_character->entity_store = nullptr;
+	p_character->entity_index = 0;
+
+	_remove_row(index);
+}
+
+bool EntityStore::has(const Character *p_character) const {
+	return p_character && p_character->entity_store == this;
+}
+
+void EntityStore::_remove_row(uint32_t p_index) {
+	// 最后一个实体移入空位
+	uint32_t index = p_index;
+	uint32_t last = owners.size() - 1;
+	if (index != last) {
+		owners[index] = owners[last];
+		health[index] = health[last];
+		max_health[index] = max_health[last];
+		health_regen[index] = health_regen[last];
+		mana[index] = mana[last];
+		max_mana[index] = max_mana[last];
+		mana_regen[index] = mana_regen[last];
+		state_flags[index] = state_flags[last];
+		kind[index] = kind[last];
+		ai_state[index] = ai_state[last];
+		respawn_time[index] = respawn_time[last];
+		death_timer[index] = death_timer[last];
+		owners[index]->entity_index = index;
+	}
+
+	owners.resize(last);
+	health.resize(last);
+	max_health.resize(last);
+	health_regen.resize(last);
+	mana.resize(last);
+	max_mana.resize(last);
+	mana_regen.resize(last);
+	state_flags.resize(last);
+	kind.resize(last);
+	ai_state.resize(last);
+	respawn_time.resize(last);
+	death_timer.resize(last);
+}
+
+void EntityStore::clear() {
+	while (!owners.is_empty()) {
+		remove(owners[owners.size() - 1]);
+	}
+}
+
+Character *EntityStore::get_character(uint32_t p_index) const {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_index, owners.size(), nullptr);
+	return owners[p_index];
+}
+
+void EntityStore::_tick_range(uint32_t p_from, uint32_t p_to, float p_delta, LocalVector<uint32_t> &r_respawns) {
+	// 与 Character::tick / Monster::tick 的逻辑保持一致
+	for (uint32_t i = p_from; i < p_to; i++) {
+		bool alive = (state_flags[i] & CHARACTER_STATE_ALIVE) && health[i] > 0;
+		if (!alive) {
+			if (kind[i] == KIND_MONSTER && respawn_time[i] > 0) {
+				death_timer[i] += p_delta;
+				if (death_timer[i] >= respawn_time[i]) {
+					death_timer[i] = 0.0f;
+					r_respawns.push_back(i);
+				}
+			}
+			continue;
+		}
+
+		if (health_regen[i] > 0 && health[i] < max_health[i]) {
+			health[i] = MIN(health[i] + health_regen[i] * p_delta, max_health[i]);
+		}
+		if (mana_regen[i] > 0 && mana[i] < max_mana[i]) {
+			mana[i] = MIN(mana[i] + mana_regen[i] * p_delta, max_mana[i]);
+		}
+	}
+}
+
+void EntityStore::_tick_batch(uint32_t p_batch, float p_delta) {
+	uint32_t from = p_batch * BATCH_SIZE;
+	uint32_t to = MIN(from + BATCH_SIZE, owners.size());
+	_tick_range(from, to, p_delta, batch_respawns[p_batch]);
+}
+
+void EntityStore::tick_all(float p_delta, bool p_parallel) {
+	ERR_FAIL_COND_MSG(ticking, "EntityStore::tick_all() is not reentrant.");
+
+	uint32_t count = owners.size();
+	if (count == 0) {
+		return;
+	}
+
+	uint32_t batch_count = (count + BATCH_SIZE - 1) / BATCH_SIZE;
+	batch_respawns.resize(batch_count);
+	for (LocalVector<uint32_t> &respawns : batch_respawns) {
+		respawns.clear();
+	}
+
+	// 并行阶段只读写各自批次内的列，不调用任何对象方法
+	ticking = true;
+	if (p_parallel && batch_count > 1) {
+		WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(this, &EntityStore::_tick_batch, p_delta, batch_count, -1, true, "EntityStoreTick");
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	} else {
+		for (uint32_t i = 0; i < batch_count; i++) {
+			_tick_batch(i, p_delta);
+		}
+	}
+	ticking = false;
+
+	// 重生会触发脚本回调和位置更新，在调用线程按索引顺序处理
+	// 回调中可能移除实体（例如卸载区块），索引随之失效，因此先取出对象 ID
+	LocalVector<ObjectID> respawned;
+	for (const LocalVector<uint32_t> &respawns : batch_respawns) {
+		for (uint32_t index : respawns) {
+			respawned.push_back(owners[index]->get_instance_id());
+		}
+	}
+	for (const ObjectID &id : respawned) {
+		Monster *monster = ObjectDB::get_instance<Monster>(id);
+		if (!monster) {
+			continue;
+		}
+		monster->respawn(1.0f);
+		monster->set_ai_state(MONSTER_AI_IDLE);
+		monster->set_local_position(monster->get_spawn_position());
+	}
+}
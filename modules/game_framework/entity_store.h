@@ -0,0 +1,69 @@
+/**************************************************************************/
+/*  entity_store.h                                                        */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/templates/local_vector.h"
+
+class Character;
+
+// 实体批量存储（SoA）
+// 角色加入后，生命/法力/状态（怪物还有 AI 状态和重生计时）以这里的列为准，
+// Character/Monster 对象只作为脚本和其他系统访问这些数据的视图。
+// tick_all() 对列做批量更新，可以在 WorkerThreadPool 上按批并行执行；
+// 需要调用对象逻辑的事件（例如怪物重生）在并行阶段结束后于调用线程按索引顺序处理。
+class EntityStore {
+public:
+	enum Kind : uint8_t {
+		KIND_CHARACTER,
+		KIND_MONSTER,
+	};
+
+	// 每个并行任务处理的实体数量
+	static constexpr uint32_t BATCH_SIZE = 1024;
+
+	// === SoA 列（索引即实体在存储中的位置）===
+	LocalVector<float> health;
+	LocalVector<float> max_health;
+	LocalVector<float> health_regen;
+	LocalVector<float> mana;
+	LocalVector<float> max_mana;
+	LocalVector<float> mana_regen;
+	LocalVector<uint32_t> state_flags;
+	LocalVector<uint8_t> kind;
+	// 以下列只对 KIND_MONSTER 有意义
+	LocalVector<uint8_t> ai_state;
+	LocalVector<float> respawn_time;
+	LocalVector<float> death_timer;
+
+private:
+	LocalVector<Character *> owners;
+	// 每个批次收集的重生事件，按批次顺序合并以保证处理顺序稳定
+	LocalVector<LocalVector<uint32_t>> batch_respawns;
+	bool ticking = false;
+
+	void _tick_batch(uint32_t p_batch, float p_delta);
+	// 与最后一个实体交换位置后删除该行，不访问行所属的对象
+	void _remove_row(uint32_t p_index);
+	void _tick_range(uint32_t p_from, uint32_t p_to, float p_delta, LocalVector<uint32_t> &r_respawns);
+
+public:
+	// 拷入角色当前属性并把角色切换为视图，返回索引
+	uint32_t add(Character *p_character);
+	// 拷回属性并解除视图（与最后一个实体交换位置，O(1)）
+	void remove(Character *p_character);
+	// 只解除视图、不拷回属性，供对象析构时使用（此时派生类部分已经销毁）
+	void detach(Character *p_character);
+	bool has(const Character *p_character) const;
+	void clear();
+
+	uint32_t get_size() const { return owners.size(); }
+	Character *get_character(uint32_t p_index) const;
+
+	// 批量更新所有实体，等价于对每个实体调用 tick()（不含怪物 AI，见 World::tick_entities()）
+	void tick_all(float p_delta, bool p_parallel = true);
+
+	EntityStore() {}
+	~EntityStore();
+};
@@ -7,10 +7,12 @@
 #include "core/config/engine.h"
 #include "core/string/print_string.h"
 #include "scene/3d/mesh_instance_3d.h"
+#include "scene/3d/multimesh_instance_3d.h"
 #include "scene/3d/node_3d.h"
+#include "scene/resources/3d/box_shape_3d.h"
 #include "scene/resources/3d/primitive_meshes.h"
-#include "scene/resources/image_texture.h"
 #include "scene/resources/material.h"
+#include "scene/resources/multimesh.h"
 #include "world_object_node_3d.h"
 
 GameFramework::GameFramework() {
@@ -23,6 +25,32 @@ void GameFramework::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_tile_size", "size"), &GameFramework::set_tile_size);
 	ClassDB::bind_method(D_METHOD("get_tile_size"), &GameFramework::get_tile_size);
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "tile_size", PROPERTY_HINT_RANGE, "0.1,10.0,0.1"), "set_tile_size", "get_tile_size");
+
+	ClassDB::bind_method(D_METHOD("request_chunk", "chunk_x", "chunk_y"), &GameFramework::request_chunk);
+	ClassDB::bind_method(D_METHOD("is_chunk_ready", "chunk_x", "chunk_y"), &GameFramework::is_chunk_ready);
+
+	ClassDB::bind_method(D_METHOD("update_working_set", "chunk_x", "chunk_y", "radius"), &GameFramework::update_working_set);
+
+	ClassDB::bind_method(D_METHOD("set_simulate_entities", "enabled"), &GameFramework::set_simulate_entities);
+	ClassDB::bind_method(D_METHOD("is_simulating_entities"), &GameFramework::is_simulating_entities);
+	ClassDB::bind_method(D_METHOD("tick_entities", "delta"), &GameFramework::tick_entities);
+	ClassDB::bind_method(D_METHOD("get_entity_count"), &GameFramework::get_entity_count);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "simulate_entities"), "set_simulate_entities", "is_simulating_entities");
+
+	ClassDB::bind_method(D_METHOD("add_world_object", "object"), &GameFramework::add_world_object);
+	ClassDB::bind_method(D_METHOD("remove_world_object", "object"), &GameFramework::remove_world_object);
+	ClassDB::bind_method(D_METHOD("find_objects_in_radius", "position", "radius"), &GameFramework::find_objects_in_radius);
+	ClassDB::bind_method(D_METHOD("find_objects_in_rect", "rect"), &GameFramework::find_objects_in_rect);
+	ClassDB::bind_method(D_METHOD("find_nearest_objects", "position", "count", "max_distance"), &GameFramework::find_nearest_objects, DEFVAL(Math::INF));
+
+	ClassDB::bind_method(D_METHOD("set_max_resident_chunks", "count"), &GameFramework::set_max_resident_chunks);
+	ClassDB::bind_method(D_METHOD("get_max_resident_chunks"), &GameFramework::get_max_resident_chunks);
+	ClassDB::bind_method(D_METHOD("set_chunk_save_path", "path"), &GameFramework::set_chunk_save_path);
+	ClassDB::bind_method(D_METHOD("get_chunk_save_path"), &GameFramework::get_chunk_save_path);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_resident_chunks", PROPERTY_HINT_RANGE, "1,4096,1"), "set_max_resident_chunks", "get_max_resident_chunks");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "chunk_save_path", PROPERTY_HINT_GLOBAL_DIR), "set_chunk_save_path", "get_chunk_save_path");
+
+	ADD_SIGNAL(MethodInfo("chunk_generated", PropertyInfo(Variant::INT, "chunk_x"), PropertyInfo(Variant::INT, "chunk_y")));
 }
 
 void GameFramework::_notification(int p_what) {
@@ -30,6 +58,28 @@ void GameFramework::_notification(int p_what) {
 		case NOTIFICATION_READY: {
 			_ready();
 		} break;
+		case NOTIFICATION_PROCESS: {
+			// 在主线程发布后台生成完成的区块，并释放已写出的区块
+			LocalVector<ChunkCoord> completed;
+			world.poll_chunks(&completed);
+			for (const ChunkCoord &coord : completed) {
+				emit_signal(SNAME("chunk_generated"), coord.x, coord.y);
+			}
+
+			LocalVector<ChunkMesher::Result> meshes;
+			terrain_mesher.poll(meshes);
+			for (const ChunkMesher::Result &result : meshes) {
+				apply_terrain_mesh(result);
+			}
+
+			if (simulate_entities && !Engine::get_singleton()->is_editor_hint()) {
+				world.tick_entities(get_process_delta_time());
+			}
+
+			if (!simulate_entities && world.get_pending_count() == 0 && terrain_mesher.get_pending_count() == 0) {
+				set_process(false);
+			}
+		} break;
 	}
 }
 
@@ -127,6 +177,70 @@ void GameFramework::print_all_entities(int32_t chunk_x, int32_t chunk_y) {
 	}
 }
 
+// ============ 异步区块生成 ============
+
+bool GameFramework::request_chunk(int32_t chunk_x, int32_t chunk_y) {
+	if (!world.request_chunk(chunk_x, chunk_y)) {
+		return false;
+	}
+	set_process(true);
+	return true;
+}
+
+bool GameFramework::is_chunk_ready(int32_t chunk_x, int32_t chunk_y) const {
+	return world.is_chunk_ready(chunk_x, chunk_y);
+}
+
+void GameFramework::update_working_set(int32_t chunk_x, int32_t chunk_y, int32_t radius) {
+	world.update_working_set(chunk_x, chunk_y, radius);
+	if (world.get_pending_count() > 0) {
+		set_process(true);
+	}
+}
+
+// ============ 实体更新 ============
+
+void GameFramework::set_simulate_entities(bool p_enabled) {
+	simulate_entities = p_enabled;
+	if (simulate_entities) {
+		set_process(true);
+	}
+}
+
+void GameFramework::tick_entities(float p_delta) {
+	world.tick_entities(p_delta);
+}
+
+// ============ 空间查询 ============
+
+static TypedArray<WorldObject> _to_object_array(const LocalVector<WorldObject *> &p_objects) {
+	TypedArray<WorldObject> result;
+	result.resize(p_objects.size());
+	for (uint32_t i = 0; i < p_objects.size(); i++) {
+		result[i] = p_objects[i];
+	}
+	return result;
+}
+
+TypedArray<WorldObject> GameFramework::find_objects_in_radius(const Vector2i &p_position, float p_radius) const {
+	LocalVector<WorldObject *> objects;
+	world.get_spatial_index().query_radius(p_position, p_radius, objects);
+	return _to_object_array(objects);
+}
+
+TypedArray<WorldObject> GameFramework::find_objects_in_rect(const Rect2i &p_rect) const {
+	LocalVector<WorldObject *> objects;
+	world.get_spatial_index().query_rect(p_rect, objects);
+	return _to_object_array(objects);
+}
+
+TypedArray<WorldObject> GameFramework::find_nearest_objects(const Vector2i &p_position, int p_count, float p_max_distance) const {
+	ERR_FAIL_COND_V(p_count < 0, TypedArray<WorldObject>());
+	LocalVector<WorldObject *> objects;
+	world.get_spatial_index().query_nearest(p_position, p_count, objects, p_max_distance);
+	return _to_object_array(objects);
+}
+
 // ============ 可视化方法 ============
 
 Color GameFramework::get_tile_color(TileType type) const {
@@ -152,8 +266,9 @@ void GameFramework::visualize_chunk(int32_t chunk_x, int32_t chunk_y) {
 	// 先清除旧的可视化节点（在获取 chunk 之前）
 	clear_visualization();
 
-	Chunk *chunk = world.get_chunk(chunk_x, chunk_y);
-	if (!chunk) {
+	// 创建节点时可能触发脚本回调并加载其他区块，固定区块以免被淘汰
+	World::ChunkPin chunk = world.pin_chunk(chunk_x, chunk_y);
+	if (!chunk.is_valid()) {
 		print_line(vformat("Chunk (%d, %d) not found", chunk_x, chunk_y));
 		return;
 	}
@@ -172,12 +287,13 @@ void GameFramework::visualize_chunk(int32_t chunk_x, int32_t chunk_y) {
 	chunk_visual->set_name("ChunkVisual");
 	add_child(chunk_visual);
 	chunk_visual->set_owner(scene_root);
+	visualized_chunk = chunk->coord;
 
-	// 创建地形网格
-	// create_terrain_mesh(chunk);
+	// 创建地形网格（后台构建）
+	create_terrain_mesh(chunk.get());
 
 	// 创建实体可视化
-	create_entity_visuals(chunk);
+	create_entity_visuals(chunk.get());
 
 	// 设置所有子节点的 owner
 	for (int i = 0; i < chunk_visual->get_child_count(); i++) {
@@ -214,157 +330,166 @@ void GameFramework::generate_in_editor() {
 }
 
 void GameFramework::create_terrain_mesh(Chunk *chunk) {
-	// 为了性能，我们按 tile type 分组创建材质
-	// 每种地形类型使用一个平面
-
-	// 先统计每种地形的格子
-	const int sample_step = 4; // 采样步长，降低精度提升性能
-	const int sampled_size = CHUNK_SIZE / sample_step;
-	const float scaled_tile_size = tile_size * sample_step;
-
-	// 创建地形图像纹理
-	Ref<Image> terrain_image = Image::create_empty(sampled_size, sampled_size, false, Image::FORMAT_RGB8);
-
-	for (int y = 0; y < sampled_size; y++) {
-		for (int x = 0; x < sampled_size; x++) {
-			int sample_x = x * sample_step;
-			int sample_y = y * sample_step;
-			TileType type = chunk->tiles[sample_y][sample_x];
-			Color color = get_tile_color(type);
-			terrain_image->set_pixel(x, y, color);
-		}
+	// 相同地形的格子合并为四边形，颜色写入顶点色，整个区块只有一个网格和一次绘制
+	Color palette[TILE_TYPE_MAX];
+	for (int i = 0; i < TILE_TYPE_MAX; i++) {
+		palette[i] = get_tile_color(static_cast<TileType>(i));
 	}
 
-	// 创建纹理
-	Ref<ImageTexture> terrain_texture = ImageTexture::create_from_image(terrain_image);
+	terrain_mesher.request(chunk->coord, chunk->tiles, tile_size, palette);
+	set_process(true);
+}
+
+void GameFramework::apply_terrain_mesh(const ChunkMesher::Result &p_result) {
+	// 构建期间可视化可能已被清除或切换到其他区块
+	if (!chunk_visual || !(p_result.coord == visualized_chunk)) {
+		return;
+	}
 
-	// 创建平面网格
-	Ref<PlaneMesh> plane_mesh;
-	plane_mesh.instantiate();
-	float plane_size = CHUNK_SIZE * tile_size;
-	plane_mesh->set_size(Size2(plane_size, plane_size));
+	Ref<ArrayMesh> terrain_mesh;
+	terrain_mesh.instantiate();
+	terrain_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, p_result.arrays);
 
-	// 创建材质
 	Ref<StandardMaterial3D> material;
 	material.instantiate();
-	material->set_texture(StandardMaterial3D::TEXTURE_ALBEDO, terrain_texture);
-	material->set_texture_filter(StandardMaterial3D::TEXTURE_FILTER_NEAREST); // 像素风格
+	material->set_flag(StandardMaterial3D::FLAG_ALBEDO_FROM_VERTEX_COLOR, true);
+	material->set_roughness(1.0f);
+	terrain_mesh->surface_set_material(0, material);
 
-	// 创建 MeshInstance3D
 	MeshInstance3D *mesh_instance = memnew(MeshInstance3D);
 	mesh_instance->set_name("TerrainMesh");
-	mesh_instance->set_mesh(plane_mesh);
-	mesh_instance->set_surface_override_material(0, material);
-
-	// 设置位置（平面中心在 chunk 中心）
-	float half_size = plane_size / 2.0f;
-	mesh_instance->set_position(Vector3(half_size, 0, half_size));
+	mesh_instance->set_mesh(terrain_mesh);
 
 	chunk_visual->add_child(mesh_instance);
+	mesh_instance->set_owner(chunk_visual->get_owner());
 }
 
-void GameFramework::create_entity_visuals(Chunk *chunk) {
-	// 创建城市可视化（使用 WorldObjectNode3D 以支持射线检测）
-	for (int i = 0; i < chunk->cities.size(); i++) {
-		const CityData &city = chunk->cities[i];
-
-		WorldObjectNode3D *city_node = memnew(WorldObjectNode3D);
-		city_node->set_name(vformat("City_%d", i));
-		city_node->set_world_object(city.world_object);
-
-		// 创建默认视觉表示（金色立方体）
-		city_node->create_default_visual(Vector3(4.0f, 4.0f, 4.0f), Color(1.0f, 0.84f, 0.0f));
+// 一种实体在区块中的全部实例
+struct EntityBatch {
+	String name;
+	Vector3 size;
+	LocalVector<Ref<WorldObject>> objects;
+	LocalVector<Vector2i> positions;
+	LocalVector<Color> colors;
+};
+
+static Color _get_monster_color(const Ref<Monster> &p_monster) {
+	if (p_monster.is_null()) {
+		return Color(1.0f, 0.0f, 0.0f); // 默认红色
+	}
+	switch (p_monster->get_rank()) {
+		case MONSTER_RANK_NORMAL:
+			return Color(1.0f, 0.0f, 0.0f); // 红色
+		case MONSTER_RANK_ELITE:
+			return Color(1.0f, 0.5f, 0.0f); // 橙色
+		case MONSTER_RANK_CHAMPION:
+			return Color(0.8f, 0.0f, 0.8f); // 紫色
+		case MONSTER_RANK_BOSS:
+			return Color(0.0f, 0.0f, 0.0f); // 黑色
+		default:
+			return Color(0.5f, 0.0f, 0.0f); // 深红
+	}
+}
 
-		// 设置位置
-		float pos_x = city.position.x * tile_size;
-		float pos_z = city.position.y * tile_size;
-		city_node->set_position(Vector3(pos_x, 2.0f, pos_z));
+static Color _get_npc_color(const Ref<NPC> &p_npc) {
+	if (p_npc.is_null()) {
+		return Color(0.0f, 0.5f, 1.0f); // 默认蓝色
+	}
+	switch (p_npc->get_npc_type()) {
+		case NPC_TYPE_VILLAGER:
+			return Color(0.4f, 0.6f, 1.0f); // 浅蓝
+		case NPC_TYPE_MERCHANT:
+			return Color(0.0f, 1.0f, 0.0f); // 绿色
+		case NPC_TYPE_QUEST_GIVER:
+			return Color(1.0f, 1.0f, 0.0f); // 黄色
+		case NPC_TYPE_TRAINER:
+			return Color(0.0f, 1.0f, 1.0f); // 青色
+		case NPC_TYPE_GUARD:
+			return Color(0.5f, 0.5f, 1.0f); // 蓝紫
+		default:
+			return Color(0.0f, 0.5f, 1.0f); // 蓝色
+	}
+}
 
-		chunk_visual->add_child(city_node);
+// 一个 MultiMeshInstance3D 绘制整批实体（实例颜色作为反照率），碰撞形状加入共享的批量碰撞体
+static void _create_entity_batch(Node3D *p_parent, WorldObjectBatchBody3D *p_colliders, float p_tile_size, const EntityBatch &p_batch) {
+	if (p_batch.positions.is_empty()) {
+		return;
 	}
 
-	// 创建怪物可视化（使用 WorldObjectNode3D 以支持射线检测）
-	for (int i = 0; i < chunk->monsters.size(); i++) {
-		const MonsterSpawnData &monster_data = chunk->monsters[i];
-
-		WorldObjectNode3D *monster_node = memnew(WorldObjectNode3D);
-		monster_node->set_name(vformat("Monster_%d", i));
-		monster_node->set_world_object(monster_data.monster);
-
-		// 确定颜色（基于怪物等级）
-		Color monster_color = Color(1.0f, 0.0f, 0.0f); // 默认红色
-		if (monster_data.monster.is_valid()) {
-			switch (monster_data.monster->get_rank()) {
-				case MONSTER_RANK_NORMAL:
-					monster_color = Color(1.0f, 0.0f, 0.0f); // 红色
-					break;
-				case MONSTER_RANK_ELITE:
-					monster_color = Color(1.0f, 0.5f, 0.0f); // 橙色
-					break;
-				case MONSTER_RANK_CHAMPION:
-					monster_color = Color(0.8f, 0.0f, 0.8f); // 紫色
-					break;
-				case MONSTER_RANK_BOSS:
-					monster_color = Color(0.0f, 0.0f, 0.0f); // 黑色
-					break;
-				default:
-					monster_color = Color(0.5f, 0.0f, 0.0f); // 深红
-					break;
-			}
+	Ref<StandardMaterial3D> material;
+	material.instantiate();
+	material->set_flag(StandardMaterial3D::FLAG_ALBEDO_FROM_VERTEX_COLOR, true);
+	material->set_roughness(0.7f);
+
+	Ref<BoxMesh> box_mesh;
+	box_mesh.instantiate();
+	box_mesh->set_size(p_batch.size);
+	box_mesh->set_material(material);
+
+	Ref<BoxShape3D> box_shape;
+	box_shape.instantiate();
+	box_shape->set_size(p_batch.size);
+
+	Ref<MultiMesh> multimesh;
+	multimesh.instantiate();
+	multimesh->set_transform_format(MultiMesh::TRANSFORM_3D);
+	multimesh->set_use_colors(true);
+	multimesh->set_mesh(box_mesh);
+	multimesh->set_instance_count(p_batch.positions.size());
+
+	for (uint32_t i = 0; i < p_batch.positions.size(); i++) {
+		// 实体底部贴地
+		Vector3 position(p_batch.positions[i].x * p_tile_size, p_batch.size.y * 0.5f, p_batch.positions[i].y * p_tile_size);
+		multimesh->set_instance_transform(i, Transform3D(Basis(), position));
+		multimesh->set_instance_color(i, p_batch.colors[i]);
+		if (p_batch.objects[i].is_valid()) {
+			p_colliders->add_world_object(p_batch.objects[i], box_shape, position);
 		}
+	}
 
-		// 创建默认视觉表示（胶囊体）
-		monster_node->create_default_visual(Vector3(2.0f, 3.0f, 2.0f), monster_color);
+	MultiMeshInstance3D *instance = memnew(MultiMeshInstance3D);
+	instance->set_name(p_batch.name);
+	instance->set_multimesh(multimesh);
+	p_parent->add_child(instance);
+}
 
-		// 设置位置
-		float pos_x = monster_data.position.x * tile_size;
-		float pos_z = monster_data.position.y * tile_size;
-		monster_node->set_position(Vector3(pos_x, 1.5f, pos_z));
+void GameFramework::create_entity_visuals(Chunk *chunk) {
+	// 每种实体一个 MultiMeshInstance3D，节点数和绘制调用数与实体数量无关
+	EntityBatch cities;
+	cities.name = "Cities";
+	cities.size = Vector3(4.0f, 4.0f, 4.0f);
+	for (const CityData &city : chunk->cities) {
+		cities.objects.push_back(city.world_object);
+		cities.positions.push_back(city.position);
+		cities.colors.push_back(Color(1.0f, 0.84f, 0.0f)); // 金色
+	}
 
-		chunk_visual->add_child(monster_node);
+	EntityBatch monsters;
+	monsters.name = "Monsters";
+	monsters.size = Vector3(2.0f, 3.0f, 2.0f);
+	for (const MonsterSpawnData &monster_data : chunk->monsters) {
+		monsters.objects.push_back(monster_data.monster);
+		monsters.positions.push_back(monster_data.position);
+		monsters.colors.push_back(_get_monster_color(monster_data.monster));
 	}
 
-	// 创建 NPC 可视化（使用 WorldObjectNode3D 以支持射线检测）
-	for (int i = 0; i < chunk->npcs.size(); i++) {
-		const NPCSpawnData &npc_data = chunk->npcs[i];
-
-		WorldObjectNode3D *npc_node = memnew(WorldObjectNode3D);
-		npc_node->set_name(vformat("NPC_%d", i));
-		npc_node->set_world_object(npc_data.npc);
-
-		// 确定颜色（基于 NPC 类型）
-		Color npc_color = Color(0.0f, 0.5f, 1.0f); // 默认蓝色
-		if (npc_data.npc.is_valid()) {
-			switch (npc_data.npc->get_npc_type()) {
-				case NPC_TYPE_VILLAGER:
-					npc_color = Color(0.4f, 0.6f, 1.0f); // 浅蓝
-					break;
-				case NPC_TYPE_MERCHANT:
-					npc_color = Color(0.0f, 1.0f, 0.0f); // 绿色
-					break;
-				case NPC_TYPE_QUEST_GIVER:
-					npc_color = Color(1.0f, 1.0f, 0.0f); // 黄色
-					break;
-				case NPC_TYPE_TRAINER:
-					npc_color = Color(0.0f, 1.0f, 1.0f); // 青色
-					break;
-				case NPC_TYPE_GUARD:
-					npc_color = Color(0.5f, 0.5f, 1.0f); // 蓝紫
-					break;
-				default:
-					npc_color = Color(0.0f, 0.5f, 1.0f); // 蓝色
-					break;
-			}
-		}
+	EntityBatch npcs;
+	npcs.name = "NPCs";
+	npcs.size = Vector3(2.0f, 3.0f, 2.0f);
+	for (const NPCSpawnData &npc_data : chunk->npcs) {
+		npcs.objects.push_back(npc_data.npc);
+		npcs.positions.push_back(npc_data.position);
+		npcs.colors.push_back(_get_npc_color(npc_data.npc));
+	}
 
-		// 创建默认视觉表示（圆柱体）
-		npc_node->create_default_visual(Vector3(2.0f, 3.0f, 2.0f), npc_color);
+	// 所有实体共用一个碰撞体（每个实体一个形状），仍然可以被射线检测到
+	WorldObjectBatchBody3D *colliders = memnew(WorldObjectBatchBody3D);
+	colliders->set_name("EntityColliders");
 
-		// 设置位置
-		float pos_x = npc_data.position.x * tile_size;
-		float pos_z = npc_data.position.y * tile_size;
-		npc_node->set_position(Vector3(pos_x, 1.5f, pos_z));
+	_create_entity_batch(chunk_visual, colliders, tile_size, cities);
+	_create_entity_batch(chunk_visual, colliders, tile_size, monsters);
+	_create_entity_batch(chunk_visual, colliders, tile_size, npcs);
 
-		chunk_visual->add_child(npc_node);
-	}
+	chunk_visual->add_child(colliders);
 }
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "chunk_mesher.h"
 #include "scene/3d/node_3d.h"
 #include "world.h"
 
@@ -12,13 +13,19 @@ class GameFramework : public Node3D {
 
 private:
 	World world;
+	// 每帧批量更新常驻区块中的怪物和 NPC
+	bool simulate_entities = false;
 
 	// 可视化相关
 	float tile_size = 1.0f; // 每个格子的大小（米）
 	Node3D *chunk_visual = nullptr;
+	ChunkCoord visualized_chunk;
+	// 地形网格在后台构建，完成后在 NOTIFICATION_PROCESS 中挂到 chunk_visual 下
+	ChunkMesher terrain_mesher;
 
 	void create_chunk_visual(int32_t chunk_x, int32_t chunk_y);
 	void create_terrain_mesh(Chunk *chunk);
+	void apply_terrain_mesh(const ChunkMesher::Result &p_result);
 	void create_entity_visuals(Chunk *chunk);
 	Color get_tile_color(TileType type) const;
 
@@ -39,6 +46,31 @@ public:
 	void print_npc(int32_t chunk_x, int32_t chunk_y, int32_t npc_index);
 	void print_all_entities(int32_t chunk_x, int32_t chunk_y);
 
+	// 异步区块生成（完成后发出 chunk_generated 信号）
+	bool request_chunk(int32_t chunk_x, int32_t chunk_y);
+	bool is_chunk_ready(int32_t chunk_x, int32_t chunk_y) const;
+
+	// 区块驻留与持久化
+	void set_max_resident_chunks(int p_count) { world.set_max_resident_chunks(p_count); }
+	int get_max_resident_chunks() const { return world.get_max_resident_chunks(); }
+	void set_chunk_save_path(const String &p_path) { world.set_persistence_path(p_path); }
+	String get_chunk_save_path() const { return world.get_persistence_path(); }
+	void update_working_set(int32_t chunk_x, int32_t chunk_y, int32_t radius);
+
+	// 实体更新（常驻区块中的怪物和 NPC，数据保存在 World 的实体存储中）
+	void set_simulate_entities(bool p_enabled);
+	bool is_simulating_entities() const { return simulate_entities; }
+	void tick_entities(float p_delta);
+	int get_entity_count() const { return world.get_entity_count(); }
+
+	// 空间查询（世界格子坐标，包含常驻区块中的物体和通过 add_world_object() 加入的物体）
+	// 加入的物体（例如玩家）的 local_position 即为世界格子坐标
+	bool add_world_object(WorldObject *p_object) { return world.add_object(p_object); }
+	bool remove_world_object(WorldObject *p_object) { return world.remove_object(p_object); }
+	TypedArray<WorldObject> find_objects_in_radius(const Vector2i &p_position, float p_radius) const;
+	TypedArray<WorldObject> find_objects_in_rect(const Rect2i &p_rect) const;
+	TypedArray<WorldObject> find_nearest_objects(const Vector2i &p_position, int p_count, float p_max_distance = Math::INF) const;
+
 	// 可视化方法
 	void visualize_chunk(int32_t chunk_x, int32_t chunk_y);
 	void clear_visualization();
@@ -4,6 +4,8 @@
 
 #include "item.h"
 
+#include "item_definition.h"
+
 #include "core/string/print_string.h"
 #include "core/variant/variant.h"
 
@@ -13,7 +15,9 @@ void Item::_bind_methods() {
 
 Item::Item() = default;
 
-Item::~Item() = default;
+Item::~Item() {
+	_invalidate_definition();
+}
 
 // ============ 工厂方法 ============
 
@@ -46,6 +50,59 @@ Ref<Item> Item::duplicate() const {
 	return copy;
 }
 
+Ref<Item> Item::create_from_definition(uint32_t p_definition_index, int32_t p_quantity, int32_t p_durability) {
+	const ItemDefinition &definition = ItemRegistry::get(p_definition_index);
+
+	Ref<Item> item;
+	item.instantiate();
+	item->item_id = definition.item_id;
+	item->display_name = definition.display_name;
+	item->description = definition.description;
+	item->max_stack_size = definition.max_stack_size;
+	item->max_durability = definition.max_durability;
+	item->category = definition.category;
+	item->rarity = definition.rarity;
+	item->flags = definition.flags;
+	item->base_value = definition.base_value;
+	item->weight = definition.weight;
+	item->quantity = p_quantity;
+	item->durability = p_durability;
+	ItemRegistry::acquire(p_definition_index);
+	item->definition_index = p_definition_index;
+	return item;
+}
+
+ItemDefinition Item::get_definition() const {
+	ItemDefinition definition;
+	definition.item_id = item_id;
+	definition.display_name = display_name;
+	definition.description = description;
+	definition.max_stack_size = max_stack_size;
+	definition.max_durability = max_durability;
+	definition.category = category;
+	definition.rarity = rarity;
+	definition.flags = flags;
+	definition.base_value = base_value;
+	definition.weight = weight;
+	return definition;
+}
+
+uint32_t Item::get_definition_index() const {
+	if (definition_index == UINT32_MAX) {
+		definition_index = ItemRegistry::intern(get_definition());
+	}
+	return definition_index;
+}
+
+void Item::_release_definition() {
+	ItemRegistry::release(definition_index);
+	definition_index = UINT32_MAX;
+}
+
+bool Item::is_flyweight_compatible() const {
+	return custom_data.is_empty() && get_script_instance() == nullptr && get_class_name() == SNAME("Item");
+}
+
 // ============ 堆叠系统 ============
 
 void Item::set_quantity(int32_t p_quantity) {
@@ -54,6 +111,7 @@ void Item::set_quantity(int32_t p_quantity) {
 
 void Item::set_max_stack_size(int32_t p_max) {
 	max_stack_size = CLAMP(p_max, 1, MAX_STACK_SIZE);
+	_invalidate_definition();
 	if (quantity > max_stack_size) {
 		quantity = max_stack_size;
 	}
@@ -138,6 +196,7 @@ void Item::set_durability(int32_t p_durability) {
 
 void Item::set_max_durability(int32_t p_max) {
 	max_durability = p_max;
+	_invalidate_definition();
 	if (max_durability != DURABILITY_INFINITE && durability > max_durability) {
 		durability = max_durability;
 	}
@@ -275,6 +334,7 @@ Dictionary Item::serialize() const {
 }
 
 void Item::deserialize(const Dictionary &p_data) {
+	_invalidate_definition();
 	item_id = p_data.get("item_id", StringName());
 	quantity = p_data.get("quantity", 1);
 	display_name = p_data.get("display_name", StringName());
@@ -44,6 +44,8 @@ enum ItemFlags : uint32_t {
 	ITEM_FLAG_UNIQUE      = 1 << 7,  // 唯一物品（只能持有一个）
 };
 
+struct ItemDefinition;
+
 // 物品基类 - 表示容器内的物品实例
 class Item : public RefCounted {
 	GDCLASS(Item, RefCounted);
@@ -80,6 +82,15 @@ private:
 	// === 扩展数据 ===
 	Dictionary custom_data;          // 自定义数据（用于特殊物品属性）
 
+	// 当前属性对应的共享定义（持有引用），修改定义属性时失效
+	mutable uint32_t definition_index = UINT32_MAX;
+	_FORCE_INLINE_ void _invalidate_definition() {
+		if (definition_index != UINT32_MAX) {
+			_release_definition();
+		}
+	}
+	void _release_definition();
+
 protected:
 	static void _bind_methods();
 
@@ -97,14 +108,33 @@ public:
 	static Ref<Item> create(const StringName &p_item_id, int32_t p_quantity = 1);
 	Ref<Item> duplicate() const;
 
+	// === 共享定义（见 ItemRegistry）===
+	// 由定义创建独立的物品实例
+	static Ref<Item> create_from_definition(uint32_t p_definition_index, int32_t p_quantity, int32_t p_durability = DURABILITY_INFINITE);
+	// 当前属性对应的定义（属性相同的物品共享同一个索引）
+	ItemDefinition get_definition() const;
+	// 结果缓存在物品上，物品存活且定义属性不变时索引一直有效；定义表已满时返回 UINT32_MAX
+	uint32_t get_definition_index() const;
+	// 能否只用 {定义, 数量, 耐久} 完整表示（没有自定义数据、脚本或子类）
+	bool is_flyweight_compatible() const;
+
 	// === 核心标识访问器 ===
-	void set_item_id(const StringName &p_id) { item_id = p_id; }
+	void set_item_id(const StringName &p_id) {
+		item_id = p_id;
+		_invalidate_definition();
+	}
 	StringName get_item_id() const { return item_id; }
 
-	void set_display_name(const StringName &p_name) { display_name = p_name; }
+	void set_display_name(const StringName &p_name) {
+		display_name = p_name;
+		_invalidate_definition();
+	}
 	StringName get_display_name() const { return display_name; }
 
-	void set_description(const StringName &p_desc) { description = p_desc; }
+	void set_description(const StringName &p_desc) {
+		description = p_desc;
+		_invalidate_definition();
+	}
 	StringName get_description() const { return description; }
 
 	// === 堆叠系统 ===
@@ -142,25 +172,46 @@ public:
 	void repair_full();                  // 完全修复
 
 	// === 分类与标签 ===
-	void set_category(ItemCategory p_category) { category = p_category; }
+	void set_category(ItemCategory p_category) {
+		category = p_category;
+		_invalidate_definition();
+	}
 	ItemCategory get_category() const { return category; }
 
-	void set_rarity(ItemRarity p_rarity) { rarity = p_rarity; }
+	void set_rarity(ItemRarity p_rarity) {
+		rarity = p_rarity;
+		_invalidate_definition();
+	}
 	ItemRarity get_rarity() const { return rarity; }
 
-	void set_flags(uint32_t p_flags) { flags = p_flags; }
+	void set_flags(uint32_t p_flags) {
+		flags = p_flags;
+		_invalidate_definition();
+	}
 	uint32_t get_flags() const { return flags; }
 
-	void add_flag(ItemFlags p_flag) { flags |= p_flag; }
-	void remove_flag(ItemFlags p_flag) { flags &= ~p_flag; }
+	void add_flag(ItemFlags p_flag) {
+		flags |= p_flag;
+		_invalidate_definition();
+	}
+	void remove_flag(ItemFlags p_flag) {
+		flags &= ~p_flag;
+		_invalidate_definition();
+	}
 	bool has_flag(ItemFlags p_flag) const { return (flags & p_flag) != 0; }
 
 	// === 经济属性 ===
-	void set_base_value(int32_t p_value) { base_value = p_value; }
+	void set_base_value(int32_t p_value) {
+		base_value = p_value;
+		_invalidate_definition();
+	}
 	int32_t get_base_value() const { return base_value; }
 	int32_t get_total_value() const { return base_value * quantity; }
 
-	void set_weight(float p_weight) { weight = p_weight; }
+	void set_weight(float p_weight) {
+		weight = p_weight;
+		_invalidate_definition();
+	}
 	float get_weight() const { return weight; }
 	float get_total_weight() const { return weight * quantity; }
 
@@ -0,0 +1,200 @@
+/**************************************************************************/
+/*  item_definition.cpp                                                   */
+/**************************************************************************/
+
+#include "item_definition.h"
+
+bool ItemDefinition::operator==(const ItemDefinition &p_other) const {
+	return item_id == p_other.item_id &&
+			display_name == p_other.display_name &&
+			description == p_other.description &&
+			max_stack_size == p_other.max_stack_size &&
+			max_durability == p_other.max_durability &&
+			category == p_other.category &&
+			rarity == p_other.rarity &&
+			flags == p_other.flags &&
+			base_value == p_other.base_value &&
+			weight == p_other.weight;
+}
+
+uint32_t ItemDefinition::hash() const {
+	uint32_t h = item_id.hash();
+	h = hash_murmur3_one_32(display_name.hash(), h);
+	h = hash_murmur3_one_32(description.hash(), h);
+	h = hash_murmur3_one_32(max_stack_size, h);
+	h = hash_murmur3_one_32(max_durability, h);
+	h = hash_murmur3_one_32(category, h);
+	h = hash_murmur3_one_32(rarity, h);
+	h = hash_murmur3_one_32(flags, h);
+	h = hash_murmur3_one_32(base_value, h);
+	h = hash_murmur3_one_float(weight, h);
+	return hash_fmix32(h);
+}
+
+ItemDefinition *ItemRegistry::pages[MAX_PAGES] = {};
+SafeNumeric<uint32_t> *ItemRegistry::ref_pages[MAX_PAGES] = {};
+const ItemDefinition ItemRegistry::invalid_definition;
+uint32_t ItemRegistry::definition_count = 0;
+LocalVector<uint32_t> ItemRegistry::free_indices;
+HashMap<ItemDefinition, uint32_t> ItemRegistry::definition_indices;
+HashMap<StringName, uint32_t> ItemRegistry::id_indices;
+HashMap<StringName, uint32_t> ItemRegistry::default_definitions;
+Mutex ItemRegistry::mutex;
+
+uint32_t ItemRegistry::intern(const ItemDefinition &p_definition) {
+	MutexLock lock(mutex);
+
+	const uint32_t *existing = definition_indices.getptr(p_definition);
+	if (existing) {
+		// 在锁内增加引用，与 release() 中的回收互斥
+		_refs(*existing).increment();
+		return *existing;
+	}
+
+	uint32_t index;
+	if (!free_indices.is_empty()) {
+		index = free_indices[free_indices.size() - 1];
+		free_indices.resize(free_indices.size() - 1);
+	} else {
+		index = definition_count;
+		uint32_t page = index >> PAGE_BITS;
+		ERR_FAIL_COND_V_MSG(page >= MAX_PAGES, INVALID_INDEX, "Too many distinct item definitions in use.");
+		if (pages[page] == nullptr) {
+			pages[page] = memnew_arr(ItemDefinition, PAGE_SIZE);
+			ref_pages[page] = memnew_arr(SafeNumeric<uint32_t>, PAGE_SIZE);
+		}
+		definition_count++;
+	}
+
+	ItemDefinition &definition = pages[index >> PAGE_BITS][index & (PAGE_SIZE - 1)];
+	definition = p_definition;
+	const uint32_t *id_index = id_indices.getptr(p_definition.item_id);
+	if (id_index) {
+		definition.id_index = *id_index;
+	} else {
+		definition.id_index = id_indices.size();
+		id_indices.insert(p_definition.item_id, definition.id_index);
+	}
+
+	definition_indices.insert(definition, index);
+	_refs(index).set(1);
+	return index;
+}
+
+uint32_t ItemRegistry::get_count() {
+	MutexLock lock(mutex);
+	return definition_count;
+}
+
+void ItemRegistry::acquire(uint32_t p_index) {
+	ERR_FAIL_UNSIGNED_INDEX(p_index, MAX_DEFINITIONS);
+	DEV_ASSERT(_refs(p_index).get() > 0);
+	_refs(p_index).increment();
+}
+
+void ItemRegistry::release(uint32_t p_index) {
+	if (p_index >= MAX_DEFINITIONS || pages[p_index >> PAGE_BITS] == nullptr) {
+		return; // 空槽位，或 clear() 之后释放的旧索引
+	}
+	if (_refs(p_index).decrement() > 0) {
+		return;
+	}
+
+	MutexLock lock(mutex);
+	// 减到 0 之后 intern() 可能又找到了这个定义，或者另一个线程已经回收了它
+	if (_refs(p_index).get() > 0) {
+		return;
+	}
+	const ItemDefinition &definition = get(p_index);
+	const uint32_t *index = definition_indices.getptr(definition);
+	if (!index || *index != p_index) {
+		return;
+	}
+	definition_indices.erase(definition);
+	free_indices.push_back(p_index);
+}
+
+uint32_t ItemRegistry::get_live_count() {
+	MutexLock lock(mutex);
+	return definition_indices.size();
+}
+
+uint32_t ItemRegistry::find_id(const StringName &p_item_id) {
+	MutexLock lock(mutex);
+	const uint32_t *id_index = id_indices.getptr(p_item_id);
+	return id_index ? *id_index : INVALID_INDEX;
+}
+
+uint32_t ItemRegistry::register_definition(const ItemDefinition &p_definition) {
+	// 登记表持有 intern() 返回的引用
+	uint32_t index = intern(p_definition);
+	if (index == INVALID_INDEX) {
+		return index;
+	}
+
+	uint32_t previous = INVALID_INDEX;
+	{
+		MutexLock lock(mutex);
+		uint32_t *registered = default_definitions.getptr(p_definition.item_id);
+		if (registered) {
+			previous = *registered;
+			*registered = index;
+		} else {
+			default_definitions.insert(p_definition.item_id, index);
+		}
+	}
+	release(previous);
+	return index;
+}
+
+uint32_t ItemRegistry::get_default(const StringName &p_item_id) {
+	{
+		MutexLock lock(mutex);
+		const uint32_t *index = default_definitions.getptr(p_item_id);
+		if (index) {
+			return *index;
+		}
+	}
+
+	ItemDefinition definition;
+	definition.item_id = p_item_id;
+	uint32_t index = intern(definition);
+	if (index == INVALID_INDEX) {
+		return index;
+	}
+
+	uint32_t result = index;
+	bool registered_first = false;
+	{
+		MutexLock lock(mutex);
+		const uint32_t *registered = default_definitions.getptr(p_item_id);
+		if (registered) {
+			result = *registered;
+			registered_first = true;
+		} else {
+			default_definitions.insert(p_item_id, index);
+		}
+	}
+	if (registered_first) {
+		// 另一个线程先登记了，登记表已经持有它自己的引用
+		release(index);
+	}
+	return result;
+}
+
+void ItemRegistry::clear() {
+	MutexLock lock(mutex);
+	for (uint32_t i = 0; i < MAX_PAGES; i++) {
+		if (pages[i]) {
+			memdelete_arr(pages[i]);
+			memdelete_arr(ref_pages[i]);
+		}
+		pages[i] = nullptr;
+		ref_pages[i] = nullptr;
+	}
+	definition_count = 0;
+	free_indices.clear();
+	definition_indices.clear();
+	id_indices.clear();
+	default_definitions.clear();
+}
@@ -0,0 +1,94 @@
+/**************************************************************************/
+/*  item_definition.h                                                     */
+/**************************************************************************/
+
+#pragma once
+
+#include "item.h"
+
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+// 物品定义 - 同一种物品所有实例共享的不可变属性
+// 容器槽位只保存 {定义索引, 数量, 耐久}，其余属性从这里读取
+struct ItemDefinition {
+	StringName item_id;
+	StringName display_name;
+	StringName description;
+	int32_t max_stack_size = 1;
+	int32_t max_durability = Item::DURABILITY_INFINITE;
+	ItemCategory category = ITEM_CATEGORY_MISC;
+	ItemRarity rarity = ITEM_RARITY_COMMON;
+	uint32_t flags = ITEM_FLAG_STACKABLE | ITEM_FLAG_TRADEABLE | ITEM_FLAG_DROPPABLE;
+	int32_t base_value = 0;
+	float weight = 0.0f;
+
+	// 物品ID的整数编号，由 ItemRegistry 分配（不参与比较），用于按ID扫描时避免比较 StringName
+	uint32_t id_index = UINT32_MAX;
+
+	bool is_stackable() const { return (flags & ITEM_FLAG_STACKABLE) && max_stack_size > 1; }
+	bool has_durability() const { return max_durability != Item::DURABILITY_INFINITE; }
+
+	bool operator==(const ItemDefinition &p_other) const;
+	uint32_t hash() const;
+};
+
+// 物品定义表（全局，线程安全）
+// 相同的定义只保存一份。定义带引用计数：容器槽位、缓存了索引的 Item 和登记的默认定义各持有一个引用，
+// 引用归零的定义被回收，索引留给之后的新定义，因此随机生成的定义不会让表无限增长。
+// intern() 和回收加锁；get()、acquire() 不加锁，定义按页分配，持有引用期间地址和内容不会改变。
+class ItemRegistry {
+public:
+	static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+private:
+	static constexpr uint32_t PAGE_BITS = 8;
+	static constexpr uint32_t PAGE_SIZE = 1 << PAGE_BITS;
+	static constexpr uint32_t MAX_PAGES = 1024;
+	static constexpr uint32_t MAX_DEFINITIONS = MAX_PAGES * PAGE_SIZE;
+
+	static ItemDefinition *pages[MAX_PAGES];
+	static SafeNumeric<uint32_t> *ref_pages[MAX_PAGES];
+	static const ItemDefinition invalid_definition;
+	static uint32_t definition_count; // 用过的最大索引 + 1
+	static LocalVector<uint32_t> free_indices;
+	static HashMap<ItemDefinition, uint32_t> definition_indices;
+	static HashMap<StringName, uint32_t> id_indices;
+	static HashMap<StringName, uint32_t> default_definitions;
+	static Mutex mutex;
+
+	static _FORCE_INLINE_ SafeNumeric<uint32_t> &_refs(uint32_t p_index) {
+		return ref_pages[p_index >> PAGE_BITS][p_index & (PAGE_SIZE - 1)];
+	}
+
+public:
+	// 返回与 p_definition 相同的定义的索引，不存在时新增，调用方持有返回的引用（用完后 release()）
+	// 定义表已满时返回 INVALID_INDEX
+	static uint32_t intern(const ItemDefinition &p_definition);
+	static _FORCE_INLINE_ const ItemDefinition &get(uint32_t p_index) {
+		ERR_FAIL_UNSIGNED_INDEX_V(p_index, MAX_DEFINITIONS, invalid_definition);
+		DEV_ASSERT(pages[p_index >> PAGE_BITS] != nullptr);
+		return pages[p_index >> PAGE_BITS][p_index & (PAGE_SIZE - 1)];
+	}
+	static uint32_t get_count();
+
+	// 为已持有引用的索引再增加一个引用
+	static void acquire(uint32_t p_index);
+	// 释放一个引用，INVALID_INDEX 被忽略
+	static void release(uint32_t p_index);
+	// 当前存活（引用未归零）的定义数量
+	static uint32_t get_live_count();
+
+	// 物品ID的整数编号，该ID从未出现过时返回 INVALID_INDEX（ID编号不回收）
+	static uint32_t find_id(const StringName &p_item_id);
+
+	// 数据表：为物品ID登记默认定义（按ID创建物品时使用），登记的定义一直保留
+	static uint32_t register_definition(const ItemDefinition &p_definition);
+	// 返回登记的默认定义；未登记时登记只有ID、其余为默认值的定义（与 Item::create() 一致）
+	static uint32_t get_default(const StringName &p_item_id);
+
+	// 释放所有定义（模块卸载时调用，之后所有索引失效）
+	static void clear();
+};
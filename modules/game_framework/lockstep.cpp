@@ -0,0 +1,365 @@
+/**************************************************************************/
+/*  lockstep.cpp                                                          */
+/**************************************************************************/
+
+#include "lockstep.h"
+
+#include "state_hash.h"
+
+LockstepSimulation::~LockstepSimulation() {
+	stop_recording();
+}
+
+void LockstepSimulation::set_step(float p_step) {
+	ERR_FAIL_COND_MSG(p_step <= 0.0f, "Simulation step must be positive.");
+	step = p_step;
+}
+
+LockstepSimulation::EntityKind LockstepSimulation::_get_kind(const Character *p_character) {
+	if (Object::cast_to<Player>(p_character)) {
+		return ENTITY_PLAYER;
+	}
+	if (Object::cast_to<Monster>(p_character)) {
+		return ENTITY_MONSTER;
+	}
+	if (Object::cast_to<NPC>(p_character)) {
+		return ENTITY_NPC;
+	}
+	return ENTITY_CHARACTER;
+}
+
+void LockstepSimulation::_rebuild_indices() {
+	entity_indices.clear();
+	for (uint32_t i = 0; i < entities.size(); i++) {
+		entity_indices.insert(entities[i].character->get_object_id(), i);
+	}
+	entity_indices_dirty = false;
+}
+
+Character *LockstepSimulation::_find(const StringName &p_object_id) {
+	if (entity_indices_dirty) {
+		_rebuild_indices();
+	}
+	const uint32_t *index = entity_indices.getptr(p_object_id);
+	return index ? entities[*index].character.ptr() : nullptr;
+}
+
+bool LockstepSimulation::add_character(const Ref<Character> &p_character) {
+	ERR_FAIL_COND_V(p_character.is_null(), false);
+	const StringName &id = p_character->get_object_id();
+	ERR_FAIL_COND_V_MSG(id == StringName(), false, "Lockstep entities need an object_id.");
+	ERR_FAIL_COND_V_MSG(_find(id) != nullptr, false, vformat("Duplicate lockstep entity \"%s\".", id));
+
+	// 按名称的字典序插入，保证两端的更新顺序一致
+	uint32_t position = entities.size();
+	while (position > 0 && StringName::AlphCompare::compare(id, entities[position - 1].character->get_object_id())) {
+		position--;
+	}
+
+	Entity entity;
+	entity.character = p_character;
+	entity.kind = _get_kind(p_character.ptr());
+	entities.insert(position, entity);
+	entity_indices_dirty = true;
+	return true;
+}
+
+bool LockstepSimulation::remove_character(const Ref<Character> &p_character) {
+	ERR_FAIL_COND_V(p_character.is_null(), false);
+	if (entity_indices_dirty) {
+		_rebuild_indices();
+	}
+	const uint32_t *index = entity_indices.getptr(p_character->get_object_id());
+	if (!index || entities[*index].character != p_character) {
+		return false;
+	}
+	entities.remove_at(*index);
+	entity_indices_dirty = true;
+	return true;
+}
+
+void LockstepSimulation::add_chunk(const Chunk *p_chunk) {
+	ERR_FAIL_NULL(p_chunk);
+	for (const MonsterSpawnData &spawn : p_chunk->monsters) {
+		if (spawn.monster.is_valid()) {
+			add_character(spawn.monster);
+		}
+	}
+	for (const NPCSpawnData &spawn : p_chunk->npcs) {
+		if (spawn.npc.is_valid()) {
+			add_character(spawn.npc);
+		}
+	}
+}
+
+Ref<Character> LockstepSimulation::get_character(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)entities.size(), Ref<Character>());
+	return entities[p_index].character;
+}
+
+void LockstepSimulation::clear() {
+	stop_recording();
+	entities.clear();
+	entity_indices.clear();
+	entity_indices_dirty = false;
+	pending_commands.clear();
+	accumulator = 0.0f;
+	tick = 0;
+	tick_hash = 0;
+	chained_hash = 0;
+}
+
+bool LockstepSimulation::queue_command(const Command &p_command) {
+	ERR_FAIL_COND_V_MSG(p_command.tick < tick, false, "Cannot queue a command for a tick that has already run.");
+	ERR_FAIL_UNSIGNED_INDEX_V((uint32_t)p_command.type, (uint32_t)COMMAND_TYPE_MAX, false);
+
+	// 排在同一 tick 已有命令之后
+	uint32_t position = pending_commands.size();
+	while (position > 0 && pending_commands[position - 1].tick > p_command.tick) {
+		position--;
+	}
+	pending_commands.insert(position, p_command);
+	return true;
+}
+
+void LockstepSimulation::_apply_command(const Command &p_command) {
+	// 目标不存在时忽略（两端会做出相同的判断）
+	Character *target = _find(p_command.target);
+	if (!target) {
+		return;
+	}
+
+	switch (p_command.type) {
+		case COMMAND_DAMAGE:
+			target->take_damage(p_command.amount);
+			break;
+		case COMMAND_HEAL:
+			target->heal(p_command.amount);
+			break;
+		case COMMAND_KILL:
+			target->die();
+			break;
+		case COMMAND_RESPAWN:
+			target->respawn(p_command.amount);
+			break;
+		case COMMAND_MOVE:
+			target->set_local_position(p_command.position);
+			break;
+		case COMMAND_SET_AI_STATE: {
+			Monster *monster = Object::cast_to<Monster>(target);
+			if (monster && p_command.state >= 0 && p_command.state < MONSTER_AI_MAX) {
+				monster->set_ai_state(static_cast<MonsterAIState>(p_command.state));
+			}
+		} break;
+		default:
+			break;
+	}
+}
+
+void LockstepSimulation::step_once() {
+	// 本 tick 的命令
+	uint32_t executed = 0;
+	while (executed < pending_commands.size() && pending_commands[executed].tick == tick) {
+		_apply_command(pending_commands[executed]);
+		if (recording_writer) {
+			tick_commands.push_back(pending_commands[executed]);
+		}
+		executed++;
+	}
+	if (executed > 0) {
+		uint32_t remaining = pending_commands.size() - executed;
+		for (uint32_t i = 0; i < remaining; i++) {
+			pending_commands[i] = pending_commands[executed + i];
+		}
+		pending_commands.resize(remaining);
+	}
+
+	for (const Entity &entity : entities) {
+		entity.character->tick(step);
+	}
+
+	tick_hash = compute_state_hash();
+	chained_hash = hash64_murmur3_64(tick_hash, chained_hash);
+
+	if (recording_writer) {
+		_record_tick();
+	}
+	tick++;
+}
+
+int LockstepSimulation::advance(float p_delta) {
+	accumulator += p_delta;
+	int steps = 0;
+	while (accumulator >= step) {
+		accumulator -= step;
+		step_once();
+		steps++;
+	}
+	return steps;
+}
+
+uint64_t LockstepSimulation::compute_state_hash() const {
+	StateHasher hasher;
+	hasher.add_u64(tick);
+	hasher.add_u32(entities.size());
+	for (const Entity &entity : entities) {
+		entity.character->hash_state(hasher);
+	}
+	return hasher.hash;
+}
+
+// ============ 录制 ============
+
+void LockstepSimulation::_write_command(SnapshotWriter &p_writer, const Command &p_command) {
+	p_writer.write_u8(p_command.type);
+	p_writer.write_name(p_command.target);
+	p_writer.write_float(p_command.amount);
+	p_writer.write_s32(p_command.position.x);
+	p_writer.write_s32(p_command.position.y);
+	p_writer.write_s32(p_command.state);
+}
+
+bool LockstepSimulation::_read_command(SnapshotReader &p_reader, Command &r_command) {
+	r_command.type = static_cast<CommandType>(p_reader.read_enum(COMMAND_TYPE_MAX, COMMAND_DAMAGE));
+	r_command.target = p_reader.read_name();
+	r_command.amount = p_reader.read_float();
+	r_command.position.x = p_reader.read_s32();
+	r_command.position.y = p_reader.read_s32();
+	r_command.state = p_reader.read_s32();
+	return !p_reader.is_corrupt();
+}
+
+Error LockstepSimulation::start_recording(const String &p_path) {
+	ERR_FAIL_COND_V_MSG(is_recording(), ERR_ALREADY_IN_USE, "Already recording.");
+
+	Error err;
+	recording = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(recording.is_null(), err, vformat("Cannot open replay file \"%s\".", p_path));
+
+	recording->store_32(REPLAY_MAGIC);
+	recording->store_32(REPLAY_VERSION);
+	recording->store_32(SnapshotWriter::VERSION);
+	recording->store_float(step);
+	recording->store_64(tick);
+	recording->store_64(chained_hash);
+
+	recording_writer = new SnapshotWriter(recording);
+	recording->store_32(entities.size());
+	for (const Entity &entity : entities) {
+		recording_writer->write_u8(entity.kind);
+		entity.character->write_snapshot(*recording_writer);
+	}
+	return recording->get_error();
+}
+
+void LockstepSimulation::_record_tick() {
+	recording_writer->write_u32(tick_commands.size());
+	for (const Command &command : tick_commands) {
+		_write_command(*recording_writer, command);
+	}
+	recording_writer->write_u64(tick_hash);
+	tick_commands.clear();
+}
+
+void LockstepSimulation::stop_recording() {
+	if (!recording_writer) {
+		return;
+	}
+	delete recording_writer;
+	recording_writer = nullptr;
+	recording.unref();
+	tick_commands.clear();
+}
+
+// ============ 回放 ============
+
+LockstepReplay::~LockstepReplay() {
+	delete reader;
+}
+
+Error LockstepReplay::open(const String &p_path) {
+	ERR_FAIL_COND_V_MSG(file.is_valid(), ERR_ALREADY_IN_USE, "Replay is already open.");
+
+	Error err;
+	file = FileAccess::open(p_path, FileAccess::READ, &err);
+	ERR_FAIL_COND_V_MSG(file.is_null(), err, vformat("Cannot open replay file \"%s\".", p_path));
+
+	ERR_FAIL_COND_V_MSG(file->get_32() != LockstepSimulation::REPLAY_MAGIC, ERR_FILE_UNRECOGNIZED, "Not a replay file.");
+	uint32_t version = file->get_32();
+	ERR_FAIL_COND_V_MSG(version > LockstepSimulation::REPLAY_VERSION, ERR_FILE_UNRECOGNIZED, vformat("Unsupported replay version %d.", version));
+	uint32_t snapshot_version = file->get_32();
+	ERR_FAIL_COND_V_MSG(snapshot_version > SnapshotWriter::VERSION, ERR_FILE_UNRECOGNIZED, vformat("Unsupported snapshot version %d.", snapshot_version));
+
+	simulation.clear();
+	simulation.set_step(file->get_float());
+	simulation.tick = file->get_64();
+	simulation.chained_hash = file->get_64();
+
+	reader = new SnapshotReader(file, snapshot_version);
+	uint32_t entity_count = file->get_32();
+	for (uint32_t i = 0; i < entity_count && !reader->is_corrupt(); i++) {
+		Ref<Character> character;
+		switch (reader->read_enum(LockstepSimulation::ENTITY_KIND_MAX, LockstepSimulation::ENTITY_CHARACTER)) {
+			case LockstepSimulation::ENTITY_MONSTER:
+				character = Ref<Character>(memnew(Monster));
+				break;
+			case LockstepSimulation::ENTITY_NPC:
+				character = Ref<Character>(memnew(NPC));
+				break;
+			case LockstepSimulation::ENTITY_PLAYER:
+				character = Ref<Character>(memnew(Player));
+				break;
+			default:
+				character.instantiate();
+				break;
+		}
+		character->read_snapshot(*reader);
+		if (!reader->is_corrupt() && !simulation.add_character(character)) {
+			reader->set_corrupt();
+		}
+	}
+	ERR_FAIL_COND_V_MSG(reader->is_corrupt(), ERR_FILE_CORRUPT, "Corrupt replay file.");
+	return OK;
+}
+
+bool LockstepReplay::step() {
+	ERR_FAIL_NULL_V_MSG(reader, false, "No replay is open.");
+	if (finished || has_desync()) {
+		return false;
+	}
+
+	uint32_t command_count = reader->read_u32();
+	if (reader->is_corrupt()) {
+		// 录制在 tick 之间结束
+		finished = true;
+		return false;
+	}
+
+	LockstepSimulation::Command command;
+	for (uint32_t i = 0; i < command_count; i++) {
+		if (!LockstepSimulation::_read_command(*reader, command)) {
+			finished = true;
+			ERR_FAIL_V_MSG(false, "Corrupt replay file.");
+		}
+		command.tick = simulation.tick;
+		simulation.queue_command(command);
+	}
+
+	simulation.step_once();
+	uint64_t recorded_hash = reader->read_u64();
+	if (reader->is_corrupt()) {
+		finished = true;
+		ERR_FAIL_V_MSG(false, "Truncated replay file.");
+	}
+	if (recorded_hash != simulation.tick_hash) {
+		desync_tick = simulation.tick - 1;
+		return false;
+	}
+	return true;
+}
+
+uint64_t LockstepReplay::run() {
+	while (step()) {
+	}
+	return desync_tick;
+}
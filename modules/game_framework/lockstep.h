@@ -0,0 +1,157 @@
+/**************************************************************************/
+/*  lockstep.h                                                            */
+/**************************************************************************/
+
+#pragma once
+
+#include "chunk.h"
+#include "player.h"
+#include "snapshot.h"
+
+#include "core/io/file_access.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+// 确定性定步长模拟（锁步）
+// 角色按 object_id 排序后依次 tick，与加入顺序、指针地址无关；外部输入必须以命令的形式
+// 提交并在指定 tick 开始时按提交顺序执行。每个 tick 结束后计算全部角色的状态哈希，
+// 并与上一个 tick 的累积哈希串联，客户端和服务器只需比较这个 64 位值即可发现不同步。
+// 两端使用相同的区块坐标调用 add_chunk() 即可得到相同的初始状态（区块种子只依赖坐标）。
+// 注意：浮点运算的一致性要求两端使用相同的编译选项。
+class LockstepSimulation {
+public:
+	enum CommandType : uint8_t {
+		COMMAND_DAMAGE,       // take_damage(amount)
+		COMMAND_HEAL,         // heal(amount)
+		COMMAND_KILL,         // die()
+		COMMAND_RESPAWN,      // respawn(amount)
+		COMMAND_MOVE,         // set_local_position(position)
+		COMMAND_SET_AI_STATE, // set_ai_state(state)，只对怪物有效
+		COMMAND_TYPE_MAX
+	};
+
+	struct Command {
+		uint64_t tick = 0;
+		StringName target;    // 目标的 object_id
+		CommandType type = COMMAND_DAMAGE;
+		float amount = 0.0f;
+		Vector2i position;
+		int32_t state = 0;
+	};
+
+	// 回放文件格式
+	static constexpr uint32_t REPLAY_MAGIC = 0x52534647; // "GFSR"
+	static constexpr uint32_t REPLAY_VERSION = 1;
+	static constexpr float DEFAULT_STEP = 1.0f / 30.0f;
+
+private:
+	enum EntityKind : uint8_t {
+		ENTITY_CHARACTER,
+		ENTITY_MONSTER,
+		ENTITY_NPC,
+		ENTITY_PLAYER,
+		ENTITY_KIND_MAX
+	};
+
+	struct Entity {
+		Ref<Character> character;
+		EntityKind kind = ENTITY_CHARACTER;
+	};
+
+	// 按 object_id 排序
+	LocalVector<Entity> entities;
+	HashMap<StringName, uint32_t> entity_indices;
+	bool entity_indices_dirty = false;
+
+	// 按 tick 排序，同一 tick 内保持提交顺序
+	LocalVector<Command> pending_commands;
+
+	float step = DEFAULT_STEP;
+	float accumulator = 0.0f;
+	uint64_t tick = 0;
+	uint64_t tick_hash = 0;
+	uint64_t chained_hash = 0;
+
+	// 录制：初始状态 + 每个 tick 执行的命令和哈希
+	Ref<FileAccess> recording;
+	SnapshotWriter *recording_writer = nullptr;
+	LocalVector<Command> tick_commands;
+
+	static EntityKind _get_kind(const Character *p_character);
+	void _rebuild_indices();
+	Character *_find(const StringName &p_object_id);
+	void _apply_command(const Command &p_command);
+	void _record_tick();
+
+	static void _write_command(SnapshotWriter &p_writer, const Command &p_command);
+	static bool _read_command(SnapshotReader &p_reader, Command &r_command);
+
+	friend class LockstepReplay;
+
+public:
+	void set_step(float p_step);
+	float get_step() const { return step; }
+
+	// === 实体 ===
+	// object_id 必须唯一且非空；模拟开始后仍可增删，但两端必须在同一 tick 之间做相同的修改
+	bool add_character(const Ref<Character> &p_character);
+	bool remove_character(const Ref<Character> &p_character);
+	// 加入区块中的全部怪物和 NPC
+	void add_chunk(const Chunk *p_chunk);
+	int get_character_count() const { return entities.size(); }
+	Ref<Character> get_character(int p_index) const;
+	void clear();
+
+	// === 命令 ===
+	// 命令的 tick 不能早于当前 tick
+	bool queue_command(const Command &p_command);
+	int get_pending_command_count() const { return pending_commands.size(); }
+
+	// === 推进 ===
+	// 执行一个定步长 tick
+	void step_once();
+	// 累积真实时间并执行相应数量的定步长 tick，返回执行的数量
+	int advance(float p_delta);
+
+	uint64_t get_tick() const { return tick; }
+	// 最近一个 tick 结束时的状态哈希
+	uint64_t get_tick_hash() const { return tick_hash; }
+	// 从开始到最近一个 tick 的累积哈希，任何一个 tick 不同步都会使其不同
+	uint64_t get_state_hash() const { return chained_hash; }
+	// 重新计算当前状态的哈希（不推进，不改变累积哈希）
+	uint64_t compute_state_hash() const;
+
+	// === 录制 ===
+	// 写入当前全部角色的快照，之后每个 tick 追加命令和哈希
+	Error start_recording(const String &p_path);
+	void stop_recording();
+	bool is_recording() const { return recording.is_valid(); }
+
+	LockstepSimulation() {}
+	~LockstepSimulation();
+};
+
+// 回放录制文件：从初始快照重建角色，按记录重新执行命令并逐 tick 比较哈希
+class LockstepReplay {
+	LockstepSimulation simulation;
+	Ref<FileAccess> file;
+	SnapshotReader *reader = nullptr;
+	uint64_t desync_tick = UINT64_MAX;
+	bool finished = false;
+
+public:
+	Error open(const String &p_path);
+
+	// 回放一个 tick，没有更多记录、记录损坏或已不同步时返回 false
+	bool step();
+	// 回放到结束，返回第一个不同步的 tick（没有不同步时返回 UINT64_MAX）
+	uint64_t run();
+
+	bool is_finished() const { return finished; }
+	bool has_desync() const { return desync_tick != UINT64_MAX; }
+	uint64_t get_desync_tick() const { return desync_tick; }
+	LockstepSimulation &get_simulation() { return simulation; }
+
+	LockstepReplay() {}
+	~LockstepReplay();
+};
@@ -4,8 +4,14 @@
 
 #include "monster.h"
 
-void Monster::_bind_methods() {
+#include "snapshot.h"
+#include "state_hash.h"
 
+void Monster::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("find_detection_target"), &Monster::find_detection_target);
+	ClassDB::bind_method(D_METHOD("is_target_out_of_chase_range"), &Monster::is_target_out_of_chase_range);
+	ClassDB::bind_method(D_METHOD("get_target_object_id"), &Monster::get_target_object_id);
+	ClassDB::bind_method(D_METHOD("update_ai"), &Monster::update_ai);
 }
 
 Monster::Monster() {
@@ -21,14 +27,14 @@ Monster::~Monster() = default;
 // ============ 怪物属性 ============
 
 void Monster::set_ai_state(MonsterAIState p_state) {
-	if (ai_state == p_state) {
+	if (_ai_state() == p_state) {
 		return;
 	}
 
-	ai_state = p_state;
+	_store_ai_state(p_state);
 
 	// 状态变化时的处理
-	if (ai_state == MONSTER_AI_DEAD) {
+	if (p_state == MONSTER_AI_DEAD) {
 		clear_target();
 	}
 }
@@ -59,6 +65,8 @@ void Monster::set_target(Object *p_target) {
 
 	Object *old_target = current_target;
 	current_target = p_target;
+	current_target_id = p_target ? p_target->get_instance_id() : ObjectID();
+	pending_target_id = StringName();
 
 	if (old_target == nullptr && p_target != nullptr) {
 		// 进入战斗
@@ -89,6 +97,99 @@ void Monster::leave_combat() {
 	set_ai_state(MONSTER_AI_RETURN);
 }
 
+static bool _is_hostile_target(const WorldObject *p_object, void *p_userdata) {
+	const Monster *self = static_cast<const Monster *>(p_userdata);
+	const Character *character = Object::cast_to<Character>(p_object);
+	if (character == nullptr || character == self || !character->is_alive() || character->has_state(CHARACTER_STATE_INVISIBLE)) {
+		return false;
+	}
+	// 敌对与友方互为敌人，中立阵营不会被主动攻击
+	Character::Faction a = self->get_faction();
+	Character::Faction b = character->get_faction();
+	return (a == Character::FACTION_HOSTILE && b == Character::FACTION_FRIENDLY) || (a == Character::FACTION_FRIENDLY && b == Character::FACTION_HOSTILE);
+}
+
+Ref<Character> Monster::find_detection_target() const {
+	const SpatialIndex *index = get_spatial_index();
+	if (index == nullptr) {
+		return Ref<Character>();
+	}
+
+	LocalVector<WorldObject *> nearest;
+	index->query_nearest(get_world_position(), 1, nearest, detection_range, _is_hostile_target, const_cast<Monster *>(this));
+	if (nearest.is_empty()) {
+		return Ref<Character>();
+	}
+	return Ref<Character>(Object::cast_to<Character>(nearest[0]));
+}
+
+bool Monster::is_target_out_of_chase_range() const {
+	const WorldObject *target = Object::cast_to<WorldObject>(ObjectDB::get_instance(current_target_id));
+	if (target == nullptr) {
+		return false;
+	}
+	Vector2i offset = target->get_world_position() - (get_chunk_origin() + spawn_position);
+	return (double)offset.x * offset.x + (double)offset.y * offset.y > (double)chase_range * chase_range;
+}
+
+StringName Monster::get_target_object_id() const {
+	if (!pending_target_id.is_empty()) {
+		return pending_target_id;
+	}
+	const WorldObject *target = Object::cast_to<WorldObject>(ObjectDB::get_instance(current_target_id));
+	return target ? target->get_object_id() : StringName();
+}
+
+static bool _is_pending_target(const WorldObject *p_object, void *p_userdata) {
+	return p_object->get_object_id() == *static_cast<const StringName *>(p_userdata);
+}
+
+void Monster::update_ai() {
+	if (!is_alive()) {
+		return;
+	}
+
+	if (!pending_target_id.is_empty()) {
+		// 快照只保存了目标的 object_id，目标只可能在追击范围内
+		const SpatialIndex *index = get_spatial_index();
+		if (index) {
+			LocalVector<WorldObject *> found;
+			index->query_nearest(get_chunk_origin() + spawn_position, 1, found, chase_range, _is_pending_target, &pending_target_id);
+			if (!found.is_empty()) {
+				// 恢复状态而不是改变目标，不触发仇恨回调
+				current_target = found[0];
+				current_target_id = found[0]->get_instance_id();
+			}
+		}
+		pending_target_id = StringName();
+	}
+
+	switch (_ai_state()) {
+		case MONSTER_AI_IDLE:
+		case MONSTER_AI_PATROL: {
+			Ref<Character> target = find_detection_target();
+			if (target.is_valid()) {
+				enter_combat(target.ptr());
+			}
+		} break;
+		case MONSTER_AI_CHASE:
+		case MONSTER_AI_ATTACK: {
+			// 目标可能已被释放，只通过 ObjectID 访问
+			const Character *target = Object::cast_to<Character>(ObjectDB::get_instance(current_target_id));
+			if (target == nullptr || !target->is_alive() || target->has_state(CHARACTER_STATE_INVISIBLE) || is_target_out_of_chase_range()) {
+				leave_combat();
+			}
+		} break;
+		case MONSTER_AI_RETURN: {
+			if (get_local_position() == spawn_position) {
+				set_ai_state(MONSTER_AI_IDLE);
+			}
+		} break;
+		default:
+			break;
+	}
+}
+
 // ============ 奖励 ============
 
 int64_t Monster::get_actual_exp_reward() const {
@@ -105,9 +206,10 @@ void Monster::tick(float p_delta) {
 	// 死亡状态处理
 	if (!is_alive()) {
 		if (can_respawn()) {
-			death_timer += p_delta;
-			if (death_timer >= respawn_time) {
-				death_timer = 0.0f;
+			float &timer = _death_timer();
+			timer += p_delta;
+			if (timer >= _respawn_time()) {
+				timer = 0.0f;
 				respawn(1.0f);
 				set_ai_state(MONSTER_AI_IDLE);
 				set_local_position(spawn_position);
@@ -127,7 +229,7 @@ Dictionary Monster::serialize() const {
 
 	// 怪物属性
 	data["rank"] = static_cast<int>(rank);
-	data["ai_state"] = static_cast<int>(ai_state);
+	data["ai_state"] = static_cast<int>(_ai_state());
 	data["monster_id"] = monster_id;
 
 	// AI 参数
@@ -143,7 +245,8 @@ Dictionary Monster::serialize() const {
 	data["loot_table_id"] = loot_table_id;
 
 	// 重生
-	data["respawn_time"] = respawn_time;
+	data["respawn_time"] = _respawn_time();
+	data["death_timer"] = _death_timer();
 
 	return data;
 }
@@ -153,7 +256,7 @@ void Monster::deserialize(const Dictionary &p_data) {
 
 	// 怪物属性
 	rank = static_cast<MonsterRank>((int)p_data.get("rank", MONSTER_RANK_NORMAL));
-	ai_state = static_cast<MonsterAIState>((int)p_data.get("ai_state", MONSTER_AI_IDLE));
+	_store_ai_state(static_cast<MonsterAIState>((int)p_data.get("ai_state", MONSTER_AI_IDLE)));
 	monster_id = p_data.get("monster_id", StringName());
 
 	// AI 参数
@@ -169,5 +272,63 @@ void Monster::deserialize(const Dictionary &p_data) {
 	loot_table_id = p_data.get("loot_table_id", StringName());
 
 	// 重生
-	respawn_time = p_data.get("respawn_time", 60.0f);
+	_respawn_time() = p_data.get("respawn_time", 60.0f);
+	_death_timer() = p_data.get("death_timer", 0.0f);
+}
+
+void Monster::write_snapshot(SnapshotWriter &p_writer) const {
+	Character::write_snapshot(p_writer);
+
+	p_writer.write_u8((uint8_t)rank);
+	p_writer.write_u8((uint8_t)_ai_state());
+	p_writer.write_name(monster_id);
+
+	p_writer.write_float(detection_range);
+	p_writer.write_float(attack_range);
+	p_writer.write_float(chase_range);
+	p_writer.write_s32(spawn_position.x);
+	p_writer.write_s32(spawn_position.y);
+
+	p_writer.write_s64(exp_reward);
+	p_writer.write_s64(gold_reward);
+	p_writer.write_name(loot_table_id);
+
+	p_writer.write_float(_respawn_time());
+	p_writer.write_float(_death_timer());
+
+	p_writer.write_name(get_target_object_id());
+}
+
+void Monster::read_snapshot(SnapshotReader &p_reader) {
+	Character::read_snapshot(p_reader);
+
+	rank = static_cast<MonsterRank>(p_reader.read_enum(MONSTER_RANK_MAX, MONSTER_RANK_NORMAL));
+	_store_ai_state(static_cast<MonsterAIState>(p_reader.read_enum(MONSTER_AI_MAX, MONSTER_AI_IDLE)));
+	monster_id = p_reader.read_name();
+
+	detection_range = p_reader.read_float();
+	attack_range = p_reader.read_float();
+	chase_range = p_reader.read_float();
+	spawn_position.x = p_reader.read_s32();
+	spawn_position.y = p_reader.read_s32();
+
+	exp_reward = p_reader.read_s64();
+	gold_reward = p_reader.read_s64();
+	loot_table_id = p_reader.read_name();
+
+	_respawn_time() = p_reader.read_float();
+	_death_timer() = p_reader.read_float();
+
+	// 目标对象可能还没有加载，先记下 object_id
+	current_target = nullptr;
+	current_target_id = ObjectID();
+	pending_target_id = p_reader.get_version() >= 2 ? p_reader.read_name() : StringName();
+}
+
+void Monster::hash_state(StateHasher &p_hasher) const {
+	Character::hash_state(p_hasher);
+
+	p_hasher.add_u32(_ai_state());
+	p_hasher.add_float(_death_timer());
+	p_hasher.add_name(get_target_object_id());
 }
@@ -45,6 +45,8 @@ private:
 
 	// === 仇恨系统 ===
 	Object *current_target = nullptr; // 当前目标
+	ObjectID current_target_id;       // 用于检查目标是否已被释放
+	StringName pending_target_id;     // 从快照读取的目标（object_id），由 update_ai() 重新找到对应对象
 
 	// === 奖励 ===
 	int64_t exp_reward = 10;          // 经验奖励
@@ -55,7 +57,23 @@ private:
 	float respawn_time = 60.0f;       // 重生时间（秒）
 	float death_timer = 0.0f;         // 死亡计时器
 
+	friend class EntityStore;
+
 protected:
+	// 加入 EntityStore 后以存储中的列为准
+	_FORCE_INLINE_ MonsterAIState _ai_state() const { return entity_store ? static_cast<MonsterAIState>(entity_store->ai_state[entity_index]) : ai_state; }
+	_FORCE_INLINE_ void _store_ai_state(MonsterAIState p_state) {
+		if (entity_store) {
+			entity_store->ai_state[entity_index] = p_state;
+		} else {
+			ai_state = p_state;
+		}
+	}
+	_FORCE_INLINE_ float &_respawn_time() { return entity_store ? entity_store->respawn_time[entity_index] : respawn_time; }
+	_FORCE_INLINE_ float _respawn_time() const { return entity_store ? entity_store->respawn_time[entity_index] : respawn_time; }
+	_FORCE_INLINE_ float &_death_timer() { return entity_store ? entity_store->death_timer[entity_index] : death_timer; }
+	_FORCE_INLINE_ float _death_timer() const { return entity_store ? entity_store->death_timer[entity_index] : death_timer; }
+
 	static void _bind_methods();
 
 	// === 虚函数 ===
@@ -72,7 +90,7 @@ public:
 	MonsterRank get_rank() const { return rank; }
 
 	void set_ai_state(MonsterAIState p_state);
-	MonsterAIState get_ai_state() const { return ai_state; }
+	MonsterAIState get_ai_state() const { return _ai_state(); }
 
 	void set_monster_id(const StringName &p_id) { monster_id = p_id; }
 	StringName get_monster_id() const { return monster_id; }
@@ -104,6 +122,20 @@ public:
 	void leave_combat();
 	bool is_in_combat() const { return current_target != nullptr; }
 
+	// 通过空间索引查找侦测范围内最近的可攻击角色（存活、未隐身、阵营敌对），
+	// 怪物未加入空间索引时返回空
+	Ref<Character> find_detection_target() const;
+	// 目标距出生点是否已超出追击范围（目标不是 WorldObject 时返回 false）
+	bool is_target_out_of_chase_range() const;
+
+	// 目标的 object_id（跨进程稳定，用于快照和状态哈希），没有目标时为空
+	StringName get_target_object_id() const;
+
+	// 一步 AI 决策：空闲/巡逻时通过空间索引寻找侦测范围内的目标并进入战斗，
+	// 追击/攻击时目标失效或超出追击范围则脱离战斗，回到出生点后恢复空闲
+	// tick() 不执行 AI，由 World::tick_entities() 在批量更新后调用
+	void update_ai();
+
 	// === 奖励 ===
 	void set_exp_reward(int64_t p_exp) { exp_reward = MAX(0LL, p_exp); }
 	int64_t get_exp_reward() const { return exp_reward; }
@@ -119,10 +151,10 @@ public:
 	int64_t get_actual_gold_reward() const;
 
 	// === 重生 ===
-	void set_respawn_time(float p_time) { respawn_time = MAX(0.0f, p_time); }
-	float get_respawn_time() const { return respawn_time; }
+	void set_respawn_time(float p_time) { _respawn_time() = MAX(0.0f, p_time); }
+	float get_respawn_time() const { return _respawn_time(); }
 
-	bool can_respawn() const { return respawn_time > 0; }
+	bool can_respawn() const { return _respawn_time() > 0; }
 
 	// === 时间更新 ===
 	void tick(float p_delta) override;
@@ -130,6 +162,9 @@ public:
 	// === 序列化 ===
 	Dictionary serialize() const override;
 	void deserialize(const Dictionary &p_data) override;
+	void write_snapshot(SnapshotWriter &p_writer) const override;
+	void read_snapshot(SnapshotReader &p_reader) override;
+	void hash_state(StateHasher &p_hasher) const override;
 };
 
 VARIANT_ENUM_CAST(MonsterRank);
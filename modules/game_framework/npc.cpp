@@ -4,6 +4,9 @@
 
 #include "npc.h"
 
+#include "snapshot.h"
+#include "state_hash.h"
+
 void NPC::_bind_methods() {
 
 }
@@ -96,3 +99,49 @@ void NPC::deserialize(const Dictionary &p_data) {
 	// 掉落表
 	loot_table_id = p_data.get("loot_table_id", StringName());
 }
+
+void NPC::write_snapshot(SnapshotWriter &p_writer) const {
+	Character::write_snapshot(p_writer);
+
+	p_writer.write_u8((uint8_t)npc_type);
+	p_writer.write_u8((uint8_t)behavior);
+
+	p_writer.write_name(dialogue_id);
+	p_writer.write_bool(can_talk);
+
+	p_writer.write_bool(is_merchant);
+	p_writer.write_name(shop_id);
+
+	p_writer.write_float(aggro_range);
+	p_writer.write_float(leash_range);
+	p_writer.write_s32(spawn_position.x);
+	p_writer.write_s32(spawn_position.y);
+
+	p_writer.write_name(loot_table_id);
+}
+
+void NPC::read_snapshot(SnapshotReader &p_reader) {
+	Character::read_snapshot(p_reader);
+
+	npc_type = static_cast<NPCType>(p_reader.read_enum(NPC_TYPE_MAX, NPC_TYPE_VILLAGER));
+	behavior = static_cast<NPCBehavior>(p_reader.read_enum(NPC_BEHAVIOR_MAX, NPC_BEHAVIOR_IDLE));
+
+	dialogue_id = p_reader.read_name();
+	can_talk = p_reader.read_bool();
+
+	is_merchant = p_reader.read_bool();
+	shop_id = p_reader.read_name();
+
+	aggro_range = p_reader.read_float();
+	leash_range = p_reader.read_float();
+	spawn_position.x = p_reader.read_s32();
+	spawn_position.y = p_reader.read_s32();
+
+	loot_table_id = p_reader.read_name();
+}
+
+void NPC::hash_state(StateHasher &p_hasher) const {
+	Character::hash_state(p_hasher);
+
+	p_hasher.add_u32(behavior);
+}
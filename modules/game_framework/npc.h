@@ -107,6 +107,9 @@ public:
 	// === 序列化 ===
 	Dictionary serialize() const override;
 	void deserialize(const Dictionary &p_data) override;
+	void write_snapshot(SnapshotWriter &p_writer) const override;
+	void read_snapshot(SnapshotReader &p_reader) override;
+	void hash_state(StateHasher &p_hasher) const override;
 };
 
 VARIANT_ENUM_CAST(NPCBehavior);
@@ -4,6 +4,9 @@
 
 #include "player.h"
 
+#include "snapshot.h"
+#include "state_hash.h"
+
 void Player::_bind_methods() {
 
 }
@@ -143,3 +146,37 @@ void Player::deserialize(const Dictionary &p_data) {
 	deaths = p_data.get("deaths", 0);
 	playtime = p_data.get("playtime", 0.0f);
 }
+
+void Player::write_snapshot(SnapshotWriter &p_writer) const {
+	Character::write_snapshot(p_writer);
+
+	p_writer.write_s64(experience);
+	p_writer.write_s64(experience_to_next_level);
+	p_writer.write_s64(gold);
+	p_writer.write_name(player_id);
+
+	p_writer.write_s32(kills);
+	p_writer.write_s32(deaths);
+	p_writer.write_float(playtime);
+}
+
+void Player::read_snapshot(SnapshotReader &p_reader) {
+	Character::read_snapshot(p_reader);
+
+	experience = p_reader.read_s64();
+	experience_to_next_level = p_reader.read_s64();
+	gold = p_reader.read_s64();
+	player_id = p_reader.read_name();
+
+	kills = p_reader.read_s32();
+	deaths = p_reader.read_s32();
+	playtime = p_reader.read_float();
+}
+
+void Player::hash_state(StateHasher &p_hasher) const {
+	Character::hash_state(p_hasher);
+
+	p_hasher.add_s64(experience);
+	p_hasher.add_s64(gold);
+	p_hasher.add_float(playtime);
+}
@@ -472,6 +472,20 @@ void PlayerController3D::_handle_mouse_click(const Vector2 &p_screen_pos) {
 		}
 	}
 
+	// 区块实体以批量碰撞体表示，通过命中的形状找到对应的 WorldObject
+	WorldObjectBatchBody3D *batch_body = Object::cast_to<WorldObjectBatchBody3D>(collider_obj);
+	if (batch_body) {
+		Ref<WorldObject> world_obj = batch_body->get_world_object_for_shape(ray_result.shape);
+		if (world_obj.is_valid()) {
+			world_obj->interact(this);
+
+			if (world_obj->has_container()) {
+				show_world_object_container(world_obj.ptr());
+			}
+			return;
+		}
+	}
+
 	// 打印调试信息
 	print_line("Mouse clicked on non-WorldObject: ", collider_obj->get_class());
 }
@@ -33,6 +33,7 @@
 #include "character.h"
 #include "game_framework.h"
 #include "item.h"
+#include "item_definition.h"
 #include "monster.h"
 #include "npc.h"
 #include "player.h"
@@ -68,6 +69,7 @@ void initialize_game_framework_module(ModuleInitializationLevel p_level) {
 	// === 世界物体系统 ===
 	GDREGISTER_CLASS(WorldObject);
 	GDREGISTER_CLASS(WorldObjectNode3D);
+	GDREGISTER_CLASS(WorldObjectBatchBody3D);
 
 	// === 角色系统（注意继承顺序：基类先注册）===
 	GDREGISTER_CLASS(Character);
@@ -95,6 +97,9 @@ void uninitialize_game_framework_module(ModuleInitializationLevel p_level) {
 	}
 
 	// 清理资源
+	// 物品定义表持有 StringName，必须在 StringName 系统清理之前释放
+	ItemRegistry::clear();
+
 	// 如果创建了单例，需要在这里删除
 	// memdelete(GameFramework::get_singleton());
 }
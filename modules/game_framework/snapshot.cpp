@@ -0,0 +1,122 @@
+/**************************************************************************/
+/*  snapshot.cpp                                                          */
+/**************************************************************************/
+
+#include "snapshot.h"
+
+#include "item_definition.h"
+
+SnapshotWriter::SnapshotWriter(const Ref<FileAccess> &p_file) :
+		file(p_file) {
+}
+
+void SnapshotWriter::write_name(const StringName &p_name) {
+	const uint32_t *index = names.getptr(p_name);
+	if (index) {
+		file->store_32(*index);
+		return;
+	}
+	uint32_t new_index = names.size();
+	names.insert(p_name, new_index);
+	file->store_32(new_index);
+	file->store_pascal_string(String(p_name));
+}
+
+void SnapshotWriter::write_definition(uint32_t p_definition_index) {
+	const uint32_t *index = definitions.getptr(p_definition_index);
+	if (index) {
+		file->store_32(*index);
+		return;
+	}
+	uint32_t new_index = definitions.size();
+	definitions.insert(p_definition_index, new_index);
+	file->store_32(new_index);
+
+	const ItemDefinition &definition = ItemRegistry::get(p_definition_index);
+	write_name(definition.item_id);
+	write_name(definition.display_name);
+	write_name(definition.description);
+	write_s32(definition.max_stack_size);
+	write_s32(definition.max_durability);
+	write_u8((uint8_t)definition.category);
+	write_u8((uint8_t)definition.rarity);
+	write_u32(definition.flags);
+	write_s32(definition.base_value);
+	write_float(definition.weight);
+}
+
+void SnapshotWriter::write_variant(const Variant &p_value) {
+	file->store_var(p_value);
+}
+
+SnapshotReader::SnapshotReader(const Ref<FileAccess> &p_file, uint32_t p_version) :
+		file(p_file), version(p_version) {
+}
+
+SnapshotReader::~SnapshotReader() {
+	for (uint32_t definition_index : definitions) {
+		ItemRegistry::release(definition_index);
+	}
+}
+
+int SnapshotReader::read_enum(int p_count, int p_default) {
+	uint8_t value = file->get_8();
+	if (value >= p_count) {
+		corrupt = true;
+		return p_default;
+	}
+	return value;
+}
+
+StringName SnapshotReader::read_name() {
+	uint32_t index = file->get_32();
+	if (index < names.size()) {
+		return names[index];
+	}
+	if (index != names.size() || is_corrupt()) {
+		corrupt = true;
+		return StringName();
+	}
+	StringName name = file->get_pascal_string();
+	names.push_back(name);
+	return name;
+}
+
+uint32_t SnapshotReader::read_definition() {
+	uint32_t index = file->get_32();
+	if (index < definitions.size()) {
+		return definitions[index];
+	}
+	if (index != definitions.size() || is_corrupt()) {
+		corrupt = true;
+		return ItemRegistry::INVALID_INDEX;
+	}
+
+	ItemDefinition definition;
+	definition.item_id = read_name();
+	definition.display_name = read_name();
+	definition.description = read_name();
+	definition.max_stack_size = read_s32();
+	definition.max_durability = read_s32();
+	definition.category = static_cast<ItemCategory>(read_enum(ITEM_CATEGORY_MAX, ITEM_CATEGORY_MISC));
+	definition.rarity = static_cast<ItemRarity>(read_enum(ITEM_RARITY_MAX, ITEM_RARITY_COMMON));
+	definition.flags = read_u32();
+	definition.base_value = read_s32();
+	definition.weight = read_float();
+	if (definition.max_stack_size < 1 || is_corrupt()) {
+		corrupt = true;
+		return ItemRegistry::INVALID_INDEX;
+	}
+
+	// 可能在工作线程中加载，intern() 是线程安全的
+	uint32_t definition_index = ItemRegistry::intern(definition);
+	definitions.push_back(definition_index);
+	return definition_index;
+}
+
+Variant SnapshotReader::read_variant() {
+	if (is_corrupt()) {
+		return Variant();
+	}
+	return file->get_var();
+}
@@ -0,0 +1,74 @@
+/**************************************************************************/
+/*  snapshot.h                                                            */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/io/file_access.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+// 二进制快照
+// 每个类按固定顺序写入自己的字段（先写父类部分），不保存字段名。
+// 布局改变时提升 VERSION，读取时通过 get_version() 判断旧布局。
+// 同一个快照中 StringName 和物品定义只完整写入一次，之后只写编号：
+// 编号等于已出现的数量时表示新条目，其后紧跟内容。
+class SnapshotWriter {
+public:
+	// 2: 怪物保存目标的 object_id
+	static constexpr uint32_t VERSION = 2;
+
+private:
+	Ref<FileAccess> file;
+	HashMap<StringName, uint32_t> names;
+	HashMap<uint32_t, uint32_t> definitions; // ItemRegistry 索引 -> 快照内编号
+
+public:
+	_FORCE_INLINE_ void write_u8(uint8_t p_value) { file->store_8(p_value); }
+	_FORCE_INLINE_ void write_bool(bool p_value) { file->store_8(p_value ? 1 : 0); }
+	_FORCE_INLINE_ void write_u32(uint32_t p_value) { file->store_32(p_value); }
+	_FORCE_INLINE_ void write_s32(int32_t p_value) { file->store_32((uint32_t)p_value); }
+	_FORCE_INLINE_ void write_u64(uint64_t p_value) { file->store_64(p_value); }
+	_FORCE_INLINE_ void write_s64(int64_t p_value) { file->store_64((uint64_t)p_value); }
+	_FORCE_INLINE_ void write_float(float p_value) { file->store_float(p_value); }
+	void write_name(const StringName &p_name);
+	void write_definition(uint32_t p_definition_index);
+	// 无固定布局的数据（例如物品的自定义数据）
+	void write_variant(const Variant &p_value);
+
+	Error get_error() const { return file->get_error(); }
+
+	SnapshotWriter(const Ref<FileAccess> &p_file);
+};
+
+class SnapshotReader {
+	Ref<FileAccess> file;
+	uint32_t version = SnapshotWriter::VERSION;
+	LocalVector<StringName> names;
+	LocalVector<uint32_t> definitions;
+	bool corrupt = false;
+
+public:
+	_FORCE_INLINE_ uint8_t read_u8() { return file->get_8(); }
+	_FORCE_INLINE_ bool read_bool() { return file->get_8() != 0; }
+	_FORCE_INLINE_ uint32_t read_u32() { return file->get_32(); }
+	_FORCE_INLINE_ int32_t read_s32() { return (int32_t)file->get_32(); }
+	_FORCE_INLINE_ uint64_t read_u64() { return file->get_64(); }
+	_FORCE_INLINE_ int64_t read_s64() { return (int64_t)file->get_64(); }
+	_FORCE_INLINE_ float read_float() { return file->get_float(); }
+	// 读取保存为一个字节的枚举值，超出范围时标记为损坏并返回 p_default
+	int read_enum(int p_count, int p_default);
+	StringName read_name();
+	// 返回 ItemRegistry 索引，数据损坏时返回 ItemRegistry::INVALID_INDEX
+	// 读取器持有读到的定义的引用，索引在读取器销毁前有效
+	uint32_t read_definition();
+	Variant read_variant();
+
+	uint32_t get_version() const { return version; }
+	void set_corrupt() { corrupt = true; }
+	// 数据无效或文件已被截断
+	bool is_corrupt() const { return corrupt || file->eof_reached(); }
+
+	SnapshotReader(const Ref<FileAccess> &p_file, uint32_t p_version);
+	~SnapshotReader();
+};
@@ -0,0 +1,207 @@
+/**************************************************************************/
+/*  spatial_index.cpp                                                     */
+/**************************************************************************/
+
+#include "spatial_index.h"
+
+#include "world_object.h"
+
+SpatialIndex::SpatialIndex(int p_cell_size) {
+	ERR_FAIL_COND_MSG(p_cell_size < 1, "Spatial index cell size must be positive.");
+	cell_size = p_cell_size;
+}
+
+SpatialIndex::~SpatialIndex() {
+	clear();
+}
+
+void SpatialIndex::_cell_insert(const Vector2i &p_cell, WorldObject *p_object) {
+	LocalVector<WorldObject *> &cell = cells[p_cell];
+	p_object->spatial_slot = cell.size();
+	cell.push_back(p_object);
+}
+
+void SpatialIndex::_cell_remove(const Vector2i &p_cell, WorldObject *p_object) {
+	LocalVector<WorldObject *> *cell = cells.getptr(p_cell);
+	ERR_FAIL_NULL(cell);
+	uint32_t slot = p_object->spatial_slot;
+	ERR_FAIL_COND(slot >= cell->size() || (*cell)[slot] != p_object);
+
+	// 与最后一个交换后移除
+	uint32_t last = cell->size() - 1;
+	if (slot != last) {
+		(*cell)[slot] = (*cell)[last];
+		(*cell)[slot]->spatial_slot = slot;
+	}
+	cell->resize(last);
+	if (cell->is_empty()) {
+		cells.erase(p_cell);
+	}
+}
+
+void SpatialIndex::insert(WorldObject *p_object, const Vector2i &p_chunk_origin) {
+	ERR_FAIL_NULL(p_object);
+	ERR_FAIL_COND_MSG(p_object->spatial_index != nullptr, "World object already belongs to a spatial index.");
+
+	p_object->spatial_index = this;
+	p_object->chunk_origin = p_chunk_origin;
+	_cell_insert(_get_cell(p_object->get_world_position()), p_object);
+	object_count++;
+}
+
+void SpatialIndex::remove(WorldObject *p_object) {
+	ERR_FAIL_NULL(p_object);
+	ERR_FAIL_COND(p_object->spatial_index != this);
+
+	_cell_remove(_get_cell(p_object->get_world_position()), p_object);
+	p_object->spatial_index = nullptr;
+	object_count--;
+}
+
+void SpatialIndex::clear() {
+	for (KeyValue<Vector2i, LocalVector<WorldObject *>> &kv : cells) {
+		for (WorldObject *object : kv.value) {
+			object->spatial_index = nullptr;
+		}
+	}
+	cells.clear();
+	object_count = 0;
+}
+
+void SpatialIndex::_object_moved(WorldObject *p_object, const Vector2i &p_old_world_position) {
+	Vector2i old_cell = _get_cell(p_old_world_position);
+	Vector2i new_cell = _get_cell(p_object->get_world_position());
+	if (old_cell == new_cell) {
+		return;
+	}
+	_cell_remove(old_cell, p_object);
+	_cell_insert(new_cell, p_object);
+}
+
+void SpatialIndex::query_radius(const Vector2i &p_center, float p_radius, LocalVector<WorldObject *> &r_results, FilterFunc p_filter, void *p_userdata) const {
+	if (p_radius < 0) {
+		return;
+	}
+
+	int reach = (int)Math::ceil(p_radius);
+	Vector2i from = _get_cell(p_center - Vector2i(reach, reach));
+	Vector2i to = _get_cell(p_center + Vector2i(reach, reach));
+	double radius_squared = (double)p_radius * p_radius;
+
+	for (int cy = from.y; cy <= to.y; cy++) {
+		for (int cx = from.x; cx <= to.x; cx++) {
+			const LocalVector<WorldObject *> *cell = cells.getptr(Vector2i(cx, cy));
+			if (!cell) {
+				continue;
+			}
+			for (WorldObject *object : *cell) {
+				Vector2i offset = object->get_world_position() - p_center;
+				if ((double)offset.x * offset.x + (double)offset.y * offset.y > radius_squared) {
+					continue;
+				}
+				if (p_filter && !p_filter(object, p_userdata)) {
+					continue;
+				}
+				r_results.push_back(object);
+			}
+		}
+	}
+}
+
+void SpatialIndex::query_rect(const Rect2i &p_rect, LocalVector<WorldObject *> &r_results, FilterFunc p_filter, void *p_userdata) const {
+	if (p_rect.size.x <= 0 || p_rect.size.y <= 0) {
+		return;
+	}
+
+	Vector2i from = _get_cell(p_rect.position);
+	Vector2i to = _get_cell(p_rect.get_end() - Vector2i(1, 1));
+
+	for (int cy = from.y; cy <= to.y; cy++) {
+		for (int cx = from.x; cx <= to.x; cx++) {
+			const LocalVector<WorldObject *> *cell = cells.getptr(Vector2i(cx, cy));
+			if (!cell) {
+				continue;
+			}
+			for (WorldObject *object : *cell) {
+				if (!p_rect.has_point(object->get_world_position())) {
+					continue;
+				}
+				if (p_filter && !p_filter(object, p_userdata)) {
+					continue;
+				}
+				r_results.push_back(object);
+			}
+		}
+	}
+}
+
+void SpatialIndex::query_nearest(const Vector2i &p_center, uint32_t p_count, LocalVector<WorldObject *> &r_results, float p_max_distance, FilterFunc p_filter, void *p_userdata) const {
+	if (p_count == 0 || object_count == 0 || p_max_distance < 0) {
+		return;
+	}
+
+	struct Candidate {
+		WorldObject *object;
+		double distance_squared;
+	};
+	// 按距离升序保存当前最近的 p_count 个候选
+	LocalVector<Candidate> best;
+	double max_distance_squared = (double)p_max_distance * p_max_distance;
+
+	Vector2i center_cell = _get_cell(p_center);
+	uint32_t visited = 0;
+
+	// 由内向外逐圈扫描网格；第 ring 圈中的点距离中心至少 (ring - 1) * cell_size
+	for (int ring = 0;; ring++) {
+		double ring_min = (double)MAX(ring - 1, 0) * cell_size;
+		double ring_min_squared = ring_min * ring_min;
+		if (ring_min_squared > max_distance_squared) {
+			break;
+		}
+		if (best.size() == p_count && ring_min_squared > best[best.size() - 1].distance_squared) {
+			break;
+		}
+		if (visited == object_count) {
+			break; // 所有物体都已检查过
+		}
+
+		for (int cy = center_cell.y - ring; cy <= center_cell.y + ring; cy++) {
+			// 只访问圈上的网格：首末行完整遍历，中间行只取两端
+			int step = (cy == center_cell.y - ring || cy == center_cell.y + ring) ? 1 : MAX(ring * 2, 1);
+			for (int cx = center_cell.x - ring; cx <= center_cell.x + ring; cx += step) {
+				const LocalVector<WorldObject *> *cell = cells.getptr(Vector2i(cx, cy));
+				if (!cell) {
+					continue;
+				}
+				visited += cell->size();
+				for (WorldObject *object : *cell) {
+					Vector2i offset = object->get_world_position() - p_center;
+					double distance_squared = (double)offset.x * offset.x + (double)offset.y * offset.y;
+					if (distance_squared > max_distance_squared) {
+						continue;
+					}
+					if (best.size() == p_count && distance_squared >= best[best.size() - 1].distance_squared) {
+						continue;
+					}
+					if (p_filter && !p_filter(object, p_userdata)) {
+						continue;
+					}
+
+					// 插入排序，保持有序且不超过 p_count 个
+					if (best.size() < p_count) {
+						best.push_back(Candidate{ object, distance_squared });
+					} else {
+						best[best.size() - 1] = Candidate{ object, distance_squared };
+					}
+					for (uint32_t i = best.size() - 1; i > 0 && best[i - 1].distance_squared > best[i].distance_squared; i--) {
+						SWAP(best[i - 1], best[i]);
+					}
+				}
+			}
+		}
+	}
+
+	for (const Candidate &candidate : best) {
+		r_results.push_back(candidate.object);
+	}
+}
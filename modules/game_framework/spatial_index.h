@@ -0,0 +1,61 @@
+/**************************************************************************/
+/*  spatial_index.h                                                       */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/rect2i.h"
+#include "core/math/vector2i.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+class WorldObject;
+
+// 世界物体空间索引（均匀网格）
+// 坐标统一使用世界格子坐标：区块坐标 * CHUNK_SIZE + 区块内坐标。
+// 物体加入索引后，WorldObject::set_local_position() 会自动更新所在网格，无需手动同步。
+// 只在主线程访问。
+class SpatialIndex {
+public:
+	static constexpr int DEFAULT_CELL_SIZE = 32;
+
+	// 查询过滤器，返回 false 的物体不计入结果
+	typedef bool (*FilterFunc)(const WorldObject *p_object, void *p_userdata);
+
+private:
+	int cell_size = DEFAULT_CELL_SIZE;
+	HashMap<Vector2i, LocalVector<WorldObject *>> cells;
+	uint32_t object_count = 0;
+
+	_FORCE_INLINE_ int _cell_coord(int p_value) const {
+		// 向下取整，负坐标也落在正确的网格中
+		return p_value >= 0 ? p_value / cell_size : -((-p_value - 1) / cell_size) - 1;
+	}
+	_FORCE_INLINE_ Vector2i _get_cell(const Vector2i &p_world) const { return Vector2i(_cell_coord(p_world.x), _cell_coord(p_world.y)); }
+
+	void _cell_insert(const Vector2i &p_cell, WorldObject *p_object);
+	void _cell_remove(const Vector2i &p_cell, WorldObject *p_object);
+
+public:
+	explicit SpatialIndex(int p_cell_size = DEFAULT_CELL_SIZE);
+	~SpatialIndex();
+
+	// p_chunk_origin 为物体所在区块左上角的世界格子坐标
+	void insert(WorldObject *p_object, const Vector2i &p_chunk_origin);
+	void remove(WorldObject *p_object);
+	void clear();
+
+	// 由 WorldObject 在坐标变化后调用
+	void _object_moved(WorldObject *p_object, const Vector2i &p_old_world_position);
+
+	uint32_t get_object_count() const { return object_count; }
+	int get_cell_size() const { return cell_size; }
+
+	// === 查询（结果追加到 r_results）===
+	// 欧氏距离不超过 p_radius 的物体
+	void query_radius(const Vector2i &p_center, float p_radius, LocalVector<WorldObject *> &r_results, FilterFunc p_filter = nullptr, void *p_userdata = nullptr) const;
+	// 位于矩形内的物体
+	void query_rect(const Rect2i &p_rect, LocalVector<WorldObject *> &r_results, FilterFunc p_filter = nullptr, void *p_userdata = nullptr) const;
+	// 距离最近的 p_count 个物体（按距离升序，距离相同时按网格遍历顺序），只考虑 p_max_distance 以内的物体
+	void query_nearest(const Vector2i &p_center, uint32_t p_count, LocalVector<WorldObject *> &r_results, float p_max_distance, FilterFunc p_filter = nullptr, void *p_userdata = nullptr) const;
+};
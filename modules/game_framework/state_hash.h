@@ -0,0 +1,28 @@
+/**************************************************************************/
+/*  state_hash.h                                                          */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/vector2i.h"
+#include "core/string/string_name.h"
+#include "core/templates/hashfuncs.h"
+
+// 模拟状态哈希（64 位）
+// 只使用与进程无关的值：StringName 按内容哈希，浮点数按位哈希，
+// 不使用指针、ItemRegistry 索引等只在本进程内有意义的值。
+struct StateHasher {
+	uint64_t hash = 0;
+
+	_FORCE_INLINE_ void add_u64(uint64_t p_value) { hash = hash64_murmur3_64(p_value, hash); }
+	_FORCE_INLINE_ void add_u32(uint32_t p_value) { add_u64(p_value); }
+	_FORCE_INLINE_ void add_s32(int32_t p_value) { add_u64((uint32_t)p_value); }
+	_FORCE_INLINE_ void add_s64(int64_t p_value) { add_u64((uint64_t)p_value); }
+	_FORCE_INLINE_ void add_float(float p_value) {
+		uint32_t bits;
+		memcpy(&bits, &p_value, sizeof(bits));
+		add_u64(bits);
+	}
+	_FORCE_INLINE_ void add_vector2i(const Vector2i &p_value) { add_u64(((uint64_t)(uint32_t)p_value.x << 32) | (uint32_t)p_value.y); }
+	_FORCE_INLINE_ void add_name(const StringName &p_name) { add_u64(p_name.hash()); }
+};
@@ -0,0 +1,227 @@
+/**************************************************************************/
+/*  test_chunk.h                                                          */
+/**************************************************************************/
+
+#pragma once
+
+#include "../chunk.h"
+#include "../tile_kernel.h"
+#include "../world.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_utils.h"
+
+namespace TestChunk {
+
+TEST_CASE("[GameFramework][Chunk] Tile kernel matches the per-tile reference") {
+	const ChunkCoord coords[] = { ChunkCoord(0, 0), ChunkCoord(-1, 3), ChunkCoord(1024, -77), ChunkCoord(-5000, -5000) };
+
+	for (const ChunkCoord &coord : coords) {
+		Chunk *chunk = memnew(Chunk(coord));
+
+		RandomPCG kernel_rng(coord.to_seed());
+		kernel_rng.rand(CHUNK_SIZE);
+		kernel_rng.rand(CHUNK_SIZE);
+		RandomPCG scalar_rng = kernel_rng;
+
+		chunk->generate_tiles(kernel_rng);
+		TileGrid kernel_tiles = chunk->tiles;
+		chunk->generate_tiles_scalar(scalar_rng);
+
+		bool identical = true;
+		uint8_t kernel_row[CHUNK_SIZE];
+		uint8_t scalar_row[CHUNK_SIZE];
+		for (int y = 0; y < CHUNK_SIZE; y++) {
+			kernel_tiles.get_row(y, kernel_row);
+			chunk->tiles.get_row(y, scalar_row);
+			identical = identical && memcmp(kernel_row, scalar_row, CHUNK_SIZE) == 0;
+		}
+		CHECK_MESSAGE(identical, vformat("Tiles of chunk (%d, %d) should be identical on both paths.", coord.x, coord.y));
+		CHECK_MESSAGE(kernel_rng.get_state() == scalar_rng.get_state(),
+				"Both paths should leave the generator at the same position for object spawning.");
+
+		memdelete(chunk);
+	}
+}
+
+TEST_CASE("[GameFramework][Chunk] Row seeking matches sequential generation") {
+	RandomPCG start(ChunkCoord(12, -34).to_seed());
+	RandomPCG sequential = start;
+
+	float noise[CHUNK_SIZE];
+	for (int y = 0; y < 40; y++) {
+		RandomPCG seeked = TileKernel::seek_row(start, y, CHUNK_SIZE);
+		CHECK(seeked.get_state() == sequential.get_state());
+		REQUIRE(TileKernel::fill_row_noise(sequential, CHUNK_SIZE, noise));
+	}
+}
+
+TEST_CASE("[GameFramework][Chunk] Tile grid packing and compression") {
+	Chunk *chunk = memnew(Chunk(ChunkCoord(3, 7)));
+	TileGrid &tiles = chunk->tiles;
+	TileGrid reference = tiles;
+
+	CHECK(tiles.get_memory_usage() == CHUNK_SIZE * CHUNK_SIZE / 2);
+
+	tiles.compress();
+	CHECK(tiles.is_compressed());
+	CHECK(tiles.get_memory_usage() < reference.get_memory_usage());
+
+	bool identical = true;
+	for (int y = 0; y < CHUNK_SIZE; y++) {
+		for (int x = 0; x < CHUNK_SIZE; x++) {
+			identical = identical && tiles.get_tile(x, y) == reference.get_tile(x, y);
+		}
+	}
+	CHECK_MESSAGE(identical, "Compressed lookups should match the packed grid.");
+
+	LocalVector<uint8_t> rle = tiles.get_rle_data();
+	TileGrid restored;
+	CHECK(restored.set_rle_data(rle.ptr(), rle.size()));
+
+	// Writing to a compressed grid decompresses it first.
+	tiles.set_tile(5, 9, TILE_MOUNTAIN);
+	CHECK_FALSE(tiles.is_compressed());
+	CHECK(tiles.get_tile(5, 9) == TILE_MOUNTAIN);
+	CHECK(restored.get_tile(5, 9) == reference.get_tile(5, 9));
+
+	restored.decompress();
+	uint8_t restored_row[CHUNK_SIZE];
+	uint8_t reference_row[CHUNK_SIZE];
+	for (int y = 0; y < CHUNK_SIZE; y++) {
+		restored.get_row(y, restored_row);
+		reference.get_row(y, reference_row);
+		identical = identical && memcmp(restored_row, reference_row, CHUNK_SIZE) == 0;
+	}
+	CHECK_MESSAGE(identical, "RLE round trip should restore the original grid.");
+
+	ERR_PRINT_OFF;
+	const uint8_t truncated[] = { 0x1F };
+	CHECK_FALSE(restored.set_rle_data(truncated, 1));
+	ERR_PRINT_ON;
+
+	memdelete(chunk);
+}
+
+TEST_CASE("[GameFramework][World] Evicted chunks are persisted and reloaded") {
+	World world;
+	world.set_persistence_path(TestUtils::get_temp_path("game_framework_chunks"));
+	world.set_max_resident_chunks(1);
+
+	Chunk *chunk = world.get_chunk(0, 0);
+	REQUIRE(chunk->get_monster_count() > 0);
+	Ref<Monster> monster = chunk->get_monster(0);
+	monster->set_health(1.0f);
+	monster->container_clear();
+	Ref<Item> item = Item::create(StringName("saved_item"));
+	item->set_max_stack_size(99);
+	item->set_quantity(3);
+	monster->container_add_item(item);
+	StringName monster_id = monster->get_object_id();
+
+	// Loading a second chunk evicts the first one, which is written out in the background.
+	world.get_chunk(1, 0);
+	CHECK_FALSE(world.is_chunk_ready(0, 0));
+	CHECK(world.get_resident_chunk_count() == 1);
+	world.wait_pending_saves();
+	CHECK(world.get_saving_count() == 0);
+
+	Chunk *reloaded = world.get_chunk(0, 0);
+	Ref<Monster> reloaded_monster = reloaded->get_monster(0);
+	CHECK(reloaded_monster != monster);
+	CHECK(reloaded_monster->get_object_id() == monster_id);
+	CHECK(reloaded_monster->get_health() == doctest::Approx(1.0f));
+	CHECK(reloaded_monster->container_count_item(StringName("saved_item")) == 3);
+
+	Chunk generated(ChunkCoord(0, 0));
+	CHECK(reloaded->center_x == generated.center_x);
+	CHECK(reloaded->center_y == generated.center_y);
+	CHECK(reloaded->tiles.get_tile(17, 200) == generated.tiles.get_tile(17, 200));
+}
+
+TEST_CASE("[GameFramework][World] Chunks accessed while saving are taken back") {
+	World world;
+	world.set_persistence_path(TestUtils::get_temp_path("game_framework_chunks_reclaim"));
+	world.set_max_resident_chunks(1);
+
+	Chunk *chunk = world.get_chunk(0, 0);
+	world.get_chunk(1, 0);
+	CHECK(world.get_saving_count() == 1);
+
+	// The evicted chunk is still being written, so it is made resident again instead of reloaded.
+	CHECK(world.get_chunk(0, 0) == chunk);
+	CHECK(world.is_chunk_ready(0, 0));
+	world.wait_pending_saves();
+}
+
+TEST_CASE("[GameFramework][World] Pinned chunks outlive eviction") {
+	World world;
+	world.set_max_resident_chunks(1);
+
+	{
+		World::ChunkPin pin = world.pin_chunk(0, 0);
+		REQUIRE(pin.is_valid());
+		CHECK(world.is_chunk_pinned(0, 0));
+		Ref<Monster> monster = pin->get_monster(0);
+
+		world.get_chunk(1, 0);
+		CHECK(world.is_chunk_ready(0, 0));
+		CHECK(world.get_chunk(0, 0) == pin.get());
+		CHECK(world.get_resident_chunk_count() == 2);
+		CHECK(monster->get_spatial_index() == &world.get_spatial_index());
+
+		ERR_PRINT_OFF;
+		CHECK_FALSE(world.unload_chunk(0, 0));
+		ERR_PRINT_ON;
+
+		World::ChunkPin moved = std::move(pin);
+		CHECK_FALSE(pin.is_valid());
+		CHECK(world.is_chunk_pinned(0, 0));
+	}
+
+	// Releasing the last pin unloads the chunk that was evicted meanwhile.
+	CHECK_FALSE(world.is_chunk_pinned(0, 0));
+	CHECK_FALSE(world.is_chunk_ready(0, 0));
+	CHECK(world.get_resident_chunk_count() == 1);
+}
+
+TEST_CASE("[GameFramework][World] Clearing saves resident chunks") {
+	String path = TestUtils::get_temp_path("game_framework_chunks_clear");
+	StringName monster_id;
+	{
+		World world;
+		world.set_persistence_path(path);
+		Ref<Monster> monster = world.get_chunk(0, 0)->get_monster(0);
+		monster->set_health(2.0f);
+		monster_id = monster->get_object_id();
+		world.clear();
+		CHECK(world.get_resident_chunk_count() == 0);
+		CHECK(world.get_saving_count() == 0);
+	}
+
+	World world;
+	world.set_persistence_path(path);
+	Ref<Monster> reloaded = world.get_chunk(0, 0)->get_monster(0);
+	CHECK(reloaded->get_object_id() == monster_id);
+	CHECK(reloaded->get_health() == doctest::Approx(2.0f));
+}
+
+TEST_CASE("[GameFramework][World] Working set raises the resident limit only while needed") {
+	World world;
+	world.set_max_resident_chunks(2);
+
+	ERR_PRINT_OFF;
+	world.update_working_set(0, 0, 1);
+	ERR_PRINT_ON;
+	world.wait_pending_chunks();
+	CHECK(world.get_resident_chunk_count() == 9);
+	CHECK(world.get_max_resident_chunks() == 2);
+
+	// Shrinking the working set evicts back down to the configured limit, keeping the center.
+	world.update_working_set(0, 0, 0);
+	CHECK(world.get_resident_chunk_count() == 2);
+	CHECK(world.is_chunk_ready(0, 0));
+	CHECK(world.get_max_resident_chunks() == 2);
+}
+
+} // namespace TestChunk
@@ -0,0 +1,72 @@
+/**************************************************************************/
+/*  test_chunk_mesher.h                                                   */
+/**************************************************************************/
+
+#pragma once
+
+#include "../chunk_mesher.h"
+
+#include "scene/resources/mesh.h"
+#include "tests/test_macros.h"
+
+namespace TestChunkMesher {
+
+TEST_CASE("[GameFramework][ChunkMesher] Greedy quads cover every tile exactly once") {
+	Chunk *chunk = memnew(Chunk(ChunkCoord(4, -9)));
+
+	LocalVector<ChunkMesher::Quad> quads;
+	ChunkMesher::build_quads(chunk->tiles, quads);
+	CHECK(quads.size() < (uint32_t)(CHUNK_SIZE * CHUNK_SIZE));
+
+	LocalVector<uint8_t> coverage;
+	coverage.resize(CHUNK_SIZE * CHUNK_SIZE);
+	memset(coverage.ptr(), 0, coverage.size());
+	bool types_match = true;
+	for (const ChunkMesher::Quad &quad : quads) {
+		for (int y = quad.y; y < quad.y + quad.height; y++) {
+			for (int x = quad.x; x < quad.x + quad.width; x++) {
+				coverage[y * CHUNK_SIZE + x]++;
+				types_match = types_match && chunk->tiles.get_tile(x, y) == quad.type;
+			}
+		}
+	}
+	bool covered_once = true;
+	for (uint8_t count : coverage) {
+		covered_once = covered_once && count == 1;
+	}
+	CHECK_MESSAGE(types_match, "Every quad should only span tiles of its own type.");
+	CHECK_MESSAGE(covered_once, "Quads should cover each tile exactly once.");
+
+	// 冷存储的区块得到相同的结果
+	LocalVector<ChunkMesher::Quad> compressed_quads;
+	chunk->tiles.compress();
+	ChunkMesher::build_quads(chunk->tiles, compressed_quads);
+	CHECK(compressed_quads.size() == quads.size());
+
+	memdelete(chunk);
+}
+
+TEST_CASE("[GameFramework][ChunkMesher] Uniform terrain becomes a single quad") {
+	TileGrid tiles;
+	tiles.fill(TILE_FOREST);
+
+	LocalVector<ChunkMesher::Quad> quads;
+	ChunkMesher::build_quads(tiles, quads);
+	REQUIRE(quads.size() == 1);
+	CHECK(quads[0].width == CHUNK_SIZE);
+	CHECK(quads[0].height == CHUNK_SIZE);
+	CHECK(quads[0].type == TILE_FOREST);
+
+	Color palette[TILE_TYPE_MAX];
+	palette[TILE_FOREST] = Color(0.1f, 0.4f, 0.1f);
+	Array arrays = ChunkMesher::build_surface_arrays(quads, 2.0f, palette);
+	PackedVector3Array vertices = arrays[Mesh::ARRAY_VERTEX];
+	PackedColorArray colors = arrays[Mesh::ARRAY_COLOR];
+	PackedInt32Array indices = arrays[Mesh::ARRAY_INDEX];
+	CHECK(vertices.size() == 4);
+	CHECK(indices.size() == 6);
+	CHECK(vertices[2].is_equal_approx(Vector3(CHUNK_SIZE * 2.0f, 0, CHUNK_SIZE * 2.0f)));
+	CHECK(colors[0].is_equal_approx(palette[TILE_FOREST]));
+}
+
+} // namespace TestChunkMesher
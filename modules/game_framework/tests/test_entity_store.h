@@ -0,0 +1,132 @@
+/**************************************************************************/
+/*  test_entity_store.h                                                   */
+/**************************************************************************/
+
+#pragma once
+
+#include "../entity_store.h"
+#include "../monster.h"
+#include "../npc.h"
+#include "../world.h"
+
+#include "tests/test_macros.h"
+
+namespace TestEntityStore {
+
+static void setup_character(const Ref<Character> &p_character, int p_seed) {
+	p_character->set_max_health(100.0f + p_seed % 7);
+	p_character->set_health(10.0f + p_seed % 50);
+	p_character->set_health_regen(0.5f + (p_seed % 3));
+	p_character->set_max_mana(40.0f);
+	p_character->set_mana(p_seed % 40);
+	p_character->set_mana_regen((p_seed % 4) * 0.25f);
+}
+
+static Ref<Monster> create_monster(int p_seed) {
+	Ref<Monster> monster;
+	monster.instantiate();
+	setup_character(monster, p_seed);
+	monster->set_respawn_time(1.0f + (p_seed % 5) * 0.5f);
+	monster->set_spawn_position(Vector2i(p_seed, -p_seed));
+	if (p_seed % 3 == 0) {
+		monster->die();
+		monster->set_ai_state(MONSTER_AI_DEAD);
+	}
+	return monster;
+}
+
+TEST_CASE("[GameFramework][EntityStore] Batched tick matches per-object tick") {
+	// 超过一个批次，走并行路径
+	const int count = EntityStore::BATCH_SIZE * 2 + 17;
+
+	LocalVector<Ref<Character>> reference;
+	LocalVector<Ref<Character>> stored;
+	EntityStore store;
+	for (int i = 0; i < count; i++) {
+		if (i % 2) {
+			reference.push_back(create_monster(i));
+			stored.push_back(create_monster(i));
+		} else {
+			Ref<NPC> a;
+			Ref<NPC> b;
+			a.instantiate();
+			b.instantiate();
+			setup_character(a, i);
+			setup_character(b, i);
+			reference.push_back(a);
+			stored.push_back(b);
+		}
+		CHECK(store.add(stored[i].ptr()) == (uint32_t)i);
+	}
+
+	for (int step = 0; step < 40; step++) {
+		for (const Ref<Character> &character : reference) {
+			character->tick(0.1f);
+		}
+		store.tick_all(0.1f);
+	}
+
+	bool identical = true;
+	for (int i = 0; i < count; i++) {
+		identical = identical && reference[i]->get_health() == stored[i]->get_health();
+		identical = identical && reference[i]->get_mana() == stored[i]->get_mana();
+		identical = identical && reference[i]->get_state_flags() == stored[i]->get_state_flags();
+		identical = identical && reference[i]->get_local_position() == stored[i]->get_local_position();
+		Ref<Monster> reference_monster = reference[i];
+		if (reference_monster.is_valid()) {
+			Ref<Monster> stored_monster = stored[i];
+			identical = identical && reference_monster->get_ai_state() == stored_monster->get_ai_state();
+		}
+	}
+	CHECK_MESSAGE(identical, "Stored entities should end up in the same state as individually ticked ones.");
+
+	// 释放对象时自动从存储中移除
+	reference.clear();
+	stored.clear();
+	CHECK(store.get_size() == 0);
+}
+
+TEST_CASE("[GameFramework][EntityStore] Removal writes values back") {
+	EntityStore store;
+	Ref<Monster> first = create_monster(1);
+	Ref<Monster> second = create_monster(3); // 死亡状态
+	store.add(first.ptr());
+	store.add(second.ptr());
+
+	first->set_health(42.0f);
+	second->tick(0.5f);
+	store.remove(first.ptr());
+
+	CHECK(store.get_size() == 1);
+	CHECK(store.get_character(0) == second.ptr());
+	CHECK(first->get_health() == doctest::Approx(42.0f));
+	CHECK_FALSE(second->is_alive());
+	CHECK(second->serialize()["death_timer"] == Variant(0.5f));
+
+	store.remove(second.ptr());
+	CHECK(second->serialize()["death_timer"] == Variant(0.5f));
+	CHECK(second->get_ai_state() == MONSTER_AI_DEAD);
+}
+
+TEST_CASE("[GameFramework][EntityStore] Resident chunk entities are ticked through the world store") {
+	World world;
+	Chunk *chunk = world.get_chunk(0, 0);
+	REQUIRE(chunk->get_monster_count() > 0);
+	CHECK(world.get_entity_count() == chunk->get_monster_count() + chunk->get_npc_count());
+
+	Ref<Monster> monster = chunk->get_monster(0);
+	monster->set_max_health(100.0f);
+	monster->set_health(50.0f);
+	monster->set_health_regen(10.0f);
+	world.tick_entities(1.0f);
+	CHECK(monster->get_health() == doctest::Approx(60.0f));
+
+	// 卸载后属性拷回对象，脚本持有的引用仍然有效
+	CHECK(world.unload_chunk(0, 0));
+	CHECK(world.get_entity_count() == 0);
+	CHECK(monster->get_health() == doctest::Approx(60.0f));
+	monster->tick(1.0f);
+	CHECK(monster->get_health() == doctest::Approx(70.0f));
+}
+
+} // namespace TestEntityStore
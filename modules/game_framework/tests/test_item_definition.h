@@ -0,0 +1,148 @@
+/**************************************************************************/
+/*  test_item_definition.h                                                */
+/**************************************************************************/
+
+#pragma once
+
+#include "../item_definition.h"
+#include "../world_object.h"
+
+#include "tests/test_macros.h"
+
+namespace TestItemDefinition {
+
+static ItemDefinition make_definition(const StringName &p_id, ItemRarity p_rarity = ITEM_RARITY_COMMON) {
+	ItemDefinition definition;
+	definition.item_id = p_id;
+	definition.display_name = p_id;
+	definition.max_stack_size = 10;
+	definition.rarity = p_rarity;
+	return definition;
+}
+
+TEST_CASE("[GameFramework][ItemRegistry] Identical definitions are shared") {
+	uint32_t common = ItemRegistry::intern(make_definition("test_registry_ore"));
+	uint32_t common_again = ItemRegistry::intern(make_definition("test_registry_ore"));
+	uint32_t rare = ItemRegistry::intern(make_definition("test_registry_ore", ITEM_RARITY_RARE));
+
+	CHECK(common == common_again);
+	CHECK(common != rare);
+	// 同一物品ID的不同定义共享ID编号
+	CHECK(ItemRegistry::get(common).id_index == ItemRegistry::get(rare).id_index);
+	CHECK(ItemRegistry::find_id("test_registry_ore") == ItemRegistry::get(common).id_index);
+	CHECK(ItemRegistry::find_id("test_registry_never_used") == ItemRegistry::INVALID_INDEX);
+
+	// 无效索引（例如定义表已满时 intern() 的返回值）不会越界访问
+	ERR_PRINT_OFF;
+	CHECK(ItemRegistry::get(ItemRegistry::INVALID_INDEX).item_id == StringName());
+	ERR_PRINT_ON;
+
+	// 物品实例与定义之间可以互相转换
+	Ref<Item> item = Item::create_from_definition(rare, 4);
+	CHECK(item->get_rarity() == ITEM_RARITY_RARE);
+	CHECK(item->get_quantity() == 4);
+	CHECK(item->get_definition_index() == rare);
+
+	// 未登记的ID使用与 Item::create() 相同的默认定义
+	uint32_t fallback = ItemRegistry::get_default("test_registry_herb");
+	CHECK(ItemRegistry::get(fallback).max_stack_size == 1);
+	uint32_t registered = ItemRegistry::register_definition(make_definition("test_registry_herb"));
+	CHECK(ItemRegistry::get_default("test_registry_herb") == registered);
+}
+
+TEST_CASE("[GameFramework][ItemRegistry] Unreferenced definitions are reclaimed") {
+	const uint32_t live_before = ItemRegistry::get_live_count();
+
+	Ref<WorldObject> chest;
+	chest.instantiate();
+	chest->init_container(2);
+
+	// intern() 返回的引用交给槽位后释放，定义由槽位保持
+	uint32_t loot = ItemRegistry::intern(make_definition("test_reclaim_loot", ITEM_RARITY_EPIC));
+	CHECK(chest->container_add_stack(loot, 3));
+	ItemRegistry::release(loot);
+	CHECK(ItemRegistry::get_live_count() == live_before + 1);
+	CHECK(ItemRegistry::get(loot).item_id == StringName("test_reclaim_loot"));
+
+	// 物品缓存定义索引，修改定义属性后重新查找
+	Ref<Item> item = chest->container_get_item(0);
+	CHECK(item->get_definition_index() == loot);
+	item->set_rarity(ITEM_RARITY_LEGENDARY);
+	uint32_t legendary = item->get_definition_index();
+	CHECK(legendary != loot);
+	CHECK(ItemRegistry::get(legendary).rarity == ITEM_RARITY_LEGENDARY);
+	CHECK(ItemRegistry::get_live_count() == live_before + 2);
+
+	// 最后的引用释放后定义被回收
+	item.unref();
+	chest->container_clear();
+	CHECK(ItemRegistry::get_live_count() == live_before);
+	uint32_t reused = ItemRegistry::intern(make_definition("test_reclaim_other"));
+	CHECK((reused == loot || reused == legendary));
+	ItemRegistry::release(reused);
+	CHECK(ItemRegistry::get_live_count() == live_before);
+}
+
+TEST_CASE("[GameFramework][WorldObject] Container slots stack definition records") {
+	Ref<WorldObject> chest;
+	chest.instantiate();
+	chest->init_container(3);
+
+	uint32_t common = ItemRegistry::intern(make_definition("test_slot_gem"));
+	uint32_t rare = ItemRegistry::intern(make_definition("test_slot_gem", ITEM_RARITY_RARE));
+
+	// 相同ID的堆叠会合并（与 Item::can_stack_with() 一致，不比较稀有度）
+	CHECK(chest->container_add_stack(common, 6));
+	CHECK(chest->container_add_stack(rare, 7));
+	CHECK(chest->get_container_used_slots() == 2);
+	CHECK(chest->container_count_item("test_slot_gem") == 13);
+	CHECK(chest->container_find_item("test_slot_gem") == 0);
+	CHECK(chest->container_get_item(0)->get_quantity() == 10);
+	CHECK(chest->container_get_item(1)->get_rarity() == ITEM_RARITY_RARE);
+
+	// 取出的是快照，修改后需要写回
+	Ref<Item> snapshot = chest->container_get_item(1);
+	snapshot->set_quantity(1);
+	CHECK(chest->container_count_item("test_slot_gem") == 13);
+	chest->container_set_item(1, snapshot);
+	CHECK(chest->container_count_item("test_slot_gem") == 11);
+
+	CHECK(chest->container_remove_items("test_slot_gem", 10) == 10);
+	CHECK(chest->container_count_item("test_slot_gem") == 1);
+	CHECK(chest->get_container_used_slots() == 1);
+
+	// 按ID添加时超出堆叠上限的数量放入新的槽位
+	ItemRegistry::register_definition(make_definition("test_slot_arrow"));
+	CHECK(chest->container_add_items("test_slot_arrow", 15) == 0);
+	CHECK(chest->container_count_item("test_slot_arrow") == 15);
+	CHECK(chest->is_container_full());
+	CHECK(chest->container_add_items("test_slot_arrow", 20) == 15);
+}
+
+TEST_CASE("[GameFramework][WorldObject] Items with custom data keep their identity") {
+	Ref<WorldObject> chest;
+	chest.instantiate();
+	chest->init_container(2);
+
+	Ref<Item> letter = Item::create("test_unique_letter");
+	letter->set_custom_value("author", "Mira");
+	CHECK_FALSE(letter->is_flyweight_compatible());
+	CHECK(chest->container_add_item(letter));
+
+	CHECK(chest->container_get_item(0) == letter);
+	CHECK(chest->container_count_item("test_unique_letter") == 1);
+
+	// 保存/读取后自定义数据仍在
+	Ref<WorldObject> loaded;
+	loaded.instantiate();
+	loaded->deserialize(chest->serialize());
+	Ref<Item> loaded_letter = loaded->container_get_item(0);
+	REQUIRE(loaded_letter.is_valid());
+	CHECK(loaded_letter->get_custom_value("author") == Variant("Mira"));
+
+	Ref<Item> removed = chest->container_remove_item(0);
+	CHECK(removed == letter);
+	CHECK(chest->is_container_empty());
+}
+
+} // namespace TestItemDefinition
@@ -0,0 +1,128 @@
+/**************************************************************************/
+/*  test_lockstep.h                                                       */
+/**************************************************************************/
+
+#pragma once
+
+#include "../lockstep.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_utils.h"
+
+namespace TestLockstep {
+
+static LockstepSimulation::Command make_command(uint64_t p_tick, const StringName &p_target, LockstepSimulation::CommandType p_type, float p_amount = 0.0f) {
+	LockstepSimulation::Command command;
+	command.tick = p_tick;
+	command.target = p_target;
+	command.type = p_type;
+	command.amount = p_amount;
+	return command;
+}
+
+static void queue_script(LockstepSimulation &p_simulation, const StringName &p_target) {
+	p_simulation.queue_command(make_command(3, p_target, LockstepSimulation::COMMAND_DAMAGE, 40.0f));
+	p_simulation.queue_command(make_command(20, p_target, LockstepSimulation::COMMAND_KILL));
+	LockstepSimulation::Command move = make_command(21, p_target, LockstepSimulation::COMMAND_MOVE);
+	move.position = Vector2i(7, 9);
+	p_simulation.queue_command(move);
+}
+
+TEST_CASE("[GameFramework][Lockstep] Independent simulations produce identical hashes") {
+	// Both sides generate the chunk from its coordinate seed instead of exchanging a snapshot.
+	Chunk chunk_a(ChunkCoord(0, 0));
+	Chunk chunk_b(ChunkCoord(0, 0));
+	REQUIRE(chunk_a.get_monster_count() > 0);
+	for (int i = 0; i < chunk_a.get_monster_count(); i++) {
+		chunk_a.get_monster(i)->set_health_regen(2.5f);
+		chunk_a.get_monster(i)->set_respawn_time(0.5f);
+		chunk_b.get_monster(i)->set_health_regen(2.5f);
+		chunk_b.get_monster(i)->set_respawn_time(0.5f);
+	}
+
+	LockstepSimulation a;
+	a.add_chunk(&chunk_a);
+	// Insertion order must not matter.
+	LockstepSimulation b;
+	for (int i = chunk_b.get_npc_count() - 1; i >= 0; i--) {
+		b.add_character(chunk_b.get_npc(i));
+	}
+	for (int i = chunk_b.get_monster_count() - 1; i >= 0; i--) {
+		b.add_character(chunk_b.get_monster(i));
+	}
+	REQUIRE(a.get_character_count() == b.get_character_count());
+	CHECK(a.compute_state_hash() == b.compute_state_hash());
+
+	StringName target = chunk_a.get_monster(0)->get_object_id();
+	queue_script(a, target);
+	queue_script(b, target);
+
+	bool identical = true;
+	for (int i = 0; i < 60; i++) {
+		a.step_once();
+		b.step_once();
+		identical = identical && a.get_tick_hash() == b.get_tick_hash();
+	}
+	CHECK_MESSAGE(identical, "Every tick should hash the same on both sides.");
+	CHECK(a.get_state_hash() == b.get_state_hash());
+	CHECK(a.get_pending_command_count() == 0);
+	// Killed at tick 20 and respawned half a second later at its spawn point.
+	CHECK(chunk_a.get_monster(0)->is_alive());
+
+	// A command that only one side executes desyncs that tick and every later state hash.
+	b.queue_command(make_command(60, target, LockstepSimulation::COMMAND_DAMAGE, 1.0f));
+	a.step_once();
+	b.step_once();
+	CHECK(a.get_tick_hash() != b.get_tick_hash());
+	a.step_once();
+	b.step_once();
+	CHECK(a.get_state_hash() != b.get_state_hash());
+}
+
+TEST_CASE("[GameFramework][Lockstep] Recorded sessions replay without desync") {
+	String path = TestUtils::get_temp_path("game_framework_lockstep.replay");
+
+	Chunk chunk(ChunkCoord(0, 0));
+	REQUIRE(chunk.get_monster_count() > 0);
+	chunk.get_monster(0)->set_health_regen(1.0f);
+
+	Ref<Player> player;
+	player.instantiate();
+	player->set_object_id(StringName("player_1"));
+	player->set_health_regen(3.0f);
+	player->set_health(10.0f);
+
+	LockstepSimulation simulation;
+	simulation.add_chunk(&chunk);
+	simulation.add_character(player);
+	simulation.step_once();
+
+	REQUIRE(simulation.start_recording(path) == OK);
+	StringName target = chunk.get_monster(0)->get_object_id();
+	queue_script(simulation, target);
+	simulation.queue_command(make_command(8, StringName("player_1"), LockstepSimulation::COMMAND_HEAL, 5.0f));
+	CHECK(simulation.advance(simulation.get_step() * 40.5f) == 40);
+	simulation.stop_recording();
+
+	{
+		LockstepReplay replay;
+		REQUIRE(replay.open(path) == OK);
+		CHECK(replay.get_simulation().get_character_count() == simulation.get_character_count());
+		CHECK(replay.run() == UINT64_MAX);
+		CHECK(replay.is_finished());
+		CHECK(replay.get_simulation().get_tick() == simulation.get_tick());
+		CHECK(replay.get_simulation().get_state_hash() == simulation.get_state_hash());
+	}
+
+	{
+		LockstepReplay replay;
+		REQUIRE(replay.open(path) == OK);
+		// Diverge from the recorded state before the first replayed tick.
+		replay.get_simulation().get_character(0)->set_max_health(1.0f);
+		CHECK(replay.step() == false);
+		CHECK(replay.has_desync());
+		CHECK(replay.get_desync_tick() == 1);
+	}
+}
+
+} // namespace TestLockstep
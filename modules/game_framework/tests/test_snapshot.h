@@ -0,0 +1,188 @@
+/**************************************************************************/
+/*  test_snapshot.h                                                       */
+/**************************************************************************/
+
+#pragma once
+
+#include "../chunk.h"
+#include "../item_definition.h"
+#include "../player.h"
+#include "../snapshot.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_utils.h"
+
+namespace TestSnapshot {
+
+TEST_CASE("[GameFramework][Snapshot] Entities round trip through the binary format") {
+	String path = TestUtils::get_temp_path("game_framework_snapshot.bin");
+
+	Ref<Monster> monster;
+	monster.instantiate();
+	monster->set_object_id(StringName("wolf_1"));
+	monster->set_monster_id(StringName("wolf"));
+	monster->set_local_position(Vector2i(12, 200));
+	monster->set_rank(MONSTER_RANK_ELITE);
+	monster->set_max_health(250.0f);
+	monster->set_health(75.5f);
+	monster->set_exp_reward(int64_t(1) << 40);
+	monster->init_container(4);
+
+	ItemDefinition pelt;
+	pelt.item_id = StringName("pelt");
+	pelt.max_stack_size = 20;
+	pelt.rarity = ITEM_RARITY_RARE;
+	monster->container_add_stack(ItemRegistry::intern(pelt), 7);
+	Ref<Item> letter = Item::create(StringName("letter"));
+	Dictionary custom_data;
+	custom_data["author"] = "wolf";
+	letter->set_custom_data(custom_data);
+	monster->container_add_item_at(3, letter);
+
+	Ref<NPC> npc;
+	npc.instantiate();
+	npc->set_object_id(StringName("smith"));
+	npc->set_npc_type(NPC_TYPE_MERCHANT);
+	npc->set_is_merchant(true);
+	npc->set_shop_id(StringName("shop_smith"));
+	npc->init_container(2);
+	npc->container_add_stack(ItemRegistry::intern(pelt), 3);
+
+	Ref<Player> player;
+	player.instantiate();
+	player->set_player_id(StringName("p1"));
+	player->set_character_name(StringName("Hero"));
+	player->add_gold(1234);
+
+	{
+		Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+		REQUIRE(file.is_valid());
+		SnapshotWriter writer(file);
+		monster->write_snapshot(writer);
+		npc->write_snapshot(writer);
+		player->write_snapshot(writer);
+		CHECK(writer.get_error() == OK);
+	}
+
+	Ref<FileAccess> file = FileAccess::open(path, FileAccess::READ);
+	REQUIRE(file.is_valid());
+	SnapshotReader reader(file, SnapshotWriter::VERSION);
+
+	Ref<Monster> loaded_monster;
+	loaded_monster.instantiate();
+	loaded_monster->read_snapshot(reader);
+	Ref<NPC> loaded_npc;
+	loaded_npc.instantiate();
+	loaded_npc->read_snapshot(reader);
+	Ref<Player> loaded_player;
+	loaded_player.instantiate();
+	loaded_player->read_snapshot(reader);
+	CHECK_FALSE(reader.is_corrupt());
+
+	// The dictionary form covers every field, so it is a convenient way to compare.
+	CHECK(loaded_monster->serialize() == monster->serialize());
+	CHECK(loaded_npc->serialize() == npc->serialize());
+	CHECK(loaded_player->serialize() == player->serialize());
+
+	CHECK(loaded_monster->container_count_item(StringName("pelt")) == 7);
+	Ref<Item> loaded_letter = loaded_monster->container_get_item(3);
+	REQUIRE(loaded_letter.is_valid());
+	CHECK(loaded_letter->get_custom_data() == custom_data);
+}
+
+TEST_CASE("[GameFramework][Snapshot] Oversized container capacity is rejected") {
+	String path = TestUtils::get_temp_path("game_framework_snapshot_capacity.bin");
+	{
+		Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+		REQUIRE(file.is_valid());
+		SnapshotWriter writer(file);
+		writer.write_name(StringName("chest"));
+		writer.write_u8(WorldObject::TYPE_CONTAINER);
+		writer.write_s32(0);
+		writer.write_s32(0);
+		writer.write_s32(WorldObject::MAX_CONTAINER_CAPACITY + 1);
+		writer.write_s32(0);
+	}
+
+	Ref<WorldObject> object;
+	object.instantiate();
+	SnapshotReader reader(FileAccess::open(path, FileAccess::READ), SnapshotWriter::VERSION);
+	object->read_snapshot(reader);
+	CHECK(reader.is_corrupt());
+	CHECK(object->get_container_capacity() == 0);
+}
+
+TEST_CASE("[GameFramework][Snapshot] Chunk save files") {
+	String path = TestUtils::get_temp_path("game_framework_chunk_snapshot.bin");
+	Chunk generated(ChunkCoord(4, -2));
+	REQUIRE(generated.get_monster_count() + generated.get_npc_count() + generated.get_city_count() > 0);
+
+	{
+		Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+		REQUIRE(file.is_valid());
+		CHECK(generated.save(file) == OK);
+	}
+
+	SUBCASE("Binary snapshot round trip") {
+		Chunk loaded(ChunkCoord(4, -2), false);
+		CHECK(loaded.load(FileAccess::open(path, FileAccess::READ)) == OK);
+
+		REQUIRE(loaded.get_city_count() == generated.get_city_count());
+		for (int i = 0; i < generated.get_city_count(); i++) {
+			CHECK(loaded.cities[i].position == generated.cities[i].position);
+			CHECK(loaded.get_city_object(i)->serialize() == generated.get_city_object(i)->serialize());
+		}
+		REQUIRE(loaded.get_monster_count() == generated.get_monster_count());
+		for (int i = 0; i < generated.get_monster_count(); i++) {
+			CHECK(loaded.get_monster(i)->serialize() == generated.get_monster(i)->serialize());
+		}
+		REQUIRE(loaded.get_npc_count() == generated.get_npc_count());
+		for (int i = 0; i < generated.get_npc_count(); i++) {
+			CHECK(loaded.get_npc(i)->serialize() == generated.get_npc(i)->serialize());
+		}
+	}
+
+	SUBCASE("Truncated files are rejected") {
+		Vector<uint8_t> data = FileAccess::get_file_as_bytes(path);
+		Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+		file->store_buffer(data.ptr(), data.size() - 5);
+		file.unref();
+
+		Chunk loaded(ChunkCoord(4, -2), false);
+		ERR_PRINT_OFF;
+		CHECK(loaded.load(FileAccess::open(path, FileAccess::READ)) == ERR_FILE_CORRUPT);
+		ERR_PRINT_ON;
+	}
+
+	SUBCASE("Version 1 dictionary saves still load") {
+		Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+		file->store_32(Chunk::SAVE_MAGIC);
+		file->store_32(1);
+		file->store_32((uint32_t)generated.coord.x);
+		file->store_32((uint32_t)generated.coord.y);
+		file->store_32((uint32_t)generated.center_x);
+		file->store_32((uint32_t)generated.center_y);
+		LocalVector<uint8_t> rle = generated.tiles.get_rle_data();
+		file->store_32(rle.size());
+		file->store_buffer(rle.ptr(), rle.size());
+		file->store_32(0);
+		file->store_32(1);
+		file->store_32(3);
+		file->store_32(5);
+		Dictionary monster_data;
+		monster_data["object_id"] = StringName("legacy_monster");
+		monster_data["health"] = 42.0f;
+		file->store_var(monster_data);
+		file->store_32(0);
+		file.unref();
+
+		Chunk loaded(generated.coord, false);
+		CHECK(loaded.load(FileAccess::open(path, FileAccess::READ)) == OK);
+		REQUIRE(loaded.get_monster_count() == 1);
+		CHECK(loaded.monsters[0].position == Vector2i(3, 5));
+		CHECK(loaded.get_monster(0)->get_object_id() == StringName("legacy_monster"));
+		CHECK(loaded.get_monster(0)->get_health() == doctest::Approx(42.0f));
+	}
+}
+
+} // namespace TestSnapshot
@@ -0,0 +1,217 @@
+/**************************************************************************/
+/*  test_spatial_index.h                                                  */
+/**************************************************************************/
+
+#pragma once
+
+#include "../monster.h"
+#include "../player.h"
+#include "../spatial_index.h"
+#include "../state_hash.h"
+#include "../world.h"
+
+#include "core/math/random_pcg.h"
+#include "tests/test_macros.h"
+
+namespace TestSpatialIndex {
+
+static bool contains(const LocalVector<WorldObject *> &p_objects, const WorldObject *p_object) {
+	for (const WorldObject *object : p_objects) {
+		if (object == p_object) {
+			return true;
+		}
+	}
+	return false;
+}
+
+TEST_CASE("[GameFramework][SpatialIndex] Queries match brute force after moves") {
+	SpatialIndex index(16);
+	LocalVector<Ref<WorldObject>> objects;
+	RandomPCG rng(1234);
+
+	for (int i = 0; i < 500; i++) {
+		Ref<WorldObject> object;
+		object.instantiate();
+		object->set_local_position(Vector2i(rng.rand(CHUNK_SIZE), rng.rand(CHUNK_SIZE)));
+		// 分布在原点周围的 3x3 个区块中
+		index.insert(object.ptr(), Vector2i(rng.random(-1, 1), rng.random(-1, 1)) * CHUNK_SIZE);
+		objects.push_back(object);
+	}
+	CHECK(index.get_object_count() == 500);
+
+	// 移动一部分物体，索引应自动更新
+	for (int i = 0; i < 200; i++) {
+		objects[rng.rand(objects.size())]->set_local_position(Vector2i(rng.rand(CHUNK_SIZE), rng.rand(CHUNK_SIZE)));
+	}
+
+	bool radius_ok = true;
+	bool rect_ok = true;
+	bool nearest_ok = true;
+	for (int query = 0; query < 50; query++) {
+		Vector2i center(rng.random(-300, 300), rng.random(-300, 300));
+		float radius = rng.random(0, 120);
+
+		LocalVector<WorldObject *> found;
+		index.query_radius(center, radius, found);
+		uint32_t expected = 0;
+		for (const Ref<WorldObject> &object : objects) {
+			Vector2i offset = object->get_world_position() - center;
+			if (offset.x * offset.x + offset.y * offset.y <= radius * radius) {
+				expected++;
+				radius_ok = radius_ok && contains(found, object.ptr());
+			}
+		}
+		radius_ok = radius_ok && found.size() == expected;
+
+		Rect2i rect(center, Vector2i(rng.rand(100), rng.rand(100)));
+		found.clear();
+		index.query_rect(rect, found);
+		expected = 0;
+		for (const Ref<WorldObject> &object : objects) {
+			if (rect.has_point(object->get_world_position())) {
+				expected++;
+				rect_ok = rect_ok && contains(found, object.ptr());
+			}
+		}
+		rect_ok = rect_ok && found.size() == expected;
+
+		// 最近的 5 个：结果按距离升序，且没有遗漏更近的物体
+		found.clear();
+		index.query_nearest(center, 5, found, Math::INF);
+		nearest_ok = nearest_ok && found.size() == 5;
+		int last_distance = 0;
+		for (const WorldObject *object : found) {
+			Vector2i offset = object->get_world_position() - center;
+			int distance = offset.x * offset.x + offset.y * offset.y;
+			nearest_ok = nearest_ok && distance >= last_distance;
+			last_distance = distance;
+		}
+		for (const Ref<WorldObject> &object : objects) {
+			Vector2i offset = object->get_world_position() - center;
+			if (offset.x * offset.x + offset.y * offset.y < last_distance) {
+				nearest_ok = nearest_ok && contains(found, object.ptr());
+			}
+		}
+	}
+	CHECK_MESSAGE(radius_ok, "Radius queries should match a brute force scan.");
+	CHECK_MESSAGE(rect_ok, "Rect queries should match a brute force scan.");
+	CHECK_MESSAGE(nearest_ok, "Nearest queries should return the closest objects in order.");
+
+	// 释放的物体自动离开索引
+	objects.clear();
+	CHECK(index.get_object_count() == 0);
+}
+
+TEST_CASE("[GameFramework][SpatialIndex] Monster detection and chase range") {
+	SpatialIndex index;
+	Ref<Monster> monster;
+	monster.instantiate();
+	monster->set_detection_range(10.0f);
+	monster->set_chase_range(20.0f);
+	monster->set_spawn_position(Vector2i(5, 5));
+	monster->set_local_position(Vector2i(5, 5));
+
+	CHECK(monster->find_detection_target().is_null());
+	index.insert(monster.ptr(), Vector2i(CHUNK_SIZE, 0));
+
+	Ref<Player> far_player;
+	far_player.instantiate();
+	far_player->set_local_position(Vector2i(5, 30));
+	index.insert(far_player.ptr(), Vector2i(CHUNK_SIZE, 0));
+
+	Ref<NPC> npc;
+	npc.instantiate();
+	npc->set_local_position(Vector2i(6, 5));
+	index.insert(npc.ptr(), Vector2i(CHUNK_SIZE, 0));
+
+	// NPC 为中立阵营，玩家在侦测范围外
+	CHECK(monster->find_detection_target().is_null());
+
+	// 玩家跨区块靠近：位于左侧区块的最右边，与怪物相距 6 格
+	Ref<Player> near_player;
+	near_player.instantiate();
+	near_player->set_local_position(Vector2i(CHUNK_SIZE - 1, 5));
+	index.insert(near_player.ptr(), Vector2i(0, 0));
+	CHECK(monster->find_detection_target() == near_player);
+
+	monster->enter_combat(near_player.ptr());
+	CHECK_FALSE(monster->is_target_out_of_chase_range());
+	near_player->set_local_position(Vector2i(CHUNK_SIZE - 30, 5));
+	CHECK(monster->is_target_out_of_chase_range());
+	CHECK(monster->find_detection_target().is_null());
+
+	far_player->set_local_position(Vector2i(5, 12));
+	CHECK(monster->find_detection_target() == far_player);
+	far_player->die();
+	CHECK(monster->find_detection_target().is_null());
+}
+
+TEST_CASE("[GameFramework][World] Resident chunk objects are indexed") {
+	World world;
+	Chunk *chunk = world.get_chunk(2, -1);
+	uint32_t object_count = chunk->get_city_count() + chunk->get_monster_count() + chunk->get_npc_count();
+	CHECK(world.get_spatial_index().get_object_count() == object_count);
+
+	if (chunk->get_monster_count() > 0) {
+		Ref<Monster> monster = chunk->get_monster(0);
+		CHECK(monster->get_chunk_origin() == Vector2i(2 * CHUNK_SIZE, -CHUNK_SIZE));
+
+		LocalVector<WorldObject *> found;
+		world.get_spatial_index().query_radius(monster->get_world_position(), 0.0f, found);
+		CHECK(contains(found, monster.ptr()));
+
+		// 卸载后即使脚本仍持有引用，物体也不再出现在索引中
+		CHECK(world.unload_chunk(2, -1));
+		CHECK(monster->get_spatial_index() == nullptr);
+	} else {
+		CHECK(world.unload_chunk(2, -1));
+	}
+	CHECK(world.get_spatial_index().get_object_count() == 0);
+}
+
+TEST_CASE("[GameFramework][World] Monster AI detects indexed players") {
+	World world;
+	Chunk *chunk = world.get_chunk(0, 0);
+	REQUIRE(chunk->get_monster_count() > 0);
+	Ref<Monster> monster = chunk->get_monster(0);
+	REQUIRE(monster->is_alive());
+
+	Ref<Player> player;
+	player.instantiate();
+	player->set_object_id(StringName("test_ai_player"));
+	player->set_local_position(monster->get_world_position() + Vector2i(1, 0));
+	// tick() 本身不执行 AI
+	monster->tick(0.1f);
+	CHECK(monster->get_ai_state() == MONSTER_AI_IDLE);
+	world.tick_entities(0.1f);
+	// 玩家未加入索引时无法被侦测到
+	CHECK(monster->get_ai_state() == MONSTER_AI_IDLE);
+
+	StateHasher idle_hash;
+	monster->hash_state(idle_hash);
+
+	CHECK(world.add_object(player.ptr()));
+	monster->tick(0.1f);
+	CHECK(monster->get_ai_state() == MONSTER_AI_IDLE);
+	world.tick_entities(0.1f);
+	CHECK(monster->get_ai_state() == MONSTER_AI_CHASE);
+	CHECK(monster->get_target() == player.ptr());
+	// 目标以 object_id 参与状态哈希
+	CHECK(monster->get_target_object_id() == StringName("test_ai_player"));
+	StateHasher chase_hash;
+	monster->hash_state(chase_hash);
+	CHECK(chase_hash.hash != idle_hash.hash);
+
+	// 超出追击范围后脱离战斗，回到出生点后恢复空闲
+	player->set_local_position(monster->get_world_position() + Vector2i((int)monster->get_chase_range() + 1, 0));
+	world.tick_entities(0.1f);
+	CHECK(monster->get_ai_state() == MONSTER_AI_RETURN);
+	CHECK_FALSE(monster->has_target());
+	world.tick_entities(0.1f);
+	CHECK(monster->get_ai_state() == MONSTER_AI_IDLE);
+
+	CHECK(world.remove_object(player.ptr()));
+	CHECK(player->get_spatial_index() == nullptr);
+}
+
+} // namespace TestSpatialIndex
@@ -0,0 +1,165 @@
+/**************************************************************************/
+/*  tile_grid.cpp                                                         */
+/**************************************************************************/
+
+#include "tile_grid.h"
+
+#include "core/error/error_macros.h"
+
+static_assert(TILE_TYPE_MAX <= 8, "Tile types must fit in the 3-bit RLE type field.");
+
+TileGrid::TileGrid() {
+	packed.resize(CHUNK_SIZE * PACKED_ROW_BYTES);
+	memset(packed.ptr(), 0, packed.size());
+}
+
+void TileGrid::_decode_rle_row(int p_y, uint8_t *r_types) const {
+	const uint8_t *src = rle.ptr() + rle_rows[p_y];
+	int x = 0;
+	while (x < CHUNK_SIZE) {
+		uint8_t byte = *src++;
+		int length = (byte & 0x1F) + 1;
+		memset(r_types + x, byte >> 5, length);
+		x += length;
+	}
+}
+
+TileType TileGrid::_get_tile_compressed(int p_x, int p_y) const {
+	const uint8_t *src = rle.ptr() + rle_rows[p_y];
+	int x = 0;
+	while (true) {
+		uint8_t byte = *src++;
+		x += (byte & 0x1F) + 1;
+		if (p_x < x) {
+			return static_cast<TileType>(byte >> 5);
+		}
+	}
+}
+
+void TileGrid::set_tile(int p_x, int p_y, TileType p_type) {
+	if (unlikely(is_compressed())) {
+		decompress();
+	}
+	uint8_t &byte = packed[p_y * PACKED_ROW_BYTES + (p_x >> 1)];
+	if (p_x & 1) {
+		byte = (byte & 0x0F) | (uint8_t)(p_type << 4);
+	} else {
+		byte = (byte & 0xF0) | (uint8_t)p_type;
+	}
+}
+
+void TileGrid::fill(TileType p_type) {
+	if (is_compressed()) {
+		rle.clear();
+		rle_rows.clear();
+		packed.resize(CHUNK_SIZE * PACKED_ROW_BYTES);
+	}
+	memset(packed.ptr(), (uint8_t)(p_type | (p_type << 4)), packed.size());
+}
+
+void TileGrid::get_row(int p_y, uint8_t *r_types) const {
+	if (is_compressed()) {
+		_decode_rle_row(p_y, r_types);
+		return;
+	}
+	const uint8_t *src = packed.ptr() + p_y * PACKED_ROW_BYTES;
+	for (int i = 0; i < PACKED_ROW_BYTES; i++) {
+		r_types[i * 2] = src[i] & 0xF;
+		r_types[i * 2 + 1] = src[i] >> 4;
+	}
+}
+
+void TileGrid::set_row(int p_y, const uint8_t *p_types) {
+	if (unlikely(is_compressed())) {
+		decompress();
+	}
+	uint8_t *dst = packed.ptr() + p_y * PACKED_ROW_BYTES;
+	for (int i = 0; i < PACKED_ROW_BYTES; i++) {
+		dst[i] = p_types[i * 2] | (uint8_t)(p_types[i * 2 + 1] << 4);
+	}
+}
+
+void TileGrid::compress() {
+	if (is_compressed()) {
+		return;
+	}
+
+	rle.clear();
+	rle_rows.resize(CHUNK_SIZE);
+
+	uint8_t row[CHUNK_SIZE];
+	for (int y = 0; y < CHUNK_SIZE; y++) {
+		get_row(y, row);
+		rle_rows[y] = rle.size();
+
+		int x = 0;
+		while (x < CHUNK_SIZE) {
+			uint8_t type = row[x];
+			int length = 1;
+			while (x + length < CHUNK_SIZE && length < RLE_MAX_RUN && row[x + length] == type) {
+				length++;
+			}
+			rle.push_back(_rle_byte(type, length));
+			x += length;
+		}
+	}
+
+	packed.reset();
+}
+
+void TileGrid::decompress() {
+	if (!is_compressed()) {
+		return;
+	}
+
+	packed.resize(CHUNK_SIZE * PACKED_ROW_BYTES);
+	uint8_t row[CHUNK_SIZE];
+	for (int y = 0; y < CHUNK_SIZE; y++) {
+		_decode_rle_row(y, row);
+		uint8_t *dst = packed.ptr() + y * PACKED_ROW_BYTES;
+		for (int i = 0; i < PACKED_ROW_BYTES; i++) {
+			dst[i] = row[i * 2] | (uint8_t)(row[i * 2 + 1] << 4);
+		}
+	}
+
+	rle.reset();
+	rle_rows.reset();
+}
+
+LocalVector<uint8_t> TileGrid::get_rle_data() const {
+	if (is_compressed()) {
+		return rle;
+	}
+	TileGrid copy = *this;
+	copy.compress();
+	return copy.rle;
+}
+
+bool TileGrid::set_rle_data(const uint8_t *p_data, uint32_t p_size) {
+	// 校验每行恰好覆盖 CHUNK_SIZE 格，同时重建行偏移
+	LocalVector<uint16_t> rows;
+	rows.resize(CHUNK_SIZE);
+	uint32_t offset = 0;
+	for (int y = 0; y < CHUNK_SIZE; y++) {
+		rows[y] = offset;
+		int x = 0;
+		while (x < CHUNK_SIZE) {
+			ERR_FAIL_COND_V_MSG(offset >= p_size, false, "Truncated tile RLE data.");
+			uint8_t byte = p_data[offset++];
+			ERR_FAIL_COND_V_MSG((byte >> 5) >= TILE_TYPE_MAX, false, "Invalid tile type in RLE data.");
+			x += (byte & 0x1F) + 1;
+		}
+		ERR_FAIL_COND_V_MSG(x != CHUNK_SIZE, false, "Tile RLE run crosses a row boundary.");
+	}
+	ERR_FAIL_COND_V_MSG(offset != p_size, false, "Trailing bytes after tile RLE data.");
+
+	packed.reset();
+	rle.resize(p_size);
+	memcpy(rle.ptr(), p_data, p_size);
+	rle_rows = rows;
+	return true;
+}
+
+size_t TileGrid::get_memory_usage() const {
+	return packed.size() + rle.size() + rle_rows.size() * sizeof(uint16_t);
+}
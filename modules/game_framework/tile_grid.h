@@ -0,0 +1,68 @@
+/**************************************************************************/
+/*  tile_grid.h                                                           */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/templates/local_vector.h"
+
+// 地块类型
+enum TileType {
+	TILE_CITY,      // 城市中心
+	TILE_TOWN,      // 城镇
+	TILE_VILLAGE,   // 村庄
+	TILE_GRASSLAND, // 草原
+	TILE_FOREST,    // 树林
+	TILE_MOUNTAIN,  // 山地
+	TILE_TYPE_MAX
+};
+
+// 区块常量
+constexpr int CHUNK_SIZE = 256;
+
+// 区块地形存储
+// 热数据：每格 4 位（两格一个字节），256x256 的区块占 32 KiB，随机访问 O(1)
+// 冷数据：按行游程编码，每个游程一个字节（高 3 位类型，低 5 位长度 - 1），游程不跨行，
+//        因此仍然可以逐行读取而无需解压整个区块
+class TileGrid {
+public:
+	static constexpr int PACKED_ROW_BYTES = CHUNK_SIZE / 2;
+	static constexpr int RLE_MAX_RUN = 32;
+
+private:
+	LocalVector<uint8_t> packed;      // 热数据（压缩时为空）
+	LocalVector<uint8_t> rle;         // 冷数据（未压缩时为空）
+	LocalVector<uint16_t> rle_rows;   // 每行在 rle 中的起始偏移
+
+	_FORCE_INLINE_ static uint8_t _rle_byte(uint8_t p_type, int p_length) { return (uint8_t)((p_type << 5) | (p_length - 1)); }
+	void _decode_rle_row(int p_y, uint8_t *r_types) const;
+
+public:
+	TileGrid();
+
+	_FORCE_INLINE_ TileType get_tile(int p_x, int p_y) const {
+		if (likely(!packed.is_empty())) {
+			uint8_t byte = packed[p_y * PACKED_ROW_BYTES + (p_x >> 1)];
+			return static_cast<TileType>((p_x & 1) ? (byte >> 4) : (byte & 0xF));
+		}
+		return _get_tile_compressed(p_x, p_y);
+	}
+	TileType _get_tile_compressed(int p_x, int p_y) const;
+	void set_tile(int p_x, int p_y, TileType p_type);
+	void fill(TileType p_type);
+
+	// 按行读写，r_types/p_types 为 CHUNK_SIZE 个 TileType 数值
+	void get_row(int p_y, uint8_t *r_types) const;
+	void set_row(int p_y, const uint8_t *p_types);
+
+	// 冷热转换
+	void compress();
+	void decompress();
+	bool is_compressed() const { return packed.is_empty(); }
+
+	// 游程数据（冷数据的序列化形式）
+	LocalVector<uint8_t> get_rle_data() const;
+	bool set_rle_data(const uint8_t *p_data, uint32_t p_size);
+
+	size_t get_memory_usage() const;
+};
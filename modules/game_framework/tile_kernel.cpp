@@ -0,0 +1,154 @@
+/**************************************************************************/
+/*  tile_kernel.cpp                                                       */
+/**************************************************************************/
+
+#include "tile_kernel.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TILE_KERNEL_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define TILE_KERNEL_NEON
+#include <arm_neon.h>
+#endif
+
+// 地形阈值，顺序对应 TILE_CITY .. TILE_MOUNTAIN
+// 归一化距离不小于第 i 个阈值时地形类型至少为 i + 1，因此类型等于"越过的阈值个数"
+static const float TILE_THRESHOLDS[5] = { 0.08f, 0.15f, 0.25f, 0.45f, 0.70f };
+
+namespace TileKernel {
+
+bool fill_row_noise(RandomPCG &r_rng, int p_width, float *r_noise) {
+	for (int x = 0; x < p_width; x++) {
+		float value = r_rng.randf();
+		// 只有首个随机数为 0 时 randf() 才返回 0，此时流少消耗一个 rand()，后续行的跳转不再成立
+		if (unlikely(value == 0.0f)) {
+			return false;
+		}
+		r_noise[x] = value * 0.15f;
+	}
+	return true;
+}
+
+RandomPCG seek_row(const RandomPCG &p_rng, int p_row, int p_width) {
+	RandomPCG rng = p_rng;
+	rng.advance((uint64_t)p_row * (uint64_t)p_width * RANDS_PER_TILE);
+	return rng;
+}
+
+void classify_row_scalar(int p_y, int p_width, int p_center_x, int p_center_y, float p_max_dist, const float *p_noise, uint8_t *r_row) {
+	int dy = p_y - p_center_y;
+	for (int x = 0; x < p_width; x++) {
+		int dx = x - p_center_x;
+		float dist = std::sqrt((float)(dx * dx + dy * dy));
+		float normalized_dist = dist / p_max_dist;
+		normalized_dist += p_noise[x];
+
+		uint8_t type = 0;
+		for (int i = 0; i < 5; i++) {
+			type += normalized_dist >= TILE_THRESHOLDS[i] ? 1 : 0;
+		}
+		r_row[x] = type;
+	}
+}
+
+#ifdef TILE_KERNEL_SSE2
+
+// 4 格：返回每格越过的阈值个数（int32）
+static _FORCE_INLINE_ __m128i _classify4(__m128 p_dx, __m128 p_dy2, __m128 p_max_dist, const float *p_noise) {
+	// 坐标差的平方和小于 2^24，在 float 中精确表示，与整数运算后再转换的结果相同
+	__m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(p_dx, p_dx), p_dy2));
+	__m128 nd = _mm_add_ps(_mm_div_ps(dist, p_max_dist), _mm_loadu_ps(p_noise));
+
+	// 比较结果为全 1（即 -1），累减得到越过的阈值个数
+	__m128i count = _mm_setzero_si128();
+	for (int i = 0; i < 5; i++) {
+		count = _mm_sub_epi32(count, _mm_castps_si128(_mm_cmpge_ps(nd, _mm_set1_ps(TILE_THRESHOLDS[i]))));
+	}
+	return count;
+}
+
+void classify_row(int p_y, int p_width, int p_center_x, int p_center_y, float p_max_dist, const float *p_noise, uint8_t *r_row) {
+	int dy = p_y - p_center_y;
+	const __m128 dy2 = _mm_set1_ps((float)(dy * dy));
+	const __m128 max_dist = _mm_set1_ps(p_max_dist);
+	const __m128 four = _mm_set1_ps(4.0f);
+
+	int x = 0;
+	__m128 dx = _mm_setr_ps((float)(0 - p_center_x), (float)(1 - p_center_x), (float)(2 - p_center_x), (float)(3 - p_center_x));
+	for (; x + 16 <= p_width; x += 16) {
+		__m128i a = _classify4(dx, dy2, max_dist, p_noise + x);
+		dx = _mm_add_ps(dx, four);
+		__m128i b = _classify4(dx, dy2, max_dist, p_noise + x + 4);
+		dx = _mm_add_ps(dx, four);
+		__m128i c = _classify4(dx, dy2, max_dist, p_noise + x + 8);
+		dx = _mm_add_ps(dx, four);
+		__m128i d = _classify4(dx, dy2, max_dist, p_noise + x + 12);
+		dx = _mm_add_ps(dx, four);
+
+		__m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+		_mm_storeu_si128((__m128i *)(r_row + x), packed);
+	}
+
+	if (x < p_width) {
+		// 剩余不足 16 格的部分走标量实现（dx 以 x 为起点重新计算）
+		classify_row_scalar(p_y, p_width - x, p_center_x - x, p_center_y, p_max_dist, p_noise + x, r_row + x);
+	}
+}
+
+#elif defined(TILE_KERNEL_NEON)
+
+static _FORCE_INLINE_ uint32x4_t _classify4(float32x4_t p_dx, float32x4_t p_dy2, float32x4_t p_max_dist, const float *p_noise) {
+	// 显式分开乘法和加法，避免编译器合并为 FMA 导致与标量结果不一致
+	float32x4_t dx2 = vmulq_f32(p_dx, p_dx);
+	float32x4_t dist = vsqrtq_f32(vaddq_f32(dx2, p_dy2));
+	float32x4_t nd = vaddq_f32(vdivq_f32(dist, p_max_dist), vld1q_f32(p_noise));
+
+	uint32x4_t count = vdupq_n_u32(0);
+	for (int i = 0; i < 5; i++) {
+		count = vsubq_u32(count, vcgeq_f32(nd, vdupq_n_f32(TILE_THRESHOLDS[i])));
+	}
+	return count;
+}
+
+void classify_row(int p_y, int p_width, int p_center_x, int p_center_y, float p_max_dist, const float *p_noise, uint8_t *r_row) {
+	int dy = p_y - p_center_y;
+	const float32x4_t dy2 = vdupq_n_f32((float)(dy * dy));
+	const float32x4_t max_dist = vdupq_n_f32(p_max_dist);
+	const float32x4_t four = vdupq_n_f32(4.0f);
+
+	const float start[4] = { (float)(0 - p_center_x), (float)(1 - p_center_x), (float)(2 - p_center_x), (float)(3 - p_center_x) };
+	float32x4_t dx = vld1q_f32(start);
+
+	int x = 0;
+	for (; x + 16 <= p_width; x += 16) {
+		uint32x4_t a = _classify4(dx, dy2, max_dist, p_noise + x);
+		dx = vaddq_f32(dx, four);
+		uint32x4_t b = _classify4(dx, dy2, max_dist, p_noise + x + 4);
+		dx = vaddq_f32(dx, four);
+		uint32x4_t c = _classify4(dx, dy2, max_dist, p_noise + x + 8);
+		dx = vaddq_f32(dx, four);
+		uint32x4_t d = _classify4(dx, dy2, max_dist, p_noise + x + 12);
+		dx = vaddq_f32(dx, four);
+
+		uint16x8_t ab = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+		uint16x8_t cd = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+		vst1q_u8(r_row + x, vcombine_u8(vmovn_u16(ab), vmovn_u16(cd)));
+	}
+
+	if (x < p_width) {
+		classify_row_scalar(p_y, p_width - x, p_center_x - x, p_center_y, p_max_dist, p_noise + x, r_row + x);
+	}
+}
+
+#else
+
+void classify_row(int p_y, int p_width, int p_center_x, int p_center_y, float p_max_dist, const float *p_noise, uint8_t *r_row) {
+	classify_row_scalar(p_y, p_width, p_center_x, p_center_y, p_max_dist, p_noise, r_row);
+}
+
+#endif
+
+} // namespace TileKernel
@@ -0,0 +1,36 @@
+/**************************************************************************/
+/*  tile_kernel.h                                                         */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/random_pcg.h"
+
+// 地形分类内核
+// 把 Chunk::generate() 的逐格循环拆成两步：
+// 1. 按行从 PCG 流中取出扰动值（行首可以通过 RandomPCG::advance() 直接跳转，因此行可以乱序计算）
+// 2. 对整行做距离 + 阈值分类，SSE2/NEON 下每次处理 16 格，其他平台走标量实现
+// 输出为 TileType 的数值，与原始逐格实现逐位一致。
+namespace TileKernel {
+
+// 每次 randf() 消耗的 rand() 数量，与 RandomPCG::randf() 的两种实现保持一致
+#if defined(CLZ32)
+// 正常情况下消耗两个（首个随机数为 0 时除外）
+constexpr uint64_t RANDS_PER_TILE = 2;
+#else
+// 位截断实现固定消耗一个
+constexpr uint64_t RANDS_PER_TILE = 1;
+#endif
+
+// 填充一行扰动值（randf() * 0.15f）
+// randf() 在首个随机数为 0 时（概率 2^-32）只消耗一个 rand()，此时返回 false，调用方应回退到逐格实现
+bool fill_row_noise(RandomPCG &r_rng, int p_width, float *r_noise);
+
+// 根据到中心点的距离和扰动值对一行分类
+void classify_row(int p_y, int p_width, int p_center_x, int p_center_y, float p_max_dist, const float *p_noise, uint8_t *r_row);
+void classify_row_scalar(int p_y, int p_width, int p_center_x, int p_center_y, float p_max_dist, const float *p_noise, uint8_t *r_row);
+
+// 从 p_rng（位于第 0 行行首）跳转到第 p_row 行行首
+RandomPCG seek_row(const RandomPCG &p_rng, int p_row, int p_width);
+
+} // namespace TileKernel
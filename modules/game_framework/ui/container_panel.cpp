@@ -218,7 +218,19 @@ void ContainerPanel::_on_slot_clicked(int button_index, int slot_index) {
 	if (button_index == 2) {  // MOUSE_BUTTON_RIGHT
 		ItemSlot *slot = get_slot(slot_index);
 		if (slot && slot->has_item()) {
-			emit_signal("item_used", slot_index, slot->get_item());
+			Ref<Item> item = slot->get_item();
+			Dictionary before = item->serialize();
+			emit_signal("item_used", slot_index, item);
+
+			// container_get_item() 返回的是快照，监听者对物品的修改（使用、消耗）需要写回容器
+			// 监听者自己改动了这个槽位时以容器为准
+			if (bound_object && slot_index < bound_object->get_container_capacity()) {
+				Ref<Item> current = bound_object->container_get_item(slot_index);
+				if (current.is_valid() && current != item && current->serialize().recursive_equal(before, 0)) {
+					bound_object->container_set_item(slot_index, item->is_empty() ? Ref<Item>() : item);
+				}
+				_sync_from_container();
+			}
 		}
 	}
 }
@@ -4,6 +4,7 @@
 
 #include "world.h"
 
+#include "core/io/dir_access.h"
 #include "core/string/print_string.h"
 #include "core/variant/variant.h"
 
@@ -14,27 +15,470 @@ World::~World() {
 	clear();
 }
 
+World::ChunkPin::ChunkPin(World *p_world, Chunk *p_chunk) :
+		world(p_world), chunk(p_chunk), key(p_chunk->coord.to_seed()) {
+}
+
+World::ChunkPin::ChunkPin(ChunkPin &&p_other) :
+		world(p_other.world), chunk(p_other.chunk), key(p_other.key) {
+	p_other.world = nullptr;
+	p_other.chunk = nullptr;
+}
+
+World::ChunkPin &World::ChunkPin::operator=(ChunkPin &&p_other) {
+	if (this != &p_other) {
+		release();
+		world = p_other.world;
+		chunk = p_other.chunk;
+		key = p_other.key;
+		p_other.world = nullptr;
+		p_other.chunk = nullptr;
+	}
+	return *this;
+}
+
+void World::ChunkPin::release() {
+	if (chunk) {
+		world->_unpin(key);
+		world = nullptr;
+		chunk = nullptr;
+	}
+}
+
+void World::_before_evict(uint64_t &p_key, ResidentChunk &p_resident) {
+	World *world = p_resident.world;
+	if (world->pin_counts.has(p_key)) {
+		world->pinned_evicted.insert(p_key, p_resident.chunk);
+		return;
+	}
+	world->_unload_chunk(p_key, p_resident.chunk);
+}
+
+static Error _save_chunk_file(const Chunk *p_chunk, const String &p_path) {
+	Error err;
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	if (file.is_valid()) {
+		err = p_chunk->save(file);
+	}
+	return err;
+}
+
+String World::_get_chunk_path(const ChunkCoord &p_coord) const {
+	return persistence_path.path_join(vformat("chunk_%d_%d.bin", p_coord.x, p_coord.y));
+}
+
+Chunk *World::_load_or_generate(const ChunkCoord &p_coord) const {
+	if (!persistence_path.is_empty()) {
+		Ref<FileAccess> file = FileAccess::open(_get_chunk_path(p_coord), FileAccess::READ);
+		if (file.is_valid()) {
+			Chunk *chunk = new Chunk(p_coord, false);
+			if (chunk->load(file) == OK) {
+				return chunk;
+			}
+			// 存档损坏时重新生成，种子只依赖坐标，结果与首次生成一致
+			delete chunk;
+		}
+	}
+	return new Chunk(p_coord);
+}
+
+void World::_make_resident(uint64_t p_key, Chunk *p_chunk) {
+	chunks.insert(p_key, ResidentChunk{ this, p_chunk });
+
+	Vector2i origin(p_chunk->coord.x * CHUNK_SIZE, p_chunk->coord.y * CHUNK_SIZE);
+	for (const CityData &city : p_chunk->cities) {
+		if (city.world_object.is_valid()) {
+			spatial_index.insert(city.world_object.ptr(), origin);
+		}
+	}
+	for (const MonsterSpawnData &spawn : p_chunk->monsters) {
+		if (spawn.monster.is_valid()) {
+			spatial_index.insert(spawn.monster.ptr(), origin);
+			entity_store.add(spawn.monster.ptr());
+		}
+	}
+	for (const NPCSpawnData &spawn : p_chunk->npcs) {
+		if (spawn.npc.is_valid()) {
+			spatial_index.insert(spawn.npc.ptr(), origin);
+			entity_store.add(spawn.npc.ptr());
+		}
+	}
+}
+
+void World::_remove_objects(Chunk *p_chunk) {
+	// 脚本可能仍持有这些物体的引用，不能依赖析构时自动移除；
+	// 从实体存储移除时属性拷回对象，之后保存或继续在脚本中使用都以对象为准
+	for (const CityData &city : p_chunk->cities) {
+		if (city.world_object.is_valid() && city.world_object->get_spatial_index() == &spatial_index) {
+			spatial_index.remove(city.world_object.ptr());
+		}
+	}
+	for (const MonsterSpawnData &spawn : p_chunk->monsters) {
+		if (spawn.monster.is_valid() && spawn.monster->get_spatial_index() == &spatial_index) {
+			spatial_index.remove(spawn.monster.ptr());
+		}
+		if (entity_store.has(spawn.monster.ptr())) {
+			entity_store.remove(spawn.monster.ptr());
+		}
+	}
+	for (const NPCSpawnData &spawn : p_chunk->npcs) {
+		if (spawn.npc.is_valid() && spawn.npc->get_spatial_index() == &spatial_index) {
+			spatial_index.remove(spawn.npc.ptr());
+		}
+		if (entity_store.has(spawn.npc.ptr())) {
+			entity_store.remove(spawn.npc.ptr());
+		}
+	}
+}
+
+Chunk *World::_find_resident(uint64_t p_key) {
+	const ResidentChunk *resident = chunks.getptr(p_key);
+	if (resident) {
+		return resident->chunk;
+	}
+	Chunk **evicted = pinned_evicted.getptr(p_key);
+	return evicted ? *evicted : nullptr;
+}
+
+void World::_unpin(uint64_t p_key) {
+	int *count = pin_counts.getptr(p_key);
+	if (!count) {
+		// 区块已被 clear() 释放
+		return;
+	}
+	if (--(*count) > 0) {
+		return;
+	}
+	pin_counts.erase(p_key);
+
+	Chunk **evicted = pinned_evicted.getptr(p_key);
+	if (evicted) {
+		Chunk *chunk = *evicted;
+		pinned_evicted.erase(p_key);
+		_unload_chunk(p_key, chunk);
+	}
+}
+
+void World::_unload_chunk(uint64_t p_key, Chunk *p_chunk) {
+	_remove_objects(p_chunk);
+	if (persistence_path.is_empty()) {
+		delete p_chunk;
+		return;
+	}
+
+	// 区块再次被访问时会先取回正在写出的区块，同一区块不会同时有两个写出任务
+	DEV_ASSERT(!pending_saves.has(p_key));
+	PendingSave *save = new PendingSave;
+	save->chunk = p_chunk;
+	save->path = _get_chunk_path(p_chunk->coord);
+	pending_saves[p_key] = save;
+	save->task_id = WorkerThreadPool::get_singleton()->add_template_task(this, &World::_save_chunk_task, save, false, vformat("SaveChunk:%d,%d", p_chunk->coord.x, p_chunk->coord.y));
+}
+
+void World::_save_chunk_task(PendingSave *p_save) {
+	p_save->error = _save_chunk_file(p_save->chunk, p_save->path);
+}
+
+void World::_finish_save(uint64_t p_key) {
+	PendingSave *save = pending_saves[p_key];
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(save->task_id);
+	if (save->error != OK) {
+		ERR_PRINT(vformat("Failed to save chunk (%d, %d) to \"%s\".", save->chunk->coord.x, save->chunk->coord.y, save->path));
+	}
+	pending_saves.erase(p_key);
+	delete save->chunk;
+	delete save;
+}
+
+Chunk *World::_reclaim_saving(uint64_t p_key) {
+	PendingSave **pending = pending_saves.getptr(p_key);
+	if (!pending) {
+		return nullptr;
+	}
+	// 只有刚被淘汰又立即被访问的区块会在这里等待，写出失败也无妨，区块再次淘汰时会重新写出
+	PendingSave *save = *pending;
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(save->task_id);
+	Chunk *chunk = save->chunk;
+	pending_saves.erase(p_key);
+	delete save;
+	_make_resident(p_key, chunk);
+	return chunk;
+}
+
+void World::_generate_chunk_task(PendingChunk *p_pending) {
+	// 种子只依赖坐标，与生成发生在哪个线程、以何种顺序完成无关
+	p_pending->chunk = _load_or_generate(p_pending->coord);
+}
+
+Chunk *World::_publish_pending(PendingChunk *p_pending) {
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(p_pending->task_id);
+
+	uint64_t key = p_pending->coord.to_seed();
+	Chunk *chunk = p_pending->chunk;
+	pending_chunks.erase(key);
+	_make_resident(key, chunk);
+	delete p_pending;
+	return chunk;
+}
+
 Chunk *World::get_chunk(int32_t x, int32_t y) {
 	ChunkCoord coord(x, y);
 	uint64_t key = coord.to_seed();
 
-	if (chunks.has(key)) {
-		return chunks[key];
+	Chunk *chunk = _find_resident(key);
+	if (chunk) {
+		return chunk;
 	}
 
-	Chunk *chunk = new Chunk(coord);
-	chunks[key] = chunk;
+	PendingChunk **pending = pending_chunks.getptr(key);
+	if (pending) {
+		return _publish_pending(*pending);
+	}
+
+	chunk = _reclaim_saving(key);
+	if (chunk) {
+		return chunk;
+	}
+
+	chunk = _load_or_generate(coord);
+	_make_resident(key, chunk);
 	return chunk;
 }
 
+World::ChunkPin World::pin_chunk(int32_t x, int32_t y) {
+	Chunk *chunk = get_chunk(x, y);
+	pin_counts[chunk->coord.to_seed()]++;
+	return ChunkPin(this, chunk);
+}
+
+bool World::request_chunk(int32_t x, int32_t y) {
+	ChunkCoord coord(x, y);
+	uint64_t key = coord.to_seed();
+
+	if (chunks.has(key) || pinned_evicted.has(key) || pending_chunks.has(key)) {
+		return false;
+	}
+	if (_reclaim_saving(key)) {
+		return true;
+	}
+
+	PendingChunk *pending = new PendingChunk;
+	pending->coord = coord;
+	pending_chunks[key] = pending;
+	pending->task_id = WorkerThreadPool::get_singleton()->add_template_task(this, &World::_generate_chunk_task, pending, false, vformat("GenerateChunk:%d,%d", x, y));
+	return true;
+}
+
+bool World::is_chunk_ready(int32_t x, int32_t y) const {
+	uint64_t key = ChunkCoord(x, y).to_seed();
+	return chunks.has(key) || pinned_evicted.has(key);
+}
+
+bool World::is_chunk_pending(int32_t x, int32_t y) const {
+	return pending_chunks.has(ChunkCoord(x, y).to_seed());
+}
+
+Chunk *World::get_chunk_if_ready(int32_t x, int32_t y) {
+	return _find_resident(ChunkCoord(x, y).to_seed());
+}
+
+int World::poll_chunks(LocalVector<ChunkCoord> *r_completed) {
+	if (!pending_saves.is_empty()) {
+		LocalVector<uint64_t> saved;
+		for (const KeyValue<uint64_t, PendingSave *> &kv : pending_saves) {
+			if (WorkerThreadPool::get_singleton()->is_task_completed(kv.value->task_id)) {
+				saved.push_back(kv.key);
+			}
+		}
+		for (uint64_t key : saved) {
+			_finish_save(key);
+		}
+	}
+
+	if (pending_chunks.is_empty()) {
+		return 0;
+	}
+
+	LocalVector<PendingChunk *> finished;
+	for (const KeyValue<uint64_t, PendingChunk *> &kv : pending_chunks) {
+		if (WorkerThreadPool::get_singleton()->is_task_completed(kv.value->task_id)) {
+			finished.push_back(kv.value);
+		}
+	}
+
+	for (PendingChunk *pending : finished) {
+		if (r_completed) {
+			r_completed->push_back(pending->coord);
+		}
+		_publish_pending(pending);
+	}
+
+	return finished.size();
+}
+
+void World::wait_pending_chunks() {
+	while (!pending_chunks.is_empty()) {
+		_publish_pending(pending_chunks.begin()->value);
+	}
+}
+
+void World::wait_pending_saves() {
+	while (!pending_saves.is_empty()) {
+		_finish_save(pending_saves.begin()->key);
+	}
+}
+
+void World::set_max_resident_chunks(int p_count) {
+	ERR_FAIL_COND_MSG(p_count < 1, "At least one chunk must stay resident.");
+	max_resident_chunks = p_count;
+	chunks.set_capacity(MAX(max_resident_chunks, working_set_size));
+}
+
+void World::set_persistence_path(const String &p_path) {
+	persistence_path = p_path;
+	if (!persistence_path.is_empty() && !DirAccess::exists(persistence_path)) {
+		Error err = DirAccess::make_dir_recursive_absolute(persistence_path);
+		ERR_FAIL_COND_MSG(err != OK, vformat("Cannot create chunk persistence directory \"%s\".", persistence_path));
+	}
+}
+
+void World::update_working_set(int32_t center_x, int32_t center_y, int32_t radius) {
+	ERR_FAIL_COND(radius < 0);
+
+	// 工作集必须能完整驻留，否则会在请求过程中把自己淘汰掉
+	// 容量只在工作集需要时临时提高，max_resident_chunks 保持不变
+	working_set_size = (radius * 2 + 1) * (radius * 2 + 1);
+	int capacity = MAX(max_resident_chunks, working_set_size);
+	if ((int)chunks.get_capacity() < capacity) {
+		WARN_PRINT_ONCE(vformat("Chunk working set (%d) exceeds max_resident_chunks (%d), raising the limit while it is in use.", working_set_size, max_resident_chunks));
+		chunks.set_capacity(capacity);
+	}
+
+	// 由近及远处理：已驻留的区块标记为最近使用，缺失的区块按距离顺序请求
+	for (int32_t ring = 0; ring <= radius; ring++) {
+		for (int32_t y = center_y - ring; y <= center_y + ring; y++) {
+			for (int32_t x = center_x - ring; x <= center_x + ring; x++) {
+				if (MAX(Math::abs(x - center_x), Math::abs(y - center_y)) != ring) {
+					continue;
+				}
+				if (!chunks.getptr(ChunkCoord(x, y).to_seed())) {
+					request_chunk(x, y);
+				}
+			}
+		}
+	}
+
+	// 工作集缩小后恢复容量；工作集内已驻留的区块刚被标记为最近使用，只会淘汰工作集以外的区块
+	if ((int)chunks.get_capacity() > capacity) {
+		chunks.set_capacity(capacity);
+	}
+}
+
+bool World::unload_chunk(int32_t x, int32_t y) {
+	uint64_t key = ChunkCoord(x, y).to_seed();
+	const ResidentChunk *resident = chunks.getptr(key);
+	if (!resident) {
+		return false;
+	}
+	ERR_FAIL_COND_V_MSG(pin_counts.has(key), false, vformat("Cannot unload chunk (%d, %d) while it is pinned.", x, y));
+	Chunk *chunk = resident->chunk;
+	chunks.erase(key);
+	_unload_chunk(key, chunk);
+	return true;
+}
+
+Error World::save_all() {
+	ERR_FAIL_COND_V_MSG(persistence_path.is_empty(), ERR_UNCONFIGURED, "No chunk persistence path set.");
+
+	Error result = OK;
+	for (const ChunkCache::Pair &pair : chunks) {
+		Error err = _save_chunk_file(pair.data.chunk, _get_chunk_path(pair.data.chunk->coord));
+		if (err != OK) {
+			result = err;
+		}
+	}
+	for (const KeyValue<uint64_t, Chunk *> &kv : pinned_evicted) {
+		Error err = _save_chunk_file(kv.value, _get_chunk_path(kv.value->coord));
+		if (err != OK) {
+			result = err;
+		}
+	}
+	return result;
+}
+
+int World::compress_cold_chunks(int32_t center_x, int32_t center_y, int32_t radius) {
+	int compressed = 0;
+	for (const ChunkCache::Pair &pair : chunks) {
+		Chunk *chunk = pair.data.chunk;
+		int32_t distance = MAX(Math::abs(chunk->coord.x - center_x), Math::abs(chunk->coord.y - center_y));
+		if (distance > radius && !chunk->tiles.is_compressed()) {
+			chunk->tiles.compress();
+			compressed++;
+		}
+	}
+	return compressed;
+}
+
+bool World::add_object(WorldObject *p_object) {
+	ERR_FAIL_NULL_V(p_object, false);
+	ERR_FAIL_COND_V_MSG(p_object->get_spatial_index() != nullptr, false, "World object already belongs to a spatial index.");
+	spatial_index.insert(p_object, Vector2i());
+	return true;
+}
+
+bool World::remove_object(WorldObject *p_object) {
+	ERR_FAIL_NULL_V(p_object, false);
+	if (p_object->get_spatial_index() != &spatial_index) {
+		return false;
+	}
+	spatial_index.remove(p_object);
+	return true;
+}
+
+void World::tick_entities(float p_delta, bool p_parallel) {
+	// 只有更新前存活的怪物执行 AI（刚重生的怪物下一次更新才开始侦测）
+	LocalVector<ObjectID> monsters;
+	for (uint32_t i = 0; i < entity_store.get_size(); i++) {
+		if (entity_store.kind[i] == EntityStore::KIND_MONSTER && entity_store.get_character(i)->is_alive()) {
+			monsters.push_back(entity_store.get_character(i)->get_instance_id());
+		}
+	}
+
+	entity_store.tick_all(p_delta, p_parallel);
+
+	// AI 需要查询空间索引并可能触发脚本回调，只能在主线程逐个执行；
+	// 回调中可能卸载区块，因此通过对象 ID 访问
+	for (const ObjectID &id : monsters) {
+		Monster *monster = ObjectDB::get_instance<Monster>(id);
+		if (monster) {
+			monster->update_ai();
+		}
+	}
+}
+
 void World::print_chunk(int32_t x, int32_t y, int preview_size) {
 	Chunk *chunk = get_chunk(x, y);
 	print_line(chunk->to_string(preview_size));
 }
 
 void World::clear() {
-	for (KeyValue<uint64_t, Chunk *> &kv : chunks) {
-		delete kv.value;
+	// 后台任务仍持有 this，必须先等待全部结束
+	wait_pending_chunks();
+
+	if (!pin_counts.is_empty()) {
+		WARN_PRINT("Clearing the world while chunks are still pinned, their pins are no longer valid.");
+	}
+
+	for (const ChunkCache::Pair &pair : chunks) {
+		_unload_chunk(pair.key, pair.data.chunk);
+	}
+	for (const KeyValue<uint64_t, Chunk *> &kv : pinned_evicted) {
+		_unload_chunk(kv.key, kv.value);
 	}
 	chunks.clear();
+	pinned_evicted.clear();
+	pin_counts.clear();
+	wait_pending_saves();
+	working_set_size = 0;
+	chunks.set_capacity(max_resident_chunks);
 }
@@ -5,17 +5,169 @@
 #pragma once
 
 #include "chunk.h"
+#include "spatial_index.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/lru.h"
 
 class World {
+public:
+	static constexpr int DEFAULT_MAX_RESIDENT_CHUNKS = 64;
+
+	// 固定区块：句柄存在期间区块不会被释放，超出容量时推迟到句柄释放后再卸载
+	// 句柄必须在 World 清空或销毁前释放
+	class ChunkPin {
+		friend class World;
+
+		World *world = nullptr;
+		Chunk *chunk = nullptr;
+		uint64_t key = 0;
+
+		ChunkPin(World *p_world, Chunk *p_chunk);
+
+	public:
+		Chunk *get() const { return chunk; }
+		Chunk *operator->() const { return chunk; }
+		bool is_valid() const { return chunk != nullptr; }
+		void release();
+
+		ChunkPin &operator=(ChunkPin &&p_other);
+		ChunkPin(ChunkPin &&p_other);
+		ChunkPin(const ChunkPin &) = delete;
+		ChunkPin &operator=(const ChunkPin &) = delete;
+		ChunkPin() {}
+		~ChunkPin() { release(); }
+	};
+
 private:
-	HashMap<uint64_t, Chunk *> chunks;
+	// 常驻区块，淘汰回调需要知道所属的 World，因此一并保存
+	struct ResidentChunk {
+		World *world = nullptr;
+		Chunk *chunk = nullptr;
+		uint64_t key = 0;
+	};
+
+	static void _before_evict(uint64_t &p_key, ResidentChunk &p_resident);
+	typedef LRUCache<uint64_t, ResidentChunk, HashMapHasherDefault, HashMapComparatorDefault<uint64_t>, World::_before_evict> ChunkCache;
+
+	// 后台生成中的区块
+	// 工作线程只写入自己的 PendingChunk，chunks/pending_chunks 两个表只在主线程访问，无需加锁
+	struct PendingChunk {
+		ChunkCoord coord;
+		Chunk *chunk = nullptr; // 由工作线程写入，任务完成后由主线程读取
+		WorkerThreadPool::TaskID task_id = WorkerThreadPool::INVALID_TASK_ID;
+	};
+
+	// 后台写出中的区块，写出完成后由主线程释放
+	// 工作线程只读取区块，区块中的物体已从空间索引和实体存储移除，写出期间不再被 World 修改
+	struct PendingSave {
+		Chunk *chunk = nullptr;
+		String path;
+		Error error = OK; // 由工作线程写入
+		WorkerThreadPool::TaskID task_id = WorkerThreadPool::INVALID_TASK_ID;
+	};
+
+	// 超出容量时最久未使用的区块被写入 persistence_path（如已设置）并释放
+	ChunkCache chunks = ChunkCache(DEFAULT_MAX_RESIDENT_CHUNKS);
+	HashMap<uint64_t, PendingChunk *> pending_chunks;
+	HashMap<uint64_t, PendingSave *> pending_saves;
+	// 固定次数，只包含被固定的区块
+	HashMap<uint64_t, int> pin_counts;
+	// 已被淘汰但仍被固定的区块，仍视为常驻，解除固定后卸载
+	HashMap<uint64_t, Chunk *> pinned_evicted;
+	int max_resident_chunks = DEFAULT_MAX_RESIDENT_CHUNKS;
+	// 最近一次 update_working_set() 的区块数量，实际容量取两者中较大的值
+	int working_set_size = 0;
+	String persistence_path;
+	// 常驻区块中的城市/怪物/NPC，区块驻留时加入，卸载时移除
+	SpatialIndex spatial_index;
+	// 常驻区块中的怪物/NPC，由 tick_entities() 批量更新
+	EntityStore entity_store;
+
+	void _generate_chunk_task(PendingChunk *p_pending);
+	// 等待任务结束并把区块发布到 chunks，返回发布的区块
+	Chunk *_publish_pending(PendingChunk *p_pending);
+	// 优先从存档加载，没有存档时重新生成（可在工作线程调用）
+	Chunk *_load_or_generate(const ChunkCoord &p_coord) const;
+	String _get_chunk_path(const ChunkCoord &p_coord) const;
+	// 移除区块中的物体，并在后台写出（未设置 persistence_path 时直接释放）
+	void _unload_chunk(uint64_t p_key, Chunk *p_chunk);
+	void _save_chunk_task(PendingSave *p_save);
+	// 等待写出结束并释放区块
+	void _finish_save(uint64_t p_key);
+	// 区块仍在写出时等待写出结束并重新驻留，避免从尚未写完的存档加载
+	Chunk *_reclaim_saving(uint64_t p_key);
+	Chunk *_find_resident(uint64_t p_key);
+	void _unpin(uint64_t p_key);
+	// 区块加入 chunks 的唯一入口，同时把其中的物体加入空间索引和实体存储
+	void _make_resident(uint64_t p_key, Chunk *p_chunk);
+	void _remove_objects(Chunk *p_chunk);
 
 public:
 	World();
 	~World();
 
+	// 同步获取（如果该区块正在后台生成，则等待其完成）
+	// 返回的指针在下一次获取/请求/发布区块之前有效，之后可能因淘汰而被释放；
+	// 需要更长时间持有时使用 pin_chunk()
 	Chunk *get_chunk(int32_t x, int32_t y);
+	// 同 get_chunk()，返回的句柄存在期间区块保持有效
+	ChunkPin pin_chunk(int32_t x, int32_t y);
+	bool is_chunk_pinned(int32_t x, int32_t y) const { return pin_counts.has(ChunkCoord(x, y).to_seed()); }
+
+	// === 异步生成 ===
+	// 请求在 WorkerThreadPool 上生成区块，已存在或已在生成中时返回 false
+	bool request_chunk(int32_t x, int32_t y);
+	bool is_chunk_ready(int32_t x, int32_t y) const;
+	bool is_chunk_pending(int32_t x, int32_t y) const;
+	// 只返回已驻留的区块，不会触发生成或加载
+	Chunk *get_chunk_if_ready(int32_t x, int32_t y);
+	int get_pending_count() const { return pending_chunks.size(); }
+	// 在主线程调用：发布所有已完成的区块并释放已写出的区块，返回本次发布的数量
+	int poll_chunks(LocalVector<ChunkCoord> *r_completed = nullptr);
+	// 等待所有后台任务完成并发布
+	void wait_pending_chunks();
+	// 后台写出中的区块数量
+	int get_saving_count() const { return pending_saves.size(); }
+	// 等待所有后台写出完成
+	void wait_pending_saves();
+
+	// === 驻留管理 ===
+	void set_max_resident_chunks(int p_count);
+	int get_max_resident_chunks() const { return max_resident_chunks; }
+	int get_resident_chunk_count() const { return chunks.get_size() + pinned_evicted.size(); }
+
+	// 被淘汰的区块在后台写入该目录，再次访问时从存档加载而不是重新生成；为空时淘汰的区块直接丢弃
+	void set_persistence_path(const String &p_path);
+	String get_persistence_path() const { return persistence_path; }
+
+	// 保持以 (center_x, center_y) 为中心、半径 radius 的区块常驻：
+	// 已驻留的区块标记为最近使用，缺失的区块异步请求
+	void update_working_set(int32_t center_x, int32_t center_y, int32_t radius);
+	// 卸载指定区块（在后台写出），区块被固定时失败
+	bool unload_chunk(int32_t x, int32_t y);
+	// 同步写出所有常驻区块
+	Error save_all();
+
+	// 将与中心区块的切比雪夫距离超过 radius 的区块地形转为冷存储（游程编码），返回本次压缩的数量
+	int compress_cold_chunks(int32_t center_x, int32_t center_y, int32_t radius);
+
+	// === 空间查询 ===
+	// 坐标为世界格子坐标（区块坐标 * CHUNK_SIZE + 区块内坐标），只包含常驻区块中的物体
+	SpatialIndex &get_spatial_index() { return spatial_index; }
+	const SpatialIndex &get_spatial_index() const { return spatial_index; }
+	// 加入不属于任何区块的物体（例如玩家），其 local_position 即为世界格子坐标；
+	// 加入后怪物的侦测可以找到它，物体释放时自动移除
+	bool add_object(WorldObject *p_object);
+	bool remove_object(WorldObject *p_object);
+
+	// === 实体更新 ===
+	// 批量更新常驻区块中的全部怪物和 NPC，然后在主线程执行怪物 AI（等价于逐个调用 tick()）
+	void tick_entities(float p_delta, bool p_parallel = true);
+	int get_entity_count() const { return entity_store.get_size(); }
+
 	void print_chunk(int32_t x, int32_t y, int preview_size = 32);
+	// 释放所有区块，设置了 persistence_path 时先写出，返回前等待全部写出完成
 	void clear();
 };
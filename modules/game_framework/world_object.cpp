@@ -4,35 +4,170 @@
 
 #include "world_object.h"
 
+#include "item_definition.h"
+#include "snapshot.h"
+#include "state_hash.h"
+
 void WorldObject::_bind_methods() {
 
 }
 
 WorldObject::WorldObject() = default;
 
-WorldObject::~WorldObject() = default;
+WorldObject::~WorldObject() {
+	if (spatial_index) {
+		spatial_index->remove(this);
+	}
+	container_clear();
+}
 
 void WorldObject::setup(const StringName &p_object_id, ObjectType p_type, const Vector2i &p_position) {
 	object_id = p_object_id;
 	object_type = p_type;
-	local_position = p_position;
+	set_local_position(p_position);
+}
+
+void WorldObject::set_local_position(const Vector2i &p_pos) {
+	Vector2i old_world_position = get_world_position();
+	local_position = p_pos;
+	if (spatial_index) {
+		spatial_index->_object_moved(this, old_world_position);
+	}
 }
 
 // ============ 容器系统 ============
 
 void WorldObject::init_container(int32_t p_capacity) {
 	ERR_FAIL_COND_MSG(p_capacity < 0, "Container capacity cannot be negative.");
+	ERR_FAIL_COND_MSG(p_capacity > MAX_CONTAINER_CAPACITY, vformat("Container capacity cannot exceed %d.", MAX_CONTAINER_CAPACITY));
+	container_clear();
 	container_capacity = p_capacity;
 	container.resize(p_capacity);
-	for (int32_t i = 0; i < p_capacity; i++) {
-		container.write[i] = Ref<Item>();
+}
+
+int32_t WorldObject::_get_slot_quantity(int32_t p_slot) const {
+	const ContainerSlot &slot = container[p_slot];
+	if (unlikely(slot.unique)) {
+		return unique_items[p_slot]->get_quantity();
+	}
+	return slot.quantity;
+}
+
+bool WorldObject::_is_slot_empty(int32_t p_slot) const {
+	return container[p_slot].def_index == ItemRegistry::INVALID_INDEX || _get_slot_quantity(p_slot) <= 0;
+}
+
+void WorldObject::_clear_slot(int32_t p_slot) {
+	if (container[p_slot].unique) {
+		unique_items.erase(p_slot);
+	}
+	ItemRegistry::release(container[p_slot].def_index);
+	container[p_slot] = ContainerSlot();
+}
+
+bool WorldObject::_store_item(int32_t p_slot, const Ref<Item> &p_item) {
+	uint32_t def_index = p_item->get_definition_index();
+	ERR_FAIL_COND_V_MSG(def_index == ItemRegistry::INVALID_INDEX, false, "Cannot store item, no item definition is available for it.");
+
+	// 先取得引用：p_item 可能就是这个槽位中的物品，清空槽位会释放同一个定义
+	ItemRegistry::acquire(def_index);
+	_clear_slot(p_slot);
+
+	ContainerSlot &slot = container[p_slot];
+	slot.def_index = def_index;
+	slot.id_index = ItemRegistry::get(def_index).id_index;
+	slot.quantity = p_item->get_quantity();
+	slot.durability = p_item->get_durability();
+	if (!p_item->is_flyweight_compatible()) {
+		// 保留对象本身，数量以对象为准
+		slot.unique = true;
+		unique_items[p_slot] = p_item;
+	}
+	return true;
+}
+
+void WorldObject::_store_stack(int32_t p_slot, uint32_t p_def_index, int32_t p_quantity, int32_t p_durability) {
+	ItemRegistry::acquire(p_def_index);
+	_clear_slot(p_slot);
+
+	ContainerSlot &slot = container[p_slot];
+	slot.def_index = p_def_index;
+	slot.id_index = ItemRegistry::get(p_def_index).id_index;
+	slot.quantity = p_quantity;
+	slot.durability = p_durability;
+}
+
+Ref<Item> WorldObject::_make_item(int32_t p_slot) const {
+	const ContainerSlot &slot = container[p_slot];
+	if (slot.def_index == ItemRegistry::INVALID_INDEX) {
+		return Ref<Item>();
+	}
+	if (slot.unique) {
+		return unique_items[p_slot];
+	}
+	return Item::create_from_definition(slot.def_index, slot.quantity, slot.durability);
+}
+
+bool WorldObject::_can_stack_into(int32_t p_slot, const ItemDefinition &p_definition, int32_t p_durability) const {
+	// 与 Item::can_stack_with() 的规则一致
+	const ContainerSlot &slot = container[p_slot];
+	if (slot.def_index == ItemRegistry::INVALID_INDEX) {
+		return false;
 	}
+	const ItemDefinition &target = ItemRegistry::get(slot.def_index);
+	if (!target.is_stackable() || !p_definition.is_stackable()) {
+		return false;
+	}
+	if (slot.id_index != p_definition.id_index) {
+		return false;
+	}
+	if (_get_slot_quantity(p_slot) >= target.max_stack_size) {
+		return false;
+	}
+	if (target.has_durability() && slot.durability != p_durability) {
+		return false;
+	}
+	return true;
+}
+
+int32_t WorldObject::_add_to_slot(int32_t p_slot, int32_t p_amount) {
+	ContainerSlot &slot = container[p_slot];
+	if (unlikely(slot.unique)) {
+		return unique_items[p_slot]->add_quantity(p_amount);
+	}
+
+	int32_t space = ItemRegistry::get(slot.def_index).max_stack_size - slot.quantity;
+	if (p_amount <= space) {
+		slot.quantity += p_amount;
+		return 0;
+	}
+	slot.quantity += space;
+	return p_amount - space;
+}
+
+int32_t WorldObject::_stack_into_existing(const ItemDefinition &p_definition, int32_t p_quantity, int32_t p_durability) {
+	int32_t remaining = p_quantity;
+	for (int32_t i = 0; i < container_capacity && remaining > 0; i++) {
+		if (_can_stack_into(i, p_definition, p_durability)) {
+			remaining = _add_to_slot(i, remaining);
+		}
+	}
+	return remaining;
+}
+
+int32_t WorldObject::_find_empty_slot() const {
+	for (int32_t i = 0; i < container_capacity; i++) {
+		if (_is_slot_empty(i)) {
+			return i;
+		}
+	}
+	return -1;
 }
 
 int32_t WorldObject::get_container_used_slots() const {
 	int32_t count = 0;
-	for (const Ref<Item> &item : container) {
-		if (item.is_valid() && !item->is_empty()) {
+	for (int32_t i = 0; i < container_capacity; i++) {
+		if (!_is_slot_empty(i)) {
 			count++;
 		}
 	}
@@ -63,14 +198,32 @@ bool WorldObject::container_add_item(const Ref<Item> &p_item) {
 	}
 
 	// 查找空槽位
-	for (int32_t i = 0; i < container_capacity; i++) {
-		if (container[i].is_null() || container[i]->is_empty()) {
-			container.write[i] = p_item;
+	int32_t slot = _find_empty_slot();
+	if (slot < 0) {
+		return false; // 容器已满
+	}
+	return _store_item(slot, p_item);
+}
+
+bool WorldObject::container_add_stack(uint32_t p_definition_index, int32_t p_quantity, int32_t p_durability) {
+	ERR_FAIL_COND_V_MSG(p_definition_index >= ItemRegistry::get_count(), false, "Invalid item definition index.");
+	ERR_FAIL_COND_V_MSG(!has_container(), false, "Object has no container.");
+
+	const ItemDefinition &definition = ItemRegistry::get(p_definition_index);
+	int32_t quantity = CLAMP(p_quantity, 0, definition.max_stack_size);
+	if (definition.is_stackable()) {
+		quantity = _stack_into_existing(definition, quantity, p_durability);
+		if (quantity <= 0) {
 			return true;
 		}
 	}
 
-	return false; // 容器已满
+	int32_t slot = _find_empty_slot();
+	if (slot < 0) {
+		return false;
+	}
+	_store_stack(slot, p_definition_index, quantity, p_durability);
+	return true;
 }
 
 bool WorldObject::container_add_item_at(int32_t p_slot, const Ref<Item> &p_item) {
@@ -78,64 +231,76 @@ bool WorldObject::container_add_item_at(int32_t p_slot, const Ref<Item> &p_item)
 	ERR_FAIL_COND_V_MSG(p_item.is_null(), false, "Cannot add null item.");
 
 	// 检查槽位是否为空
-	if (container[p_slot].is_valid() && !container[p_slot]->is_empty()) {
+	if (!_is_slot_empty(p_slot)) {
 		// 尝试堆叠
-		if (container[p_slot]->can_stack_with(p_item)) {
-			container[p_slot]->stack_with(p_item);
+		uint32_t def_index = p_item->get_definition_index();
+		ERR_FAIL_COND_V_MSG(def_index == ItemRegistry::INVALID_INDEX, false, "Cannot store item, no item definition is available for it.");
+		if (_can_stack_into(p_slot, ItemRegistry::get(def_index), p_item->get_durability())) {
+			p_item->set_quantity(_add_to_slot(p_slot, p_item->get_quantity()));
 			return p_item->is_empty();
 		}
 		return false;
 	}
 
-	container.write[p_slot] = p_item;
-	return true;
+	return _store_item(p_slot, p_item);
 }
 
 Ref<Item> WorldObject::container_remove_item(int32_t p_slot) {
 	ERR_FAIL_INDEX_V(p_slot, container_capacity, Ref<Item>());
 
-	Ref<Item> item = container[p_slot];
-	if (item.is_valid()) {
-		container.write[p_slot] = Ref<Item>();
-	}
+	Ref<Item> item = _make_item(p_slot);
+	_clear_slot(p_slot);
 	return item;
 }
 
 Ref<Item> WorldObject::container_get_item(int32_t p_slot) const {
 	ERR_FAIL_INDEX_V(p_slot, container_capacity, Ref<Item>());
-	return container[p_slot];
+	return _make_item(p_slot);
 }
 
 bool WorldObject::container_set_item(int32_t p_slot, const Ref<Item> &p_item) {
 	ERR_FAIL_INDEX_V(p_slot, container_capacity, false);
 
-	container.write[p_slot] = p_item;
-
-	return true;
+	if (p_item.is_null()) {
+		_clear_slot(p_slot);
+		return true;
+	}
+	return _store_item(p_slot, p_item);
 }
 
 void WorldObject::container_clear() {
-	for (int32_t i = 0; i < container.size(); i++) {
-		if (container[i].is_valid()) {
-			container.write[i] = Ref<Item>();
-		}
+	for (ContainerSlot &slot : container) {
+		ItemRegistry::release(slot.def_index);
+		slot = ContainerSlot();
 	}
+	unique_items.clear();
 }
 
-int32_t WorldObject::container_find_item(const StringName &p_item_id) const {
-	for (int32_t i = 0; i < container.size(); i++) {
-		if (container[i].is_valid() && container[i]->get_item_id() == p_item_id) {
+int32_t WorldObject::_find_id_slot(const StringName &p_item_id) const {
+	// 比较定义中的 StringName（指针比较），不经过 ItemRegistry::find_id() 的全局锁
+	for (int32_t i = 0; i < container_capacity; i++) {
+		uint32_t def_index = container[i].def_index;
+		if (def_index != ItemRegistry::INVALID_INDEX && ItemRegistry::get(def_index).item_id == p_item_id) {
 			return i;
 		}
 	}
 	return -1;
 }
 
+int32_t WorldObject::container_find_item(const StringName &p_item_id) const {
+	return _find_id_slot(p_item_id);
+}
+
 int32_t WorldObject::container_count_item(const StringName &p_item_id) const {
+	int32_t first = _find_id_slot(p_item_id);
+	if (first < 0) {
+		return 0;
+	}
+	uint32_t id_index = container[first].id_index;
 	int32_t count = 0;
-	for (const Ref<Item> &item : container) {
-		if (item.is_valid() && item->get_item_id() == p_item_id) {
-			count += item->get_quantity();
+	for (int32_t i = first; i < container_capacity; i++) {
+		if (container[i].id_index == id_index) {
+			count += _get_slot_quantity(i);
 		}
 	}
 	return count;
@@ -149,32 +314,27 @@ int32_t WorldObject::container_add_items(const StringName &p_item_id, int32_t p_
 	ERR_FAIL_COND_V_MSG(p_quantity <= 0, 0, "Quantity must be positive.");
 	ERR_FAIL_COND_V_MSG(!has_container(), p_quantity, "Object has no container.");
 
+	uint32_t def_index = ItemRegistry::get_default(p_item_id);
+	const ItemDefinition &definition = ItemRegistry::get(def_index);
 	int32_t remaining = p_quantity;
 
 	// 先尝试添加到现有堆叠
-	for (int32_t i = 0; i < container.size() && remaining > 0; i++) {
-		if (container[i].is_valid() && container[i]->get_item_id() == p_item_id && !container[i]->is_full_stack()) {
-			remaining = container[i]->add_quantity(remaining);
+	for (int32_t i = 0; i < container_capacity && remaining > 0; i++) {
+		if (container[i].id_index == definition.id_index && _get_slot_quantity(i) < ItemRegistry::get(container[i].def_index).max_stack_size) {
+			remaining = _add_to_slot(i, remaining);
 		}
 	}
 
 	// 创建新堆叠
 	while (remaining > 0) {
-		int32_t slot = -1;
-		for (int32_t i = 0; i < container_capacity; i++) {
-			if (container[i].is_null() || container[i]->is_empty()) {
-				slot = i;
-				break;
-			}
-		}
-
+		int32_t slot = _find_empty_slot();
 		if (slot < 0) {
 			break; // 没有空槽位
 		}
 
-		Ref<Item> new_item = Item::create(p_item_id, remaining);
-		remaining = 0; // 默认全部添加（如果有堆叠限制会被调整）
-		container.write[slot] = new_item;
+		int32_t amount = MIN(remaining, definition.max_stack_size);
+		_store_stack(slot, def_index, amount, Item::DURABILITY_INFINITE);
+		remaining -= amount;
 	}
 
 	return remaining;
@@ -183,21 +343,32 @@ int32_t WorldObject::container_add_items(const StringName &p_item_id, int32_t p_
 int32_t WorldObject::container_remove_items(const StringName &p_item_id, int32_t p_quantity) {
 	ERR_FAIL_COND_V_MSG(p_quantity <= 0, 0, "Quantity must be positive.");
 
+	int32_t first = _find_id_slot(p_item_id);
+	if (first < 0) {
+		return 0;
+	}
+	uint32_t id_index = container[first].id_index;
+
 	int32_t removed = 0;
 	int32_t to_remove = p_quantity;
 
-	for (int32_t i = 0; i < container.size() && to_remove > 0; i++) {
-		if (container[i].is_valid() && container[i]->get_item_id() == p_item_id) {
-			int32_t qty = container[i]->get_quantity();
-			if (qty <= to_remove) {
-				removed += qty;
-				to_remove -= qty;
-				container.write[i] = Ref<Item>();
+	for (int32_t i = first; i < container_capacity && to_remove > 0; i++) {
+		if (container[i].id_index != id_index) {
+			continue;
+		}
+		int32_t qty = _get_slot_quantity(i);
+		if (qty <= to_remove) {
+			removed += qty;
+			to_remove -= qty;
+			_clear_slot(i);
+		} else {
+			if (unlikely(container[i].unique)) {
+				unique_items[i]->remove_quantity(to_remove);
 			} else {
-				container[i]->remove_quantity(to_remove);
-				removed += to_remove;
-				to_remove = 0;
+				container[i].quantity -= to_remove;
 			}
+			removed += to_remove;
+			to_remove = 0;
 		}
 	}
 
@@ -206,9 +377,9 @@ int32_t WorldObject::container_remove_items(const StringName &p_item_id, int32_t
 
 TypedArray<Ref<Item>> WorldObject::container_get_all_items() const {
 	TypedArray<Ref<Item>> items;
-	for (const Ref<Item> &item : container) {
-		if (item.is_valid() && !item->is_empty()) {
-			items.push_back(item);
+	for (int32_t i = 0; i < container_capacity; i++) {
+		if (!_is_slot_empty(i)) {
+			items.push_back(_make_item(i));
 		}
 	}
 	return items;
@@ -221,15 +392,14 @@ bool WorldObject::container_try_stack(const Ref<Item> &p_item) {
 		return false;
 	}
 
-	bool stacked = false;
-	for (int32_t i = 0; i < container.size() && !p_item->is_empty(); i++) {
-		if (container[i].is_valid() && container[i]->can_stack_with(p_item)) {
-			container[i]->stack_with(p_item);
-			stacked = true;
-		}
-	}
+	uint32_t def_index = p_item->get_definition_index();
+	ERR_FAIL_COND_V_MSG(def_index == ItemRegistry::INVALID_INDEX, false, "Cannot stack item, no item definition is available for it.");
+
+	int32_t quantity = p_item->get_quantity();
+	int32_t remaining = _stack_into_existing(ItemRegistry::get(def_index), quantity, p_item->get_durability());
+	p_item->set_quantity(remaining);
 
-	return stacked;
+	return remaining != quantity;
 }
 
 // ============ 交互接口 ============
@@ -243,9 +413,9 @@ TypedArray<Dictionary> WorldObject::harvest(Object *p_actor) {
 	TypedArray<Dictionary> loot;
 
 	// 默认行为：将容器内容作为掉落物
-	for (const Ref<Item> &item : container) {
-		if (item.is_valid() && !item->is_empty()) {
-			loot.push_back(item->serialize());
+	for (int32_t i = 0; i < container_capacity; i++) {
+		if (!_is_slot_empty(i)) {
+			loot.push_back(_make_item(i)->serialize());
 		}
 	}
 
@@ -264,12 +434,11 @@ Dictionary WorldObject::serialize() const {
 	if (has_container()) {
 		data["container_capacity"] = container_capacity;
 		Array container_data;
-		for (int32_t i = 0; i < container.size(); i++) {
-			const Ref<Item> &item = container[i];
-			if (item.is_valid() && !item->is_empty()) {
+		for (int32_t i = 0; i < container_capacity; i++) {
+			if (!_is_slot_empty(i)) {
 				Dictionary slot_data;
 				slot_data["slot"] = i;
-				slot_data["item"] = item->serialize();
+				slot_data["item"] = _make_item(i)->serialize();
 				container_data.push_back(slot_data);
 			}
 		}
@@ -284,8 +453,7 @@ Dictionary WorldObject::serialize() const {
 void WorldObject::deserialize(const Dictionary &p_data) {
 	object_id = p_data.get("object_id", StringName());
 	object_type = static_cast<ObjectType>((int)p_data.get("object_type", TYPE_GENERIC));
-	local_position.x = p_data.get("position_x", 0);
-	local_position.y = p_data.get("position_y", 0);
+	set_local_position(Vector2i(p_data.get("position_x", 0), p_data.get("position_y", 0)));
 
 	if (p_data.has("container_capacity")) {
 		init_container(p_data["container_capacity"]);
@@ -299,9 +467,97 @@ void WorldObject::deserialize(const Dictionary &p_data) {
 					Ref<Item> item;
 					item.instantiate();
 					item->deserialize(slot_data["item"]);
-					container.write[slot] = item;
+					_store_item(slot, item);
 				}
 			}
 		}
 	}
 }
+
+// ============ 二进制快照 ============
+
+void WorldObject::write_snapshot(SnapshotWriter &p_writer) const {
+	p_writer.write_name(object_id);
+	p_writer.write_u8((uint8_t)object_type);
+	p_writer.write_s32(local_position.x);
+	p_writer.write_s32(local_position.y);
+
+	p_writer.write_s32(container_capacity);
+	p_writer.write_s32(get_container_used_slots());
+	for (int32_t i = 0; i < container_capacity; i++) {
+		if (_is_slot_empty(i)) {
+			continue;
+		}
+		const ContainerSlot &slot = container[i];
+		p_writer.write_s32(i);
+		p_writer.write_bool(slot.unique);
+		if (slot.unique) {
+			// 自定义数据没有固定布局，这类物品很少，直接沿用字典格式
+			p_writer.write_variant(unique_items[i]->serialize());
+		} else {
+			p_writer.write_definition(slot.def_index);
+			p_writer.write_s32(slot.quantity);
+			p_writer.write_s32(slot.durability);
+		}
+	}
+}
+
+void WorldObject::read_snapshot(SnapshotReader &p_reader) {
+	object_id = p_reader.read_name();
+	object_type = static_cast<ObjectType>(p_reader.read_enum(TYPE_MAX, TYPE_GENERIC));
+	int32_t x = p_reader.read_s32();
+	int32_t y = p_reader.read_s32();
+	set_local_position(Vector2i(x, y));
+
+	int32_t capacity = p_reader.read_s32();
+	int32_t used = p_reader.read_s32();
+	if (capacity < 0 || capacity > MAX_CONTAINER_CAPACITY || used < 0 || used > capacity || p_reader.is_corrupt()) {
+		p_reader.set_corrupt();
+		return;
+	}
+	init_container(capacity);
+
+	for (int32_t i = 0; i < used; i++) {
+		int32_t slot = p_reader.read_s32();
+		bool unique = p_reader.read_bool();
+		if (slot < 0 || slot >= capacity || p_reader.is_corrupt()) {
+			p_reader.set_corrupt();
+			return;
+		}
+		if (unique) {
+			Ref<Item> item;
+			item.instantiate();
+			item->deserialize(p_reader.read_variant());
+			_store_item(slot, item);
+		} else {
+			uint32_t definition_index = p_reader.read_definition();
+			int32_t quantity = p_reader.read_s32();
+			int32_t durability = p_reader.read_s32();
+			if (definition_index == ItemRegistry::INVALID_INDEX) {
+				p_reader.set_corrupt();
+				return;
+			}
+			_store_stack(slot, definition_index, quantity, durability);
+		}
+	}
+}
+
+// ============ 状态哈希 ============
+
+void WorldObject::hash_state(StateHasher &p_hasher) const {
+	p_hasher.add_name(object_id);
+	p_hasher.add_vector2i(local_position);
+
+	p_hasher.add_s32(container_capacity);
+	for (int32_t i = 0; i < container_capacity; i++) {
+		if (_is_slot_empty(i)) {
+			p_hasher.add_u32(0);
+			continue;
+		}
+		// 定义按内容哈希，ItemRegistry 索引在不同进程中可能不同
+		const ContainerSlot &slot = container[i];
+		p_hasher.add_u32(ItemRegistry::get(slot.def_index).hash());
+		p_hasher.add_s32(_get_slot_quantity(i));
+		p_hasher.add_s32(slot.unique ? unique_items[i]->get_durability() : slot.durability);
+	}
+}
@@ -5,16 +5,27 @@
 #pragma once
 
 #include "item.h"
+#include "spatial_index.h"
 
 #include "core/object/ref_counted.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/dictionary.h"
 #include "core/variant/typed_array.h"
 
 // 世界物体基类 - 表示世界中所有可交互的对象
+struct ItemDefinition;
+class SnapshotReader;
+class SnapshotWriter;
+struct StateHasher;
+
 class WorldObject : public RefCounted {
 	GDCLASS(WorldObject, RefCounted);
 
 public:
+	// 容器容量上限，防止损坏的存档申请过大的槽位数组
+	static constexpr int32_t MAX_CONTAINER_CAPACITY = 65536;
+
 	enum ObjectType {
 		TYPE_GENERIC,    // 通用物体
 		TYPE_CONTAINER,  // 容器类（箱子、柜子）
@@ -32,9 +43,37 @@ private:
 	Vector2i local_position;         // 区块内坐标
 
 	// === 容器系统 ===
-	Vector<Ref<Item>> container;     // 使用 Item 类存储物品
+	// 槽位只保存共享定义（ItemRegistry）的索引和实例数据，按物品ID扫描时只比较整数
+	struct ContainerSlot {
+		uint32_t def_index = UINT32_MAX;  // 定义索引，UINT32_MAX 表示空槽位
+		uint32_t id_index = UINT32_MAX;   // 定义中物品ID的编号（冗余保存，便于扫描）
+		int32_t quantity = 0;
+		int32_t durability = Item::DURABILITY_INFINITE;
+		bool unique = false;              // 物品无法用定义表示，数量以 unique_items 中的对象为准
+	};
+	LocalVector<ContainerSlot> container;
+	// 带自定义数据、脚本或子类的物品保留对象本身
+	HashMap<int32_t, Ref<Item>> unique_items;
 	int32_t container_capacity = 0;
 
+	int32_t _get_slot_quantity(int32_t p_slot) const;
+	bool _is_slot_empty(int32_t p_slot) const;
+	void _clear_slot(int32_t p_slot);
+	bool _store_item(int32_t p_slot, const Ref<Item> &p_item); // 定义表已满时失败
+	void _store_stack(int32_t p_slot, uint32_t p_def_index, int32_t p_quantity, int32_t p_durability);
+	Ref<Item> _make_item(int32_t p_slot) const;
+	bool _can_stack_into(int32_t p_slot, const ItemDefinition &p_definition, int32_t p_durability) const;
+	int32_t _add_to_slot(int32_t p_slot, int32_t p_amount); // 返回溢出数量
+	int32_t _stack_into_existing(const ItemDefinition &p_definition, int32_t p_quantity, int32_t p_durability); // 返回剩余数量
+	int32_t _find_empty_slot() const;
+	int32_t _find_id_slot(const StringName &p_item_id) const; // 第一个该物品ID的槽位，没有时返回 -1
+
+	// === 空间索引 ===
+	SpatialIndex *spatial_index = nullptr;
+	Vector2i chunk_origin;           // 所在区块左上角的世界坐标
+	uint32_t spatial_slot = 0;       // 在索引网格中的位置
+	friend class SpatialIndex;
+
 protected:
 	static void _bind_methods();
 
@@ -52,9 +91,14 @@ public:
 	void set_object_type(ObjectType p_type) { object_type = p_type; }
 	ObjectType get_object_type() const { return object_type; }
 
-	void set_local_position(const Vector2i &p_pos) { local_position = p_pos; }
+	void set_local_position(const Vector2i &p_pos);
 	Vector2i get_local_position() const { return local_position; }
 
+	// 世界坐标（区块原点 + 区块内坐标），区块原点在加入空间索引时设置
+	Vector2i get_chunk_origin() const { return chunk_origin; }
+	Vector2i get_world_position() const { return chunk_origin + local_position; }
+	SpatialIndex *get_spatial_index() const { return spatial_index; }
+
 	// === 容器系统 ===
 	void init_container(int32_t p_capacity);
 	int32_t get_container_capacity() const { return container_capacity; }
@@ -65,7 +109,10 @@ public:
 	bool is_container_empty() const;
 
 	// 容器操作
+	// 除带自定义数据、脚本或子类的物品外，容器保存的是物品的副本：
+	// container_get_item() 返回快照，修改后需通过 container_set_item() 写回
 	bool container_add_item(const Ref<Item> &p_item);              // 添加物品到第一个可用槽位
+	bool container_add_stack(uint32_t p_definition_index, int32_t p_quantity, int32_t p_durability = Item::DURABILITY_INFINITE);  // 按定义添加，不创建 Item 对象
 	bool container_add_item_at(int32_t p_slot, const Ref<Item> &p_item);  // 添加到指定槽位
 	Ref<Item> container_remove_item(int32_t p_slot);               // 移除并返回物品
 	Ref<Item> container_get_item(int32_t p_slot) const;            // 获取槽位物品
@@ -90,6 +137,15 @@ public:
 	// === 序列化 ===
 	virtual Dictionary serialize() const;
 	virtual void deserialize(const Dictionary &p_data);
+
+	// === 二进制快照 ===
+	// 固定布局，子类先调用父类实现再读写自己的字段，读写顺序必须一致
+	virtual void write_snapshot(SnapshotWriter &p_writer) const;
+	virtual void read_snapshot(SnapshotReader &p_reader);
+
+	// === 状态哈希 ===
+	// 用于确定性校验（LockstepSimulation），只包含模拟过程中会变化的状态
+	virtual void hash_state(StateHasher &p_hasher) const;
 };
 
 VARIANT_ENUM_CAST(WorldObject::ObjectType);
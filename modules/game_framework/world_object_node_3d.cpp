@@ -65,3 +65,31 @@ void WorldObjectNode3D::create_default_visual(const Vector3 &p_size, const Color
 	box_shape->set_size(p_size);
 	collision_shape->set_shape(box_shape);
 }
+
+// ============ WorldObjectBatchBody3D ============
+
+void WorldObjectBatchBody3D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_world_object_count"), &WorldObjectBatchBody3D::get_world_object_count);
+	ClassDB::bind_method(D_METHOD("get_world_object_for_shape", "shape_index"), &WorldObjectBatchBody3D::get_world_object_for_shape);
+}
+
+void WorldObjectBatchBody3D::add_world_object(const Ref<WorldObject> &p_world_object, const Ref<Shape3D> &p_shape, const Vector3 &p_position) {
+	ERR_FAIL_COND(p_world_object.is_null() || p_shape.is_null());
+
+	uint32_t owner = create_shape_owner(p_world_object.ptr());
+	shape_owner_add_shape(owner, p_shape);
+	shape_owner_set_transform(owner, Transform3D(Basis(), p_position));
+	objects[owner] = p_world_object;
+}
+
+void WorldObjectBatchBody3D::clear_world_objects() {
+	for (const KeyValue<uint32_t, Ref<WorldObject>> &kv : objects) {
+		remove_shape_owner(kv.key);
+	}
+	objects.clear();
+}
+
+Ref<WorldObject> WorldObjectBatchBody3D::get_world_object_for_shape(int p_shape_index) const {
+	const Ref<WorldObject> *object = objects.getptr(shape_find_owner(p_shape_index));
+	return object ? *object : Ref<WorldObject>();
+}
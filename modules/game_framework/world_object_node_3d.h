@@ -34,3 +34,23 @@ public:
 	// 创建基本的可视化表示（简单的立方体）
 	void create_default_visual(const Vector3 &p_size = Vector3(1, 1, 1), const Color &p_color = Color(0.8, 0.6, 0.4));
 };
+
+// 批量表示多个 WorldObject 的碰撞体
+// 每个物体只是一个碰撞形状而不是一个节点，射线检测命中后通过 RayResult::shape 找回对应的物体
+class WorldObjectBatchBody3D : public StaticBody3D {
+	GDCLASS(WorldObjectBatchBody3D, StaticBody3D);
+
+private:
+	HashMap<uint32_t, Ref<WorldObject>> objects; // shape owner -> WorldObject
+
+protected:
+	static void _bind_methods();
+
+public:
+	void add_world_object(const Ref<WorldObject> &p_world_object, const Ref<Shape3D> &p_shape, const Vector3 &p_position);
+	void clear_world_objects();
+	int get_world_object_count() const { return objects.size(); }
+
+	// p_shape_index 为射线检测结果中的形状索引
+	Ref<WorldObject> get_world_object_for_shape(int p_shape_index) const;
+};
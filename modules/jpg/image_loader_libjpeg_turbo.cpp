@@ -78,6 +78,13 @@ Error jpeg_turbo_load_image_from_buffer(Image *p_image, const uint8_t *p_buffer,
 }
 
 Error ImageLoaderLibJPEGTurbo::load_image(Ref<Image> p_image, Ref<FileAccess> f, BitField<ImageFormatLoader::LoaderFlags> p_flags, float p_scale) {
+	const Span<uint8_t> mapped = f->get_mapped_buffer();
+	if (!mapped.is_empty()) {
+		// Already in memory, decode in place.
+		ERR_FAIL_COND_V(mapped.size() > INT_MAX, ERR_FILE_CORRUPT);
+		return jpeg_turbo_load_image_from_buffer(p_image.ptr(), mapped.ptr(), mapped.size());
+	}
+
 	Vector<uint8_t> src_image;
 	uint64_t src_image_len = f->get_length();
 	ERR_FAIL_COND_V(src_image_len == 0, ERR_FILE_CORRUPT);
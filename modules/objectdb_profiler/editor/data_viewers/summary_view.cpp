@@ -30,6 +30,7 @@
 
 #include "summary_view.h"
 
+#include "core/debugger/debugger_marshalls.h"
 #include "core/os/time.h"
 #include "editor/editor_node.h"
 #include "scene/gui/center_container.h"
@@ -115,6 +116,11 @@ void SnapshotSummaryView::show_snapshot(GameStateSnapshot *p_data, GameStateSnap
 		_push_overview_blurb(snapshot_b_name + " " + TTRC("Overview"), diff_data);
 	}
 
+	_push_memory_tag_blurb(snapshot_a_name + " " + TTRC("Heap by Allocation Tag"), snapshot_data, nullptr);
+	if (diff_data) {
+		_push_memory_tag_blurb(TTRC("Heap Change by Allocation Tag (B - A)"), diff_data, snapshot_data);
+	}
+
 	_push_node_blurb(snapshot_a_name + " " + TTRC("Nodes"), snapshot_data);
 	if (diff_data) {
 		_push_node_blurb(snapshot_b_name + " " + TTRC("Nodes"), diff_data);
@@ -198,6 +204,52 @@ void SnapshotSummaryView::_push_overview_blurb(const String &p_title, GameStateS
 	blurb_list->add_child(memnew(SummaryBlurb(p_title, c)));
 }
 
+void SnapshotSummaryView::_push_memory_tag_blurb(const String &p_title, GameStateSnapshot *p_snapshot, GameStateSnapshot *p_baseline) {
+	// Only present when the game was built with `memory_tags=yes`.
+	if (!p_snapshot->snapshot_context.has("mem_tags")) {
+		return;
+	}
+	DebuggerMarshalls::MemoryTagUsage usage;
+	if (!usage.deserialize(p_snapshot->snapshot_context["mem_tags"])) {
+		return;
+	}
+	if (p_baseline) {
+		DebuggerMarshalls::MemoryTagUsage baseline;
+		if (!p_baseline->snapshot_context.has("mem_tags") || !baseline.deserialize(p_baseline->snapshot_context["mem_tags"])) {
+			return;
+		}
+		usage = usage.diff(baseline);
+	}
+
+	struct LargestFirst {
+		_FORCE_INLINE_ bool operator()(const DebuggerMarshalls::MemoryTagUsage::Entry &p_a, const DebuggerMarshalls::MemoryTagUsage::Entry &p_b) const {
+			return Math::abs(p_a.live_bytes) > Math::abs(p_b.live_bytes);
+		}
+	};
+	usage.entries.sort_custom<LargestFirst>();
+
+	const int max_lines = 25;
+	String c = "[ul]\n";
+	int lines = 0;
+	for (const DebuggerMarshalls::MemoryTagUsage::Entry &entry : usage.entries) {
+		if (entry.live_bytes == 0 || lines == max_lines) {
+			break;
+		}
+		String size = String::humanize_size(Math::abs(entry.live_bytes));
+		if (p_baseline) {
+			size = (entry.live_bytes > 0 ? "+" : "-") + size;
+		}
+		c += vformat(" [i]%s[/i] %s (%s)\n", entry.name, size, vformat(TTR("%d blocks"), entry.live_blocks));
+		lines++;
+	}
+	if (lines == 0) {
+		c += " " + TTR("No change.") + "\n";
+	}
+	c += "[/ul]\n";
+
+	blurb_list->add_child(memnew(SummaryBlurb(p_title, c)));
+}
+
 void SnapshotSummaryView::_push_node_blurb(const String &p_title, GameStateSnapshot *p_snapshot) {
 	LocalVector<String> nodes;
 	nodes.reserve(p_snapshot->objects.size());
@@ -55,6 +55,8 @@ protected:
 	CenterContainer *explainer_text = nullptr;
 
 	void _push_overview_blurb(const String &p_title, GameStateSnapshot *p_snapshot);
+	// Live heap per allocation tag, or its change since p_baseline when given.
+	void _push_memory_tag_blurb(const String &p_title, GameStateSnapshot *p_snapshot, GameStateSnapshot *p_baseline);
 	void _push_node_blurb(const String &p_title, GameStateSnapshot *p_snapshot);
 	void _push_refcounted_blurb(const String &p_title, GameStateSnapshot *p_snapshot);
 	void _push_object_blurb(const String &p_title, GameStateSnapshot *p_snapshot);
@@ -31,6 +31,7 @@
 #include "snapshot_collector.h"
 
 #include "core/core_bind.h"
+#include "core/debugger/debugger_marshalls.h"
 #include "core/debugger/engine_debugger.h"
 #include "core/io/compression.h"
 #include "core/os/time.h"
@@ -114,6 +115,11 @@ void SnapshotCollector::snapshot_objects(Array *p_arr, Dictionary &p_snapshot_co
 	// Add a header to the snapshot with general data about the state of the game, not tied to any particular object.
 	p_snapshot_context["mem_usage"] = Memory::get_mem_usage();
 	p_snapshot_context["mem_max_usage"] = Memory::get_mem_max_usage();
+	if (Memory::is_tagging_enabled()) {
+		DebuggerMarshalls::MemoryTagUsage tag_usage;
+		tag_usage.capture();
+		p_snapshot_context["mem_tags"] = tag_usage.serialize();
+	}
 	p_snapshot_context["timestamp"] = Time::get_singleton()->get_unix_time_from_system();
 	p_snapshot_context["game_version"] = get_godot_version_string();
 	p_arr->push_back(p_snapshot_context);
@@ -31,8 +31,9 @@
 #include "cpu_particles_2d.h"
 #include "cpu_particles_2d.compat.inc"
 
-#include "core/math/random_number_generator.h"
+#include "core/math/random_pcg.h"
 #include "core/math/transform_interpolator.h"
+#include "core/object/worker_thread_pool.h"
 #include "scene/2d/gpu_particles_2d.h"
 #include "scene/resources/atlas_texture.h"
 #include "scene/resources/canvas_item_material.h"
@@ -296,6 +297,14 @@ bool CPUParticles2D::get_fractional_delta() const {
 	return fractional_delta;
 }
 
+void CPUParticles2D::set_parallel_processing_enabled(bool p_enabled) {
+	parallel_processing = p_enabled;
+}
+
+bool CPUParticles2D::is_parallel_processing_enabled() const {
+	return parallel_processing;
+}
+
 PackedStringArray CPUParticles2D::get_configuration_warnings() const {
 	PackedStringArray warnings = Node2D::get_configuration_warnings();
 
@@ -749,11 +758,6 @@ void CPUParticles2D::_update_internal() {
 void CPUParticles2D::_particles_process(double p_delta) {
 	p_delta *= speed_scale;
 
-	int pcount = particles.size();
-	Particle *w = particles.ptrw();
-
-	Particle *parray = w;
-
 	double prev_time = time;
 	time += p_delta;
 	if (time > lifetime) {
@@ -765,29 +769,70 @@ void CPUParticles2D::_particles_process(double p_delta) {
 		}
 	}
 
-	Transform2D emission_xform;
-	Transform2D velocity_xform;
+	ProcessFrame frame;
+	frame.particles = particles.ptrw();
+	frame.particle_count = particles.size();
+	frame.delta = p_delta;
+	frame.prev_time = prev_time;
+
 	if (!local_coords) {
 		if (!_interpolation_data.interpolated_follow) {
-			emission_xform = get_global_transform();
+			frame.emission_xform = get_global_transform();
 		} else {
-			TransformInterpolator::interpolate_transform_2d(_interpolation_data.global_xform_prev, _interpolation_data.global_xform_curr, emission_xform, Engine::get_singleton()->get_physics_interpolation_fraction());
+			TransformInterpolator::interpolate_transform_2d(_interpolation_data.global_xform_prev, _interpolation_data.global_xform_curr, frame.emission_xform, Engine::get_singleton()->get_physics_interpolation_fraction());
+		}
+		frame.velocity_xform = frame.emission_xform;
+		frame.velocity_xform[2] = Vector2();
+	}
+
+	frame.system_phase = time / lifetime;
+
+	// Gradients sort their points lazily, which must not happen while particles are processed concurrently.
+	for (const Ref<Gradient> &gradient : { color_ramp, color_initial_ramp }) {
+		if (gradient.is_valid() && gradient->get_point_count() > 0) {
+			gradient->get_offset(0);
+		}
+	}
+
+	// Particles only depend on their own state and seed, so blocks can be processed in any order.
+	const uint32_t block_count = (frame.particle_count + PROCESS_BLOCK_SIZE - 1) / PROCESS_BLOCK_SIZE;
+	// When already running on a pool thread (e.g. the scene is processed from a group task), waiting on
+	// a nested group task can deadlock once every pool thread is waiting, so process the blocks inline instead.
+	if (parallel_processing && block_count > 1 && WorkerThreadPool::get_singleton()->get_thread_index() == -1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &CPUParticles2D::_particles_process_block, &frame, block_count, -1, true, SNAME("CPUParticles2DProcess"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < block_count; i++) {
+			_particles_process_block(i, &frame);
 		}
-		velocity_xform = emission_xform;
-		velocity_xform[2] = Vector2();
 	}
 
-	double system_phase = time / lifetime;
+	if (!Math::is_equal_approx(time, 0.0) && active && !frame.should_be_active.is_set()) {
+		active = false;
+		emit_signal(SceneStringName(finished));
+	}
+}
+
+void CPUParticles2D::_particles_process_block(uint32_t p_block, ProcessFrame *p_frame) {
+	Particle *parray = p_frame->particles;
+	const int pcount = p_frame->particle_count;
+	const double prev_time = p_frame->prev_time;
+	const double system_phase = p_frame->system_phase;
+	const Transform2D &emission_xform = p_frame->emission_xform;
+	const Transform2D &velocity_xform = p_frame->velocity_xform;
+
+	const int from = p_block * PROCESS_BLOCK_SIZE;
+	const int to = MIN(from + PROCESS_BLOCK_SIZE, pcount);
 
 	bool should_be_active = false;
-	for (int i = 0; i < pcount; i++) {
+	for (int i = from; i < to; i++) {
 		Particle &p = parray[i];
 
 		if (!emitting && !p.active) {
 			continue;
 		}
 
-		double local_delta = p_delta;
+		double local_delta = p_frame->delta;
 
 		// The phase is a ratio between 0 (birth) and 1 (end of life) for each particle.
 		// While we use time in tests later on, for randomness we use the phase as done in the
@@ -863,22 +908,22 @@ void CPUParticles2D::_particles_process(double p_delta) {
 			}
 
 			p.seed = seed + uint32_t(i) + i + cycle;
-			rng->set_seed(p.seed);
+			RandomPCG rng(p.seed);
 
-			p.angle_rand = rng->randf();
-			p.scale_rand = rng->randf();
-			p.hue_rot_rand = rng->randf();
-			p.anim_offset_rand = rng->randf();
+			p.angle_rand = rng.randf();
+			p.scale_rand = rng.randf();
+			p.hue_rot_rand = rng.randf();
+			p.anim_offset_rand = rng.randf();
 
 			if (color_initial_ramp.is_valid()) {
-				p.start_color_rand = color_initial_ramp->get_color_at_offset(rng->randf());
+				p.start_color_rand = color_initial_ramp->get_color_at_offset(rng.randf());
 			} else {
 				p.start_color_rand = Color(1, 1, 1, 1);
 			}
 
-			real_t angle1_rad = direction.angle() + Math::deg_to_rad((rng->randf() * 2.0 - 1.0) * spread);
+			real_t angle1_rad = direction.angle() + Math::deg_to_rad((rng.randf() * 2.0 - 1.0) * spread);
 			Vector2 rot = Vector2(Math::cos(angle1_rad), Math::sin(angle1_rad));
-			p.velocity = rot * Math::lerp(parameters_min[PARAM_INITIAL_LINEAR_VELOCITY], parameters_max[PARAM_INITIAL_LINEAR_VELOCITY], rng->randf());
+			p.velocity = rot * Math::lerp(parameters_min[PARAM_INITIAL_LINEAR_VELOCITY], parameters_max[PARAM_INITIAL_LINEAR_VELOCITY], rng.randf());
 
 			real_t base_angle = tex_angle * Math::lerp(parameters_min[PARAM_ANGLE], parameters_max[PARAM_ANGLE], p.angle_rand);
 			p.rotation = Math::deg_to_rad(base_angle);
@@ -886,7 +931,7 @@ void CPUParticles2D::_particles_process(double p_delta) {
 			p.custom[0] = 0.0; // unused
 			p.custom[1] = 0.0; // phase [0..1]
 			p.custom[2] = tex_anim_offset * Math::lerp(parameters_min[PARAM_ANIM_OFFSET], parameters_max[PARAM_ANIM_OFFSET], p.anim_offset_rand);
-			p.custom[3] = (1.0 - rng->randf() * lifetime_randomness);
+			p.custom[3] = (1.0 - rng.randf() * lifetime_randomness);
 			p.transform = Transform2D();
 			p.time = 0;
 			p.lifetime = lifetime * p.custom[3];
@@ -897,17 +942,17 @@ void CPUParticles2D::_particles_process(double p_delta) {
 					//do none
 				} break;
 				case EMISSION_SHAPE_SPHERE: {
-					real_t t = Math::TAU * rng->randf();
-					real_t radius = emission_sphere_radius * rng->randf();
+					real_t t = Math::TAU * rng.randf();
+					real_t radius = emission_sphere_radius * rng.randf();
 					p.transform[2] = Vector2(Math::cos(t), Math::sin(t)) * radius;
 				} break;
 				case EMISSION_SHAPE_SPHERE_SURFACE: {
-					real_t s = rng->randf(), t = Math::TAU * rng->randf();
+					real_t s = rng.randf(), t = Math::TAU * rng.randf();
 					real_t radius = emission_sphere_radius * Math::sqrt(1.0 - s * s);
 					p.transform[2] = Vector2(Math::cos(t), Math::sin(t)) * radius;
 				} break;
 				case EMISSION_SHAPE_RECTANGLE: {
-					p.transform[2] = Vector2(rng->randf() * 2.0 - 1.0, rng->randf() * 2.0 - 1.0) * emission_rect_extents;
+					p.transform[2] = Vector2(rng.randf() * 2.0 - 1.0, rng.randf() * 2.0 - 1.0) * emission_rect_extents;
 				} break;
 				case EMISSION_SHAPE_POINTS:
 				case EMISSION_SHAPE_DIRECTED_POINTS: {
@@ -916,7 +961,7 @@ void CPUParticles2D::_particles_process(double p_delta) {
 						break;
 					}
 
-					int random_idx = Math::rand() % pc;
+					int random_idx = rng.rand() % pc;
 
 					p.transform[2] = emission_points.get(random_idx);
 
@@ -933,10 +978,10 @@ void CPUParticles2D::_particles_process(double p_delta) {
 					}
 				} break;
 				case EMISSION_SHAPE_RING: {
-					real_t t = Math::TAU * Math::randf();
+					real_t t = Math::TAU * rng.randf();
 					real_t outer_sq = emission_ring_radius * emission_ring_radius;
 					real_t inner_sq = emission_ring_inner_radius * emission_ring_inner_radius;
-					real_t radius = Math::sqrt(Math::randf() * (outer_sq - inner_sq) + inner_sq);
+					real_t radius = Math::sqrt(rng.randf() * (outer_sq - inner_sq) + inner_sq);
 					p.transform[2] = Vector2(Math::cos(t), Math::sin(t)) * radius;
 				} break;
 				case EMISSION_SHAPE_MAX: { // Max value for validity check.
@@ -1135,9 +1180,8 @@ void CPUParticles2D::_particles_process(double p_delta) {
 
 		should_be_active = true;
 	}
-	if (!Math::is_equal_approx(time, 0.0) && active && !should_be_active) {
-		active = false;
-		emit_signal(SceneStringName(finished));
+	if (should_be_active) {
+		p_frame->should_be_active.set();
 	}
 }
 
@@ -1455,6 +1499,8 @@ void CPUParticles2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_use_local_coordinates"), &CPUParticles2D::get_use_local_coordinates);
 	ClassDB::bind_method(D_METHOD("get_fixed_fps"), &CPUParticles2D::get_fixed_fps);
 	ClassDB::bind_method(D_METHOD("get_fractional_delta"), &CPUParticles2D::get_fractional_delta);
+	ClassDB::bind_method(D_METHOD("set_parallel_processing_enabled", "enabled"), &CPUParticles2D::set_parallel_processing_enabled);
+	ClassDB::bind_method(D_METHOD("is_parallel_processing_enabled"), &CPUParticles2D::is_parallel_processing_enabled);
 	ClassDB::bind_method(D_METHOD("get_speed_scale"), &CPUParticles2D::get_speed_scale);
 	ClassDB::bind_method(D_METHOD("set_use_fixed_seed", "use_fixed_seed"), &CPUParticles2D::set_use_fixed_seed);
 	ClassDB::bind_method(D_METHOD("get_use_fixed_seed"), &CPUParticles2D::get_use_fixed_seed);
@@ -1486,6 +1532,7 @@ void CPUParticles2D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "lifetime_randomness", PROPERTY_HINT_RANGE, "0,1,0.01"), "set_lifetime_randomness", "get_lifetime_randomness");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "fixed_fps", PROPERTY_HINT_RANGE, "0,1000,1,suffix:FPS"), "set_fixed_fps", "get_fixed_fps");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "fract_delta"), "set_fractional_delta", "get_fractional_delta");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "parallel_processing"), "set_parallel_processing_enabled", "is_parallel_processing_enabled");
 	ADD_GROUP("Drawing", "");
 	// No visibility_rect property contrarily to Particles2D, it's updated automatically.
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "local_coords"), "set_use_local_coordinates", "get_use_local_coordinates");
@@ -1676,8 +1723,6 @@ CPUParticles2D::CPUParticles2D() {
 	set_use_local_coordinates(false);
 	set_seed(Math::rand());
 
-	rng.instantiate();
-
 	set_param_min(PARAM_INITIAL_LINEAR_VELOCITY, 0);
 	set_param_min(PARAM_ANGULAR_VELOCITY, 0);
 	set_param_min(PARAM_ORBIT_VELOCITY, 0);
@@ -33,11 +33,10 @@
 #include "scene/2d/node_2d.h"
 #include "scene/resources/gradient.h"
 
-class RandomNumberGenerator;
-
 class CPUParticles2D : public Node2D {
 private:
 	GDCLASS(CPUParticles2D, Node2D);
+	friend class TestCPUParticles2DInternalsAccessor;
 
 public:
 	enum DrawOrder {
@@ -136,6 +135,7 @@ private:
 	bool local_coords = false;
 	int fixed_fps = 0;
 	bool fractional_delta = true;
+	bool parallel_processing = true;
 	uint32_t seed = 0;
 	bool use_fixed_seed = false;
 
@@ -179,10 +179,23 @@ private:
 
 	Vector2 gravity = Vector2(0, 980);
 
-	Ref<RandomNumberGenerator> rng;
-
 	void _update_internal();
+	// Per-frame values shared by the blocks of particles processed in parallel.
+	struct ProcessFrame {
+		Particle *particles = nullptr;
+		int particle_count = 0;
+		double delta = 0.0;
+		double prev_time = 0.0;
+		double system_phase = 0.0;
+		Transform2D emission_xform;
+		Transform2D velocity_xform;
+		SafeFlag should_be_active;
+	};
+
+	static constexpr int PROCESS_BLOCK_SIZE = 256;
+
 	void _particles_process(double p_delta);
+	void _particles_process_block(uint32_t p_block, ProcessFrame *p_frame);
 	void _update_particle_data_buffer();
 	void _set_emitting();
 
@@ -248,6 +261,8 @@ public:
 
 	void set_fractional_delta(bool p_enable);
 	bool get_fractional_delta() const;
+	void set_parallel_processing_enabled(bool p_enabled);
+	bool is_parallel_processing_enabled() const;
 
 	void set_draw_order(DrawOrder p_order);
 	DrawOrder get_draw_order() const;
@@ -31,7 +31,8 @@
 #include "cpu_particles_3d.h"
 #include "cpu_particles_3d.compat.inc"
 
-#include "core/math/random_number_generator.h"
+#include "core/math/random_pcg.h"
+#include "core/object/worker_thread_pool.h"
 #include "scene/3d/camera_3d.h"
 #include "scene/3d/gpu_particles_3d.h"
 #include "scene/main/viewport.h"
@@ -211,6 +212,14 @@ bool CPUParticles3D::get_fractional_delta() const {
 	return fractional_delta;
 }
 
+void CPUParticles3D::set_parallel_processing_enabled(bool p_enabled) {
+	parallel_processing = p_enabled;
+}
+
+bool CPUParticles3D::is_parallel_processing_enabled() const {
+	return parallel_processing;
+}
+
 PackedStringArray CPUParticles3D::get_configuration_warnings() const {
 	PackedStringArray warnings = GeometryInstance3D::get_configuration_warnings();
 
@@ -703,11 +712,6 @@ void CPUParticles3D::_update_internal() {
 void CPUParticles3D::_particles_process(double p_delta) {
 	p_delta *= speed_scale;
 
-	int pcount = particles.size();
-	Particle *w = particles.ptrw();
-
-	Particle *parray = w;
-
 	double prev_time = time;
 	time += p_delta;
 	if (time > lifetime) {
@@ -719,24 +723,65 @@ void CPUParticles3D::_particles_process(double p_delta) {
 		}
 	}
 
-	Transform3D emission_xform;
-	Basis velocity_xform;
+	ProcessFrame frame;
+	frame.particles = particles.ptrw();
+	frame.particle_count = particles.size();
+	frame.delta = p_delta;
+	frame.prev_time = prev_time;
+
 	if (!local_coords) {
-		emission_xform = get_global_transform_interpolated();
-		velocity_xform = emission_xform.basis;
+		frame.emission_xform = get_global_transform_interpolated();
+		frame.velocity_xform = frame.emission_xform.basis;
+	}
+
+	frame.system_phase = time / lifetime;
+
+	// Gradients sort their points lazily, which must not happen while particles are processed concurrently.
+	for (const Ref<Gradient> &gradient : { color_ramp, color_initial_ramp }) {
+		if (gradient.is_valid() && gradient->get_point_count() > 0) {
+			gradient->get_offset(0);
+		}
+	}
+
+	// Particles only depend on their own state and seed, so blocks can be processed in any order.
+	const uint32_t block_count = (frame.particle_count + PROCESS_BLOCK_SIZE - 1) / PROCESS_BLOCK_SIZE;
+	// When already running on a pool thread (e.g. the scene is processed from a group task), waiting on
+	// a nested group task can deadlock once every pool thread is waiting, so process the blocks inline instead.
+	if (parallel_processing && block_count > 1 && WorkerThreadPool::get_singleton()->get_thread_index() == -1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &CPUParticles3D::_particles_process_block, &frame, block_count, -1, true, SNAME("CPUParticles3DProcess"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < block_count; i++) {
+			_particles_process_block(i, &frame);
+		}
+	}
+
+	if (!Math::is_equal_approx(time, 0.0) && active && !frame.should_be_active.is_set()) {
+		active = false;
+		emit_signal(SceneStringName(finished));
 	}
+}
+
+void CPUParticles3D::_particles_process_block(uint32_t p_block, ProcessFrame *p_frame) {
+	Particle *parray = p_frame->particles;
+	const int pcount = p_frame->particle_count;
+	const double prev_time = p_frame->prev_time;
+	const double system_phase = p_frame->system_phase;
+	const Transform3D &emission_xform = p_frame->emission_xform;
+	const Basis &velocity_xform = p_frame->velocity_xform;
 
-	double system_phase = time / lifetime;
+	const int from = p_block * PROCESS_BLOCK_SIZE;
+	const int to = MIN(from + PROCESS_BLOCK_SIZE, pcount);
 
 	bool should_be_active = false;
-	for (int i = 0; i < pcount; i++) {
+	for (int i = from; i < to; i++) {
 		Particle &p = parray[i];
 
 		if (!emitting && !p.active) {
 			continue;
 		}
 
-		double local_delta = p_delta;
+		double local_delta = p_frame->delta;
 
 		// The phase is a ratio between 0 (birth) and 1 (end of life) for each particle.
 		// While we use time in tests later on, for randomness we use the phase as done in the
@@ -812,26 +857,26 @@ void CPUParticles3D::_particles_process(double p_delta) {
 			}
 
 			p.seed = seed + uint32_t(1) + i + cycle * pcount;
-			rng->set_seed(p.seed);
-			p.angle_rand = rng->randf();
-			p.scale_rand = rng->randf();
-			p.hue_rot_rand = rng->randf();
-			p.anim_offset_rand = rng->randf();
+			RandomPCG rng(p.seed);
+			p.angle_rand = rng.randf();
+			p.scale_rand = rng.randf();
+			p.hue_rot_rand = rng.randf();
+			p.anim_offset_rand = rng.randf();
 
 			if (color_initial_ramp.is_valid()) {
-				p.start_color_rand = color_initial_ramp->get_color_at_offset(rng->randf());
+				p.start_color_rand = color_initial_ramp->get_color_at_offset(rng.randf());
 			} else {
 				p.start_color_rand = Color(1, 1, 1, 1);
 			}
 
 			if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
-				real_t angle1_rad = Math::atan2(direction.y, direction.x) + Math::deg_to_rad((rng->randf() * 2.0 - 1.0) * spread);
+				real_t angle1_rad = Math::atan2(direction.y, direction.x) + Math::deg_to_rad((rng.randf() * 2.0 - 1.0) * spread);
 				Vector3 rot = Vector3(Math::cos(angle1_rad), Math::sin(angle1_rad), 0.0);
-				p.velocity = rot * Math::lerp(parameters_min[PARAM_INITIAL_LINEAR_VELOCITY], parameters_max[PARAM_INITIAL_LINEAR_VELOCITY], rng->randf());
+				p.velocity = rot * Math::lerp(parameters_min[PARAM_INITIAL_LINEAR_VELOCITY], parameters_max[PARAM_INITIAL_LINEAR_VELOCITY], rng.randf());
 			} else {
 				//initiate velocity spread in 3D
-				real_t angle1_rad = Math::deg_to_rad((rng->randf() * (real_t)2.0 - (real_t)1.0) * spread);
-				real_t angle2_rad = Math::deg_to_rad((rng->randf() * (real_t)2.0 - (real_t)1.0) * ((real_t)1.0 - flatness) * spread);
+				real_t angle1_rad = Math::deg_to_rad((rng.randf() * (real_t)2.0 - (real_t)1.0) * spread);
+				real_t angle2_rad = Math::deg_to_rad((rng.randf() * (real_t)2.0 - (real_t)1.0) * ((real_t)1.0 - flatness) * spread);
 
 				Vector3 direction_xz = Vector3(Math::sin(angle1_rad), 0, Math::cos(angle1_rad));
 				Vector3 direction_yz = Vector3(0, Math::sin(angle2_rad), Math::cos(angle2_rad));
@@ -851,14 +896,14 @@ void CPUParticles3D::_particles_process(double p_delta) {
 				binormal.normalize();
 				Vector3 normal = binormal.cross(direction_nrm);
 				spread_direction = binormal * spread_direction.x + normal * spread_direction.y + direction_nrm * spread_direction.z;
-				p.velocity = spread_direction * Math::lerp(parameters_min[PARAM_INITIAL_LINEAR_VELOCITY], parameters_max[PARAM_INITIAL_LINEAR_VELOCITY], rng->randf());
+				p.velocity = spread_direction * Math::lerp(parameters_min[PARAM_INITIAL_LINEAR_VELOCITY], parameters_max[PARAM_INITIAL_LINEAR_VELOCITY], rng.randf());
 			}
 
 			real_t base_angle = tex_angle * Math::lerp(parameters_min[PARAM_ANGLE], parameters_max[PARAM_ANGLE], p.angle_rand);
 			p.custom[0] = Math::deg_to_rad(base_angle); //angle
 			p.custom[1] = 0.0; //phase
 			p.custom[2] = tex_anim_offset * Math::lerp(parameters_min[PARAM_ANIM_OFFSET], parameters_max[PARAM_ANIM_OFFSET], p.anim_offset_rand); //animation offset (0-1)
-			p.custom[3] = (1.0 - rng->randf() * lifetime_randomness);
+			p.custom[3] = (1.0 - rng.randf() * lifetime_randomness);
 			p.transform = Transform3D();
 			p.time = 0;
 			p.lifetime = lifetime * p.custom[3];
@@ -869,20 +914,20 @@ void CPUParticles3D::_particles_process(double p_delta) {
 					//do none
 				} break;
 				case EMISSION_SHAPE_SPHERE: {
-					real_t s = 2.0 * rng->randf() - 1.0;
-					real_t t = Math::TAU * rng->randf();
-					real_t x = rng->randf();
+					real_t s = 2.0 * rng.randf() - 1.0;
+					real_t t = Math::TAU * rng.randf();
+					real_t x = rng.randf();
 					real_t radius = emission_sphere_radius * Math::sqrt(1.0 - s * s);
 					p.transform.origin = Vector3(0, 0, 0).lerp(Vector3(radius * Math::cos(t), radius * Math::sin(t), emission_sphere_radius * s), x);
 				} break;
 				case EMISSION_SHAPE_SPHERE_SURFACE: {
-					real_t s = 2.0 * rng->randf() - 1.0;
-					real_t t = Math::TAU * rng->randf();
+					real_t s = 2.0 * rng.randf() - 1.0;
+					real_t t = Math::TAU * rng.randf();
 					real_t radius = emission_sphere_radius * Math::sqrt(1.0 - s * s);
 					p.transform.origin = Vector3(radius * Math::cos(t), radius * Math::sin(t), emission_sphere_radius * s);
 				} break;
 				case EMISSION_SHAPE_BOX: {
-					p.transform.origin = Vector3(rng->randf() * 2.0 - 1.0, rng->randf() * 2.0 - 1.0, rng->randf() * 2.0 - 1.0) * emission_box_extents;
+					p.transform.origin = Vector3(rng.randf() * 2.0 - 1.0, rng.randf() * 2.0 - 1.0, rng.randf() * 2.0 - 1.0) * emission_box_extents;
 				} break;
 				case EMISSION_SHAPE_POINTS:
 				case EMISSION_SHAPE_DIRECTED_POINTS: {
@@ -891,7 +936,7 @@ void CPUParticles3D::_particles_process(double p_delta) {
 						break;
 					}
 
-					int random_idx = Math::rand() % pc;
+					int random_idx = rng.rand() % pc;
 
 					p.transform.origin = emission_points.get(random_idx);
 
@@ -926,11 +971,11 @@ void CPUParticles3D::_particles_process(double p_delta) {
 				case EMISSION_SHAPE_RING: {
 					real_t radius_clamped = MAX(0.001, emission_ring_radius);
 					real_t top_radius = MAX(radius_clamped - Math::tan(Math::deg_to_rad(90.0 - emission_ring_cone_angle)) * emission_ring_height, 0.0);
-					real_t y_pos = rng->randf();
+					real_t y_pos = rng.randf();
 					real_t skew = MAX(MIN(radius_clamped, top_radius) / MAX(radius_clamped, top_radius), 0.5);
 					y_pos = radius_clamped < top_radius ? Math::pow(y_pos, skew) : 1.0 - Math::pow(y_pos, skew);
-					real_t ring_random_angle = rng->randf() * Math::TAU;
-					real_t ring_random_radius = Math::sqrt(rng->randf() * (radius_clamped * radius_clamped - emission_ring_inner_radius * emission_ring_inner_radius) + emission_ring_inner_radius * emission_ring_inner_radius);
+					real_t ring_random_angle = rng.randf() * Math::TAU;
+					real_t ring_random_radius = Math::sqrt(rng.randf() * (radius_clamped * radius_clamped - emission_ring_inner_radius * emission_ring_inner_radius) + emission_ring_inner_radius * emission_ring_inner_radius);
 					ring_random_radius = Math::lerp(ring_random_radius, ring_random_radius * (top_radius / radius_clamped), y_pos);
 					Vector3 axis = emission_ring_axis == Vector3(0.0, 0.0, 0.0) ? Vector3(0.0, 0.0, 1.0) : emission_ring_axis.normalized();
 					Vector3 ortho_axis;
@@ -1205,9 +1250,8 @@ void CPUParticles3D::_particles_process(double p_delta) {
 
 		should_be_active = true;
 	}
-	if (!Math::is_equal_approx(time, 0.0) && active && !should_be_active) {
-		active = false;
-		emit_signal(SceneStringName(finished));
+	if (should_be_active) {
+		p_frame->should_be_active.set();
 	}
 }
 
@@ -1512,6 +1556,8 @@ void CPUParticles3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_use_local_coordinates"), &CPUParticles3D::get_use_local_coordinates);
 	ClassDB::bind_method(D_METHOD("get_fixed_fps"), &CPUParticles3D::get_fixed_fps);
 	ClassDB::bind_method(D_METHOD("get_fractional_delta"), &CPUParticles3D::get_fractional_delta);
+	ClassDB::bind_method(D_METHOD("set_parallel_processing_enabled", "enabled"), &CPUParticles3D::set_parallel_processing_enabled);
+	ClassDB::bind_method(D_METHOD("is_parallel_processing_enabled"), &CPUParticles3D::is_parallel_processing_enabled);
 	ClassDB::bind_method(D_METHOD("get_speed_scale"), &CPUParticles3D::get_speed_scale);
 
 	ClassDB::bind_method(D_METHOD("set_draw_order", "order"), &CPUParticles3D::set_draw_order);
@@ -1546,6 +1592,7 @@ void CPUParticles3D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "lifetime_randomness", PROPERTY_HINT_RANGE, "0,1,0.01"), "set_lifetime_randomness", "get_lifetime_randomness");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "fixed_fps", PROPERTY_HINT_RANGE, "0,1000,1,suffix:FPS"), "set_fixed_fps", "get_fixed_fps");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "fract_delta"), "set_fractional_delta", "get_fractional_delta");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "parallel_processing"), "set_parallel_processing_enabled", "is_parallel_processing_enabled");
 	ADD_GROUP("Drawing", "");
 	ADD_PROPERTY(PropertyInfo(Variant::AABB, "visibility_aabb", PROPERTY_HINT_NONE, "suffix:m"), "set_visibility_aabb", "get_visibility_aabb");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "local_coords"), "set_use_local_coordinates", "get_use_local_coordinates");
@@ -1760,8 +1807,6 @@ CPUParticles3D::CPUParticles3D() {
 	set_amount(8);
 	set_seed(Math::rand());
 
-	rng.instantiate();
-
 	set_param_min(PARAM_INITIAL_LINEAR_VELOCITY, 0);
 	set_param_min(PARAM_ANGULAR_VELOCITY, 0);
 	set_param_min(PARAM_ORBIT_VELOCITY, 0);
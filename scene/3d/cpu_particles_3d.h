@@ -33,11 +33,10 @@
 #include "scene/3d/visual_instance_3d.h"
 #include "scene/resources/gradient.h"
 
-class RandomNumberGenerator;
-
 class CPUParticles3D : public GeometryInstance3D {
 private:
 	GDCLASS(CPUParticles3D, GeometryInstance3D);
+	friend class TestCPUParticles3DInternalsAccessor;
 
 public:
 	enum DrawOrder {
@@ -145,6 +144,7 @@ private:
 	bool local_coords = false;
 	int fixed_fps = 0;
 	bool fractional_delta = true;
+	bool parallel_processing = true;
 	uint32_t seed = 0;
 	bool use_fixed_seed = false;
 
@@ -191,10 +191,23 @@ private:
 
 	Vector3 gravity = Vector3(0, -9.8, 0);
 
-	Ref<RandomNumberGenerator> rng;
-
 	void _update_internal();
+	// Per-frame values shared by the blocks of particles processed in parallel.
+	struct ProcessFrame {
+		Particle *particles = nullptr;
+		int particle_count = 0;
+		double delta = 0.0;
+		double prev_time = 0.0;
+		double system_phase = 0.0;
+		Transform3D emission_xform;
+		Basis velocity_xform;
+		SafeFlag should_be_active;
+	};
+
+	static constexpr int PROCESS_BLOCK_SIZE = 256;
+
 	void _particles_process(double p_delta);
+	void _particles_process_block(uint32_t p_block, ProcessFrame *p_frame);
 	void _update_particle_data_buffer();
 	void _set_emitting();
 
@@ -246,6 +259,8 @@ public:
 
 	void set_fractional_delta(bool p_enable);
 	bool get_fractional_delta() const;
+	void set_parallel_processing_enabled(bool p_enabled);
+	bool is_parallel_processing_enabled() const;
 
 	void set_draw_order(DrawOrder p_order);
 	DrawOrder get_draw_order() const;
@@ -207,6 +207,23 @@ void Skeleton3D::_get_property_list(List<PropertyInfo> *p_list) const {
 	}
 }
 
+// Stores p_global_pose * p_bind_pose in the row-major 3x4 layout used by RenderingServer skeletons,
+// without going through an intermediate Transform3D.
+static _FORCE_INLINE_ void _store_skin_transform(const Transform3D &p_global_pose, const Transform3D &p_bind_pose, float *r_data) {
+	const Basis &a = p_global_pose.basis;
+	const Basis &b = p_bind_pose.basis;
+	const Vector3 &o = p_bind_pose.origin;
+	for (int row = 0; row < 3; row++) {
+		const real_t a0 = a.rows[row][0];
+		const real_t a1 = a.rows[row][1];
+		const real_t a2 = a.rows[row][2];
+		r_data[row * 4 + 0] = a0 * b.rows[0][0] + a1 * b.rows[1][0] + a2 * b.rows[2][0];
+		r_data[row * 4 + 1] = a0 * b.rows[0][1] + a1 * b.rows[1][1] + a2 * b.rows[2][1];
+		r_data[row * 4 + 2] = a0 * b.rows[0][2] + a1 * b.rows[1][2] + a2 * b.rows[2][2];
+		r_data[row * 4 + 3] = a0 * o.x + a1 * o.y + a2 * o.z + p_global_pose.origin[row];
+	}
+}
+
 void Skeleton3D::_update_process_order() const {
 	if (!process_order_dirty) {
 		return;
@@ -358,6 +375,7 @@ void Skeleton3D::_notification(int p_what) {
 					E->bind_count = bind_count;
 					E->skin_bone_indices.resize(bind_count);
 					E->skin_bone_indices_ptrs = E->skin_bone_indices.ptrw();
+					E->skin_transforms.resize_initialized(bind_count * 12);
 				}
 
 				if (E->skeleton_version != version) {
@@ -396,11 +414,19 @@ void Skeleton3D::_notification(int p_what) {
 					E->skeleton_version = version;
 				}
 
+				if (bind_count == 0) {
+					continue;
+				}
+
+				// Only the upload is batched. Global poses were resolved one bone at a time in parent-first
+				// order by force_update_all_dirty_bones() above, not level by level over the hierarchy.
+				float *transforms = E->skin_transforms.ptrw();
 				for (uint32_t i = 0; i < bind_count; i++) {
 					uint32_t bone_index = E->skin_bone_indices_ptrs[i];
 					ERR_CONTINUE(bone_index >= (uint32_t)len);
-					rs->skeleton_bone_set_transform(skeleton, i, bonesptr[bone_index].global_pose * skin->get_bind_pose(i));
+					_store_skin_transform(bonesptr[bone_index].global_pose, skin->get_bind_pose(i), transforms + i * 12);
 				}
+				rs->skeleton_set_transforms(skeleton, E->skin_transforms);
 			}
 
 			if (!modifiers.is_empty()) {
@@ -49,6 +49,8 @@ class SkinReference : public RefCounted {
 	uint64_t skeleton_version = 0;
 	Vector<uint32_t> skin_bone_indices;
 	uint32_t *skin_bone_indices_ptrs = nullptr;
+	// Skinning matrices in the RenderingServer skeleton layout, uploaded at once.
+	Vector<float> skin_transforms;
 
 protected:
 	static void _bind_methods();
@@ -33,6 +33,7 @@
 
 #include "core/config/engine.h"
 #include "core/config/project_settings.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/string/string_name.h"
 #include "scene/2d/audio_stream_player_2d.h"
 #include "scene/animation/animation_player.h"
@@ -538,6 +539,15 @@ AnimationMixer::AnimationCallbackModeDiscrete AnimationMixer::get_callback_mode_
 	return callback_mode_discrete;
 }
 
+void AnimationMixer::set_parallel_blending_enabled(bool p_enabled) {
+	parallel_blending = p_enabled;
+	_update_parallel_blending_element();
+}
+
+bool AnimationMixer::is_parallel_blending_enabled() const {
+	return parallel_blending;
+}
+
 void AnimationMixer::set_audio_max_polyphony(int p_audio_max_polyphony) {
 	ERR_FAIL_COND(p_audio_max_polyphony < 0 || p_audio_max_polyphony > 128);
 	audio_max_polyphony = p_audio_max_polyphony;
@@ -2018,6 +2028,176 @@ void AnimationMixer::_blend_apply() {
 	}
 }
 
+/* -------------------------------------------- */
+/* -- Parallel blending ----------------------- */
+/* -------------------------------------------- */
+
+SelfList<AnimationMixer>::List AnimationMixer::parallel_blending_mixers;
+uint64_t AnimationMixer::parallel_blending_last_frame[2] = { UINT64_MAX, UINT64_MAX };
+
+void AnimationMixer::_update_parallel_blending_element() {
+	bool enabled = parallel_blending && is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
+	if (enabled == parallel_blending_element.in_list()) {
+		return;
+	}
+	if (enabled) {
+		parallel_blending_mixers.add(&parallel_blending_element);
+	} else {
+		parallel_blending_mixers.remove(&parallel_blending_element);
+	}
+}
+
+bool AnimationMixer::_can_blend_in_parallel() const {
+	// Method, audio and animation playback tracks and discrete value tracks act on other objects while blending,
+	// and overridden key post processing runs script code, these must stay on the main thread.
+	if (GDVIRTUAL_IS_OVERRIDDEN(_post_process_key_value)) {
+		return false;
+	}
+	bool force_continuous = callback_mode_discrete == ANIMATION_CALLBACK_MODE_DISCRETE_FORCE_CONTINUOUS;
+	for (const AnimationInstance &ai : animation_instances) {
+		const Ref<Animation> &a = ai.animation_data.animation;
+		const LocalVector<Animation::Track *> &tracks = a->get_tracks();
+		for (uint32_t i = 0; i < tracks.size(); i++) {
+			const Animation::Track *animation_track = tracks[i];
+			if (!animation_track->enabled) {
+				continue;
+			}
+			switch (animation_track->type) {
+				case Animation::TYPE_METHOD:
+				case Animation::TYPE_AUDIO:
+				case Animation::TYPE_ANIMATION: {
+					return false;
+				}
+				case Animation::TYPE_VALUE: {
+					if (!force_continuous && a->value_track_get_update_mode(i) == Animation::UPDATE_DISCRETE) {
+						return false;
+					}
+				} break;
+				default: {
+				} break;
+			}
+		}
+	}
+	return true;
+}
+
+void AnimationMixer::_blend_parallel_task(void *p_userdata, uint32_t p_index) {
+	ParallelBlend &blend = static_cast<ParallelBlend *>(p_userdata)[p_index];
+	blend.mixer->_blend_calc_total_weight();
+	blend.mixer->_blend_process(blend.delta);
+}
+
+void AnimationMixer::_process_parallel_blending(SceneTree *p_tree, bool p_physics) {
+	uint64_t frame = p_physics ? Engine::get_singleton()->get_physics_frames() : Engine::get_singleton()->get_process_frames();
+	AnimationCallbackModeProcess mode = p_physics ? ANIMATION_CALLBACK_MODE_PROCESS_PHYSICS : ANIMATION_CALLBACK_MODE_PROCESS_IDLE;
+	if (parallel_blending_last_frame[p_physics] == frame) {
+		return;
+	}
+	parallel_blending_last_frame[p_physics] = frame;
+
+	// Mixers may be freed by scripts called while advancing or applying others, so keep track of them by ID.
+	LocalVector<ObjectID> mixer_ids;
+	for (SelfList<AnimationMixer> *E = parallel_blending_mixers.first(); E; E = E->next()) {
+		AnimationMixer *mixer = E->self();
+		if (mixer->parallel_blending_frame != frame && mixer->get_tree() == p_tree && mixer->callback_mode_process == mode) {
+			mixer_ids.push_back(mixer->get_instance_id());
+		}
+	}
+
+	LocalVector<ParallelBlend> blends;
+	LocalVector<ParallelBlend> serial_blends;
+	for (const ObjectID &id : mixer_ids) {
+		AnimationMixer *mixer = ObjectDB::get_instance<AnimationMixer>(id);
+		if (!mixer || !mixer->parallel_blending_element.in_list() || mixer->parallel_blending_frame == frame) {
+			continue;
+		}
+		bool processing_enabled = p_physics ? mixer->is_physics_processing_internal() : mixer->is_processing_internal();
+		if (!mixer->active || !processing_enabled || !mixer->can_process() || !mixer->is_accessible_from_caller_thread()) {
+			continue;
+		}
+		mixer->parallel_blending_frame = frame;
+
+		double delta = p_physics ? mixer->get_physics_process_delta_time() : mixer->get_process_delta_time();
+		mixer->_blend_init();
+		if (!mixer->cache_valid || !mixer->_blend_pre_process(delta, mixer->track_count, mixer->track_map)) {
+			mixer->clear_animation_instances();
+			continue;
+		}
+		mixer->_blend_capture(delta);
+
+		ParallelBlend blend;
+		blend.mixer_id = id;
+		blend.delta = delta;
+		blend.call_post_process_virtual = mixer->is_GDVIRTUAL_CALL_post_process_key_value;
+
+		// These call into other objects or scripts while blending, so run them after the parallel set has been applied.
+		if (!mixer->_can_blend_in_parallel()) {
+			serial_blends.push_back(blend);
+			continue;
+		}
+
+		// Not overridden, so skip looking up the script method from the worker threads.
+		mixer->is_GDVIRTUAL_CALL_post_process_key_value = false;
+		blends.push_back(blend);
+	}
+
+	// Preparing later mixers may have run script code,
+	// so resolve the pointers only now and drop mixers that were freed or lost their caches.
+	uint32_t valid_count = 0;
+	for (uint32_t i = 0; i < blends.size(); i++) {
+		AnimationMixer *mixer = ObjectDB::get_instance<AnimationMixer>(blends[i].mixer_id);
+		if (!mixer) {
+			continue;
+		}
+		if (!mixer->cache_valid) {
+			mixer->is_GDVIRTUAL_CALL_post_process_key_value = blends[i].call_post_process_virtual;
+			mixer->clear_animation_instances();
+			continue;
+		}
+		blends[i].mixer = mixer;
+		blends[valid_count++] = blends[i];
+	}
+	blends.resize(valid_count);
+
+	// Worker threads only touch the mixers' own caches and instances, no script code runs until the results are applied.
+	if (blends.size() > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&AnimationMixer::_blend_parallel_task, blends.ptr(), blends.size(), -1, true, SNAME("AnimationMixerBlend"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else if (blends.size() == 1) {
+		_blend_parallel_task(blends.ptr(), 0);
+	}
+
+	// Applying may run script code that frees other mixers, so look each one up again.
+	for (const ParallelBlend &blend : blends) {
+		AnimationMixer *mixer = ObjectDB::get_instance<AnimationMixer>(blend.mixer_id);
+		if (!mixer) {
+			continue;
+		}
+		mixer->is_GDVIRTUAL_CALL_post_process_key_value = blend.call_post_process_virtual;
+		mixer->_blend_apply();
+		mixer->_blend_post_process();
+		mixer->emit_signal(SNAME("mixer_applied"));
+		mixer->clear_animation_instances();
+	}
+
+	for (const ParallelBlend &blend : serial_blends) {
+		AnimationMixer *mixer = ObjectDB::get_instance<AnimationMixer>(blend.mixer_id);
+		if (!mixer) {
+			continue;
+		}
+		if (!mixer->cache_valid) {
+			mixer->clear_animation_instances();
+			continue;
+		}
+		mixer->_blend_calc_total_weight();
+		mixer->_blend_process(blend.delta);
+		mixer->_blend_apply();
+		mixer->_blend_post_process();
+		mixer->emit_signal(SNAME("mixer_applied"));
+		mixer->clear_animation_instances();
+	}
+}
+
 void AnimationMixer::_call_object(ObjectID p_object_id, const StringName &p_method, const Vector<Variant> &p_params, bool p_deferred) {
 	// Separate function to use alloca() more efficiently
 	const Variant **argptrs = (const Variant **)alloca(sizeof(Variant *) * p_params.size());
@@ -2350,22 +2530,42 @@ void AnimationMixer::_notification(int p_what) {
 				set_process_internal(false);
 			}
 			_clear_caches();
+			_update_parallel_blending_element();
 		} break;
 
 		case NOTIFICATION_INTERNAL_PROCESS: {
 			if (active && callback_mode_process == ANIMATION_CALLBACK_MODE_PROCESS_IDLE) {
-				_process_animation(get_process_delta_time());
+				if (parallel_blending_element.in_list() && Thread::is_main_thread()) {
+					_process_parallel_blending(get_tree(), false);
+					if (parallel_blending_frame != Engine::get_singleton()->get_process_frames()) {
+						// Joined after the mixers of this frame were processed together.
+						parallel_blending_frame = Engine::get_singleton()->get_process_frames();
+						_process_animation(get_process_delta_time());
+					}
+				} else {
+					_process_animation(get_process_delta_time());
+				}
 			}
 		} break;
 
 		case NOTIFICATION_INTERNAL_PHYSICS_PROCESS: {
 			if (active && callback_mode_process == ANIMATION_CALLBACK_MODE_PROCESS_PHYSICS) {
-				_process_animation(get_physics_process_delta_time());
+				if (parallel_blending_element.in_list() && Thread::is_main_thread()) {
+					_process_parallel_blending(get_tree(), true);
+					if (parallel_blending_frame != Engine::get_singleton()->get_physics_frames()) {
+						// Joined after the mixers of this frame were processed together.
+						parallel_blending_frame = Engine::get_singleton()->get_physics_frames();
+						_process_animation(get_physics_process_delta_time());
+					}
+				} else {
+					_process_animation(get_physics_process_delta_time());
+				}
 			}
 		} break;
 
 		case NOTIFICATION_EXIT_TREE: {
 			_clear_caches();
+			_update_parallel_blending_element();
 		} break;
 	}
 }
@@ -2424,6 +2624,9 @@ void AnimationMixer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_callback_mode_discrete", "mode"), &AnimationMixer::set_callback_mode_discrete);
 	ClassDB::bind_method(D_METHOD("get_callback_mode_discrete"), &AnimationMixer::get_callback_mode_discrete);
 
+	ClassDB::bind_method(D_METHOD("set_parallel_blending_enabled", "enabled"), &AnimationMixer::set_parallel_blending_enabled);
+	ClassDB::bind_method(D_METHOD("is_parallel_blending_enabled"), &AnimationMixer::is_parallel_blending_enabled);
+
 	/* ---- Audio ---- */
 	ClassDB::bind_method(D_METHOD("set_audio_max_polyphony", "max_polyphony"), &AnimationMixer::set_audio_max_polyphony);
 	ClassDB::bind_method(D_METHOD("get_audio_max_polyphony"), &AnimationMixer::get_audio_max_polyphony);
@@ -2455,6 +2658,7 @@ void AnimationMixer::_bind_methods() {
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "active"), "set_active", "is_active");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "deterministic"), "set_deterministic", "is_deterministic");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "parallel_blending"), "set_parallel_blending_enabled", "is_parallel_blending_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "reset_on_save", PROPERTY_HINT_NONE, ""), "set_reset_on_save_enabled", "is_reset_on_save_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "root_node"), "set_root_node", "get_root_node");
 
@@ -2493,7 +2697,8 @@ void AnimationMixer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("_restore", "backup"), &AnimationMixer::restore);
 }
 
-AnimationMixer::AnimationMixer() {
+AnimationMixer::AnimationMixer() :
+		parallel_blending_element(this) {
 	root_node = SceneStringName(path_pp);
 }
 
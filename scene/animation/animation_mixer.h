@@ -31,6 +31,7 @@
 #pragma once
 
 #include "core/templates/a_hash_map.h"
+#include "core/templates/self_list.h"
 #include "scene/animation/tween.h"
 #include "scene/main/node.h"
 #include "scene/resources/animation.h"
@@ -372,6 +373,29 @@ protected:
 	virtual void _blend_post_process();
 	void _call_object(ObjectID p_object_id, const StringName &p_method, const Vector<Variant> &p_params, bool p_deferred);
 
+	/* ---- Parallel blending ---- */
+	// Mixers with parallel blending enabled are processed together when the first of them is processed in a frame.
+	// Playback advancing and applying the results happen on the main thread, sampling and blending the tracks
+	// of the mixers happens on the WorkerThreadPool.
+	struct ParallelBlend {
+		AnimationMixer *mixer = nullptr;
+		ObjectID mixer_id;
+		double delta = 0.0;
+		bool call_post_process_virtual = false;
+	};
+
+	static SelfList<AnimationMixer>::List parallel_blending_mixers;
+	// Last process and physics frame the mixers were processed together, so only the first mixer walks the list.
+	static uint64_t parallel_blending_last_frame[2];
+	SelfList<AnimationMixer> parallel_blending_element;
+	bool parallel_blending = false;
+	uint64_t parallel_blending_frame = UINT64_MAX;
+
+	void _update_parallel_blending_element();
+	bool _can_blend_in_parallel() const;
+	static void _process_parallel_blending(SceneTree *p_tree, bool p_physics);
+	static void _blend_parallel_task(void *p_userdata, uint32_t p_index);
+
 	/* ---- Capture feature ---- */
 	struct CaptureCache {
 		Ref<Animation> animation;
@@ -434,6 +458,9 @@ public:
 	void set_callback_mode_discrete(AnimationCallbackModeDiscrete p_mode);
 	AnimationCallbackModeDiscrete get_callback_mode_discrete() const;
 
+	void set_parallel_blending_enabled(bool p_enabled);
+	bool is_parallel_blending_enabled() const;
+
 	/* ---- Audio ---- */
 	void set_audio_max_polyphony(int p_audio_max_polyphony);
 	int get_audio_max_polyphony() const;
@@ -347,6 +347,97 @@ void SceneTree::_update_group_order(Group &g) {
 	g.changed = false;
 }
 
+void SceneTree::_group_dispatch_node(Node *p_node, const GroupDispatch &p_dispatch, GroupMethodCache &r_cache) {
+	if (p_dispatch.notification >= 0) {
+		p_node->notification(p_dispatch.notification, p_dispatch.reverse);
+		return;
+	}
+
+	Callable::CallError ce;
+	if (p_node->get_script_instance() || p_dispatch.function == CoreStringName(free_)) {
+		p_node->callp(p_dispatch.function, p_dispatch.args, p_dispatch.argcount, ce);
+	} else {
+		// Same as Object::callp() without a script, but the method is only looked up when the class changes.
+		const StringName &class_name = p_node->get_class_name();
+		if (class_name != r_cache.class_name) {
+			r_cache.class_name = class_name;
+			r_cache.method = ClassDB::get_method(class_name, p_dispatch.function);
+		}
+		if (r_cache.method) {
+#ifdef DEBUG_ENABLED
+			_ObjectDebugLock debug_lock(p_node);
+#endif
+			r_cache.method->call(p_node, p_dispatch.args, p_dispatch.argcount, ce);
+		} else {
+			ce.error = Callable::CallError::CALL_ERROR_INVALID_METHOD;
+		}
+	}
+	if (unlikely(ce.error != Callable::CallError::CALL_OK && ce.error != Callable::CallError::CALL_ERROR_INVALID_METHOD)) {
+		ERR_PRINT(vformat("Error calling group method on node \"%s\": %s.", p_node->get_name(), Variant::get_callable_error_text(Callable(p_node, p_dispatch.function), p_dispatch.args, p_dispatch.argcount, ce)));
+	}
+}
+
+void SceneTree::_group_dispatch(Node **p_nodes, int p_node_count, bool p_threaded, GroupDispatch &p_dispatch) {
+	// Threaded dispatch is only possible from the main thread outside of group processing,
+	// otherwise the nodes of other process groups can't be accessed.
+	bool use_threads = p_threaded && !node_threading_disabled && Thread::is_main_thread() && !Node::is_group_processing();
+
+	// Nodes in a sub-thread process group are collected per group and dispatched after the rest,
+	// keeping the order within each group.
+	HashMap<ProcessGroup *, uint32_t> batch_indices;
+	GroupMethodCache cache;
+
+	for (int j = 0; j < p_node_count; j++) {
+		Node *node = p_nodes[p_dispatch.reverse ? p_node_count - 1 - j : j];
+		if (nodes_removed_on_group_call_lock && nodes_removed_on_group_call.has(node)) {
+			continue;
+		}
+
+		if (use_threads) {
+			ProcessGroup *pg = (ProcessGroup *)node->data.process_group;
+			if (pg && pg->owner && pg->owner->data.process_thread_group == Node::PROCESS_THREAD_GROUP_SUB_THREAD) {
+				uint32_t *index = batch_indices.getptr(pg);
+				if (!index) {
+					index = &batch_indices.insert(pg, p_dispatch.batches.size())->value;
+					p_dispatch.batches.push_back(GroupDispatch::Batch());
+					p_dispatch.batches[*index].owner = pg->owner;
+				}
+				p_dispatch.batches[*index].nodes.push_back(node);
+				continue;
+			}
+		}
+
+		_group_dispatch_node(node, p_dispatch, cache);
+	}
+
+	if (p_dispatch.batches.is_empty()) {
+		return;
+	}
+
+	if (p_dispatch.batches.size() == 1) {
+		_group_dispatch_thread(0, &p_dispatch);
+		return;
+	}
+
+	WorkerThreadPool::GroupID id = WorkerThreadPool::get_singleton()->add_template_group_task(this, &SceneTree::_group_dispatch_thread, &p_dispatch, p_dispatch.batches.size(), -1, true, SNAME("SceneTreeGroupCall"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(id);
+}
+
+void SceneTree::_group_dispatch_thread(uint32_t p_index, GroupDispatch *p_dispatch) {
+	const GroupDispatch::Batch &batch = p_dispatch->batches[p_index];
+	GroupMethodCache cache;
+
+	Node::current_process_thread_group = batch.owner;
+	for (Node *node : batch.nodes) {
+		// Nodes can only be removed on the main thread, which is waiting here.
+		if (nodes_removed_on_group_call.has(node)) {
+			continue;
+		}
+		_group_dispatch_node(node, *p_dispatch, cache);
+	}
+	Node::current_process_thread_group = nullptr;
+}
+
 void SceneTree::call_group_flagsp(uint32_t p_call_flags, const StringName &p_group, const StringName &p_function, const Variant **p_args, int p_argcount) {
 	Vector<Node *> nodes_copy;
 
@@ -394,22 +485,21 @@ void SceneTree::call_group_flagsp(uint32_t p_call_flags, const StringName &p_gro
 		nodes_removed_on_group_call_lock++;
 	}
 
-	if (p_call_flags & GROUP_CALL_REVERSE) {
+	if (!(p_call_flags & GROUP_CALL_DEFERRED)) {
+		GroupDispatch dispatch;
+		dispatch.function = p_function;
+		dispatch.args = p_args;
+		dispatch.argcount = p_argcount;
+		dispatch.reverse = p_call_flags & GROUP_CALL_REVERSE;
+		_group_dispatch(gr_nodes, gr_node_count, p_call_flags & GROUP_CALL_THREADED, dispatch);
+
+	} else if (p_call_flags & GROUP_CALL_REVERSE) {
 		for (int i = gr_node_count - 1; i >= 0; i--) {
 			if (nodes_removed_on_group_call_lock && nodes_removed_on_group_call.has(gr_nodes[i])) {
 				continue;
 			}
 
-			Node *node = gr_nodes[i];
-			if (!(p_call_flags & GROUP_CALL_DEFERRED)) {
-				Callable::CallError ce;
-				node->callp(p_function, p_args, p_argcount, ce);
-				if (unlikely(ce.error != Callable::CallError::CALL_OK && ce.error != Callable::CallError::CALL_ERROR_INVALID_METHOD)) {
-					ERR_PRINT(vformat("Error calling group method on node \"%s\": %s.", node->get_name(), Variant::get_callable_error_text(Callable(node, p_function), p_args, p_argcount, ce)));
-				}
-			} else {
-				MessageQueue::get_singleton()->push_callp(node, p_function, p_args, p_argcount);
-			}
+			MessageQueue::get_singleton()->push_callp(gr_nodes[i], p_function, p_args, p_argcount);
 		}
 
 	} else {
@@ -418,16 +508,7 @@ void SceneTree::call_group_flagsp(uint32_t p_call_flags, const StringName &p_gro
 				continue;
 			}
 
-			Node *node = gr_nodes[i];
-			if (!(p_call_flags & GROUP_CALL_DEFERRED)) {
-				Callable::CallError ce;
-				node->callp(p_function, p_args, p_argcount, ce);
-				if (unlikely(ce.error != Callable::CallError::CALL_OK && ce.error != Callable::CallError::CALL_ERROR_INVALID_METHOD)) {
-					ERR_PRINT(vformat("Error calling group method on node \"%s\": %s.", node->get_name(), Variant::get_callable_error_text(Callable(node, p_function), p_args, p_argcount, ce)));
-				}
-			} else {
-				MessageQueue::get_singleton()->push_callp(node, p_function, p_args, p_argcount);
-			}
+			MessageQueue::get_singleton()->push_callp(gr_nodes[i], p_function, p_args, p_argcount);
 		}
 	}
 
@@ -466,17 +547,19 @@ void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_gr
 		nodes_removed_on_group_call_lock++;
 	}
 
-	if (p_call_flags & GROUP_CALL_REVERSE) {
+	if (!(p_call_flags & GROUP_CALL_DEFERRED)) {
+		GroupDispatch dispatch;
+		dispatch.notification = p_notification;
+		dispatch.reverse = p_call_flags & GROUP_CALL_REVERSE;
+		_group_dispatch(gr_nodes, gr_node_count, p_call_flags & GROUP_CALL_THREADED, dispatch);
+
+	} else if (p_call_flags & GROUP_CALL_REVERSE) {
 		for (int i = gr_node_count - 1; i >= 0; i--) {
 			if (nodes_removed_on_group_call.has(gr_nodes[i])) {
 				continue;
 			}
 
-			if (!(p_call_flags & GROUP_CALL_DEFERRED)) {
-				gr_nodes[i]->notification(p_notification, true);
-			} else {
-				MessageQueue::get_singleton()->push_notification(gr_nodes[i], p_notification);
-			}
+			MessageQueue::get_singleton()->push_notification(gr_nodes[i], p_notification);
 		}
 
 	} else {
@@ -485,11 +568,7 @@ void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_gr
 				continue;
 			}
 
-			if (!(p_call_flags & GROUP_CALL_DEFERRED)) {
-				gr_nodes[i]->notification(p_notification);
-			} else {
-				MessageQueue::get_singleton()->push_notification(gr_nodes[i], p_notification);
-			}
+			MessageQueue::get_singleton()->push_notification(gr_nodes[i], p_notification);
 		}
 	}
 
@@ -1966,6 +2045,7 @@ void SceneTree::_bind_methods() {
 	BIND_ENUM_CONSTANT(GROUP_CALL_REVERSE);
 	BIND_ENUM_CONSTANT(GROUP_CALL_DEFERRED);
 	BIND_ENUM_CONSTANT(GROUP_CALL_UNIQUE);
+	BIND_ENUM_CONSTANT(GROUP_CALL_THREADED);
 }
 
 SceneTree *SceneTree::singleton = nullptr;
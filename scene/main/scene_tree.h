@@ -124,6 +124,27 @@ private:
 		bool changed = false;
 	};
 
+	// Immediate group call or notification, shared by the serial and threaded dispatch.
+	struct GroupDispatch {
+		StringName function;
+		const Variant **args = nullptr;
+		int argcount = 0;
+		int notification = -1; // When set, notify instead of calling function.
+		bool reverse = false;
+
+		struct Batch {
+			Node *owner = nullptr;
+			LocalVector<Node *> nodes;
+		};
+		LocalVector<Batch> batches;
+	};
+
+	// Method resolved for the last class seen, consecutive group members are usually of the same class.
+	struct GroupMethodCache {
+		StringName class_name;
+		MethodBind *method = nullptr;
+	};
+
 #ifndef _3D_DISABLED
 	struct ClientPhysicsInterpolation {
 		SelfList<Node3D>::List _node_3d_list;
@@ -240,6 +261,10 @@ private:
 
 	void _process_group(ProcessGroup *p_group, bool p_physics);
 	void _process_groups_thread(uint32_t p_index, bool p_physics);
+
+	void _group_dispatch_node(Node *p_node, const GroupDispatch &p_dispatch, GroupMethodCache &r_cache);
+	void _group_dispatch(Node **p_nodes, int p_node_count, bool p_threaded, GroupDispatch &p_dispatch);
+	void _group_dispatch_thread(uint32_t p_index, GroupDispatch *p_dispatch);
 	void _process(bool p_physics);
 
 	void _remove_process_group(Node *p_node);
@@ -298,6 +323,7 @@ public:
 		GROUP_CALL_REVERSE = 1,
 		GROUP_CALL_DEFERRED = 2,
 		GROUP_CALL_UNIQUE = 4,
+		GROUP_CALL_THREADED = 8,
 	};
 
 	_FORCE_INLINE_ Window *get_root() const { return root; }
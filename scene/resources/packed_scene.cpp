@@ -41,6 +41,7 @@
 #include "scene/gui/control.h"
 #include "scene/main/instance_placeholder.h"
 #include "scene/main/missing_node.h"
+#include "scene/main/scene_tree.h"
 #include "scene/property_utils.h"
 
 #ifndef _3D_DISABLED
@@ -150,7 +151,49 @@ static Node *_find_node_by_id(Node *p_owner, Node *p_node, int32_t p_id) {
 	return nullptr;
 }
 
+// Arrays and dictionaries in the packed data are shared between instances. Each instance gets a copy
+// typed like the property it is assigned to.
+static Array _copy_array_for_property(Node *p_node, const StringName &p_property, const Array &p_array) {
+	Array set_array = p_array;
+	bool is_get_valid = false;
+	Variant get_value = p_node->get(p_property, &is_get_valid);
+
+	if (is_get_valid && get_value.get_type() == Variant::ARRAY) {
+		Array get_array = get_value;
+		if (set_array.is_same_typed(get_array)) {
+			set_array = set_array.duplicate();
+		} else {
+			set_array = Array(set_array, get_array.get_typed_builtin(), get_array.get_typed_class_name(), get_array.get_typed_script());
+		}
+	}
+	return set_array;
+}
+
+static Dictionary _copy_dictionary_for_property(Node *p_node, const StringName &p_property, const Dictionary &p_dictionary) {
+	Dictionary set_dict = p_dictionary;
+	bool is_get_valid = false;
+	Variant get_value = p_node->get(p_property, &is_get_valid);
+
+	if (is_get_valid && get_value.get_type() == Variant::DICTIONARY) {
+		Dictionary get_dict = get_value;
+		if (set_dict.is_same_typed(get_dict)) {
+			set_dict = set_dict.duplicate();
+		} else {
+			set_dict = Dictionary(set_dict, get_dict.get_typed_key_builtin(), get_dict.get_typed_key_class_name(), get_dict.get_typed_key_script(), get_dict.get_typed_value_builtin(), get_dict.get_typed_value_class_name(), get_dict.get_typed_value_script());
+		}
+	}
+	return set_dict;
+}
+
 Node *SceneState::instantiate(GenEditState p_edit_state) const {
+	if (p_edit_state == GEN_EDIT_STATE_DISABLED && !Engine::get_singleton()->is_editor_hint() && !ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
+		const InstantiationPlan *plan = _get_instantiation_plan();
+		if (plan) {
+			Node **plan_nodes = (Node **)alloca(sizeof(Node *) * plan->nodes.size());
+			return _instantiate_from_plan(*plan, plan_nodes);
+		}
+	}
+
 	// Nodes where instantiation failed (because something is missing.)
 	List<Node *> stray_instances;
 
@@ -446,36 +489,12 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 						}
 
 						if (value.get_type() == Variant::ARRAY) {
-							Array set_array = value;
-							bool is_get_valid = false;
-							Variant get_value = node->get(snames[nprops[j].name], &is_get_valid);
-
-							if (is_get_valid && get_value.get_type() == Variant::ARRAY) {
-								Array get_array = get_value;
-								if (set_array.is_same_typed(get_array)) {
-									set_array = set_array.duplicate();
-								} else {
-									set_array = Array(set_array, get_array.get_typed_builtin(), get_array.get_typed_class_name(), get_array.get_typed_script());
-								}
-							}
-
+							Array set_array = _copy_array_for_property(node, snames[nprops[j].name], value);
 							value = setup_resources_in_array(set_array, n, resources_local_to_scenes, node, snames[nprops[j].name], i, ret_nodes, p_edit_state);
 						}
 
 						if (value.get_type() == Variant::DICTIONARY) {
-							Dictionary set_dict = value;
-							bool is_get_valid = false;
-							Variant get_value = node->get(snames[nprops[j].name], &is_get_valid);
-
-							if (is_get_valid && get_value.get_type() == Variant::DICTIONARY) {
-								Dictionary get_dict = get_value;
-								if (set_dict.is_same_typed(get_dict)) {
-									set_dict = set_dict.duplicate();
-								} else {
-									set_dict = Dictionary(set_dict, get_dict.get_typed_key_builtin(), get_dict.get_typed_key_class_name(), get_dict.get_typed_key_script(), get_dict.get_typed_value_builtin(), get_dict.get_typed_value_class_name(), get_dict.get_typed_value_script());
-								}
-							}
-
+							Dictionary set_dict = _copy_dictionary_for_property(node, snames[nprops[j].name], value);
 							value = setup_resources_in_dictionary(set_dict, n, resources_local_to_scenes, node, snames[nprops[j].name], i, ret_nodes, p_edit_state);
 						}
 
@@ -592,7 +611,73 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 		}
 	}
 
-	for (const DeferredNodePathProperties &dnp : deferred_node_paths) {
+	_set_deferred_node_paths(deferred_node_paths);
+
+	for (KeyValue<Node *, HashMap<Ref<Resource>, Ref<Resource>>> &E : resources_local_to_scenes) {
+		for (KeyValue<Ref<Resource>, Ref<Resource>> &R : E.value) {
+			R.value->setup_local_to_scene(); // Setup may be required for the resource to work properly.
+		}
+	}
+
+	//do connections
+
+	int cc = connections.size();
+	const ConnectionData *cdata = connections.ptr();
+
+	for (int i = 0; i < cc; i++) {
+		const ConnectionData &c = cdata[i];
+		//ERR_FAIL_INDEX_V( c.from, nc, nullptr );
+		//ERR_FAIL_INDEX_V( c.to, nc, nullptr );
+
+		NODE_FROM_ID(cfrom, c.from);
+		NODE_FROM_ID(cto, c.to);
+
+		if (!cfrom || !cto) {
+			continue;
+		}
+
+		Callable callable(cto, snames[c.method]);
+
+		Array binds;
+		if (c.flags & CONNECT_APPEND_SOURCE_OBJECT) {
+			binds.push_back(cfrom);
+		}
+
+		for (int bind : c.binds) {
+			binds.push_back(props[bind]);
+		}
+
+		if (!binds.is_empty()) {
+			callable = callable.bindv(binds);
+		}
+
+		if (c.unbinds > 0) {
+			callable = callable.unbind(c.unbinds);
+		}
+
+		cfrom->connect(snames[c.signal], callable, CONNECT_PERSIST | c.flags | (p_edit_state == GEN_EDIT_STATE_MAIN ? 0 : CONNECT_INHERITED));
+	}
+
+	//Node *s = ret_nodes[0];
+
+	//remove nodes that could not be added, likely as a result that
+	while (stray_instances.size()) {
+		memdelete(stray_instances.front()->get());
+		stray_instances.pop_front();
+	}
+
+	for (int i = 0; i < editable_instances.size(); i++) {
+		Node *ei = ret_nodes[0]->get_node_or_null(editable_instances[i]);
+		if (ei) {
+			ret_nodes[0]->set_editable_instance(ei, true);
+		}
+	}
+
+	return ret_nodes[0];
+}
+
+void SceneState::_set_deferred_node_paths(const LocalVector<DeferredNodePathProperties> &p_deferred_node_paths) {
+	for (const DeferredNodePathProperties &dnp : p_deferred_node_paths) {
 		// Replace properties stored as NodePaths with actual Nodes.
 		Node *base = ObjectDB::get_instance<Node>(dnp.base);
 		ERR_CONTINUE_EDMSG(!base, vformat("Failed to set deferred property '%s' as the base node disappeared.", dnp.property));
@@ -637,68 +722,520 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 			base->set(dnp.property, base->get_node_or_null(dnp.value));
 		}
 	}
+}
 
-	for (KeyValue<Node *, HashMap<Ref<Resource>, Ref<Resource>>> &E : resources_local_to_scenes) {
-		for (KeyValue<Ref<Resource>, Ref<Resource>> &R : E.value) {
-			R.value->setup_local_to_scene(); // Setup may be required for the resource to work properly.
+static bool _dictionary_has_local_resource(const Dictionary &p_dictionary) {
+	for (const KeyValue<Variant, Variant> &kv : p_dictionary) {
+		Ref<Resource> key = kv.key;
+		Ref<Resource> value = kv.value;
+		if ((key.is_valid() && key->is_local_to_scene()) || (value.is_valid() && value->is_local_to_scene())) {
+			return true;
 		}
 	}
+	return false;
+}
 
-	//do connections
+bool SceneState::_build_instantiation_plan(InstantiationPlan &r_plan) const {
+	const int nc = nodes.size();
+	if (nc == 0 || base_scene_idx >= 0 || !editable_instances.is_empty()) {
+		return false;
+	}
 
-	int cc = connections.size();
-	const ConnectionData *cdata = connections.ptr();
+	const int sname_count = names.size();
+	const int prop_count = variants.size();
 
-	for (int i = 0; i < cc; i++) {
-		const ConnectionData &c = cdata[i];
-		//ERR_FAIL_INDEX_V( c.from, nc, nullptr );
-		//ERR_FAIL_INDEX_V( c.to, nc, nullptr );
+	r_plan.nodes.resize(nc);
+	r_plan.poolable = true;
 
-		NODE_FROM_ID(cfrom, c.from);
-		NODE_FROM_ID(cto, c.to);
+	for (int i = 0; i < nc; i++) {
+		const NodeData &n = nodes[i];
+		InstantiationPlan::PlanNode &pn = r_plan.nodes[i];
 
-		if (!cfrom || !cto) {
-			continue;
+		// Parents and owners must be nodes created earlier by this scene, not paths into nested scenes.
+		if (i == 0 ? n.parent != -1 : (n.parent < 0 || (n.parent & FLAG_ID_IS_PATH) || n.parent >= i)) {
+			return false;
+		}
+		if (n.owner >= 0 && ((n.owner & FLAG_ID_IS_PATH) || n.owner >= i)) {
+			return false;
+		}
+		if (n.name < 0 || n.name >= sname_count) {
+			return false;
 		}
 
-		Callable callable(cto, snames[c.method]);
+		pn.parent = n.parent;
+		pn.owner = n.owner;
+		pn.index = n.index;
+		pn.name = names[n.name];
+		if (i < ids.size()) {
+			pn.unique_id = ids[i];
+			pn.has_unique_id = true;
+		}
+		if (i > 0) {
+			r_plan.nodes[n.parent].child_count++;
+		}
 
-		Array binds;
-		if (c.flags & CONNECT_APPEND_SOURCE_OBJECT) {
-			binds.push_back(cfrom);
+		if (n.instance >= 0) {
+			if ((n.instance & FLAG_INSTANCE_IS_PLACEHOLDER) || (n.instance & FLAG_MASK) >= prop_count) {
+				return false;
+			}
+			pn.instance = variants[n.instance & FLAG_MASK];
+			if (pn.instance.is_null()) {
+				return false;
+			}
+			r_plan.poolable = false;
+		} else {
+			if (n.type == TYPE_INSTANTIATED || n.type < 0 || n.type >= sname_count) {
+				return false;
+			}
+			pn.type = names[n.type];
+			// Classes that cannot be created fall back to placeholders in instantiate().
+			if (!ClassDB::can_instantiate(pn.type) || !ClassDB::is_parent_class(pn.type, SNAME("Node"))) {
+				return false;
+			}
+			pn.create = ClassDB::get_creation_func(pn.type);
 		}
 
+		bool has_script = false;
+		for (const NodeData::Property &prop : n.properties) {
+			const uint32_t name_idx = prop.name & FLAG_PROP_NAME_MASK;
+			if (name_idx >= (uint32_t)sname_count || prop.value < 0 || prop.value >= prop_count) {
+				return false;
+			}
+
+			InstantiationPlan::Property pp;
+			pp.name = names[name_idx];
+			pp.value = variants[prop.value];
+
+			if (prop.name & FLAG_PATH_PROPERTY_IS_NODE) {
+				pp.is_node_path = true;
+			} else if (pp.name == CoreStringName(script)) {
+				// Replacing the script of a nested scene has to carry over its state, see instantiate().
+				if (pn.instance.is_valid()) {
+					return false;
+				}
+#ifdef TOOLS_ENABLED
+				const Ref<Script> script = pp.value;
+				if (script.is_valid() && script->is_abstract()) {
+					return false;
+				}
+#endif
+				pp.is_script = true;
+				has_script = true;
+			} else if (pp.name == SNAME("metadata/_edit_pinned_properties_")) {
+				// Removed again right away when not instantiating for editing.
+				continue;
+			} else {
+				// Resources local to the scene are duplicated per instance.
+				switch (pp.value.get_type()) {
+					case Variant::OBJECT: {
+						const Ref<Resource> res = pp.value;
+						if (res.is_valid() && res->is_local_to_scene()) {
+							return false;
+						}
+					} break;
+					case Variant::ARRAY: {
+						if (has_local_resource(pp.value)) {
+							return false;
+						}
+						pp.is_container = true;
+					} break;
+					case Variant::DICTIONARY: {
+						if (_dictionary_has_local_resource(pp.value)) {
+							return false;
+						}
+						pp.is_container = true;
+					} break;
+					default:
+						break;
+				}
+			}
+			pn.properties.push_back(pp);
+		}
+
+		// Without a script or extension in between, Object::set() ends up calling the bound setter.
+		if (pn.create && !has_script) {
+			for (InstantiationPlan::Property &pp : pn.properties) {
+				if (!pp.is_node_path && !pp.is_script) {
+					pp.setter = ClassDB::get_property_setter_method(pn.type, pp.name, &pp.setter_index);
+				}
+			}
+		}
+
+		for (int group : n.groups) {
+			if (group < 0 || group >= sname_count) {
+				return false;
+			}
+			pn.groups.push_back(names[group]);
+		}
+	}
+
+	for (const ConnectionData &c : connections) {
+		if ((c.from & FLAG_ID_IS_PATH) || (c.to & FLAG_ID_IS_PATH) || c.from < 0 || c.from >= nc || c.to < 0 || c.to >= nc) {
+			return false;
+		}
+		if (c.signal < 0 || c.signal >= sname_count || c.method < 0 || c.method >= sname_count) {
+			return false;
+		}
+
+		InstantiationPlan::Connection pc;
+		pc.from = c.from;
+		pc.to = c.to;
+		pc.signal = names[c.signal];
+		pc.method = names[c.method];
+		pc.flags = CONNECT_PERSIST | c.flags | CONNECT_INHERITED;
+		pc.unbinds = c.unbinds;
 		for (int bind : c.binds) {
-			binds.push_back(props[bind]);
+			if (bind < 0 || bind >= prop_count) {
+				return false;
+			}
+			pc.binds.push_back(variants[bind]);
 		}
+		r_plan.connections.push_back(pc);
+	}
 
-		if (!binds.is_empty()) {
+	return true;
+}
+
+const SceneState::InstantiationPlan *SceneState::_get_instantiation_plan() const {
+	if (instantiation_plan_status.get() == PLAN_NOT_BUILT) {
+		MutexLock lock(instantiation_plan_mutex);
+		if (instantiation_plan_status.get() == PLAN_NOT_BUILT) {
+			if (_build_instantiation_plan(instantiation_plan)) {
+				instantiation_plan_status.set(PLAN_READY);
+			} else {
+				instantiation_plan.clear();
+				instantiation_plan_status.set(PLAN_UNSUPPORTED);
+			}
+		}
+	}
+	return instantiation_plan_status.get() == PLAN_READY ? &instantiation_plan : nullptr;
+}
+
+void SceneState::_clear_instantiation_plan() {
+	if (instantiation_plan_status.get() == PLAN_NOT_BUILT) {
+		return;
+	}
+	MutexLock lock(instantiation_plan_mutex);
+	instantiation_plan.clear();
+	instantiation_plan_status.set(PLAN_NOT_BUILT);
+}
+
+Node *SceneState::_instantiate_from_plan(const InstantiationPlan &p_plan, Node **r_nodes) const {
+	LocalVector<DeferredNodePathProperties> deferred_node_paths;
+
+	const uint32_t nc = p_plan.nodes.size();
+	for (uint32_t i = 0; i < nc; i++) {
+		const InstantiationPlan::PlanNode &pn = p_plan.nodes[i];
+
+		Node *node = nullptr;
+		if (pn.instance.is_valid()) {
+			node = pn.instance->instantiate(PackedScene::GEN_EDIT_STATE_DISABLED);
+		} else if (pn.create) {
+			node = static_cast<Node *>(pn.create(true));
+		} else {
+			node = Object::cast_to<Node>(ClassDB::instantiate(pn.type));
+		}
+		if (!node) {
+			if (i > 0) {
+				memdelete(r_nodes[0]);
+			}
+			ERR_FAIL_V_MSG(nullptr, vformat("Failed to instantiate node \"%s\" of scene \"%s\".", pn.name, path));
+		}
+
+		if (pn.has_unique_id) {
+			node->set_unique_scene_id(pn.unique_id);
+		}
+
+		for (const InstantiationPlan::Property &prop : pn.properties) {
+			if (prop.is_node_path) {
+				DeferredNodePathProperties dnp;
+				dnp.value = prop.value;
+				dnp.base = node->get_instance_id();
+				dnp.property = prop.name;
+				deferred_node_paths.push_back(dnp);
+				continue;
+			}
+			if (prop.is_script) {
+				node->set_script(prop.value);
+				continue;
+			}
+
+			Variant container;
+			const Variant *value = &prop.value;
+			if (prop.is_container) {
+				if (prop.value.get_type() == Variant::ARRAY) {
+					container = _copy_array_for_property(node, prop.name, prop.value);
+				} else {
+					container = _copy_dictionary_for_property(node, prop.name, prop.value);
+				}
+				value = &container;
+			}
+
+			if (prop.setter) {
+				Callable::CallError ce;
+				if (prop.setter_index >= 0) {
+					const Variant index = prop.setter_index;
+					const Variant *args[2] = { &index, value };
+					prop.setter->call(node, args, 2, ce);
+				} else {
+					const Variant *args[1] = { value };
+					prop.setter->call(node, args, 1, ce);
+				}
+			} else {
+				node->set(prop.name, *value);
+			}
+		}
+
+		for (const StringName &group : pn.groups) {
+			node->add_to_group(group, true);
+		}
+
+		if (i > 0) {
+			Node *parent = r_nodes[pn.parent];
+			parent->_add_child_nocheck(node, pn.name);
+			if (pn.index >= 0 && pn.index < parent->get_child_count() - 1) {
+				parent->move_child(node, pn.index);
+			}
+		} else {
+			node->_set_name_nocheck(pn.name);
+		}
+
+		if (pn.owner >= 0) {
+			node->_set_owner_nocheck(r_nodes[pn.owner]);
+			if (node->data.unique_name_in_owner) {
+				node->_acquire_unique_name_in_owner();
+			}
+		}
+
+		r_nodes[i] = node;
+	}
+
+	_set_deferred_node_paths(deferred_node_paths);
+
+	for (const InstantiationPlan::Connection &c : p_plan.connections) {
+		Node *cfrom = r_nodes[c.from];
+		Callable callable(r_nodes[c.to], c.method);
+
+		if (c.flags & CONNECT_APPEND_SOURCE_OBJECT) {
+			Array binds;
+			binds.push_back(cfrom);
+			binds.append_array(c.binds);
 			callable = callable.bindv(binds);
+		} else if (!c.binds.is_empty()) {
+			callable = callable.bindv(c.binds);
 		}
 
 		if (c.unbinds > 0) {
 			callable = callable.unbind(c.unbinds);
 		}
 
-		cfrom->connect(snames[c.signal], callable, CONNECT_PERSIST | c.flags | (p_edit_state == GEN_EDIT_STATE_MAIN ? 0 : CONNECT_INHERITED));
+		cfrom->connect(c.signal, callable, c.flags);
 	}
 
-	//Node *s = ret_nodes[0];
+	return r_nodes[0];
+}
 
-	//remove nodes that could not be added, likely as a result that
-	while (stray_instances.size()) {
-		memdelete(stray_instances.front()->get());
-		stray_instances.pop_front();
+static bool _is_reset_reference(const Variant &p_value, bool p_any_object) {
+	Object *object = p_value.get_validated_object();
+	return p_any_object ? object != nullptr : Object::cast_to<Node>(object) != nullptr;
+}
+
+static bool _container_has_references(const Variant &p_value, bool p_any_object) {
+	if (p_value.get_type() == Variant::ARRAY) {
+		const Array array = p_value;
+		for (const Variant &E : array) {
+			if (_is_reset_reference(E, p_any_object)) {
+				return true;
+			}
+		}
+	} else if (p_value.get_type() == Variant::DICTIONARY) {
+		const Dictionary dict = p_value;
+		for (const KeyValue<Variant, Variant> &kv : dict) {
+			if (_is_reset_reference(kv.key, p_any_object) || _is_reset_reference(kv.value, p_any_object)) {
+				return true;
+			}
+		}
 	}
+	return false;
+}
 
-	for (int i = 0; i < editable_instances.size(); i++) {
-		Node *ei = ret_nodes[0]->get_node_or_null(editable_instances[i]);
-		if (ei) {
-			ret_nodes[0]->set_editable_instance(ei, true);
+bool SceneState::_build_reset_properties(InstantiationPlan &r_plan) const {
+	// Record the state of a fresh instance, references to its own nodes are kept as indices.
+	const uint32_t nc = r_plan.nodes.size();
+	Node **prototype_nodes = (Node **)alloca(sizeof(Node *) * nc);
+	Node *prototype = _instantiate_from_plan(r_plan, prototype_nodes);
+	ERR_FAIL_NULL_V(prototype, false);
+
+	HashMap<Node *, int> node_indices;
+	for (uint32_t i = 0; i < nc; i++) {
+		node_indices.insert(prototype_nodes[i], i);
+	}
+
+	r_plan.reset_properties.resize(nc);
+	for (uint32_t i = 0; i < nc; i++) {
+		List<PropertyInfo> property_list;
+		prototype_nodes[i]->get_property_list(&property_list);
+
+		for (const PropertyInfo &pi : property_list) {
+			if (!(pi.usage & (PROPERTY_USAGE_STORAGE | PROPERTY_USAGE_SCRIPT_VARIABLE)) || pi.name == CoreStringName(script)) {
+				continue;
+			}
+
+			InstantiationPlan::ResetProperty rp;
+			rp.name = pi.name;
+			rp.value = prototype_nodes[i]->get(pi.name);
+
+			// Objects created by script initializers belong to the prototype, sharing them between instances
+			// would leak state from one instance to the next, so those variables are left as they are.
+			const bool script_variable = pi.usage & PROPERTY_USAGE_SCRIPT_VARIABLE;
+			if (rp.value.get_type() == Variant::OBJECT) {
+				Node *reference = Object::cast_to<Node>(rp.value.get_validated_object());
+				if (reference) {
+					const int *index = node_indices.getptr(reference);
+					if (!index) {
+						continue;
+					}
+					rp.node_ref = *index;
+					rp.value = Variant();
+				} else if (script_variable && rp.value.get_validated_object()) {
+					continue;
+				}
+			} else if (_container_has_references(rp.value, script_variable)) {
+				continue;
+			}
+			r_plan.reset_properties[i].push_back(rp);
 		}
 	}
 
-	return ret_nodes[0];
+	memdelete(prototype);
+	return true;
+}
+
+// Connections made at runtime, usually from _ready(), would be made twice once a recycled instance is ready again.
+// Engine code connects through method pointers, those belong to how the nodes work and are kept.
+static bool _is_runtime_connection(const Object::Connection &p_connection) {
+	if (p_connection.flags & Object::CONNECT_PERSIST) {
+		return false;
+	}
+	const Callable *base = p_connection.callable.get_base_comparator();
+	return !base->is_custom() || !dynamic_cast<CallableCustomMethodPointerBase *>(base->get_custom());
+}
+
+static void _disconnect_runtime_connections(Node *p_node) {
+	List<Object::Connection> connections;
+	p_node->get_all_signal_connections(&connections);
+	p_node->get_signals_connected_to_this(&connections);
+	for (const Object::Connection &c : connections) {
+		if (!_is_runtime_connection(c)) {
+			continue;
+		}
+		// Connections between nodes of the instance show up on both ends.
+		Object *source = c.signal.get_object();
+		if (source && source->is_connected(c.signal.get_name(), c.callable)) {
+			source->disconnect(c.signal.get_name(), c.callable);
+		}
+	}
+}
+
+// Finds the nodes of an instance in plan order. Fails if they don't have the names, classes, owners and
+// child counts of the packed scene.
+bool SceneState::_match_instance_nodes(const InstantiationPlan &p_plan, Node *p_root, Node **r_nodes) {
+	for (uint32_t i = 0; i < p_plan.nodes.size(); i++) {
+		const InstantiationPlan::PlanNode &pn = p_plan.nodes[i];
+		Node *node = i == 0 ? p_root : r_nodes[pn.parent]->_get_child_by_name(pn.name);
+		if (!node) {
+			return false;
+		}
+		// Nested scenes bring children of their own.
+		if (pn.instance.is_null() && (node->get_class_name() != pn.type || node->get_child_count(false) != pn.child_count)) {
+			return false;
+		}
+		if (pn.owner >= 0 && node->get_owner() != r_nodes[pn.owner]) {
+			return false;
+		}
+		r_nodes[i] = node;
+	}
+	return true;
+}
+
+bool SceneState::matches_instance(Node *p_root) const {
+	ERR_FAIL_NULL_V(p_root, false);
+
+	const InstantiationPlan *plan = _get_instantiation_plan();
+	if (!plan) {
+		return false;
+	}
+	Node **instance_nodes = (Node **)alloca(sizeof(Node *) * plan->nodes.size());
+	return _match_instance_nodes(*plan, p_root, instance_nodes);
+}
+
+bool SceneState::reset_instance(Node *p_root) const {
+	ERR_FAIL_NULL_V(p_root, false);
+	ERR_FAIL_COND_V_MSG(p_root->get_parent(), false, "Only instances without a parent can be reset.");
+
+	const InstantiationPlan *plan = _get_instantiation_plan();
+	if (!plan || !plan->poolable) {
+		return false;
+	}
+
+	// The structure of the instance must still match the packed scene.
+	const uint32_t nc = plan->nodes.size();
+	Node **instance_nodes = (Node **)alloca(sizeof(Node *) * nc);
+	if (!_match_instance_nodes(*plan, p_root, instance_nodes)) {
+		return false;
+	}
+
+	if (!plan->reset_properties_built.is_set()) {
+		MutexLock lock(instantiation_plan_mutex);
+		if (!instantiation_plan.reset_properties_built.is_set()) {
+			if (!_build_reset_properties(instantiation_plan)) {
+				return false;
+			}
+			instantiation_plan.reset_properties_built.set();
+		}
+	}
+
+	for (uint32_t i = 0; i < nc; i++) {
+		_disconnect_runtime_connections(instance_nodes[i]);
+	}
+
+	p_root->_set_name_nocheck(plan->nodes[0].name);
+
+	for (uint32_t i = 0; i < nc; i++) {
+		Node *node = instance_nodes[i];
+
+		for (const InstantiationPlan::ResetProperty &rp : plan->reset_properties[i]) {
+			const Variant value = rp.node_ref >= 0 ? Variant(instance_nodes[rp.node_ref]) : rp.value;
+			bool valid = false;
+			const Variant current = node->get(rp.name, &valid);
+			if (valid && current == value) {
+				continue;
+			}
+			if (value.get_type() == Variant::ARRAY || value.get_type() == Variant::DICTIONARY) {
+				node->set(rp.name, value.duplicate());
+			} else {
+				node->set(rp.name, value);
+			}
+		}
+
+		const InstantiationPlan::PlanNode &pn = plan->nodes[i];
+		List<Node::GroupInfo> groups;
+		node->get_groups(&groups);
+		for (const Node::GroupInfo &group : groups) {
+			if (!pn.groups.has(group.name)) {
+				node->remove_from_group(group.name);
+			}
+		}
+		for (const StringName &group : pn.groups) {
+			if (!node->is_in_group(group)) {
+				node->add_to_group(group, true);
+			}
+		}
+
+		node->request_ready();
+	}
+
+	return true;
 }
 
 Variant SceneState::make_local_resource(Variant &p_value, const SceneState::NodeData &p_node_data, HashMap<Node *, HashMap<Ref<Resource>, Ref<Resource>>> &p_resources_local_to_scenes, Node *p_node, const StringName p_sname, int p_i, Node **p_ret_nodes, SceneState::GenEditState p_edit_state) const {
@@ -1441,6 +1978,7 @@ String SceneState::get_path() const {
 }
 
 void SceneState::clear() {
+	_clear_instantiation_plan();
 	names.clear();
 	variants.clear();
 	nodes.clear();
@@ -1645,6 +2183,8 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 
 	ERR_FAIL_COND_MSG(version > PACKED_SCENE_VERSION, "Save format version too new.");
 
+	_clear_instantiation_plan();
+
 	const int node_count = p_dictionary["node_count"];
 	const Vector<int> snodes = p_dictionary["nodes"];
 	ERR_FAIL_COND(snodes.size() < node_count);
@@ -2273,11 +2813,13 @@ Vector<Ref<Resource>> SceneState::get_sub_resources() {
 //add
 
 int SceneState::add_name(const StringName &p_name) {
+	_clear_instantiation_plan();
 	names.push_back(p_name);
 	return names.size() - 1;
 }
 
 int SceneState::add_value(const Variant &p_value) {
+	_clear_instantiation_plan();
 	variants.push_back(p_value);
 	return variants.size() - 1;
 }
@@ -2297,6 +2839,7 @@ int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int
 	nd.instance = p_instance;
 	nd.index = p_index;
 
+	_clear_instantiation_plan();
 	nodes.push_back(nd);
 
 	ids.push_back(p_unique_id);
@@ -2315,17 +2858,20 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value, bool p_d
 		prop.name |= FLAG_PATH_PROPERTY_IS_NODE;
 	}
 	prop.value = p_value;
+	_clear_instantiation_plan();
 	nodes.write[p_node].properties.push_back(prop);
 }
 
 void SceneState::add_node_group(int p_node, int p_group) {
 	ERR_FAIL_INDEX(p_node, nodes.size());
 	ERR_FAIL_INDEX(p_group, names.size());
+	_clear_instantiation_plan();
 	nodes.write[p_node].groups.push_back(p_group);
 }
 
 void SceneState::set_base_scene(int p_idx) {
 	ERR_FAIL_INDEX(p_idx, variants.size());
+	_clear_instantiation_plan();
 	base_scene_idx = p_idx;
 }
 
@@ -2344,14 +2890,17 @@ void SceneState::add_connection(int p_from, int p_to, int p_signal, int p_method
 	c.flags = p_flags;
 	c.unbinds = p_unbinds;
 	c.binds = p_binds;
+	_clear_instantiation_plan();
 	connections.push_back(c);
 }
 
 void SceneState::add_editable_instance(const NodePath &p_path) {
+	_clear_instantiation_plan();
 	editable_instances.push_back(p_path);
 }
 
 bool SceneState::remove_group_references(const StringName &p_name) {
+	_clear_instantiation_plan();
 	bool edited = false;
 	for (NodeData &node : nodes) {
 		for (const int &group : node.groups) {
@@ -2366,6 +2915,7 @@ bool SceneState::remove_group_references(const StringName &p_name) {
 }
 
 bool SceneState::rename_group_references(const StringName &p_old_name, const StringName &p_new_name) {
+	_clear_instantiation_plan();
 	bool edited = false;
 	for (const NodeData &node : nodes) {
 		for (const int &group : node.groups) {
@@ -2447,10 +2997,12 @@ Dictionary PackedScene::_get_bundled_scene() const {
 }
 
 Error PackedScene::pack(Node *p_scene) {
+	_clear_instance_pool();
 	return state->pack(p_scene);
 }
 
 void PackedScene::clear() {
+	_clear_instance_pool();
 	state->clear();
 }
 
@@ -2485,6 +3037,14 @@ Node *PackedScene::instantiate(GenEditState p_edit_state) const {
 	ERR_FAIL_COND_V_MSG(p_edit_state != GEN_EDIT_STATE_DISABLED, nullptr, "Edit state is only for editors, does not work without tools compiled.");
 #endif
 
+	if (p_edit_state == GEN_EDIT_STATE_DISABLED && instance_pool_size > 0) {
+		Node *pooled = _take_pooled_instance();
+		if (pooled) {
+			pooled->notification(Node::NOTIFICATION_SCENE_INSTANTIATED);
+			return pooled;
+		}
+	}
+
 	Node *s = state->instantiate((SceneState::GenEditState)p_edit_state);
 	if (!s) {
 		return nullptr;
@@ -2504,6 +3064,7 @@ Node *PackedScene::instantiate(GenEditState p_edit_state) const {
 }
 
 void PackedScene::replace_state(Ref<SceneState> p_by) {
+	_clear_instance_pool();
 	state = p_by;
 	state->set_path(get_path());
 #ifdef TOOLS_ENABLED
@@ -2512,6 +3073,7 @@ void PackedScene::replace_state(Ref<SceneState> p_by) {
 }
 
 void PackedScene::recreate_state() {
+	_clear_instance_pool();
 	state.instantiate();
 	state->set_path(get_path());
 #ifdef TOOLS_ENABLED
@@ -2586,6 +3148,98 @@ void PackedScene::set_path_cache(const String &p_path) {
 void PackedScene::reset_state() {
 	clear();
 }
+
+Node *PackedScene::_take_pooled_instance() const {
+	MutexLock lock(instance_pool_mutex);
+	while (!instance_pool.is_empty()) {
+		const ObjectID id = instance_pool[instance_pool.size() - 1];
+		instance_pool.resize(instance_pool.size() - 1);
+		// Pooled instances may have been freed by someone else in the meantime.
+		Node *node = ObjectDB::get_instance<Node>(id);
+		if (node && !node->get_parent()) {
+			return node;
+		}
+	}
+	return nullptr;
+}
+
+void PackedScene::_clear_instance_pool() {
+	LocalVector<ObjectID> pooled;
+	{
+		MutexLock lock(instance_pool_mutex);
+		SWAP(pooled, instance_pool);
+	}
+	for (const ObjectID &id : pooled) {
+		Node *node = ObjectDB::get_instance<Node>(id);
+		if (node && !node->get_parent()) {
+			memdelete(node);
+		}
+	}
+}
+
+void PackedScene::set_instance_pool_size(int p_size) {
+	ERR_FAIL_COND_MSG(p_size < 0, "The instance pool size can't be negative.");
+	instance_pool_size = p_size;
+
+	LocalVector<ObjectID> excess;
+	{
+		MutexLock lock(instance_pool_mutex);
+		while (instance_pool.size() > (uint32_t)instance_pool_size) {
+			excess.push_back(instance_pool[instance_pool.size() - 1]);
+			instance_pool.resize(instance_pool.size() - 1);
+		}
+	}
+	for (const ObjectID &id : excess) {
+		Node *node = ObjectDB::get_instance<Node>(id);
+		if (node && !node->get_parent()) {
+			memdelete(node);
+		}
+	}
+}
+
+int PackedScene::get_pooled_instance_count() const {
+	MutexLock lock(instance_pool_mutex);
+	return instance_pool.size();
+}
+
+bool PackedScene::recycle_instance(Node *p_node) {
+	ERR_FAIL_NULL_V(p_node, false);
+	ERR_FAIL_COND_V_MSG(p_node->is_queued_for_deletion(), false, "Can't recycle a node that is queued for deletion.");
+	if (is_built_in()) {
+		// Instances of built-in scenes don't record where they come from, so their structure is all there is to check.
+		ERR_FAIL_COND_V_MSG(!p_node->get_scene_file_path().is_empty() || !state->matches_instance(p_node), false, vformat("Node \"%s\" is not an instance of this built-in scene.", p_node->get_name()));
+	} else {
+		ERR_FAIL_COND_V_MSG(p_node->get_scene_file_path() != get_path(), false, vformat("Node \"%s\" is not an instance of scene \"%s\".", p_node->get_name(), get_path()));
+	}
+
+	if (p_node->get_parent()) {
+		p_node->get_parent()->remove_child(p_node);
+	}
+
+	{
+		MutexLock lock(instance_pool_mutex);
+		if (instance_pool.has(p_node->get_instance_id())) {
+			return true;
+		}
+	}
+
+	if ((int)get_pooled_instance_count() < instance_pool_size && state->reset_instance(p_node)) {
+		MutexLock lock(instance_pool_mutex);
+		if ((int)instance_pool.size() < instance_pool_size) {
+			instance_pool.push_back(p_node->get_instance_id());
+			return true;
+		}
+	}
+
+	// The pool is full or the instance can't be reset, free it instead. Deletion is deferred when possible,
+	// as instances are usually recycled from their own callbacks.
+	if (SceneTree::get_singleton()) {
+		p_node->queue_free();
+	} else {
+		memdelete(p_node);
+	}
+	return false;
+}
 void PackedScene::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pack", "path"), &PackedScene::pack);
 	ClassDB::bind_method(D_METHOD("instantiate", "edit_state"), &PackedScene::instantiate, DEFVAL(GEN_EDIT_STATE_DISABLED));
@@ -2593,6 +3247,10 @@ void PackedScene::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("_set_bundled_scene", "scene"), &PackedScene::_set_bundled_scene);
 	ClassDB::bind_method(D_METHOD("_get_bundled_scene"), &PackedScene::_get_bundled_scene);
 	ClassDB::bind_method(D_METHOD("get_state"), &PackedScene::get_state);
+	ClassDB::bind_method(D_METHOD("set_instance_pool_size", "size"), &PackedScene::set_instance_pool_size);
+	ClassDB::bind_method(D_METHOD("get_instance_pool_size"), &PackedScene::get_instance_pool_size);
+	ClassDB::bind_method(D_METHOD("get_pooled_instance_count"), &PackedScene::get_pooled_instance_count);
+	ClassDB::bind_method(D_METHOD("recycle_instance", "node"), &PackedScene::recycle_instance);
 
 	ADD_PROPERTY(PropertyInfo(Variant::DICTIONARY, "_bundled", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_STORAGE | PROPERTY_USAGE_INTERNAL), "_set_bundled_scene", "_get_bundled_scene");
 
@@ -2605,3 +3263,7 @@ void PackedScene::_bind_methods() {
 PackedScene::PackedScene() {
 	state.instantiate();
 }
+
+PackedScene::~PackedScene() {
+	_clear_instance_pool();
+}
@@ -31,6 +31,9 @@
 #pragma once
 
 #include "core/io/resource.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 #include "scene/main/node.h"
 
 class SceneState : public RefCounted {
@@ -90,6 +93,87 @@ class SceneState : public RefCounted {
 
 	Vector<ConnectionData> connections;
 
+	// Precomputed steps for instantiating at runtime (no edit state, outside the editor): constructors and
+	// setters are resolved and connection binds are built once. Only scenes whose nodes are all created by
+	// this scene or are nested scenes get a plan, anything else goes through the generic instantiate().
+	struct InstantiationPlan {
+		struct Property {
+			StringName name;
+			Variant value;
+			MethodBind *setter = nullptr; // Bound setter of a built-in class, otherwise set through Object::set().
+			int setter_index = -1;
+			bool is_script = false;
+			bool is_container = false; // Arrays and dictionaries are typed and copied for each instance.
+			bool is_node_path = false; // Resolved to nodes once the whole tree exists.
+		};
+
+		struct PlanNode {
+			int parent = -1;
+			int owner = -1;
+			int index = -1;
+			int32_t unique_id = Node::UNIQUE_SCENE_ID_UNASSIGNED;
+			bool has_unique_id = false;
+			StringName name;
+			StringName type;
+			ClassDB::CreationFunc create = nullptr; // Null for nested scenes and classes that need ClassDB::instantiate().
+			Ref<PackedScene> instance;
+			LocalVector<Property> properties;
+			LocalVector<StringName> groups;
+			int child_count = 0;
+		};
+
+		struct Connection {
+			int from = 0;
+			int to = 0;
+			StringName signal;
+			StringName method;
+			uint32_t flags = 0;
+			int unbinds = 0;
+			Array binds;
+		};
+
+		// Packed value of a property, restored when an instance is recycled.
+		struct ResetProperty {
+			StringName name;
+			Variant value;
+			int node_ref = -1; // Index of the referenced node of this scene, if the value is one.
+		};
+
+		LocalVector<PlanNode> nodes;
+		LocalVector<Connection> connections;
+		// No nested scenes, so the whole tree of an instance is known and can be reset.
+		bool poolable = false;
+		// Built from a prototype instance the first time an instance is recycled.
+		LocalVector<LocalVector<ResetProperty>> reset_properties;
+		SafeFlag reset_properties_built;
+
+		void clear() {
+			nodes.clear();
+			connections.clear();
+			poolable = false;
+			reset_properties.clear();
+			reset_properties_built.clear();
+		}
+	};
+
+	enum InstantiationPlanStatus {
+		PLAN_NOT_BUILT,
+		PLAN_READY,
+		PLAN_UNSUPPORTED,
+	};
+
+	mutable InstantiationPlan instantiation_plan;
+	mutable SafeNumeric<uint32_t> instantiation_plan_status;
+	mutable BinaryMutex instantiation_plan_mutex;
+
+	bool _build_instantiation_plan(InstantiationPlan &r_plan) const;
+	const InstantiationPlan *_get_instantiation_plan() const;
+	void _clear_instantiation_plan();
+	Node *_instantiate_from_plan(const InstantiationPlan &p_plan, Node **r_nodes) const;
+	bool _build_reset_properties(InstantiationPlan &r_plan) const;
+	static bool _match_instance_nodes(const InstantiationPlan &p_plan, Node *p_root, Node **r_nodes);
+	static void _set_deferred_node_paths(const LocalVector<DeferredNodePathProperties> &p_deferred_node_paths);
+
 	Error _parse_node(Node *p_owner, Node *p_node, int p_parent_idx, HashMap<StringName, int> &name_map, HashMap<Variant, int> &variant_map, HashMap<Node *, int> &node_map, HashMap<Node *, int> &nodepath_map, HashSet<int32_t> &ids_saved);
 	Error _parse_connections(Node *p_owner, Node *p_node, HashMap<StringName, int> &name_map, HashMap<Variant, int> &variant_map, HashMap<Node *, int> &node_map, HashMap<Node *, int> &nodepath_map);
 
@@ -159,6 +243,11 @@ public:
 
 	bool can_instantiate() const;
 	Node *instantiate(GenEditState p_edit_state) const;
+	// Restores an instance of this scene that has no parent to its packed state. Fails if the scene contains
+	// nested scenes or other nodes the runtime plan doesn't support, or if the instance's node structure changed.
+	bool reset_instance(Node *p_root) const;
+	// Whether the node structure under p_root (names, classes, owners and child counts) is that of an instance of this scene.
+	bool matches_instance(Node *p_root) const;
 
 	Array setup_resources_in_array(Array &array_to_scan, const SceneState::NodeData &n, HashMap<Node *, HashMap<Ref<Resource>, Ref<Resource>>> &p_resources_local_to_scenes, Node *node, const StringName sname, int i, Node **ret_nodes, SceneState::GenEditState p_edit_state) const;
 	Dictionary setup_resources_in_dictionary(Dictionary &p_dictionary_to_scan, const SceneState::NodeData &p_n, HashMap<Node *, HashMap<Ref<Resource>, Ref<Resource>>> &p_resources_local_to_scenes, Node *p_node, const StringName p_sname, int p_i, Node **p_ret_nodes, SceneState::GenEditState p_edit_state) const;
@@ -247,8 +336,15 @@ class PackedScene : public Resource {
 
 	Ref<SceneState> state;
 
+	// Opt-in pool of recycled instances, reused by instantiate() without an edit state.
+	int instance_pool_size = 0;
+	mutable LocalVector<ObjectID> instance_pool;
+	mutable BinaryMutex instance_pool_mutex;
+
 	void _set_bundled_scene(const Dictionary &p_scene);
 	Dictionary _get_bundled_scene() const;
+	Node *_take_pooled_instance() const;
+	void _clear_instance_pool();
 
 protected:
 	virtual bool editor_can_reload_from_file() override { return false; } // this is handled by editor better
@@ -273,6 +369,11 @@ public:
 	void recreate_state();
 	void replace_state(Ref<SceneState> p_by);
 
+	void set_instance_pool_size(int p_size);
+	int get_instance_pool_size() const { return instance_pool_size; }
+	int get_pooled_instance_count() const;
+	bool recycle_instance(Node *p_node);
+
 	virtual void reload_from_file() override;
 
 	virtual void set_path(const String &p_path, bool p_take_over = false) override;
@@ -289,6 +390,7 @@ public:
 	Ref<SceneState> get_state() const;
 
 	PackedScene();
+	~PackedScene();
 };
 
 VARIANT_ENUM_CAST(PackedScene::GenEditState)
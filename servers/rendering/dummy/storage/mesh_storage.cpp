@@ -100,3 +100,83 @@ Vector<float> MeshStorage::_multimesh_get_buffer(RID p_multimesh) const {
 
 	return multimesh->buffer;
 }
+
+/* SKELETON API */
+
+RID MeshStorage::skeleton_allocate() {
+	return skeleton_owner.allocate_rid();
+}
+
+void MeshStorage::skeleton_initialize(RID p_rid) {
+	skeleton_owner.initialize_rid(p_rid, DummySkeleton());
+}
+
+void MeshStorage::skeleton_free(RID p_rid) {
+	DummySkeleton *skeleton = skeleton_owner.get_or_null(p_rid);
+	ERR_FAIL_NULL(skeleton);
+
+	skeleton_owner.free(p_rid);
+}
+
+void MeshStorage::skeleton_allocate_data(RID p_skeleton, int p_bones, bool p_2d_skeleton) {
+	DummySkeleton *skeleton = skeleton_owner.get_or_null(p_skeleton);
+	ERR_FAIL_NULL(skeleton);
+	ERR_FAIL_COND(p_bones < 0);
+
+	skeleton->size = p_bones;
+	skeleton->use_2d = p_2d_skeleton;
+	skeleton->data.resize(p_bones * (p_2d_skeleton ? 8 : 12));
+	memset(skeleton->data.ptr(), 0, skeleton->data.size() * sizeof(float));
+}
+
+int MeshStorage::skeleton_get_bone_count(RID p_skeleton) const {
+	DummySkeleton *skeleton = skeleton_owner.get_or_null(p_skeleton);
+	ERR_FAIL_NULL_V(skeleton, 0);
+
+	return skeleton->size;
+}
+
+void MeshStorage::skeleton_bone_set_transform(RID p_skeleton, int p_bone, const Transform3D &p_transform) {
+	DummySkeleton *skeleton = skeleton_owner.get_or_null(p_skeleton);
+	ERR_FAIL_NULL(skeleton);
+	ERR_FAIL_INDEX(p_bone, skeleton->size);
+	ERR_FAIL_COND(skeleton->use_2d);
+
+	float *dataptr = skeleton->data.ptr() + p_bone * 12;
+	for (int row = 0; row < 3; row++) {
+		dataptr[row * 4 + 0] = p_transform.basis.rows[row][0];
+		dataptr[row * 4 + 1] = p_transform.basis.rows[row][1];
+		dataptr[row * 4 + 2] = p_transform.basis.rows[row][2];
+		dataptr[row * 4 + 3] = p_transform.origin[row];
+	}
+}
+
+Transform3D MeshStorage::skeleton_bone_get_transform(RID p_skeleton, int p_bone) const {
+	DummySkeleton *skeleton = skeleton_owner.get_or_null(p_skeleton);
+	ERR_FAIL_NULL_V(skeleton, Transform3D());
+	ERR_FAIL_INDEX_V(p_bone, skeleton->size, Transform3D());
+	ERR_FAIL_COND_V(skeleton->use_2d, Transform3D());
+
+	const float *dataptr = skeleton->data.ptr() + p_bone * 12;
+	Transform3D t;
+	for (int row = 0; row < 3; row++) {
+		t.basis.rows[row][0] = dataptr[row * 4 + 0];
+		t.basis.rows[row][1] = dataptr[row * 4 + 1];
+		t.basis.rows[row][2] = dataptr[row * 4 + 2];
+		t.origin[row] = dataptr[row * 4 + 3];
+	}
+	return t;
+}
+
+void MeshStorage::skeleton_set_transforms(RID p_skeleton, const Vector<float> &p_buffer) {
+	DummySkeleton *skeleton = skeleton_owner.get_or_null(p_skeleton);
+	ERR_FAIL_NULL(skeleton);
+	ERR_FAIL_COND(skeleton->use_2d);
+	ERR_FAIL_COND(p_buffer.size() != skeleton->size * 12);
+
+	if (skeleton->size == 0) {
+		return;
+	}
+
+	memcpy(skeleton->data.ptr(), p_buffer.ptr(), p_buffer.size() * sizeof(float));
+}
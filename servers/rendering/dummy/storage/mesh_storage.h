@@ -55,6 +55,15 @@ private:
 
 	mutable RID_Owner<DummyMultiMesh> multimesh_owner;
 
+	// Bone transforms are kept so they can be read back, in the same layout as the real skeleton storage.
+	struct DummySkeleton {
+		LocalVector<float> data;
+		int size = 0;
+		bool use_2d = false;
+	};
+
+	mutable RID_Owner<DummySkeleton> skeleton_owner;
+
 public:
 	static MeshStorage *get_singleton() { return singleton; }
 
@@ -185,14 +194,17 @@ public:
 
 	/* SKELETON API */
 
-	virtual RID skeleton_allocate() override { return RID(); }
-	virtual void skeleton_initialize(RID p_rid) override {}
-	virtual void skeleton_free(RID p_rid) override {}
-	virtual void skeleton_allocate_data(RID p_skeleton, int p_bones, bool p_2d_skeleton = false) override {}
+	bool owns_skeleton(RID p_rid) { return skeleton_owner.owns(p_rid); }
+
+	virtual RID skeleton_allocate() override;
+	virtual void skeleton_initialize(RID p_rid) override;
+	virtual void skeleton_free(RID p_rid) override;
+	virtual void skeleton_allocate_data(RID p_skeleton, int p_bones, bool p_2d_skeleton = false) override;
 	virtual void skeleton_set_base_transform_2d(RID p_skeleton, const Transform2D &p_base_transform) override {}
-	virtual int skeleton_get_bone_count(RID p_skeleton) const override { return 0; }
-	virtual void skeleton_bone_set_transform(RID p_skeleton, int p_bone, const Transform3D &p_transform) override {}
-	virtual Transform3D skeleton_bone_get_transform(RID p_skeleton, int p_bone) const override { return Transform3D(); }
+	virtual int skeleton_get_bone_count(RID p_skeleton) const override;
+	virtual void skeleton_bone_set_transform(RID p_skeleton, int p_bone, const Transform3D &p_transform) override;
+	virtual Transform3D skeleton_bone_get_transform(RID p_skeleton, int p_bone) const override;
+	virtual void skeleton_set_transforms(RID p_skeleton, const Vector<float> &p_buffer) override;
 	virtual void skeleton_bone_set_transform_2d(RID p_skeleton, int p_bone, const Transform2D &p_transform) override {}
 	virtual Transform2D skeleton_bone_get_transform_2d(RID p_skeleton, int p_bone) const override { return Transform2D(); }
 
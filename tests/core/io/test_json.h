@@ -30,8 +30,10 @@
 
 #pragma once
 
+#include "core/io/dir_access.h"
 #include "core/io/json.h"
 
+#include "tests/test_utils.h"
 #include "thirdparty/doctest/doctest.h"
 
 namespace TestJSON {
@@ -423,4 +425,113 @@ TEST_CASE("[JSON] Serialization") {
 		}
 	}
 }
+
+TEST_CASE("[JSON] Parsing UTF-8") {
+	const String source = U"{\"name\": \"Tēšt 日本語 \\u00e9\\ud83d\\ude00\", \"list\": [1, 2.5, -3e2, true, null], \"nested\": {\"empty\": []}}";
+	const CharString utf8 = source.utf8();
+
+	JSON from_string;
+	REQUIRE(from_string.parse(source) == OK);
+	JSON from_utf8;
+	REQUIRE(from_utf8.parse_utf8(Span((const uint8_t *)utf8.ptr(), utf8.length())) == OK);
+
+	const Dictionary dictionary = from_utf8.get_data();
+	CHECK(dictionary["name"] == String(U"Tēšt 日本語 é😀"));
+	CHECK(Array(dictionary["list"]).size() == 5);
+	CHECK(double(Array(dictionary["list"])[2]) == -300.0);
+	CHECK(from_utf8.get_data() == from_string.get_data());
+
+	// Errors are reported the same way.
+	ERR_PRINT_OFF
+	const char *broken = "[1,\n2,\n3 4]";
+	CHECK(from_utf8.parse_utf8(Span((const uint8_t *)broken, strlen(broken))) == ERR_PARSE_ERROR);
+	CHECK(from_utf8.get_error_line() == 2);
+	CHECK(from_utf8.get_error_message() == "Expected ','");
+	ERR_PRINT_ON
+}
+
+TEST_CASE("[JSON] Repeated object keys share their data") {
+	JSON json;
+	REQUIRE(json.parse(R"([{"identifier": 1, "other": 2}, {"identifier": 3, "other": 4}])") == OK);
+	const Array array = json.get_data();
+	const Dictionary first = array[0];
+	const Dictionary second = array[1];
+	REQUIRE(first.keys().size() == 2);
+	const String first_key = first.keys()[0];
+	const String second_key = second.keys()[0];
+	CHECK(first_key == "identifier");
+	CHECK(first_key.ptr() == second_key.ptr());
+}
+
+TEST_CASE("[JSON] Parsing from a file") {
+	const String path = TestUtils::get_temp_path("test_json_stream.json");
+	{
+		Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+		REQUIRE(file.is_valid());
+		// Large enough to be read in several chunks.
+		file->store_string("[");
+		for (int i = 0; i < 20000; i++) {
+			file->store_string(vformat("%s{\"index\": %d, \"text\": \"item %d\"}", i == 0 ? "" : ",\n", i, i));
+		}
+		file->store_string("]");
+	}
+
+	SUBCASE("Building the document") {
+		JSON json;
+		REQUIRE(json.parse_file(FileAccess::open(path, FileAccess::READ)) == OK);
+		const Array array = json.get_data();
+		REQUIRE(array.size() == 20000);
+		const Dictionary last = array[19999];
+		CHECK(int(last["index"]) == 19999);
+		CHECK(last["text"] == "item 19999");
+	}
+
+	SUBCASE("Streaming") {
+		struct Counter : public JSON::StreamHandler {
+			int objects = 0;
+			int values = 0;
+			int depth = 0;
+			int max_depth = 0;
+			int stop_at_objects = -1;
+
+			bool begin_object() override {
+				max_depth = MAX(max_depth, ++depth);
+				return ++objects != stop_at_objects;
+			}
+			bool end_object() override {
+				depth--;
+				return true;
+			}
+			bool begin_array() override {
+				max_depth = MAX(max_depth, ++depth);
+				return true;
+			}
+			bool end_array() override {
+				depth--;
+				return true;
+			}
+			bool value(const Variant &p_value) override {
+				values++;
+				return true;
+			}
+		};
+
+		Counter counter;
+		String error;
+		int line = 0;
+		CHECK(JSON::parse_stream(FileAccess::open(path, FileAccess::READ), &counter, error, line) == OK);
+		CHECK(counter.objects == 20000);
+		CHECK(counter.values == 40000);
+		CHECK(counter.max_depth == 2);
+		CHECK(counter.depth == 0);
+
+		Counter stopping;
+		stopping.stop_at_objects = 10;
+		CHECK(JSON::parse_stream(FileAccess::open(path, FileAccess::READ), &stopping, error, line) == ERR_SKIP);
+		CHECK(stopping.objects == 10);
+		CHECK(line == 9);
+	}
+
+	DirAccess::remove_file_or_error(path);
+}
 } // namespace TestJSON
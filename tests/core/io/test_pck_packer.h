@@ -116,4 +116,46 @@ TEST_CASE("[PCKPacker] Pack a PCK file with some files and directories") {
 			f->get_length() <= 27000,
 			"The generated non-empty PCK file shouldn't be too large.");
 }
+
+TEST_CASE("[PCKPacker] Read files from a loaded PCK in place") {
+	const String source_path = TestUtils::get_temp_path("mapped_source.bin");
+	PackedByteArray contents;
+	contents.resize(10000);
+	for (int i = 0; i < contents.size(); i++) {
+		contents.write[i] = uint8_t(i * 7);
+	}
+	{
+		Ref<FileAccess> f = FileAccess::open(source_path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_buffer(contents);
+	}
+
+	PCKPacker pck_packer;
+	const String output_pck_path = TestUtils::get_temp_path("output_mapped.pck");
+	REQUIRE(pck_packer.pck_start(output_pck_path) == OK);
+	REQUIRE(pck_packer.add_file("res://test_pck_mapped/data.bin", source_path) == OK);
+	REQUIRE(pck_packer.flush() == OK);
+
+	REQUIRE(PackedData::get_singleton()->add_pack(output_pck_path, false, 0) == OK);
+	Ref<FileAccess> f = FileAccess::open("res://test_pck_mapped/data.bin", FileAccess::READ);
+	REQUIRE(f.is_valid());
+	CHECK(f->get_length() == uint64_t(contents.size()));
+
+	const Span<uint8_t> mapped = f->get_mapped_buffer();
+	CHECK_MESSAGE(mapped.size() == uint64_t(contents.size()), "Unencrypted files in a PCK should be readable from the mapped pack.");
+	CHECK(memcmp(mapped.ptr(), contents.ptr(), MIN(mapped.size(), uint64_t(contents.size()))) == 0);
+
+	// Regular reads return the same bytes.
+	f->seek(9990);
+	CHECK(f->get_buffer(20) == contents.slice(9990));
+	CHECK(f->eof_reached());
+	f->seek(0);
+	CHECK(f->get_buffer(contents.size()) == contents);
+	CHECK(f->get_8() == 0);
+	CHECK(f->eof_reached());
+
+	PackedData::get_singleton()->remove_path("res://test_pck_mapped/data.bin");
+	DirAccess::remove_file_or_error(source_path);
+}
+
 } // namespace TestPCKPacker
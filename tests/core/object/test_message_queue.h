@@ -0,0 +1,167 @@
+/**************************************************************************/
+/*  test_message_queue.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/object/message_queue.h"
+#include "core/os/thread.h"
+
+#include "tests/test_macros.h"
+
+#include <atomic>
+
+namespace TestMessageQueue {
+
+constexpr uint32_t PRODUCER_COUNT = 4;
+constexpr uint32_t MESSAGES_PER_PRODUCER = 20000;
+
+struct Receiver {
+	uint32_t next_sequence[PRODUCER_COUNT] = {};
+	uint32_t received = 0;
+	uint32_t out_of_order = 0;
+
+	void receive(uint32_t p_producer, uint32_t p_sequence) {
+		if (next_sequence[p_producer] != p_sequence) {
+			out_of_order++;
+		}
+		next_sequence[p_producer] = p_sequence + 1;
+		received++;
+	}
+};
+
+static Receiver *receiver = nullptr;
+
+static void receive(uint32_t p_producer, uint32_t p_sequence) {
+	receiver->receive(p_producer, p_sequence);
+}
+
+TEST_CASE("[MessageQueue] Messages from other threads keep their order per thread") {
+	struct Tester {
+		CallQueue queue;
+		Receiver received;
+		SafeNumeric<uint32_t> next_producer;
+		std::atomic<uint32_t> producers_done = { 0 };
+		std::atomic<uint32_t> push_errors = { 0 };
+
+		static void producer_func(void *p_data) {
+			Tester *tester = (Tester *)p_data;
+			const uint32_t producer = tester->next_producer.postincrement();
+			const Callable callable = callable_mp_static(&receive);
+			for (uint32_t i = 0; i < MESSAGES_PER_PRODUCER; i++) {
+				if (tester->queue.push_callable(callable, producer, i) != OK) {
+					tester->push_errors.fetch_add(1);
+				}
+			}
+			tester->producers_done.fetch_add(1);
+		}
+
+		void run() {
+			receiver = &received;
+			Thread threads[PRODUCER_COUNT];
+			for (Thread &thread : threads) {
+				thread.start(&Tester::producer_func, this);
+			}
+			// Flush while the producers are still pushing.
+			while (producers_done.load() < PRODUCER_COUNT) {
+				queue.flush();
+				Thread::yield();
+			}
+			for (Thread &thread : threads) {
+				thread.wait_to_finish();
+			}
+			queue.flush();
+			receiver = nullptr;
+		}
+	};
+
+	Tester tester;
+	tester.run();
+
+	CHECK(tester.push_errors.load() == 0);
+	CHECK(tester.received.out_of_order == 0);
+	CHECK(tester.received.received == PRODUCER_COUNT * MESSAGES_PER_PRODUCER);
+	CHECK_FALSE(tester.queue.has_messages());
+}
+
+static CallQueue *reentrant_queue = nullptr;
+
+static void push_again(int p_remaining) {
+	receiver->received++;
+	if (p_remaining > 0) {
+		reentrant_queue->push_callable(callable_mp_static(&push_again), p_remaining - 1);
+	}
+}
+
+TEST_CASE("[MessageQueue] Messages pushed while flushing are processed in the same flush") {
+	CallQueue queue;
+	Receiver received;
+	receiver = &received;
+	reentrant_queue = &queue;
+
+	CHECK_FALSE(queue.has_messages());
+	queue.push_callable(callable_mp_static(&push_again), 99);
+	CHECK(queue.has_messages());
+	CHECK(queue.flush() == OK);
+	CHECK(received.received == 100);
+	CHECK_FALSE(queue.has_messages());
+
+	// Cleared messages are destroyed without being called.
+	queue.push_callable(callable_mp_static(&receive), 0u, 0u);
+	queue.clear();
+	CHECK_FALSE(queue.has_messages());
+	CHECK(queue.flush() == OK);
+	CHECK(received.received == 100);
+
+	reentrant_queue = nullptr;
+	receiver = nullptr;
+}
+
+TEST_CASE("[MessageQueue] Idle producers are released") {
+	CallQueue queue;
+	Receiver received;
+	receiver = &received;
+
+	queue.push_callable(callable_mp_static(&receive), 0u, 0u);
+	const int usage = queue.get_max_buffer_usage();
+	CHECK(usage > 0);
+	for (int i = 0; i < 64; i++) {
+		queue.flush();
+	}
+	// The released producer is reused by the next thread that pushes, so no page is added.
+	queue.push_callable(callable_mp_static(&receive), 0u, 1u);
+	queue.flush();
+	CHECK(received.received == 2);
+	CHECK(received.out_of_order == 0);
+	CHECK(queue.get_max_buffer_usage() == usage);
+
+	receiver = nullptr;
+}
+
+} // namespace TestMessageQueue
@@ -0,0 +1,171 @@
+/**************************************************************************/
+/*  test_memory_tags.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/debugger/debugger_marshalls.h"
+#include "core/os/memory.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMemoryTags {
+
+TEST_CASE("[Memory] Tag registry") {
+	if (!Memory::is_tagging_enabled()) {
+		CHECK(Memory::get_tag("TestMemoryTags") == Memory::TAG_UNTAGGED);
+		CHECK(Memory::get_tag_count() == 0);
+		CHECK(Memory::get_tag_usage(Memory::TAG_UNTAGGED).live_bytes == 0);
+		return;
+	}
+
+	const Memory::Tag tag = Memory::get_tag("TestMemoryTags");
+	CHECK(tag != Memory::TAG_UNTAGGED);
+	CHECK(tag < Memory::get_tag_count());
+	CHECK(Memory::get_tag("TestMemoryTags") == tag);
+	CHECK(String(Memory::get_tag_name(tag)) == "TestMemoryTags");
+	CHECK(String(Memory::get_tag_name(Memory::TAG_UNTAGGED)) == "untagged");
+
+	// Names are matched by contents, not by pointer.
+	char copy[] = "TestMemoryTags";
+	CHECK(Memory::get_tag(copy) == tag);
+	CHECK(Memory::get_tag("TestMemoryTags2") != tag);
+}
+
+TEST_CASE("[Memory] Allocations are accounted to the scope tag") {
+	if (!Memory::is_tagging_enabled()) {
+		return;
+	}
+
+	const Memory::Tag tag = Memory::get_tag("TestMemoryTagsScope");
+	const Memory::Tag inner_tag = Memory::get_tag("TestMemoryTagsInnerScope");
+	const Memory::TagUsage before = Memory::get_tag_usage(tag);
+
+	void *block = nullptr;
+	int *object = nullptr;
+	{
+		MemoryTagScope scope(tag);
+		CHECK(Memory::get_thread_tag() == tag);
+		block = memalloc(100);
+		object = memnew(int(5));
+		{
+			MemoryTagScope inner_scope(inner_tag);
+			CHECK(Memory::get_thread_tag() == inner_tag);
+		}
+		CHECK(Memory::get_thread_tag() == tag);
+	}
+	CHECK(Memory::get_thread_tag() == Memory::TAG_UNTAGGED);
+
+	Memory::TagUsage usage = Memory::get_tag_usage(tag);
+	CHECK(usage.live_bytes == before.live_bytes + 100 + sizeof(int));
+	CHECK(usage.live_blocks == before.live_blocks + 2);
+	CHECK(usage.allocations == before.allocations + 2);
+
+	// Resizing outside of the scope keeps the original tag.
+	block = memrealloc(block, 300);
+	CHECK(Memory::get_tag_usage(tag).live_bytes == before.live_bytes + 300 + sizeof(int));
+
+	memfree(block);
+	memdelete(object);
+	usage = Memory::get_tag_usage(tag);
+	CHECK(usage.live_bytes == before.live_bytes);
+	CHECK(usage.live_blocks == before.live_blocks);
+	CHECK(usage.allocations == before.allocations + 2);
+}
+
+TEST_CASE("[Memory] memnew outside of a scope is tagged by call site") {
+	if (!Memory::is_tagging_enabled()) {
+		return;
+	}
+
+	int *object = memnew(int(7));
+	Memory::Tag site_tag = Memory::TAG_UNTAGGED;
+	for (uint32_t i = 1; i < Memory::get_tag_count(); i++) {
+		const String name = Memory::get_tag_name(i);
+		if (name.contains("test_memory_tags.h") && Memory::get_tag_usage(i).live_blocks > 0) {
+			site_tag = i;
+		}
+	}
+	CHECK(site_tag != Memory::TAG_UNTAGGED);
+	const uint64_t live_bytes = Memory::get_tag_usage(site_tag).live_bytes;
+	memdelete(object);
+	CHECK(Memory::get_tag_usage(site_tag).live_bytes == live_bytes - sizeof(int));
+}
+
+TEST_CASE("[Memory] Tag usage snapshots and diffs") {
+	DebuggerMarshalls::MemoryTagUsage baseline;
+	DebuggerMarshalls::MemoryTagUsage::Entry entry;
+	entry.name = "A";
+	entry.live_bytes = 100;
+	entry.live_blocks = 2;
+	entry.allocations = 5;
+	baseline.entries.push_back(entry);
+	entry.name = "B";
+	entry.live_bytes = 50;
+	entry.live_blocks = 1;
+	entry.allocations = 1;
+	baseline.entries.push_back(entry);
+
+	DebuggerMarshalls::MemoryTagUsage current;
+	// A shrank, B is unchanged, C is new.
+	entry.name = "A";
+	entry.live_bytes = 40;
+	entry.live_blocks = 1;
+	entry.allocations = 6;
+	current.entries.push_back(entry);
+	current.entries.push_back(baseline.entries[1]);
+	entry.name = "C";
+	entry.live_bytes = 16;
+	entry.live_blocks = 1;
+	entry.allocations = 1;
+	current.entries.push_back(entry);
+
+	DebuggerMarshalls::MemoryTagUsage change = current.diff(baseline);
+	REQUIRE(change.entries.size() == 2);
+	CHECK(change.entries[0].name == "A");
+	CHECK(change.entries[0].live_bytes == -60);
+	CHECK(change.entries[0].live_blocks == -1);
+	CHECK(change.entries[0].allocations == 1);
+	CHECK(change.entries[1].name == "C");
+	CHECK(change.entries[1].live_bytes == 16);
+
+	DebuggerMarshalls::MemoryTagUsage decoded;
+	REQUIRE(decoded.deserialize(change.serialize()));
+	REQUIRE(decoded.entries.size() == 2);
+	CHECK(decoded.entries[0].name == "A");
+	CHECK(decoded.entries[0].live_bytes == -60);
+	CHECK(decoded.entries[1].allocations == 1);
+
+	// The live capture matches the registry.
+	DebuggerMarshalls::MemoryTagUsage live;
+	live.capture();
+	CHECK(live.entries.size() == (int)Memory::get_tag_count());
+}
+
+} // namespace TestMemoryTags
@@ -0,0 +1,160 @@
+/**************************************************************************/
+/*  test_small_allocator.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/os/os.h"
+#include "core/os/small_allocator.h"
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
+
+#include "tests/test_macros.h"
+
+#include <cstdlib>
+
+namespace TestSmallAllocator {
+
+TEST_CASE("[SmallAllocator] Size classes") {
+	CHECK(SmallAllocator::alloc(SmallAllocator::MAX_SIZE + 1) == nullptr);
+
+	uint32_t previous_size = 0;
+	for (uint32_t i = 0; i < SmallAllocator::SIZE_CLASS_COUNT; i++) {
+		const uint32_t size = SmallAllocator::get_size_class_block_size(i);
+		CHECK(size > previous_size);
+		CHECK(size % 16 == 0);
+		previous_size = size;
+	}
+	CHECK(previous_size == SmallAllocator::MAX_SIZE);
+
+	bool all_fit = true;
+	for (size_t bytes = 1; bytes <= SmallAllocator::MAX_SIZE; bytes += 7) {
+		void *block = SmallAllocator::alloc(bytes);
+		REQUIRE(block != nullptr);
+		all_fit = all_fit && SmallAllocator::owns(block) && SmallAllocator::get_block_size(block) >= bytes && ((uintptr_t)block % 16) == 0;
+		memset(block, 0xAB, bytes);
+		SmallAllocator::free(block);
+	}
+	CHECK_MESSAGE(all_fit, "Blocks should be aligned, big enough and recognized as owned.");
+
+	void *system_block = malloc(64);
+	CHECK_FALSE(SmallAllocator::owns(system_block));
+	::free(system_block);
+	int on_stack = 0;
+	CHECK_FALSE(SmallAllocator::owns(&on_stack));
+}
+
+TEST_CASE("[SmallAllocator] Freed blocks are reused and counted") {
+	const uint32_t size_class = 3; // 64 bytes.
+	// Other threads may use the allocator too when it backs Memory, so counters are only checked as lower bounds.
+	const SmallAllocator::SizeClassStats before = SmallAllocator::get_size_class_stats(size_class);
+
+	void *first = SmallAllocator::alloc(64);
+	SmallAllocator::free(first);
+	void *second = SmallAllocator::alloc(60);
+	CHECK_MESSAGE(first == second, "The last block freed on a thread should be the next one allocated.");
+
+	const SmallAllocator::SizeClassStats during = SmallAllocator::get_size_class_stats(size_class);
+	CHECK(during.block_size == 64);
+	CHECK(during.allocations >= before.allocations + 2);
+	CHECK(during.frees >= before.frees + 1);
+	CHECK(during.slabs >= 1);
+
+	SmallAllocator::free(second);
+	CHECK(SmallAllocator::get_size_class_stats(size_class).frees >= before.frees + 2);
+}
+
+#ifdef THREADS_ENABLED
+constexpr uint32_t CROSS_THREAD_BLOCK_COUNT = 20000;
+
+// Blocks allocated on one thread are freed on another, then taken back by the
+// owner. Checks contents and counters; timing is not checked.
+TEST_CASE("[SmallAllocator] Blocks freed on other threads") {
+	struct Tester {
+		LocalVector<uint8_t *> blocks;
+		std::atomic<uint32_t> corrupted = 0;
+
+		static size_t block_bytes(uint32_t p_index) {
+			return 1 + (p_index * 37) % SmallAllocator::MAX_SIZE;
+		}
+
+		static void free_func(void *p_data) {
+			Tester *tester = (Tester *)p_data;
+			uint32_t local_corrupted = 0;
+			for (uint32_t i = 0; i < tester->blocks.size(); i++) {
+				uint8_t *block = tester->blocks[i];
+				for (size_t j = 0; j < block_bytes(i); j++) {
+					if (block[j] != uint8_t(i)) {
+						local_corrupted++;
+						break;
+					}
+				}
+				SmallAllocator::free(block);
+			}
+			tester->corrupted.fetch_add(local_corrupted);
+		}
+	};
+
+	uint64_t remote_frees_before = 0;
+	for (uint32_t i = 0; i < SmallAllocator::SIZE_CLASS_COUNT; i++) {
+		remote_frees_before += SmallAllocator::get_size_class_stats(i).remote_frees;
+	}
+
+	Tester tester;
+	for (uint32_t i = 0; i < CROSS_THREAD_BLOCK_COUNT; i++) {
+		uint8_t *block = (uint8_t *)SmallAllocator::alloc(Tester::block_bytes(i));
+		REQUIRE(block != nullptr);
+		memset(block, uint8_t(i), Tester::block_bytes(i));
+		tester.blocks.push_back(block);
+	}
+
+	Thread thread;
+	thread.start(&Tester::free_func, &tester);
+	thread.wait_to_finish();
+	CHECK(tester.corrupted.load() == 0);
+
+	uint64_t remote_frees_after = 0;
+	for (uint32_t i = 0; i < SmallAllocator::SIZE_CLASS_COUNT; i++) {
+		remote_frees_after += SmallAllocator::get_size_class_stats(i).remote_frees;
+	}
+	CHECK(remote_frees_after >= remote_frees_before + CROSS_THREAD_BLOCK_COUNT);
+
+	// The owner gets the remotely freed blocks back before carving new ones.
+	const uint64_t reserved = SmallAllocator::get_reserved_bytes();
+	for (uint32_t i = 0; i < CROSS_THREAD_BLOCK_COUNT; i++) {
+		tester.blocks[i] = (uint8_t *)SmallAllocator::alloc(Tester::block_bytes(i));
+	}
+	CHECK(SmallAllocator::get_reserved_bytes() == reserved);
+	for (uint8_t *block : tester.blocks) {
+		SmallAllocator::free(block);
+	}
+}
+#endif // THREADS_ENABLED
+
+} // namespace TestSmallAllocator
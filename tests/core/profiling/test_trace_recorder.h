@@ -0,0 +1,130 @@
+/**************************************************************************/
+/*  test_trace_recorder.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/io/json.h"
+#include "core/os/thread.h"
+#include "core/profiling/trace_recorder.h"
+
+#include "tests/test_macros.h"
+
+namespace TestTraceRecorder {
+
+static Array get_trace_events() {
+	const Variant trace = JSON::parse_string(TraceRecorder::to_json());
+	REQUIRE(trace.get_type() == Variant::DICTIONARY);
+	const Dictionary trace_dict = trace;
+	REQUIRE(trace_dict.has("traceEvents"));
+	return trace_dict["traceEvents"];
+}
+
+static Array find_events(const Array &p_events, const String &p_name) {
+	Array found;
+	for (const Variant &event : p_events) {
+		const Dictionary event_dict = event;
+		if (String(event_dict.get("name", String())) == p_name) {
+			found.push_back(event_dict);
+		}
+	}
+	return found;
+}
+
+static void record_thread_zone(void *p_userdata) {
+	TraceRecorder::Zone zone("TestTraceThread");
+}
+
+TEST_CASE("[TraceRecorder] Zones and frame marks are exported as trace events") {
+	TraceRecorder::start();
+	CHECK(TraceRecorder::is_recording());
+	{
+		TraceRecorder::Zone outer("TestTraceOuter");
+		{
+			TraceRecorder::Zone inner("TestTrace\"Inner\"");
+		}
+		TraceRecorder::frame_mark();
+	}
+	{
+		TraceRecorder::Zone grouped("TestTraceGroupA");
+		grouped.restart("TestTraceGroupB");
+		grouped.end();
+	}
+	Thread thread;
+	thread.start(record_thread_zone, nullptr);
+	thread.wait_to_finish();
+	TraceRecorder::stop();
+	CHECK_FALSE(TraceRecorder::is_recording());
+	{
+		TraceRecorder::Zone ignored("TestTraceAfterStop");
+	}
+
+	const Array events = get_trace_events();
+
+	const Array outer = find_events(events, "TestTraceOuter");
+	const Array inner = find_events(events, "TestTrace\"Inner\"");
+	REQUIRE(outer.size() == 1);
+	REQUIRE(inner.size() == 1);
+	const Dictionary outer_event = outer[0];
+	const Dictionary inner_event = inner[0];
+	CHECK(String(outer_event["ph"]) == "X");
+	CHECK(double(inner_event["ts"]) >= double(outer_event["ts"]));
+	CHECK(double(inner_event["ts"]) + double(inner_event["dur"]) <= double(outer_event["ts"]) + double(outer_event["dur"]));
+	CHECK(int64_t(inner_event["tid"]) == int64_t(outer_event["tid"]));
+
+	const Array frames = find_events(events, "Frame");
+	REQUIRE(frames.size() >= 1);
+	CHECK(String(Dictionary(frames[0])["ph"]) == "i");
+
+	CHECK(find_events(events, "TestTraceGroupA").size() == 1);
+	CHECK(find_events(events, "TestTraceGroupB").size() == 1);
+
+	const Array thread_events = find_events(events, "TestTraceThread");
+	REQUIRE(thread_events.size() == 1);
+	CHECK(int64_t(Dictionary(thread_events[0])["tid"]) != int64_t(outer_event["tid"]));
+
+	CHECK(find_events(events, "TestTraceAfterStop").is_empty());
+}
+
+TEST_CASE("[TraceRecorder] Only the most recent events of a thread are kept") {
+	TraceRecorder::start();
+	for (uint32_t i = 0; i < TraceRecorder::EVENTS_PER_THREAD + 10; i++) {
+		TraceRecorder::Zone zone("TestTraceWrap");
+	}
+	TraceRecorder::stop();
+	// One slot is always treated as possibly being written.
+	CHECK(find_events(get_trace_events(), "TestTraceWrap").size() == TraceRecorder::EVENTS_PER_THREAD - 1);
+
+	// Starting again discards the previous recording.
+	TraceRecorder::start();
+	TraceRecorder::stop();
+	CHECK(find_events(get_trace_events(), "TestTraceWrap").is_empty());
+}
+
+} // namespace TestTraceRecorder
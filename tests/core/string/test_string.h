@@ -1853,6 +1853,31 @@ TEST_CASE("[String] hash") {
 
 	CHECK(a.hash64() == b.hash64());
 	CHECK(a.hash64() != c.hash64());
+
+	// Hashing the string matches hashing its characters.
+	CHECK(a.hash() == String::hash("Test"));
+	CHECK(a.hash() == String::hash(U"Test"));
+	CHECK(String(U"Tēšt").hash() == String::hash(U"Tēšt"));
+	CHECK(String().hash() == String::hash(""));
+	CHECK(String().hash() == String("").hash());
+}
+
+TEST_CASE("[String] Comparisons of shared buffers") {
+	String a = "Shared";
+	String b = a;
+	REQUIRE(a.ptr() == b.ptr());
+	CHECK(a == b);
+	CHECK_FALSE(a != b);
+	CHECK_FALSE(a < b);
+
+	// Modifying the copy gives it its own buffer.
+	b += "!";
+	CHECK(a != b);
+	CHECK(a < b);
+	CHECK_FALSE(b < a);
+
+	CHECK(String() == String(""));
+	CHECK_FALSE(String() < String(""));
 }
 
 TEST_CASE("[String] uri_encode/unescape") {
@@ -0,0 +1,148 @@
+/**************************************************************************/
+/*  test_string_name.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/string/string_name.h"
+#include "core/templates/local_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Interning") {
+	const StringName a = StringName("string_name_test_a");
+	const StringName b = StringName(String("string_name_test_a"));
+	const StringName c = StringName("string_name_test_c");
+
+	CHECK(a == b);
+	CHECK(a.data_unique_pointer() == b.data_unique_pointer());
+	CHECK(a != c);
+	CHECK(a == String("string_name_test_a"));
+	CHECK(StringName("").is_empty());
+	CHECK(StringName(String()).is_empty());
+}
+
+TEST_CASE("[StringName] Table grows and releases names") {
+	const StringName::TableStats before = StringName::get_table_stats();
+
+	// More names than the table has buckets initially.
+	const int count = int(before.buckets) + 1000;
+	LocalVector<StringName> names;
+	names.resize(count);
+	for (int i = 0; i < count; i++) {
+		names[i] = StringName("string_name_growth_" + itos(i));
+	}
+
+	const StringName::TableStats grown = StringName::get_table_stats();
+	CHECK(grown.names >= before.names + count);
+	CHECK(grown.buckets > before.buckets);
+
+	bool all_found = true;
+	for (int i = 0; i < count; i++) {
+		all_found = all_found && StringName("string_name_growth_" + itos(i)).data_unique_pointer() == names[i].data_unique_pointer();
+	}
+	CHECK_MESSAGE(all_found, "Every name should still be found after the table grew.");
+
+	names.clear();
+	const StringName::TableStats released = StringName::get_table_stats();
+	CHECK(released.names == grown.names - count);
+	CHECK(released.releases >= grown.releases + count);
+	CHECK_MESSAGE(released.retired == 0, "Without concurrent readers, released names should be reclaimed right away.");
+}
+
+#ifdef THREADS_ENABLED
+constexpr int CONCURRENT_NAME_COUNT = 256;
+constexpr int CONCURRENT_ITERATIONS = 20000;
+
+// Interns the same names from several threads while other names are constantly
+// released and re-created, so lock-free lookups race with removals in every shard.
+// Runs long enough to be useful under a thread sanitizer; timing is not checked.
+TEST_CASE("[StringName] Concurrent intern and release") {
+	struct Tester {
+		LocalVector<StringName> anchors;
+		TightLocalVector<Thread> threads;
+		SafeNumeric<uint32_t> next_thread_idx;
+		std::atomic<uint32_t> mismatches = 0;
+
+		static void thread_func(void *p_data) {
+			Tester *tester = (Tester *)p_data;
+			const uint32_t self_idx = tester->next_thread_idx.postincrement();
+			uint32_t local_mismatches = 0;
+			for (int i = 0; i < CONCURRENT_ITERATIONS; i++) {
+				const int k = (i * 7 + self_idx) % CONCURRENT_NAME_COUNT;
+				const StringName anchored = StringName("string_name_anchor_" + itos(k));
+				if (anchored != tester->anchors[k]) {
+					local_mismatches++;
+				}
+				// Nobody else holds these, so they are released and recreated all the time.
+				const StringName churn = StringName("string_name_churn_" + itos(k % 32));
+				const StringName again = StringName(String("string_name_churn_") + itos(k % 32));
+				if (churn != again || churn != ("string_name_churn_" + itos(k % 32))) {
+					local_mismatches++;
+				}
+			}
+			tester->mismatches.fetch_add(local_mismatches);
+		}
+
+		void run() {
+			for (int i = 0; i < CONCURRENT_NAME_COUNT; i++) {
+				anchors.push_back(StringName("string_name_anchor_" + itos(i)));
+			}
+			threads.resize(MAX(2, OS::get_singleton()->get_processor_count()));
+			for (Thread &thread : threads) {
+				thread.start(&Tester::thread_func, this);
+			}
+			for (Thread &thread : threads) {
+				thread.wait_to_finish();
+			}
+		}
+	};
+
+	const StringName::TableStats before = StringName::get_table_stats();
+
+	Tester tester;
+	tester.run();
+	CHECK(tester.mismatches.load() == 0);
+
+	const StringName::TableStats after = StringName::get_table_stats();
+#ifdef DEV_ENABLED
+	CHECK_MESSAGE(after.lock_free_hits > before.lock_free_hits, "Existing names should be found without locking.");
+#endif
+	CHECK(after.locked_lookups > before.locked_lookups);
+
+	tester.anchors.clear();
+	CHECK(StringName::get_table_stats().names == before.names);
+}
+#endif // THREADS_ENABLED
+
+} // namespace TestStringName
@@ -93,4 +93,24 @@ TEST_CASE("[LRU] Resize and clear") {
 	CHECK(!lru.has(3));
 	CHECK(!lru.has(4));
 }
+
+TEST_CASE("[LRU] Iteration order") {
+	LRUCache<int, int> lru;
+
+	lru.set_capacity(3);
+	lru.insert(1, 10);
+	lru.insert(2, 20);
+	lru.insert(3, 30);
+	lru.get(1);
+
+	const int expected_keys[] = { 1, 3, 2 };
+	int index = 0;
+	for (const LRUCache<int, int>::Pair &pair : lru) {
+		REQUIRE(index < 3);
+		CHECK(pair.key == expected_keys[index]);
+		CHECK(pair.data == expected_keys[index] * 10);
+		index++;
+	}
+	CHECK(index == 3);
+}
 } // namespace TestLRU
@@ -0,0 +1,130 @@
+/**************************************************************************/
+/*  test_work_stealing_queue.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/work_stealing_queue.h"
+
+#include "tests/test_macros.h"
+
+namespace TestWorkStealingQueue {
+
+TEST_CASE("[WorkStealingQueue] Owner pops newest, thieves steal oldest") {
+	WorkStealingQueue<uint32_t> queue(2);
+	CHECK(queue.is_empty());
+
+	// Grows past the initial capacity.
+	for (uint32_t i = 1; i <= 100; i++) {
+		queue.push(i);
+	}
+	CHECK(queue.size() == 100);
+
+	uint32_t value = 0;
+	CHECK(queue.pop(value));
+	CHECK(value == 100);
+	CHECK(queue.steal(value) == WorkStealingQueue<uint32_t>::STEAL_SUCCESS);
+	CHECK(value == 1);
+	CHECK(queue.steal(value) == WorkStealingQueue<uint32_t>::STEAL_SUCCESS);
+	CHECK(value == 2);
+	CHECK(queue.size() == 97);
+
+	uint32_t popped = 0;
+	while (queue.pop(value)) {
+		popped++;
+	}
+	CHECK(popped == 97);
+	CHECK(value == 3);
+	CHECK(queue.is_empty());
+	CHECK(queue.steal(value) == WorkStealingQueue<uint32_t>::STEAL_EMPTY);
+	CHECK_FALSE(queue.pop(value));
+}
+
+#ifdef THREADS_ENABLED
+constexpr uint32_t STEAL_ITEM_COUNT = 200000;
+
+// The owner keeps pushing, occasionally popping, while the other threads steal.
+// Every item must be taken exactly once. Timing is not checked.
+TEST_CASE("[WorkStealingQueue] Concurrent push, pop and steal") {
+	struct Tester {
+		WorkStealingQueue<uint32_t> queue{ 4 };
+		LocalVector<std::atomic<uint32_t>> taken;
+		TightLocalVector<Thread> thieves;
+		std::atomic<bool> done = false;
+
+		static void thief_func(void *p_data) {
+			Tester *tester = (Tester *)p_data;
+			uint32_t value = 0;
+			while (!tester->done.load() || !tester->queue.is_empty()) {
+				if (tester->queue.steal(value) == WorkStealingQueue<uint32_t>::STEAL_SUCCESS) {
+					tester->taken[value].fetch_add(1);
+				}
+			}
+		}
+
+		void run() {
+			taken.resize(STEAL_ITEM_COUNT);
+			thieves.resize(MAX(2, OS::get_singleton()->get_processor_count() - 1));
+			for (Thread &thief : thieves) {
+				thief.start(&Tester::thief_func, this);
+			}
+			uint32_t value = 0;
+			for (uint32_t i = 0; i < STEAL_ITEM_COUNT; i++) {
+				queue.push(i);
+				if (i % 3 == 0 && queue.pop(value)) {
+					taken[value].fetch_add(1);
+				}
+			}
+			while (queue.pop(value)) {
+				taken[value].fetch_add(1);
+			}
+			done.store(true);
+			for (Thread &thief : thieves) {
+				thief.wait_to_finish();
+			}
+		}
+	};
+
+	Tester tester;
+	tester.run();
+
+	uint32_t wrong = 0;
+	for (uint32_t i = 0; i < STEAL_ITEM_COUNT; i++) {
+		if (tester.taken[i].load() != 1) {
+			wrong++;
+		}
+	}
+	CHECK_MESSAGE(wrong == 0, "Every item should be taken exactly once.");
+}
+#endif // THREADS_ENABLED
+
+} // namespace TestWorkStealingQueue
@@ -106,6 +106,70 @@ TEST_CASE("[WorkerThreadPool] Process elements using group tasks") {
 	}
 }
 
+static void static_nested_child(void *p_arg) {
+	counter[(uintptr_t)p_arg].increment();
+}
+static void static_nested_group_child(void *p_arg, uint32_t p_index) {
+	counter[(uintptr_t)p_arg + 1 + p_index].increment();
+}
+static void static_nested_parent(void *p_arg) {
+	// Tasks posted from a pool thread go to its own queue, from where the others steal them.
+	const uintptr_t base = (uintptr_t)p_arg;
+	WorkerThreadPool::TaskID child = WorkerThreadPool::get_singleton()->add_native_task(static_nested_child, (void *)base, true);
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(static_nested_group_child, (void *)base, 7, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(child);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+}
+TEST_CASE("[WorkerThreadPool] Tasks posted from inside tasks") {
+	for (int iterations = 0; iterations < 100; iterations++) {
+		const int parents = Math::pow(2.0f, Math::random(0.0f, 5.0f));
+
+		counter.clear();
+		counter.resize(parents * 8);
+		LocalVector<WorkerThreadPool::TaskID> tasks;
+		for (int i = 0; i < parents; i++) {
+			tasks.push_back(WorkerThreadPool::get_singleton()->add_native_task(static_nested_parent, (void *)(uintptr_t)(i * 8), true));
+		}
+		for (uint32_t i = 0; i < tasks.size(); i++) {
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(tasks[i]);
+		}
+
+		bool all_run_once = true;
+		for (int i = 0; i < parents * 8; i++) {
+			all_run_once &= counter[i].get() == 1;
+		}
+		CHECK(all_run_once);
+	}
+}
+
+static void static_tiny_group_element(void *p_arg, uint32_t p_index) {
+	counter[p_index].increment();
+}
+// Runs many tiny elements on pools of 1 to N threads, so every thread count
+// exercises posting, stealing and sleeping. Timing is not checked.
+TEST_CASE("[WorkerThreadPool] Group tasks with tiny elements on 1 to N threads") {
+	const int max_threads = MAX(2, OS::get_singleton()->get_default_thread_pool_size());
+	const int count = 4096;
+	for (int thread_count = 1; thread_count <= max_threads; thread_count++) {
+		WorkerThreadPool *pool = memnew(WorkerThreadPool(false));
+		pool->init(thread_count);
+
+		bool all_run_once = true;
+		for (int iterations = 0; iterations < 20; iterations++) {
+			counter.clear();
+			counter.resize(count);
+			WorkerThreadPool::GroupID group = pool->add_native_group_task(static_tiny_group_element, nullptr, count, -1, iterations % 2);
+			pool->wait_for_group_task_completion(group);
+			for (int i = 0; i < count; i++) {
+				all_run_once &= counter[i].get() == 1;
+			}
+		}
+		CHECK_MESSAGE(all_run_once, vformat("Every element should run once with %d threads.", thread_count));
+
+		memdelete(pool);
+	}
+}
+
 static void static_test_daemon(void *p_arg) {
 	while (!exit.is_set()) {
 		counter[0].add(1);
@@ -2229,6 +2229,63 @@ TEST_CASE("[Variant] Utility functions") {
 	}
 }
 
+TEST_CASE("[Variant] Builtin method call cache") {
+	Variant::BuiltInMethodCache cache;
+	Callable::CallError ce;
+	Variant ret;
+
+	Variant vector = Vector3(1, 2, 3);
+	const Variant other = Vector3(4, 5, 6);
+	const Variant *args[1] = { &other };
+	vector.callp("dot", args, 1, ret, ce, cache);
+	CHECK(ce.error == Callable::CallError::CALL_OK);
+	CHECK(ret == Variant(32.0));
+	CHECK(cache.type == Variant::VECTOR3);
+	CHECK(cache.method != nullptr);
+
+	// Calling again with the same base type uses the cached method.
+	const VariantBuiltInMethodInfo *resolved = cache.method;
+	vector = Vector3(1, 0, 0);
+	vector.callp("dot", args, 1, ret, ce, cache);
+	CHECK(ce.error == Callable::CallError::CALL_OK);
+	CHECK(ret == Variant(4.0));
+	CHECK(cache.method == resolved);
+
+	// Another base type resolves the method again.
+	Variant::BuiltInMethodCache size_cache;
+	Variant array = Array{ 1, 2, 3 };
+	array.callp("size", nullptr, 0, ret, ce, size_cache);
+	CHECK(ret == Variant(3));
+	PackedByteArray bytes;
+	bytes.resize(5);
+	Variant packed = bytes;
+	packed.callp("size", nullptr, 0, ret, ce, size_cache);
+	CHECK(ce.error == Callable::CallError::CALL_OK);
+	CHECK(ret == Variant(5));
+	CHECK(size_cache.type == Variant::PACKED_BYTE_ARRAY);
+
+	// Methods missing on the base type fail the same way as without a cache.
+	Variant::BuiltInMethodCache missing_cache;
+	Variant string = "hello";
+	string.callp("dot", args, 1, ret, ce, missing_cache);
+	CHECK(ce.error == Callable::CallError::CALL_ERROR_INVALID_METHOD);
+	string.callp("dot", args, 1, ret, ce, missing_cache);
+	CHECK(ce.error == Callable::CallError::CALL_ERROR_INVALID_METHOD);
+
+	// Non-const methods are rejected by call_const() even once cached.
+	Variant::BuiltInMethodCache push_cache;
+	array.callp("push_back", args, 1, ret, ce, push_cache);
+	CHECK(ce.error == Callable::CallError::CALL_OK);
+	CHECK(Array(array).size() == 4);
+	array.call_const("push_back", args, 1, ret, ce, push_cache);
+	CHECK(ce.error == Callable::CallError::CALL_ERROR_METHOD_NOT_CONST);
+	CHECK(Array(array).size() == 4);
+
+	// Callables of builtin methods resolve the method when created.
+	const Callable callable = Callable::create(Vector3(0, 1, 0), "dot");
+	CHECK(callable.call(other) == Variant(5.0));
+}
+
 TEST_CASE("[Variant] Operator NOT") {
 	// Verify that operator NOT works for all types and is consistent with booleanize().
 	for (int i = 0; i < Variant::VARIANT_MAX; i++) {
@@ -30,7 +30,9 @@
 
 #pragma once
 
+#include "scene/3d/node_3d.h"
 #include "scene/animation/animation_player.h"
+#include "scene/main/window.h"
 #include "scene/resources/animation.h"
 #include "tests/test_macros.h"
 
@@ -61,4 +63,64 @@ TEST_CASE("[AnimationPlayer] get & set blend_time") {
 	memdelete(animation_player);
 }
 
+TEST_CASE("[SceneTree][AnimationPlayer] Parallel blending applies the same poses") {
+	const Ref<Animation> walk = memnew(Animation);
+	walk->set_length(1.0);
+	int track = walk->add_track(Animation::TYPE_POSITION_3D);
+	walk->track_set_path(track, NodePath("Target"));
+	walk->position_track_insert_key(track, 0.0, Vector3());
+	walk->position_track_insert_key(track, 1.0, Vector3(4, 2, 0));
+	track = walk->add_track(Animation::TYPE_SCALE_3D);
+	walk->track_set_path(track, NodePath("Target"));
+	walk->scale_track_insert_key(track, 0.0, Vector3(1, 1, 1));
+	walk->scale_track_insert_key(track, 1.0, Vector3(2, 1, 3));
+
+	const Ref<Animation> turn = memnew(Animation);
+	turn->set_length(1.0);
+	track = turn->add_track(Animation::TYPE_POSITION_3D);
+	turn->track_set_path(track, NodePath("Target"));
+	turn->position_track_insert_key(track, 0.0, Vector3(0, 0, -2));
+	turn->position_track_insert_key(track, 1.0, Vector3(0, 0, -6));
+	track = turn->add_track(Animation::TYPE_ROTATION_3D);
+	turn->track_set_path(track, NodePath("Target"));
+	turn->rotation_track_insert_key(track, 0.0, Quaternion());
+	turn->rotation_track_insert_key(track, 1.0, Quaternion(Vector3(0, 1, 0), Math::PI * 0.5));
+
+	const Ref<AnimationLibrary> library = memnew(AnimationLibrary);
+	library->add_animation("walk", walk);
+	library->add_animation("turn", turn);
+
+	// One serial mixer and several parallel ones, so the parallel set runs as a group task.
+	const int count = 4;
+	Node3D *roots[count];
+	Node3D *targets[count];
+	for (int i = 0; i < count; i++) {
+		roots[i] = memnew(Node3D);
+		targets[i] = memnew(Node3D);
+		targets[i]->set_name("Target");
+		roots[i]->add_child(targets[i]);
+		AnimationPlayer *player = memnew(AnimationPlayer);
+		player->add_animation_library("", library);
+		player->set_parallel_blending_enabled(i > 0);
+		roots[i]->add_child(player);
+		SceneTree::get_singleton()->get_root()->add_child(roots[i]);
+
+		// Cross-fade so both animations contribute to the pose.
+		player->play("walk");
+		player->play("turn", 1.0);
+	}
+
+	SceneTree::get_singleton()->process(0.25);
+
+	const Transform3D expected = targets[0]->get_transform();
+	CHECK_FALSE(expected.is_equal_approx(Transform3D()));
+	for (int i = 1; i < count; i++) {
+		CHECK_MESSAGE(targets[i]->get_transform().is_equal_approx(expected), vformat("Mixer %d should match the serial result.", i));
+	}
+
+	for (int i = 0; i < count; i++) {
+		memdelete(roots[i]);
+	}
+}
+
 } // namespace TestAnimationPlayer
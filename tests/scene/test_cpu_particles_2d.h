@@ -0,0 +1,92 @@
+/**************************************************************************/
+/*  test_cpu_particles_2d.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "scene/2d/cpu_particles_2d.h"
+
+#include "tests/test_macros.h"
+
+class TestCPUParticles2DInternalsAccessor {
+public:
+	static void process(CPUParticles2D *p_particles, double p_delta) {
+		p_particles->_particles_process(p_delta);
+	}
+
+	static Vector<Transform2D> get_transforms(const CPUParticles2D *p_particles) {
+		Vector<Transform2D> transforms;
+		for (const CPUParticles2D::Particle &particle : p_particles->particles) {
+			transforms.push_back(particle.active ? particle.transform : Transform2D());
+		}
+		return transforms;
+	}
+};
+
+namespace TestCPUParticles2D {
+
+TEST_CASE("[CPUParticles2D] Parallel processing gives the same particles") {
+	// Five blocks, the last one partial.
+	const int amount = 1041;
+	Vector<Transform2D> results[2];
+	for (int i = 0; i < 2; i++) {
+		CPUParticles2D *particles = memnew(CPUParticles2D);
+		particles->set_amount(amount);
+		particles->set_use_fixed_seed(true);
+		particles->set_seed(42);
+		particles->set_use_local_coordinates(true);
+		particles->set_explosiveness_ratio(0.5);
+		particles->set_emission_shape(CPUParticles2D::EMISSION_SHAPE_RING);
+		particles->set_emission_ring_inner_radius(10.0);
+		particles->set_emission_ring_radius(30.0);
+		particles->set_spread(180.0);
+		particles->set_param_min(CPUParticles2D::PARAM_INITIAL_LINEAR_VELOCITY, 20.0);
+		particles->set_param_max(CPUParticles2D::PARAM_INITIAL_LINEAR_VELOCITY, 80.0);
+		particles->set_parallel_processing_enabled(i == 1);
+		particles->set_emitting(true);
+
+		for (int step = 0; step < 10; step++) {
+			TestCPUParticles2DInternalsAccessor::process(particles, 1.0 / 30.0);
+		}
+		results[i] = TestCPUParticles2DInternalsAccessor::get_transforms(particles);
+		memdelete(particles);
+	}
+
+	REQUIRE(results[0].size() == amount);
+	int emitted = 0;
+	for (const Transform2D &transform : results[0]) {
+		if (transform != Transform2D()) {
+			emitted++;
+		}
+	}
+	CHECK(emitted > 256); // More than one block.
+	CHECK_MESSAGE(results[0] == results[1], "Processing the blocks on the WorkerThreadPool should not change the result.");
+}
+
+} // namespace TestCPUParticles2D
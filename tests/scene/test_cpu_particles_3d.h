@@ -0,0 +1,96 @@
+/**************************************************************************/
+/*  test_cpu_particles_3d.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "scene/3d/cpu_particles_3d.h"
+
+#include "tests/test_macros.h"
+
+class TestCPUParticles3DInternalsAccessor {
+public:
+	static void process(CPUParticles3D *p_particles, double p_delta) {
+		p_particles->_particles_process(p_delta);
+	}
+
+	static Vector<Transform3D> get_transforms(const CPUParticles3D *p_particles) {
+		Vector<Transform3D> transforms;
+		for (const CPUParticles3D::Particle &particle : p_particles->particles) {
+			transforms.push_back(particle.active ? particle.transform : Transform3D());
+		}
+		return transforms;
+	}
+};
+
+namespace TestCPUParticles3D {
+
+TEST_CASE("[CPUParticles3D] Parallel processing gives the same particles") {
+	// Five blocks, the last one partial.
+	const int amount = 1041;
+	PackedVector3Array points;
+	for (int i = 0; i < 16; i++) {
+		points.push_back(Vector3(i, i % 4, -i));
+	}
+
+	Vector<Transform3D> results[2];
+	for (int i = 0; i < 2; i++) {
+		CPUParticles3D *particles = memnew(CPUParticles3D);
+		particles->set_amount(amount);
+		particles->set_use_fixed_seed(true);
+		particles->set_seed(42);
+		particles->set_use_local_coordinates(true);
+		particles->set_explosiveness_ratio(0.5);
+		particles->set_emission_shape(CPUParticles3D::EMISSION_SHAPE_POINTS);
+		particles->set_emission_points(points);
+		particles->set_spread(180.0);
+		particles->set_param_min(CPUParticles3D::PARAM_INITIAL_LINEAR_VELOCITY, 2.0);
+		particles->set_param_max(CPUParticles3D::PARAM_INITIAL_LINEAR_VELOCITY, 8.0);
+		particles->set_parallel_processing_enabled(i == 1);
+		particles->set_emitting(true);
+
+		for (int step = 0; step < 10; step++) {
+			TestCPUParticles3DInternalsAccessor::process(particles, 1.0 / 30.0);
+		}
+		results[i] = TestCPUParticles3DInternalsAccessor::get_transforms(particles);
+		memdelete(particles);
+	}
+
+	REQUIRE(results[0].size() == amount);
+	int emitted = 0;
+	for (const Transform3D &transform : results[0]) {
+		if (transform != Transform3D()) {
+			emitted++;
+		}
+	}
+	CHECK(emitted > 256); // More than one block.
+	CHECK_MESSAGE(results[0] == results[1], "Processing the blocks on the WorkerThreadPool should not change the result.");
+}
+
+} // namespace TestCPUParticles3D
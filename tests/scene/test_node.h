@@ -71,6 +71,8 @@ protected:
 		ClassDB::bind_method(D_METHOD("set_exported_nodes", "node"), &TestNode::set_exported_nodes);
 		ClassDB::bind_method(D_METHOD("get_exported_nodes"), &TestNode::get_exported_nodes);
 		ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "exported_nodes", PROPERTY_HINT_TYPE_STRING, "24/34:Node"), "set_exported_nodes", "get_exported_nodes");
+
+		ClassDB::bind_method(D_METHOD("add_group_calls", "amount"), &TestNode::add_group_calls);
 	}
 
 private:
@@ -91,6 +93,14 @@ public:
 
 	List<Node *> *callback_list = nullptr;
 
+	int group_call_counter = 0;
+	bool group_call_in_process_group = false;
+
+	void add_group_calls(int p_amount) {
+		group_call_counter += p_amount;
+		group_call_in_process_group = is_group_processing();
+	}
+
 	void set_exported_node(Node *p_node) { exported_node = p_node; }
 	Node *get_exported_node() const { return exported_node; }
 
@@ -913,4 +923,58 @@ TEST_CASE("[SceneTree][Node] Test the process priority") {
 	memdelete(node4);
 }
 
+TEST_CASE("[SceneTree][Node] Group calls") {
+	Node *main_parent = memnew(Node);
+	Node *thread_parent_a = memnew(Node);
+	Node *thread_parent_b = memnew(Node);
+	SceneTree::get_singleton()->get_root()->add_child(main_parent);
+	SceneTree::get_singleton()->get_root()->add_child(thread_parent_a);
+	SceneTree::get_singleton()->get_root()->add_child(thread_parent_b);
+	thread_parent_a->set_process_thread_group(Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+	thread_parent_b->set_process_thread_group(Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+
+	LocalVector<TestNode *> nodes;
+	for (Node *parent : { main_parent, thread_parent_a, thread_parent_b }) {
+		for (int i = 0; i < 4; i++) {
+			TestNode *node = memnew(TestNode);
+			parent->add_child(node);
+			node->add_to_group(SNAME("test_group"));
+			nodes.push_back(node);
+		}
+	}
+	// A member of another class that doesn't have the method.
+	Node *other = memnew(Node);
+	main_parent->add_child(other);
+	other->add_to_group(SNAME("test_group"));
+
+	SUBCASE("Immediate calls") {
+		SceneTree::get_singleton()->call_group(SNAME("test_group"), SNAME("add_group_calls"), 2);
+		SceneTree::get_singleton()->call_group_flags(SceneTree::GROUP_CALL_REVERSE, SNAME("test_group"), SNAME("add_group_calls"), 1);
+		for (TestNode *node : nodes) {
+			CHECK_EQ(node->group_call_counter, 3);
+			CHECK_FALSE(node->group_call_in_process_group);
+		}
+	}
+
+	SUBCASE("Threaded calls") {
+		SceneTree::get_singleton()->call_group_flags(SceneTree::GROUP_CALL_THREADED, SNAME("test_group"), SNAME("add_group_calls"), 2);
+		for (TestNode *node : nodes) {
+			CHECK_EQ(node->group_call_counter, 2);
+			// Only members of a sub-thread process group are dispatched from the process group.
+			CHECK_EQ(node->group_call_in_process_group, node->get_parent() != main_parent);
+		}
+	}
+
+	SUBCASE("Threaded notifications") {
+		SceneTree::get_singleton()->notify_group_flags(SceneTree::GROUP_CALL_THREADED, SNAME("test_group"), Node::NOTIFICATION_PROCESS);
+		for (TestNode *node : nodes) {
+			CHECK_EQ(node->process_counter, 1);
+		}
+	}
+
+	memdelete(main_parent);
+	memdelete(thread_parent_a);
+	memdelete(thread_parent_b);
+}
+
 } // namespace TestNode
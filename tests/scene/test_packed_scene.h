@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include "scene/2d/node_2d.h"
 #include "scene/resources/packed_scene.h"
 
 #include "tests/test_macros.h"
@@ -280,4 +281,127 @@ TEST_CASE("[PackedScene] Recreate State") {
 	memdelete(scene);
 }
 
+TEST_CASE("[PackedScene] Instantiate Packed Scene With Properties, Groups and Connections") {
+	// Create a scene to pack.
+	Node2D *scene = memnew(Node2D);
+	scene->set_name("TestScene");
+	scene->set_position(Vector2(10, 20));
+	scene->add_to_group("roots", true);
+
+	Node2D *child = memnew(Node2D);
+	child->set_name("Child");
+	child->set_rotation(1.5);
+	child->set_meta("items", Array{ 1, 2 });
+	scene->add_child(child);
+	child->set_owner(scene);
+	child->set_unique_name_in_owner(true);
+	child->connect(SceneStringName(visibility_changed), Callable(scene, "update_configuration_warnings"), Object::CONNECT_PERSIST);
+
+	PackedScene packed_scene;
+	packed_scene.pack(scene);
+
+	Node *first = packed_scene.instantiate();
+	Node *second = packed_scene.instantiate();
+	for (Node *instance : { first, second }) {
+		Node2D *root = Object::cast_to<Node2D>(instance);
+		REQUIRE(root != nullptr);
+		CHECK(root->get_name() == "TestScene");
+		CHECK(root->get_position() == Vector2(10, 20));
+		CHECK(root->is_in_group("roots"));
+
+		Node2D *instance_child = Object::cast_to<Node2D>(root->get_node_or_null(NodePath("%Child")));
+		REQUIRE(instance_child != nullptr);
+		CHECK(instance_child->get_owner() == root);
+		CHECK(instance_child->get_rotation() == doctest::Approx(1.5));
+		CHECK(instance_child->is_connected(SceneStringName(visibility_changed), Callable(root, "update_configuration_warnings")));
+	}
+
+	// Containers are copied for each instance.
+	Array first_items = first->get_child(0)->get_meta("items");
+	first_items.push_back(3);
+	CHECK(Array(second->get_child(0)->get_meta("items")).size() == 2);
+
+	memdelete(scene);
+	memdelete(first);
+	memdelete(second);
+}
+
+TEST_CASE("[SceneTree][PackedScene] Recycle Instances") {
+	Node2D *scene = memnew(Node2D);
+	scene->set_name("TestScene");
+	scene->set_position(Vector2(10, 20));
+
+	Node2D *child = memnew(Node2D);
+	child->set_name("Child");
+	child->add_to_group("enemies", true);
+	scene->add_child(child);
+	child->set_owner(scene);
+
+	Ref<PackedScene> packed_scene;
+	packed_scene.instantiate();
+	packed_scene->pack(scene);
+	memdelete(scene);
+
+	Node2D *instance = Object::cast_to<Node2D>(packed_scene->instantiate());
+	REQUIRE(instance != nullptr);
+
+	// The pool is empty by default, the instance is queued for deletion instead.
+	Node *unpooled = packed_scene->instantiate();
+	CHECK_FALSE(packed_scene->recycle_instance(unpooled));
+	CHECK(unpooled->is_queued_for_deletion());
+	memdelete(unpooled);
+
+	packed_scene->set_instance_pool_size(1);
+
+	// Modify the instance, recycling restores its packed state.
+	Node2D *parent = memnew(Node2D);
+	parent->add_child(instance);
+	instance->set_name("Renamed");
+	instance->set_position(Vector2(1, 1));
+	Node2D *instance_child = Object::cast_to<Node2D>(instance->get_child(0));
+	instance_child->set_visible(false);
+	instance_child->remove_from_group("enemies");
+	instance_child->add_to_group("dead");
+	// Runtime connections are dropped so _ready() can make them again, engine method pointers are kept.
+	instance_child->connect("visibility_changed", Callable(instance, "queue_redraw"));
+	instance->connect("renamed", callable_mp(static_cast<Node *>(instance_child), &Node::is_ready));
+
+	CHECK(packed_scene->recycle_instance(instance));
+	CHECK(instance->get_parent() == nullptr);
+	CHECK(packed_scene->get_pooled_instance_count() == 1);
+
+	Node *reused = packed_scene->instantiate();
+	CHECK(reused == instance);
+	CHECK(packed_scene->get_pooled_instance_count() == 0);
+	CHECK(instance->get_name() == "TestScene");
+	CHECK(instance->get_position() == Vector2(10, 20));
+	CHECK(instance_child->is_visible());
+	CHECK(instance_child->is_in_group("enemies"));
+	CHECK_FALSE(instance_child->is_in_group("dead"));
+	CHECK_FALSE(instance_child->is_connected("visibility_changed", Callable(instance, "queue_redraw")));
+	CHECK(instance->is_connected("renamed", callable_mp(static_cast<Node *>(instance_child), &Node::is_ready)));
+
+	// Instances whose structure changed can't be reset. As the scene is built-in, the structure is also
+	// what identifies its instances, so such nodes are left alone.
+	Node *extra = memnew(Node);
+	instance->add_child(extra);
+	ERR_PRINT_OFF;
+	CHECK_FALSE(packed_scene->recycle_instance(instance));
+	ERR_PRINT_ON;
+	CHECK_FALSE(instance->is_queued_for_deletion());
+	CHECK(packed_scene->get_pooled_instance_count() == 0);
+	memdelete(extra);
+
+	// Neither are nodes of other scenes, even with a matching structure.
+	instance->set_scene_file_path("res://other_scene.tscn");
+	ERR_PRINT_OFF;
+	CHECK_FALSE(packed_scene->recycle_instance(instance));
+	ERR_PRINT_ON;
+	CHECK_FALSE(instance->is_queued_for_deletion());
+	CHECK(packed_scene->get_pooled_instance_count() == 0);
+
+	memdelete(instance);
+	memdelete(parent);
+}
+
 } // namespace TestPackedScene
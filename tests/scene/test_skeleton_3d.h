@@ -33,6 +33,8 @@
 #include "tests/test_macros.h"
 
 #include "scene/3d/skeleton_3d.h"
+#include "scene/main/window.h"
+#include "scene/resources/3d/skin.h"
 
 namespace TestSkeleton3D {
 
@@ -72,4 +74,50 @@ TEST_CASE("[Skeleton3D] Test per-bone meta") {
 	skeleton->set_bone_meta(0, "non-existing-key", Variant());
 	memdelete(skeleton);
 }
+
+TEST_CASE("[SceneTree][Skeleton3D] Skin transforms are uploaded to the RenderingServer") {
+	Skeleton3D *skeleton = memnew(Skeleton3D);
+	skeleton->add_bone("root");
+	skeleton->add_bone("arm");
+	skeleton->add_bone("hand");
+	skeleton->set_bone_parent(1, 0);
+	skeleton->set_bone_parent(2, 1);
+	skeleton->set_bone_pose_position(0, Vector3(0, 1, 0));
+	skeleton->set_bone_pose_rotation(0, Quaternion(Vector3(0, 1, 0), 0.5));
+	skeleton->set_bone_pose_position(1, Vector3(0.5, 0, 0));
+	skeleton->set_bone_pose_rotation(1, Quaternion(Vector3(1, 0, 0), -1.2));
+	skeleton->set_bone_pose_scale(1, Vector3(1, 2, 1));
+	skeleton->set_bone_pose_position(2, Vector3(0, 0.25, 0.1));
+
+	Ref<Skin> skin;
+	skin.instantiate();
+	skin->add_bind(2, Transform3D(Basis(Vector3(0, 0, 1), 0.3), Vector3(1, -2, 0.5)));
+	skin->add_named_bind("root", Transform3D(Basis().scaled(Vector3(0.5, 0.5, 0.5)), Vector3(0, -1, 0)));
+	skin->add_bind(1, Transform3D());
+	Ref<SkinReference> skin_ref = skeleton->register_skin(skin);
+
+	// Entering the tree updates the skins right away.
+	SceneTree::get_singleton()->get_root()->add_child(skeleton);
+	RID rs_skeleton = skin_ref->get_skeleton();
+	REQUIRE(RS::get_singleton()->skeleton_get_bone_count(rs_skeleton) == skin->get_bind_count());
+
+	const int bones[] = { 2, 0, 1 };
+	for (int i = 0; i < skin->get_bind_count(); i++) {
+		const Transform3D expected = skeleton->get_bone_global_pose(bones[i]) * skin->get_bind_pose(i);
+		CHECK_MESSAGE(RS::get_singleton()->skeleton_bone_get_transform(rs_skeleton, i).is_equal_approx(expected), vformat("Bind %d should be the bone's global pose times its bind pose.", i));
+	}
+
+	SUBCASE("Buffers of the wrong size are rejected") {
+		const Transform3D before = RS::get_singleton()->skeleton_bone_get_transform(rs_skeleton, 0);
+		Vector<float> buffer;
+		buffer.resize((skin->get_bind_count() - 1) * 12);
+		buffer.fill(0.0f);
+		ERR_PRINT_OFF;
+		RS::get_singleton()->skeleton_set_transforms(rs_skeleton, buffer);
+		ERR_PRINT_ON;
+		CHECK(RS::get_singleton()->skeleton_bone_get_transform(rs_skeleton, 0) == before);
+	}
+
+	memdelete(skeleton);
+}
 } // namespace TestSkeleton3D
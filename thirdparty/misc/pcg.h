@@ -12,5 +12,6 @@ typedef struct { uint64_t state;  uint64_t inc; } pcg32_random_t;
 uint32_t pcg32_random_r(pcg32_random_t* rng);
 void pcg32_srandom_r(pcg32_random_t* rng, uint64_t initstate, uint64_t initseq);
 uint32_t pcg32_boundedrand_r(pcg32_random_t* rng, uint32_t bound);
+void pcg32_advance_r(pcg32_random_t* rng, uint64_t delta);
 
 #endif // RANDOM_H